@@ -0,0 +1,135 @@
+#include "Benchmarks.h"
+#include "BenchmarkRunner.h"
+
+#include <ituGL/asset/ModelLoader.h>
+#include <ituGL/asset/TextureCubemapLoader.h>
+#include <ituGL/geometry/VertexFormat.h>
+#include <assimp/mesh.h>
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+static const std::vector<size_t> s_vertexCounts = { 1024, 65536, 1048576 };
+
+// Mesh with positions, normals, tangents, bitangents and one UV channel, like the models exported for the shaders
+static std::shared_ptr<aiMesh> CreateMesh(size_t vertexCount)
+{
+    std::shared_ptr<aiMesh> mesh = std::make_shared<aiMesh>();
+    unsigned int count = static_cast<unsigned int>(vertexCount);
+    mesh->mNumVertices = count;
+    mesh->mVertices = new aiVector3D[count];
+    mesh->mNormals = new aiVector3D[count];
+    mesh->mTangents = new aiVector3D[count];
+    mesh->mBitangents = new aiVector3D[count];
+    mesh->mTextureCoords[0] = new aiVector3D[count];
+    mesh->mNumUVComponents[0] = 2;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        float x = static_cast<float>(i % 256);
+        float y = static_cast<float>(i / 256);
+        mesh->mVertices[i] = aiVector3D(x, y, 0.0f);
+        mesh->mNormals[i] = aiVector3D(0.0f, 0.0f, 1.0f);
+        mesh->mTangents[i] = aiVector3D(1.0f, 0.0f, 0.0f);
+        mesh->mBitangents[i] = aiVector3D(0.0f, 1.0f, 0.0f);
+        mesh->mTextureCoords[0][i] = aiVector3D(x / 256.0f, y / 256.0f, 0.0f);
+    }
+    return mesh;
+}
+
+void AssetBenchmarks::RegisterModelLoaderBenchmarks(BenchmarkRunner& runner)
+{
+    // Copy positions from the tight source arrays into an interleaved vertex of 56 bytes
+    runner.Add("ModelLoader::CopyBuffer/vec3 to interleaved", s_vertexCounts, [](size_t count)
+    {
+        const size_t dstStride = 56;
+        const size_t srcStride = sizeof(aiVector3D);
+        auto dst = std::make_shared<std::vector<GLubyte>>(dstStride * count);
+        auto src = std::make_shared<std::vector<aiVector3D>>(count, aiVector3D(1.0f, 2.0f, 3.0f));
+        return BenchmarkRunner::Case{ [dst, src, count](size_t iterations)
+        {
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                ModelLoader::CopyBuffer(dst->data(), dstStride, src->data(), srcStride, count, srcStride);
+                BenchmarkRunner::ClobberMemory();
+            }
+        }, count };
+    });
+
+    // Narrow the 32 bit indices of the faces to 16 bits, one index at a time
+    runner.Add("ModelLoader::CopyBuffer/uint to ushort", s_vertexCounts, [](size_t count)
+    {
+        auto dst = std::make_shared<std::vector<GLushort>>(count);
+        auto src = std::make_shared<std::vector<GLuint>>(count, 7u);
+        return BenchmarkRunner::Case{ [dst, src, count](size_t iterations)
+        {
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                ModelLoader::CopyBuffer(dst->data(), sizeof(GLushort), src->data(), sizeof(GLuint), count, sizeof(GLushort));
+                BenchmarkRunner::ClobberMemory();
+            }
+        }, count };
+    });
+
+    for (bool interleaved : { true, false })
+    {
+        const char* name = interleaved ? "ModelLoader::CollectVertexData/interleaved" : "ModelLoader::CollectVertexData/contiguous";
+        runner.Add(name, s_vertexCounts, [interleaved](size_t count)
+        {
+            std::shared_ptr<aiMesh> mesh = CreateMesh(count);
+            return BenchmarkRunner::Case{ [mesh, interleaved](size_t iterations)
+            {
+                VertexFormat vertexFormat;
+                for (size_t i = 0; i < iterations; ++i)
+                {
+                    std::vector<GLubyte> vertexData = ModelLoader::CollectVertexData(*mesh, vertexFormat, interleaved);
+                    BenchmarkRunner::DoNotOptimize(vertexData.data());
+                }
+            }, count };
+        });
+    }
+}
+
+void AssetBenchmarks::RegisterTextureCubemapLoaderBenchmarks(BenchmarkRunner& runner)
+{
+    // Extract the six faces of an RGBA8 cross layout image. The upload is stubbed, so only the copy is timed
+    runner.Add("TextureCubemapLoader::LoadFace/rgba8", { 64, 256, 1024 }, [](size_t side)
+    {
+        auto textureData = std::make_shared<TextureLoaderUtils::TextureData>();
+        textureData->width = static_cast<int>(4 * side);
+        textureData->height = static_cast<int>(3 * side);
+        textureData->dataType = Data::Type::UByte;
+        textureData->format = TextureObject::FormatRGBA;
+        textureData->internalFormat = TextureObject::InternalFormatRGBA8;
+        // The texture data frees the pixels with stb, which uses free
+        size_t dataSize = 4 * static_cast<size_t>(textureData->width) * textureData->height;
+        std::byte* data = static_cast<std::byte*>(std::malloc(dataSize));
+        std::fill(data, data + dataSize, std::byte(128));
+        textureData->data = std::span<const std::byte>(data, dataSize);
+
+        auto faceData = std::make_shared<std::vector<std::byte>>(4 * side * side);
+        auto textureCubemap = std::make_shared<TextureCubemapObject>();
+        return BenchmarkRunner::Case{ [textureData, faceData, textureCubemap, side](size_t iterations)
+        {
+            // The faces are set on the bound texture, as CreateTexture does
+            textureCubemap->Bind();
+            int faceSide = static_cast<int>(side);
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                TextureCubemapLoader::LoadFace(*textureCubemap, TextureCubemapObject::Face::Left, *textureData, *faceData, 0, 1, faceSide);
+                TextureCubemapLoader::LoadFace(*textureCubemap, TextureCubemapObject::Face::Right, *textureData, *faceData, 2, 1, faceSide);
+                TextureCubemapLoader::LoadFace(*textureCubemap, TextureCubemapObject::Face::Bottom, *textureData, *faceData, 1, 2, faceSide);
+                TextureCubemapLoader::LoadFace(*textureCubemap, TextureCubemapObject::Face::Top, *textureData, *faceData, 1, 0, faceSide);
+                TextureCubemapLoader::LoadFace(*textureCubemap, TextureCubemapObject::Face::Front, *textureData, *faceData, 3, 1, faceSide);
+                TextureCubemapLoader::LoadFace(*textureCubemap, TextureCubemapObject::Face::Back, *textureData, *faceData, 1, 1, faceSide);
+                BenchmarkRunner::ClobberMemory();
+            }
+        }, 6 * side * side };
+    });
+}
+
+void AssetBenchmarks::Register(BenchmarkRunner& runner)
+{
+    RegisterModelLoaderBenchmarks(runner);
+    RegisterTextureCubemapLoaderBenchmarks(runner);
+}
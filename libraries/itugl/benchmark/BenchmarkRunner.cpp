@@ -0,0 +1,199 @@
+#include "BenchmarkRunner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+BenchmarkRunner::BenchmarkRunner(const Settings& settings) : m_settings(settings)
+{
+}
+
+void BenchmarkRunner::Add(const std::string& name, const std::vector<size_t>& sizes, const SetupFunction& setup)
+{
+    m_benchmarks.push_back({ name, sizes, setup });
+}
+
+void BenchmarkRunner::List() const
+{
+    for (const Benchmark& benchmark : m_benchmarks)
+    {
+        std::printf("%s:", benchmark.name.c_str());
+        for (size_t size : benchmark.sizes)
+        {
+            std::printf(" %zu", size);
+        }
+        std::printf("\n");
+    }
+}
+
+bool BenchmarkRunner::Run()
+{
+    std::printf("%-40s %10s %14s %10s %14s %8s %9s\n", "Benchmark", "Size", "Median ns", "MAD %", "ns/item", "Samples", "Outliers");
+
+    std::vector<Result> results;
+    for (const Benchmark& benchmark : m_benchmarks)
+    {
+        if (!m_settings.filter.empty() && benchmark.name.find(m_settings.filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        for (size_t size : benchmark.sizes)
+        {
+            // The data is created again for each size, so the previous size doesn't leave it in the caches
+            Case benchmarkCase = benchmark.setup(size);
+            const Result& result = results.emplace_back(Measure(benchmark.name, size, benchmarkCase));
+
+            double madPercent = result.median > 0.0 ? 100.0 * result.mad / result.median : 0.0;
+            std::printf("%-40s %10zu %14.1f %10.2f %14.3f %8u %9u\n", result.name.c_str(), result.size, result.median, madPercent,
+                result.median / result.itemsPerIteration, result.sampleCount, result.outliers);
+            std::fflush(stdout);
+        }
+    }
+
+    return WriteReport(results);
+}
+
+BenchmarkRunner::Result BenchmarkRunner::Measure(const std::string& name, size_t size, const Case& benchmarkCase) const
+{
+    Result result;
+    result.name = name;
+    result.size = size;
+    result.itemsPerIteration = std::max(benchmarkCase.itemsPerIteration, static_cast<size_t>(1));
+    result.iterationsPerSample = CalibrateIterations(benchmarkCase);
+
+    // Warm-up samples fill the caches and let the CPU frequency settle
+    for (unsigned int i = 0; i < m_settings.warmupSampleCount; ++i)
+    {
+        TimeIterations(benchmarkCase, result.iterationsPerSample);
+    }
+
+    std::vector<double> samples(std::max(m_settings.sampleCount, 1u));
+    for (double& sample : samples)
+    {
+        sample = 1.0e9 * TimeIterations(benchmarkCase, result.iterationsPerSample) / result.iterationsPerSample;
+    }
+    ComputeStatistics(samples, result);
+    return result;
+}
+
+size_t BenchmarkRunner::CalibrateIterations(const Case& benchmarkCase) const
+{
+    size_t iterations = 1;
+    while (true)
+    {
+        double elapsed = TimeIterations(benchmarkCase, iterations);
+        if (elapsed >= m_settings.minSampleTime)
+        {
+            return iterations;
+        }
+
+        // Jump close to the target once the time is large enough to trust, otherwise keep doubling
+        size_t nextIterations = iterations * 2;
+        if (elapsed > m_settings.minSampleTime * 0.05)
+        {
+            double scale = 1.2 * m_settings.minSampleTime / elapsed;
+            nextIterations = std::max(nextIterations, static_cast<size_t>(std::ceil(iterations * scale)));
+        }
+        iterations = nextIterations;
+    }
+}
+
+double BenchmarkRunner::TimeIterations(const Case& benchmarkCase, size_t iterations)
+{
+    ClobberMemory();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    benchmarkCase.run(iterations);
+    ClobberMemory();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+void BenchmarkRunner::ComputeStatistics(std::vector<double>& samples, Result& result)
+{
+    std::sort(samples.begin(), samples.end());
+    size_t count = samples.size();
+    result.sampleCount = static_cast<unsigned int>(count);
+
+    auto median = [](const std::vector<double>& sorted)
+    {
+        size_t half = sorted.size() / 2;
+        return sorted.size() % 2 ? sorted[half] : 0.5 * (sorted[half - 1] + sorted[half]);
+    };
+    result.median = median(samples);
+    result.min = samples.front();
+    result.max = samples.back();
+    result.p95 = samples[std::min(static_cast<size_t>(std::ceil(0.95 * count)), count) - 1];
+
+    double sum = 0.0;
+    for (double sample : samples)
+    {
+        sum += sample;
+    }
+    result.mean = sum / count;
+    double squaredSum = 0.0;
+    for (double sample : samples)
+    {
+        squaredSum += (sample - result.mean) * (sample - result.mean);
+    }
+    result.stddev = count > 1 ? std::sqrt(squaredSum / (count - 1)) : 0.0;
+
+    std::vector<double> deviations(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        deviations[i] = std::abs(samples[i] - result.median);
+    }
+    std::sort(deviations.begin(), deviations.end());
+    result.mad = 1.4826 * median(deviations);
+
+    result.outliers = 0;
+    for (double sample : samples)
+    {
+        result.outliers += std::abs(sample - result.median) > 3.0 * result.mad ? 1 : 0;
+    }
+
+    // The ranks around the median that contain it with 95% probability, from the normal approximation of the binomial distribution
+    double spread = 0.98 * std::sqrt(static_cast<double>(count));
+    double lowRank = std::floor(0.5 * count - spread);
+    double highRank = std::ceil(0.5 * count + spread);
+    result.medianLow = samples[static_cast<size_t>(std::clamp(lowRank, 1.0, static_cast<double>(count))) - 1];
+    result.medianHigh = samples[static_cast<size_t>(std::clamp(highRank, 1.0, static_cast<double>(count))) - 1];
+}
+
+bool BenchmarkRunner::WriteReport(const std::vector<Result>& results) const
+{
+    std::ofstream file(m_settings.outputPath);
+    if (!file)
+    {
+        std::printf("Could not write the benchmark report to %s\n", m_settings.outputPath.c_str());
+        return false;
+    }
+
+    file << "{\n  \"sampleCount\": " << m_settings.sampleCount << ",\n  \"minSampleTimeMs\": " << 1000.0 * m_settings.minSampleTime;
+    file << ",\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result& result = results[i];
+        file << (i ? "," : "") << "\n    { \"name\": \"" << result.name << "\", \"size\": " << result.size
+            << ", \"itemsPerIteration\": " << result.itemsPerIteration
+            << ", \"iterationsPerSample\": " << result.iterationsPerSample
+            << ", \"samples\": " << result.sampleCount
+            << ", \"ns\": { \"median\": " << result.median
+            << ", \"medianLow\": " << result.medianLow
+            << ", \"medianHigh\": " << result.medianHigh
+            << ", \"mad\": " << result.mad
+            << ", \"mean\": " << result.mean
+            << ", \"stddev\": " << result.stddev
+            << ", \"min\": " << result.min
+            << ", \"p95\": " << result.p95
+            << ", \"max\": " << result.max << " }"
+            << ", \"nsPerItem\": " << result.median / result.itemsPerIteration
+            << ", \"outliers\": " << result.outliers << " }";
+    }
+    file << "\n  ]\n}\n";
+
+    std::printf("Benchmark report written to %s\n", m_settings.outputPath.c_str());
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// Runs registered benchmarks over a sweep of sizes, and reports robust statistics of the samples
+// Each sample times enough iterations to last at least the minimum sample time, so the clock resolution doesn't matter
+class BenchmarkRunner
+{
+public:
+    struct Settings
+    {
+        // Samples measured for each benchmark and size, after the warm-up samples
+        unsigned int sampleCount = 30;
+        unsigned int warmupSampleCount = 3;
+        // Minimum duration of a sample, in seconds
+        double minSampleTime = 0.005;
+        // Only the benchmarks with this text in the name run, if not empty
+        std::string filter;
+        std::string outputPath = "itugl_benchmarks.json";
+    };
+
+    // Work of one benchmark at one size. The function runs the given number of iterations
+    struct Case
+    {
+        std::function<void(size_t iterations)> run;
+        // Items processed by each iteration, to report the time per item
+        size_t itemsPerIteration = 1;
+    };
+
+    // Creates the data for a size, outside the timed region
+    using SetupFunction = std::function<Case(size_t size)>;
+
+    // Statistics of the samples, in nanoseconds per iteration
+    struct Result
+    {
+        std::string name;
+        size_t size = 0;
+        size_t itemsPerIteration = 1;
+        size_t iterationsPerSample = 0;
+        unsigned int sampleCount = 0;
+        double median = 0.0;
+        // Median absolute deviation, scaled to estimate the standard deviation of normal samples
+        double mad = 0.0;
+        double mean = 0.0;
+        double stddev = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+        double p95 = 0.0;
+        // 95% confidence interval of the median, from the order statistics of the samples
+        double medianLow = 0.0;
+        double medianHigh = 0.0;
+        // Samples further than 3 MADs from the median, usually preemptions or page faults
+        unsigned int outliers = 0;
+    };
+
+public:
+    BenchmarkRunner(const Settings& settings);
+
+    void Add(const std::string& name, const std::vector<size_t>& sizes, const SetupFunction& setup);
+
+    // Print the names and the sizes of the registered benchmarks
+    void List() const;
+
+    // Run the benchmarks that pass the filter, print them and write the JSON report. Returns false if the report could not be written
+    bool Run();
+
+    // Keep the compiler from removing the computation of a value that is not used otherwise
+    template<typename T>
+    static void DoNotOptimize(const T& value);
+
+    // Keep the compiler from caching memory values across this point
+    static void ClobberMemory();
+
+private:
+    struct Benchmark
+    {
+        std::string name;
+        std::vector<size_t> sizes;
+        SetupFunction setup;
+    };
+
+    Result Measure(const std::string& name, size_t size, const Case& benchmarkCase) const;
+
+    // Iterations needed for a sample to last at least the minimum sample time
+    size_t CalibrateIterations(const Case& benchmarkCase) const;
+
+    // Time the iterations, in seconds
+    static double TimeIterations(const Case& benchmarkCase, size_t iterations);
+
+    static void ComputeStatistics(std::vector<double>& samples, Result& result);
+
+    bool WriteReport(const std::vector<Result>& results) const;
+
+private:
+    Settings m_settings;
+
+    std::vector<Benchmark> m_benchmarks;
+};
+
+template<typename T>
+inline void BenchmarkRunner::DoNotOptimize(const T& value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    // Reading the value through a volatile pointer forces it to be computed
+    const volatile char* sink = reinterpret_cast<const volatile char*>(&value);
+    (void)*sink;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+inline void BenchmarkRunner::ClobberMemory()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : : "memory");
+#endif
+}
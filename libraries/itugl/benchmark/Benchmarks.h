@@ -0,0 +1,52 @@
+#pragma once
+
+#include <memory>
+
+class BenchmarkRunner;
+class ShaderProgram;
+
+// Transform chains and bounds intersections
+class SceneBenchmarks
+{
+public:
+    static void Register(BenchmarkRunner& runner);
+};
+
+// Vertex format layout iteration
+class GeometryBenchmarks
+{
+public:
+    static void Register(BenchmarkRunner& runner);
+};
+
+// Setting and reading the values stored in uniform collections
+class ShaderBenchmarks
+{
+public:
+    static void Register(BenchmarkRunner& runner);
+
+    // Program built from GLSL sources. The recording GL reports the uniforms declared, in order
+    static std::shared_ptr<ShaderProgram> CreateShaderProgram(const char* vertexSource, const char* fragmentSource);
+};
+
+// Data conversion helpers of the loaders. Friend of the loaders, to time their private helpers
+class AssetBenchmarks
+{
+public:
+    static void Register(BenchmarkRunner& runner);
+
+private:
+    static void RegisterModelLoaderBenchmarks(BenchmarkRunner& runner);
+    static void RegisterTextureCubemapLoaderBenchmarks(BenchmarkRunner& runner);
+};
+
+// Drawcall collection and submission of the renderer, with the GL calls recorded but not executed
+class RendererBenchmarks
+{
+public:
+    static void Register(BenchmarkRunner& runner);
+
+    // Record one frame of each renderer scene and write the command stream, to compare it across builds
+    // Returns false if the file can't be written
+    static bool WriteCommands(const char* path);
+};
@@ -0,0 +1,37 @@
+#include "Benchmarks.h"
+#include "BenchmarkRunner.h"
+
+#include <ituGL/geometry/VertexFormat.h>
+#include <memory>
+
+void GeometryBenchmarks::Register(BenchmarkRunner& runner)
+{
+    const std::vector<size_t> attributeCounts = { 1, 4, 8, 16 };
+
+    // Walk the layouts of all the attributes, as the meshes do when they set up a VAO
+    for (bool interleaved : { true, false })
+    {
+        const char* name = interleaved ? "VertexFormat::LayoutIterator/interleaved" : "VertexFormat::LayoutIterator/contiguous";
+        runner.Add(name, attributeCounts, [interleaved](size_t attributeCount)
+        {
+            auto vertexFormat = std::make_shared<VertexFormat>();
+            for (size_t i = 0; i < attributeCount; ++i)
+            {
+                vertexFormat->AddVertexAttribute<float>(1 + i % 4);
+            }
+            return BenchmarkRunner::Case{ [vertexFormat, interleaved](size_t iterations)
+            {
+                for (size_t i = 0; i < iterations; ++i)
+                {
+                    size_t offsetSum = 0;
+                    auto itEnd = vertexFormat->LayoutEnd();
+                    for (auto it = vertexFormat->LayoutBegin(1024, interleaved); it != itEnd; it++)
+                    {
+                        offsetSum += it->GetOffset() + it->GetStride();
+                    }
+                    BenchmarkRunner::DoNotOptimize(offsetSum);
+                }
+            }, attributeCount };
+        });
+    }
+}
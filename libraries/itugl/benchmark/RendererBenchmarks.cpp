@@ -0,0 +1,276 @@
+#include "Benchmarks.h"
+#include "BenchmarkRunner.h"
+
+#include <ituGL/renderer/Renderer.h>
+#include <ituGL/core/RecordingGL.h>
+#include <ituGL/renderer/ForwardRenderPass.h>
+#include <ituGL/camera/Camera.h>
+#include <ituGL/geometry/Model.h>
+#include <ituGL/geometry/VertexFormat.h>
+#include <ituGL/lighting/PointLight.h>
+#include <ituGL/shader/Material.h>
+#include <ituGL/scene/Scene.h>
+#include <ituGL/scene/SceneCamera.h>
+#include <ituGL/scene/RendererSceneVisitor.h>
+#include <ituGL/scene/StressSceneBuilder.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+// Renderer with a forward pass, and models that share one mesh. Created with the recording GL
+struct RendererScene
+{
+    RendererScene(size_t modelCount, bool uniqueMaterials, bool forwardPass);
+
+    std::unique_ptr<Renderer> renderer;
+    Camera camera;
+    PointLight light;
+    std::vector<Model> models;
+    std::vector<glm::mat4> worldMatrices;
+
+    // Collect the drawcalls of all the models, and run the passes
+    void RenderFrame();
+};
+
+// Program that draws the models with the material color. Only the color is a property, the matrix is set by the renderer
+static std::shared_ptr<ShaderProgram> CreateColorProgram()
+{
+    const char* vertexSource = R"(#version 330 core
+layout (location = 0) in vec3 VertexPosition;
+uniform mat4 WorldViewProjMatrix;
+void main()
+{
+    gl_Position = WorldViewProjMatrix * vec4(VertexPosition, 1.0);
+})";
+    const char* fragmentSource = R"(#version 330 core
+uniform vec4 Color;
+out vec4 FragColor;
+void main()
+{
+    FragColor = Color;
+})";
+    return ShaderBenchmarks::CreateShaderProgram(vertexSource, fragmentSource);
+}
+
+// Renderer that updates the matrix and the lights of the program, with a forward pass or without passes
+static std::unique_ptr<Renderer> CreateRenderer(std::shared_ptr<ShaderProgram> shaderProgram, bool forwardPass)
+{
+    std::unique_ptr<Renderer> renderer = std::make_unique<Renderer>(DeviceGL::GetInstance());
+    // The timer queries are not part of the work measured
+    renderer->GetProfiler().SetEnabled(false);
+    if (forwardPass)
+    {
+        renderer->AddRenderPass(std::make_unique<ForwardRenderPass>());
+    }
+
+    ShaderProgram::Location worldViewProjMatrixLocation = shaderProgram->GetUniformLocation("WorldViewProjMatrix");
+    renderer->RegisterShaderProgram(shaderProgram,
+        [=](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
+        {
+            shaderProgram.SetUniform(worldViewProjMatrixLocation, camera.GetViewProjectionMatrix() * worldMatrix);
+        },
+        renderer->GetDefaultUpdateLightsFunction(*shaderProgram));
+    return renderer;
+}
+
+// Cube without indices
+static std::shared_ptr<Mesh> CreateCubeMesh()
+{
+    VertexFormat vertexFormat;
+    vertexFormat.AddVertexAttribute<float>(3, VertexAttribute::Semantic::Position);
+    std::vector<glm::vec3> vertices(36, glm::vec3(0.0f));
+    std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+    mesh->AddSubmesh<glm::vec3, VertexFormat::LayoutIterator>(Drawcall::Primitive::Triangles, vertices, vertexFormat.LayoutBegin(36, false), vertexFormat.LayoutEnd());
+    return mesh;
+}
+
+RendererScene::RendererScene(size_t modelCount, bool uniqueMaterials, bool forwardPass)
+{
+    std::shared_ptr<ShaderProgram> shaderProgram = CreateColorProgram();
+    renderer = CreateRenderer(shaderProgram, forwardPass);
+    std::shared_ptr<Mesh> mesh = CreateCubeMesh();
+
+    Material::NameSet filteredUniforms = { "WorldViewProjMatrix" };
+    std::shared_ptr<Material> sharedMaterial = std::make_shared<Material>(shaderProgram, filteredUniforms);
+    for (size_t i = 0; i < modelCount; ++i)
+    {
+        std::shared_ptr<Material> material = sharedMaterial;
+        if (uniqueMaterials)
+        {
+            material = std::make_shared<Material>(shaderProgram, filteredUniforms);
+            material->SetUniformValue("Color", glm::vec4(static_cast<float>(i % 256) / 255.0f, 0.5f, 0.5f, 1.0f));
+        }
+        Model& model = models.emplace_back(mesh);
+        model.AddMaterial(material);
+        worldMatrices.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(static_cast<float>(i % 100), 0.0f, static_cast<float>(i / 100))));
+    }
+
+    camera.SetViewMatrix(glm::vec3(-10.0f, 10.0f, -10.0f), glm::vec3(50.0f, 0.0f, 50.0f));
+    camera.SetPerspectiveProjectionMatrix(1.0f, 1.0f, 0.1f, 1000.0f);
+    light.SetColor(glm::vec3(1.0f));
+}
+
+void RendererScene::RenderFrame()
+{
+    renderer->SetCurrentCamera(camera);
+    renderer->AddLight(light);
+    for (size_t i = 0; i < models.size(); ++i)
+    {
+        renderer->AddModel(models[i], worldMatrices[i]);
+    }
+    renderer->Render();
+}
+
+// Scene filled by the StressSceneBuilder, and drawn through the RendererSceneVisitor as the applications do
+struct StressScene
+{
+    StressScene(const StressSceneBuilder::Settings& settings, bool forwardPass);
+
+    std::unique_ptr<Renderer> renderer;
+    Scene scene;
+
+    // Visit the scene to collect the camera, the lights and the drawcalls, and run the passes
+    void RenderFrame();
+};
+
+StressScene::StressScene(const StressSceneBuilder::Settings& settings, bool forwardPass)
+{
+    std::shared_ptr<ShaderProgram> shaderProgram = CreateColorProgram();
+    renderer = CreateRenderer(shaderProgram, forwardPass);
+
+    std::shared_ptr<Model> model = std::make_shared<Model>(CreateCubeMesh());
+    model->AddMaterial(std::make_shared<Material>(shaderProgram, Material::NameSet{ "WorldViewProjMatrix" }));
+
+    StressSceneBuilder builder(settings);
+    builder.Build(scene, std::span<const std::shared_ptr<Model>>(&model, 1));
+
+    std::shared_ptr<Camera> camera = std::make_shared<Camera>();
+    camera->SetViewMatrix(glm::vec3(0.0f, 0.5f * settings.extent, -1.5f * settings.extent), glm::vec3(0.0f));
+    camera->SetPerspectiveProjectionMatrix(1.0f, 1.0f, 0.1f, 4.0f * settings.extent);
+    scene.AddSceneNode(std::make_shared<SceneCamera>("camera", camera));
+}
+
+void StressScene::RenderFrame()
+{
+    RendererSceneVisitor rendererSceneVisitor(*renderer);
+    scene.AcceptVisitor(rendererSceneVisitor);
+    renderer->Render();
+}
+
+// Settings of the stress scenes. The seed is fixed, so every run measures the same layout
+static StressSceneBuilder::Settings GetStressSceneSettings(size_t modelCount, size_t lightCount, unsigned int hierarchyDepth)
+{
+    StressSceneBuilder::Settings settings;
+    settings.seed = 1234u;
+    settings.modelCount = static_cast<unsigned int>(modelCount);
+    settings.lightCount = static_cast<unsigned int>(lightCount);
+    settings.hierarchyDepth = hierarchyDepth;
+    settings.modelVariantCount = 16;
+    settings.materialVariantFunction = [](Material& material, unsigned int variantIndex)
+        {
+            material.SetUniformValue("Color", glm::vec4(static_cast<float>(variantIndex) / 16.0f, 0.5f, 0.5f, 1.0f));
+        };
+    return settings;
+}
+
+static void RegisterStressSceneBenchmarks(BenchmarkRunner& runner)
+{
+    // Scene traversal and drawcall collection, without passes
+    runner.Add("StressScene/objects", { 1000, 10000, 100000, 1000000 }, [](size_t modelCount)
+    {
+        std::shared_ptr<StressScene> scene = std::make_shared<StressScene>(GetStressSceneSettings(modelCount, 1, 4), false);
+        return BenchmarkRunner::Case{ [scene](size_t iterations)
+        {
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                scene->RenderFrame();
+            }
+        }, modelCount };
+    });
+
+    // Same traversal, with deeper hierarchies above the models. The size is the depth
+    runner.Add("StressScene/hierarchy depth", { 0, 1, 4, 16 }, [](size_t hierarchyDepth)
+    {
+        const size_t modelCount = 100000;
+        std::shared_ptr<StressScene> scene = std::make_shared<StressScene>(GetStressSceneSettings(modelCount, 1, static_cast<unsigned int>(hierarchyDepth)), false);
+        return BenchmarkRunner::Case{ [scene](size_t iterations)
+        {
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                scene->RenderFrame();
+            }
+        }, modelCount };
+    });
+
+    // Forward pass, that draws each model once per light. The size is the light count, the items are the draws
+    runner.Add("StressScene/forward lights", { 1, 10, 100, 1000, 10000 }, [](size_t lightCount)
+    {
+        const size_t modelCount = 100;
+        std::shared_ptr<StressScene> scene = std::make_shared<StressScene>(GetStressSceneSettings(modelCount, lightCount, 0), true);
+        return BenchmarkRunner::Case{ [scene](size_t iterations)
+        {
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                scene->RenderFrame();
+            }
+        }, modelCount * lightCount };
+    });
+}
+
+void RendererBenchmarks::Register(BenchmarkRunner& runner)
+{
+    const std::vector<size_t> modelCounts = { 16, 1024, 16384, 100000 };
+
+    // Only the collection of the drawcalls, without passes
+    runner.Add("Renderer::AddModel", modelCounts, [](size_t modelCount)
+    {
+        std::shared_ptr<RendererScene> scene = std::make_shared<RendererScene>(modelCount, false, false);
+        return BenchmarkRunner::Case{ [scene](size_t iterations)
+        {
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                scene->RenderFrame();
+            }
+        }, modelCount };
+    });
+
+    // Drawcalls prepared and submitted by the forward pass, with one light
+    for (bool uniqueMaterials : { false, true })
+    {
+        const char* name = uniqueMaterials ? "Renderer::Render forward/unique materials" : "Renderer::Render forward/shared material";
+        runner.Add(name, modelCounts, [uniqueMaterials](size_t modelCount)
+        {
+            std::shared_ptr<RendererScene> scene = std::make_shared<RendererScene>(modelCount, uniqueMaterials, true);
+            return BenchmarkRunner::Case{ [scene](size_t iterations)
+            {
+                for (size_t i = 0; i < iterations; ++i)
+                {
+                    scene->RenderFrame();
+                }
+            }, modelCount };
+        });
+    }
+
+    RegisterStressSceneBenchmarks(runner);
+}
+
+bool RendererBenchmarks::WriteCommands(const char* path)
+{
+    RecordingGL::ClearCommands();
+    for (bool uniqueMaterials : { false, true })
+    {
+        RendererScene scene(1024, uniqueMaterials, true);
+
+        // The first frame also creates the objects of the passes
+        scene.RenderFrame();
+
+        RecordingGL::SetRecording(true);
+        scene.RenderFrame();
+        RecordingGL::SetRecording(false);
+    }
+
+    const std::vector<uint64_t>& commandBuffer = RecordingGL::GetCommandBuffer();
+    std::printf("Recorded %u commands, hash %016llx\n", RecordingGL::GetCommandCount(), static_cast<unsigned long long>(RecordingGL::GetHash(commandBuffer)));
+    return RecordingGL::WriteCommands(commandBuffer, path);
+}
@@ -0,0 +1,180 @@
+#include "Benchmarks.h"
+#include "BenchmarkRunner.h"
+
+#include <ituGL/scene/Transform.h>
+#include <ituGL/scene/Bounds.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Chain of transforms where each one is the parent of the next. Returns the leaf, the root is the first one
+static std::vector<std::shared_ptr<Transform>> CreateTransformChain(size_t depth)
+{
+    std::vector<std::shared_ptr<Transform>> chain;
+    for (size_t i = 0; i < depth; ++i)
+    {
+        std::shared_ptr<Transform> transform = std::make_shared<Transform>();
+        transform->SetTranslation(glm::vec3(1.0f, 0.5f, 0.0f));
+        transform->SetRotation(glm::vec3(0.1f, 0.2f, 0.3f));
+        transform->SetScale(glm::vec3(1.01f));
+        if (!chain.empty())
+        {
+            transform->SetParent(chain.back());
+        }
+        chain.push_back(transform);
+    }
+    return chain;
+}
+
+static void RegisterTransformBenchmarks(BenchmarkRunner& runner)
+{
+    const std::vector<size_t> depths = { 1, 4, 16, 64 };
+
+    // Nothing changed, the cached matrix is returned after checking the parents
+    runner.Add("Transform::GetTransformMatrix/clean", depths, [](size_t depth)
+    {
+        std::vector<std::shared_ptr<Transform>> chain = CreateTransformChain(depth);
+        chain.back()->GetTransformMatrix();
+        return BenchmarkRunner::Case{ [chain](size_t iterations)
+        {
+            const Transform& leaf = *chain.back();
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                BenchmarkRunner::DoNotOptimize(leaf.GetTransformMatrix());
+            }
+        }, depth };
+    });
+
+    // The root moves every time, so the whole chain is computed again
+    runner.Add("Transform::GetTransformMatrix/dirty root", depths, [](size_t depth)
+    {
+        std::vector<std::shared_ptr<Transform>> chain = CreateTransformChain(depth);
+        return BenchmarkRunner::Case{ [chain](size_t iterations)
+        {
+            Transform& root = *chain.front();
+            const Transform& leaf = *chain.back();
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                root.SetTranslation(glm::vec3(static_cast<float>(i & 7), 0.0f, 0.0f));
+                BenchmarkRunner::DoNotOptimize(leaf.GetTransformMatrix());
+            }
+        }, depth };
+    });
+}
+
+// Bounds with random placement in a small volume, so about half of the pairs intersect
+class RandomBounds
+{
+public:
+    RandomBounds(unsigned int seed) : m_random(seed), m_position(-4.0f, 4.0f), m_size(0.5f, 2.0f), m_angle(0.0f, 6.2831853f)
+    {
+    }
+
+    SphereBounds CreateSphere() { return SphereBounds(CreatePosition(), m_size(m_random)); }
+    AabbBounds CreateAabb() { return AabbBounds(CreatePosition(), CreateSize()); }
+    BoxBounds CreateBox()
+    {
+        glm::vec3 axis = glm::normalize(CreatePosition() + glm::vec3(0.01f));
+        glm::mat3 rotationMatrix(glm::rotate(glm::mat4(1.0f), m_angle(m_random), axis));
+        return BoxBounds(CreatePosition(), rotationMatrix, CreateSize());
+    }
+
+    template<typename T>
+    T Create();
+
+private:
+    glm::vec3 CreatePosition() { return glm::vec3(m_position(m_random), m_position(m_random), m_position(m_random)); }
+    glm::vec3 CreateSize() { return glm::vec3(m_size(m_random), m_size(m_random), m_size(m_random)); }
+
+private:
+    std::mt19937 m_random;
+    std::uniform_real_distribution<float> m_position;
+    std::uniform_real_distribution<float> m_size;
+    std::uniform_real_distribution<float> m_angle;
+};
+
+template<> SphereBounds RandomBounds::Create() { return CreateSphere(); }
+template<> AabbBounds RandomBounds::Create() { return CreateAabb(); }
+template<> BoxBounds RandomBounds::Create() { return CreateBox(); }
+
+// Test each bounds of the first array with the bounds in the same position of the second one
+template<typename TA, typename TB>
+static void AddIntersectsBenchmark(BenchmarkRunner& runner, const char* name, const std::vector<size_t>& counts)
+{
+    runner.Add(name, counts, [](size_t count)
+    {
+        RandomBounds randomBounds(12345u);
+        auto boundsA = std::make_shared<std::vector<TA>>();
+        auto boundsB = std::make_shared<std::vector<TB>>();
+        for (size_t i = 0; i < count; ++i)
+        {
+            boundsA->push_back(randomBounds.Create<TA>());
+            boundsB->push_back(randomBounds.Create<TB>());
+        }
+        return BenchmarkRunner::Case{ [boundsA, boundsB](size_t iterations)
+        {
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                unsigned int intersections = 0;
+                for (size_t j = 0; j < boundsA->size(); ++j)
+                {
+                    intersections += Bounds::Intersects((*boundsA)[j], (*boundsB)[j]) ? 1 : 0;
+                }
+                BenchmarkRunner::DoNotOptimize(intersections);
+            }
+        }, count };
+    });
+}
+
+static void RegisterBoundsBenchmarks(BenchmarkRunner& runner)
+{
+    // Frustum bounds are left out, their constructor is not implemented and their tests always pass
+    const std::vector<size_t> counts = { 64, 4096, 262144 };
+    AddIntersectsBenchmark<SphereBounds, SphereBounds>(runner, "Bounds::Intersects/sphere-sphere", counts);
+    AddIntersectsBenchmark<AabbBounds, SphereBounds>(runner, "Bounds::Intersects/aabb-sphere", counts);
+    AddIntersectsBenchmark<AabbBounds, AabbBounds>(runner, "Bounds::Intersects/aabb-aabb", counts);
+    AddIntersectsBenchmark<BoxBounds, SphereBounds>(runner, "Bounds::Intersects/box-sphere", counts);
+    AddIntersectsBenchmark<BoxBounds, AabbBounds>(runner, "Bounds::Intersects/box-aabb", counts);
+    AddIntersectsBenchmark<BoxBounds, BoxBounds>(runner, "Bounds::Intersects/box-box", counts);
+
+    // Mixed types through the base class, which dispatches on the type of both bounds
+    runner.Add("Bounds::Intersects/mixed dynamic", counts, [](size_t count)
+    {
+        RandomBounds randomBounds(12345u);
+        auto bounds = std::make_shared<std::vector<std::unique_ptr<Bounds>>>();
+        for (size_t i = 0; i < 2 * count; ++i)
+        {
+            switch (i % 3)
+            {
+            case 0:
+                bounds->push_back(std::make_unique<SphereBounds>(randomBounds.CreateSphere()));
+                break;
+            case 1:
+                bounds->push_back(std::make_unique<AabbBounds>(randomBounds.CreateAabb()));
+                break;
+            default:
+                bounds->push_back(std::make_unique<BoxBounds>(randomBounds.CreateBox()));
+                break;
+            }
+        }
+        return BenchmarkRunner::Case{ [bounds](size_t iterations)
+        {
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                unsigned int intersections = 0;
+                for (size_t j = 0; j + 1 < bounds->size(); j += 2)
+                {
+                    intersections += Bounds::Intersects(*(*bounds)[j], *(*bounds)[j + 1]) ? 1 : 0;
+                }
+                BenchmarkRunner::DoNotOptimize(intersections);
+            }
+        }, count };
+    });
+}
+
+void SceneBenchmarks::Register(BenchmarkRunner& runner)
+{
+    RegisterTransformBenchmarks(runner);
+    RegisterBoundsBenchmarks(runner);
+}
@@ -0,0 +1,83 @@
+#include "Benchmarks.h"
+#include "BenchmarkRunner.h"
+
+#include <ituGL/shader/ShaderUniformCollection.h>
+#include <ituGL/shader/Shader.h>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <memory>
+#include <string>
+
+std::shared_ptr<ShaderProgram> ShaderBenchmarks::CreateShaderProgram(const char* vertexSource, const char* fragmentSource)
+{
+    Shader vertexShader(Shader::VertexShader);
+    vertexShader.SetSource(vertexSource);
+    vertexShader.Compile();
+
+    Shader fragmentShader(Shader::FragmentShader);
+    fragmentShader.SetSource(fragmentSource);
+    fragmentShader.Compile();
+
+    std::shared_ptr<ShaderProgram> shaderProgram = std::make_shared<ShaderProgram>();
+    shaderProgram->Build(vertexShader, fragmentShader);
+    return shaderProgram;
+}
+
+// Collection of a program with this many uniforms of the type. The locations are 0 to count - 1
+static std::shared_ptr<ShaderUniformCollection> CreateUniformCollection(const char* glslType, size_t count)
+{
+    std::string fragmentSource = "#version 330 core\n";
+    for (size_t i = 0; i < count; ++i)
+    {
+        fragmentSource += std::string("uniform ") + glslType + " Uniform" + std::to_string(i) + ";\n";
+    }
+    fragmentSource += "out vec4 FragColor;\nvoid main() { FragColor = vec4(1.0); }\n";
+    const char* vertexSource = "#version 330 core\nvoid main() { gl_Position = vec4(0.0); }\n";
+    return std::make_shared<ShaderUniformCollection>(ShaderBenchmarks::CreateShaderProgram(vertexSource, fragmentSource.c_str()));
+}
+
+template<typename T>
+static void AddUniformBenchmarks(BenchmarkRunner& runner, const char* typeName, const std::vector<size_t>& counts)
+{
+    // Set every uniform of the collection
+    runner.Add(std::string("ShaderUniformCollection::SetUniformValue/") + typeName, counts, [typeName](size_t count)
+    {
+        std::shared_ptr<ShaderUniformCollection> collection = CreateUniformCollection(typeName, count);
+        return BenchmarkRunner::Case{ [collection, count](size_t iterations)
+        {
+            T value(1.0f);
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                for (ShaderProgram::Location location = 0; location < static_cast<ShaderProgram::Location>(count); ++location)
+                {
+                    collection->SetUniformValue(location, value);
+                }
+                BenchmarkRunner::ClobberMemory();
+            }
+        }, count };
+    });
+
+    // Read every uniform of the collection, through GetDataValues
+    runner.Add(std::string("ShaderUniformCollection::GetUniformValue/") + typeName, counts, [typeName](size_t count)
+    {
+        std::shared_ptr<ShaderUniformCollection> collection = CreateUniformCollection(typeName, count);
+        return BenchmarkRunner::Case{ [collection, count](size_t iterations)
+        {
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                for (ShaderProgram::Location location = 0; location < static_cast<ShaderProgram::Location>(count); ++location)
+                {
+                    BenchmarkRunner::DoNotOptimize(collection->GetUniformValue<T>(location));
+                }
+            }
+        }, count };
+    });
+}
+
+void ShaderBenchmarks::Register(BenchmarkRunner& runner)
+{
+    const std::vector<size_t> counts = { 4, 16, 64 };
+    AddUniformBenchmarks<float>(runner, "float", counts);
+    AddUniformBenchmarks<glm::vec4>(runner, "vec4", counts);
+    AddUniformBenchmarks<glm::mat4>(runner, "mat4", counts);
+}
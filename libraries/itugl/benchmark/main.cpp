@@ -0,0 +1,75 @@
+#include "Benchmarks.h"
+#include "BenchmarkRunner.h"
+
+#include <ituGL/core/DeviceGL.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Usage: itugl_benchmarks [--filter TEXT] [--samples N] [--min-time MILLISECONDS] [--output PATH] [--list] [--commands PATH]
+// The GL calls are recorded, no window or context is created
+// With --commands, only one frame of each renderer scene is recorded and written to PATH, to diff it against other builds
+int main(int argc, char** argv)
+{
+    BenchmarkRunner::Settings settings;
+    bool list = false;
+    const char* commandsPath = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--filter") == 0 && hasValue)
+        {
+            settings.filter = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--samples") == 0 && hasValue)
+        {
+            settings.sampleCount = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--min-time") == 0 && hasValue)
+        {
+            settings.minSampleTime = 0.001 * std::strtod(argv[++i], nullptr);
+        }
+        else if (std::strcmp(argv[i], "--output") == 0 && hasValue)
+        {
+            settings.outputPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--commands") == 0 && hasValue)
+        {
+            commandsPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--list") == 0)
+        {
+            list = true;
+        }
+    }
+
+#ifndef NDEBUG
+    std::printf("Asserts are enabled, build in Release for representative times\n");
+#endif
+
+    DeviceGL device;
+    if (!device.LoadRecordingContext())
+    {
+        std::printf("Could not load the recording GL\n");
+        return 1;
+    }
+
+    if (commandsPath)
+    {
+        return RendererBenchmarks::WriteCommands(commandsPath) ? 0 : 1;
+    }
+
+    BenchmarkRunner runner(settings);
+    SceneBenchmarks::Register(runner);
+    GeometryBenchmarks::Register(runner);
+    ShaderBenchmarks::Register(runner);
+    AssetBenchmarks::Register(runner);
+    RendererBenchmarks::Register(runner);
+
+    if (list)
+    {
+        runner.List();
+        return 0;
+    }
+    return runner.Run() ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+# ---------------------------------------------------------------------------------
+# Generate a C++ header with the uniforms and vertex attributes declared in the shaders
+# Usage: cmake -DSHADER_DIR=<folder> -DOUTPUT=<header> -P GenerateShaderInterface.cmake
+#
+# Uniforms must be declared with a fixed location, as "LOCATION(N) uniform type Name;", and vertex attributes
+# as "layout (location = N) in type Name;". Uniforms with the same name must have the same location and type
+# in all the shaders, so the code can set them in any program without looking them up by name
+# Members of uniform blocks, declared as "layout(std140) uniform Block { type Name; ... };", don't have a location. They
+# get -1, unless the same name is declared with a location in other shaders
+# ---------------------------------------------------------------------------------
+cmake_minimum_required(VERSION 3.15)
+
+if(NOT SHADER_DIR OR NOT OUTPUT)
+	message(FATAL_ERROR "GenerateShaderInterface: SHADER_DIR and OUTPUT are required")
+endif()
+
+# Statements that declare uniforms and vertex inputs
+set(uniform_regex "^[ \t]*(LOCATION[ \t]*\\([ \t]*[0-9]+[ \t]*\\)[ \t]*)?uniform[ \t]")
+set(attribute_regex "^[ \t]*(layout[ \t]*\\([^)]*\\)[ \t]*)?in[ \t]")
+set(block_regex "^[ \t]*layout[ \t]*\\([^)]*\\)[ \t]*uniform[ \t]+([A-Za-z_][A-Za-z0-9_]*)")
+
+# Min value of GL_MAX_UNIFORM_LOCATIONS
+set(max_uniform_locations 1024)
+
+# C++ type of each GLSL type. Samplers are set as textures, and bools as ints
+set(cpp_type_float "float")
+set(cpp_type_int "int")
+set(cpp_type_uint "unsigned int")
+set(cpp_type_bool "int")
+foreach(n 2 3 4)
+	set(cpp_type_vec${n} "glm::vec${n}")
+	set(cpp_type_ivec${n} "glm::ivec${n}")
+	set(cpp_type_uvec${n} "glm::uvec${n}")
+	set(cpp_type_mat${n} "glm::mat${n}")
+endforeach()
+
+function(get_cpp_type glsl_type file result)
+	if(glsl_type MATCHES "^[iu]?sampler")
+		set(${result} "TextureObject" PARENT_SCOPE)
+	elseif(DEFINED cpp_type_${glsl_type})
+		set(${result} "${cpp_type_${glsl_type}}" PARENT_SCOPE)
+	else()
+		message(FATAL_ERROR "${file}: type ${glsl_type} is not supported in the shader interface")
+	endif()
+endfunction()
+
+file(GLOB_RECURSE shader_files "${SHADER_DIR}/*.vert" "${SHADER_DIR}/*.frag" "${SHADER_DIR}/*.geom" "${SHADER_DIR}/*.glsl")
+list(SORT shader_files)
+
+set(uniform_names "")
+set(block_uniform_names "")
+set(attribute_names "")
+foreach(file ${shader_files})
+	# Members of uniform blocks, one per line
+	file(STRINGS "${file}" lines)
+	set(block "")
+	foreach(line ${lines})
+		if(block STREQUAL "")
+			if(line MATCHES "${block_regex}")
+				set(block ${CMAKE_MATCH_1})
+			endif()
+		elseif(line MATCHES "^[ \t]*}")
+			if(NOT line MATCHES "^[ \t]*}[ \t]*;")
+				message(FATAL_ERROR "${file}: uniform block ${block} with an instance name is not supported")
+			endif()
+			set(block "")
+		elseif(line MATCHES "^[ \t]*([A-Za-z0-9_]+)[ \t]+([A-Za-z_][A-Za-z0-9_]*)[ \t]*;")
+			set(glsl_type ${CMAKE_MATCH_1})
+			set(name ${CMAKE_MATCH_2})
+			get_cpp_type(${glsl_type} ${file} cpp_type)
+			if(DEFINED block_type_${name})
+				if(NOT block_type_${name} STREQUAL cpp_type)
+					message(FATAL_ERROR "${file}: ${name} is declared as ${glsl_type}, but it was ${block_type_${name}} in ${block_file_${name}}")
+				endif()
+			else()
+				set(block_type_${name} ${cpp_type})
+				set(block_file_${name} ${file})
+				list(APPEND block_uniform_names ${name})
+			endif()
+		endif()
+	endforeach()
+
+	file(STRINGS "${file}" declarations REGEX "${uniform_regex}")
+	foreach(declaration ${declarations})
+		if(NOT declaration MATCHES "${uniform_regex}")
+			continue()
+		endif()
+		if(NOT declaration MATCHES "^[ \t]*LOCATION[ \t]*\\([ \t]*([0-9]+)[ \t]*\\)[ \t]*uniform[ \t]+([A-Za-z0-9_]+)[ \t]+([A-Za-z_][A-Za-z0-9_]*)[ \t]*;")
+			message(FATAL_ERROR "${file}: uniform without a fixed location, or not supported: \"${declaration}\"")
+		endif()
+		set(location ${CMAKE_MATCH_1})
+		set(glsl_type ${CMAKE_MATCH_2})
+		set(name ${CMAKE_MATCH_3})
+		get_cpp_type(${glsl_type} ${file} cpp_type)
+
+		if(location GREATER_EQUAL max_uniform_locations)
+			message(FATAL_ERROR "${file}: location ${location} of ${name} is over the limit of ${max_uniform_locations}")
+		endif()
+		if(DEFINED uniform_location_${name})
+			if(NOT uniform_location_${name} EQUAL location OR NOT uniform_type_${name} STREQUAL cpp_type)
+				message(FATAL_ERROR "${file}: ${name} is declared as ${glsl_type} with location ${location}, "
+					"but it was ${uniform_type_${name}} with location ${uniform_location_${name}} in ${uniform_file_${name}}")
+			endif()
+		else()
+			if(DEFINED uniform_at_${location})
+				message(FATAL_ERROR "${file}: location ${location} of ${name} is already used by ${uniform_at_${location}}")
+			endif()
+			set(uniform_location_${name} ${location})
+			set(uniform_type_${name} ${cpp_type})
+			set(uniform_file_${name} ${file})
+			set(uniform_at_${location} ${name})
+			list(APPEND uniform_names ${name})
+		endif()
+	endforeach()
+
+	# Vertex attributes
+	if(file MATCHES "\\.vert$")
+		file(STRINGS "${file}" declarations REGEX "${attribute_regex}")
+		foreach(declaration ${declarations})
+			if(NOT declaration MATCHES "${attribute_regex}")
+				continue()
+			endif()
+			if(NOT declaration MATCHES "^[ \t]*layout[ \t]*\\([ \t]*location[ \t]*=[ \t]*([0-9]+)[ \t]*\\)[ \t]*in[ \t]+[A-Za-z0-9_]+[ \t]+([A-Za-z_][A-Za-z0-9_]*)[ \t]*;")
+				message(FATAL_ERROR "${file}: vertex attribute without a fixed location: \"${declaration}\"")
+			endif()
+			set(location ${CMAKE_MATCH_1})
+			set(name ${CMAKE_MATCH_2})
+			if(DEFINED attribute_location_${name})
+				if(NOT attribute_location_${name} EQUAL location)
+					message(FATAL_ERROR "${file}: attribute ${name} has location ${location}, but it was ${attribute_location_${name}}")
+				endif()
+			else()
+				set(attribute_location_${name} ${location})
+				list(APPEND attribute_names ${name})
+			endif()
+		endforeach()
+	endif()
+endforeach()
+
+# Block members declared with a location somewhere else use it, the others are listed after the uniforms
+set(block_only_names "")
+foreach(name ${block_uniform_names})
+	if(DEFINED uniform_location_${name})
+		if(NOT uniform_type_${name} STREQUAL block_type_${name})
+			message(FATAL_ERROR "${block_file_${name}}: ${name} is declared as ${block_type_${name}} in a uniform block, "
+				"but it was ${uniform_type_${name}} in ${uniform_file_${name}}")
+		endif()
+	else()
+		list(APPEND block_only_names ${name})
+	endif()
+endforeach()
+
+# Sort by location, so the header shows how they are assigned
+set(uniform_list "")
+foreach(name ${uniform_names})
+	# Pad the locations, so the string sort works
+	string(LENGTH "${uniform_location_${name}}" digits)
+	math(EXPR padding "4 - ${digits}")
+	string(REPEAT "0" ${padding} zeros)
+	list(APPEND uniform_list "${zeros}${uniform_location_${name}}:${name}")
+endforeach()
+list(SORT uniform_list)
+
+set(content "#pragma once\n\n")
+string(APPEND content "// Generated by GenerateShaderInterface.cmake from the shaders. Don't edit, change the shaders instead\n")
+string(APPEND content "// Uniform locations are fixed in the shaders, so they are the same in all the programs and variants\n\n")
+string(APPEND content "#include <ituGL/shader/ShaderProgram.h>\n\n")
+string(APPEND content "namespace ShaderUniforms\n{\n")
+foreach(entry ${uniform_list})
+	string(REGEX REPLACE "^[0-9]+:" "" name ${entry})
+	string(APPEND content "    inline constexpr ShaderUniform<${uniform_type_${name}}> ${name}{ ${uniform_location_${name}}, \"${name}\" };\n")
+endforeach()
+if(block_only_names)
+	string(APPEND content "\n    // Only in uniform blocks, set through a ShaderUniformCollection\n")
+endif()
+foreach(name ${block_only_names})
+	string(APPEND content "    inline constexpr ShaderUniform<${block_type_${name}}> ${name}{ -1, \"${name}\" };\n")
+endforeach()
+string(APPEND content "}\n\n")
+string(APPEND content "namespace ShaderAttributes\n{\n")
+foreach(name ${attribute_names})
+	string(APPEND content "    inline constexpr ShaderProgram::Location ${name} = ${attribute_location_${name}};\n")
+endforeach()
+string(APPEND content "}\n")
+
+# Only write if it changed, so the sources that include it are not built again
+set(old_content "")
+if(EXISTS "${OUTPUT}")
+	file(READ "${OUTPUT}" old_content)
+endif()
+if(NOT old_content STREQUAL content)
+	file(WRITE "${OUTPUT}" "${content}")
+endif()
@@ -6,6 +6,22 @@
 
 class Application
 {
+public:
+    // Run without a display, rendering to an offscreen default framebuffer
+    struct HeadlessSettings
+    {
+        bool enabled = false;
+        // Size of the default framebuffer. If 0, the size passed to the constructor is used
+        int width = 0;
+        int height = 0;
+        // Frames to render before closing. If 0, the application runs until it closes itself
+        unsigned int frameCount = 0;
+    };
+
+    // Must be set before the application is constructed
+    static const HeadlessSettings& GetHeadlessSettings() { return s_headlessSettings; }
+    static void SetHeadlessSettings(const HeadlessSettings& headlessSettings) { s_headlessSettings = headlessSettings; }
+
 public:
     // Construct the application specifying the dimensions of the window and its title
     Application(int width, int height, const char* title);
@@ -33,6 +49,10 @@ protected:
     // Get time in seconds of the current frame
     float GetDeltaTime() const { return m_deltaTime; }
 
+    // If positive, time advances by this step every frame instead of following the clock, so updates are deterministic
+    float GetFixedTimeStep() const { return m_fixedTimeStep; }
+    void SetFixedTimeStep(float fixedTimeStep) { m_fixedTimeStep = fixedTimeStep; }
+
     // Test if the application is currently running
     bool IsRunning() const;
 
@@ -71,9 +91,13 @@ private:
     float m_currentTime;
     // Time in seconds of the current frame
     float m_deltaTime;
+    // Simulated time step, or 0 to use the clock
+    float m_fixedTimeStep;
 
     // Exit code
     int m_exitCode;
     // Error message to display on exit
     std::string m_errorMessage;
+
+    static HeadlessSettings s_headlessSettings;
 };
@@ -2,11 +2,17 @@
 
 #include <GLFW/glfw3.h>
 #include <glm/vec2.hpp>
+#include <memory>
 
 class Window
 {
 public:
-    Window(int width, int height, const char* title);
+    // Function to get the address of the OpenGL functions of the context
+    using ProcAddressFunction = void* (*)(const char*);
+
+public:
+    // A headless window has no display. It renders to an offscreen EGL pbuffer of the given size, and has no input
+    Window(int width, int height, const char* title, bool headless = false);
     ~Window();
 
     // (C++) 1
@@ -14,8 +20,16 @@ public:
     inline const GLFWwindow* GetInternalWindow() const { return m_window; }
     inline GLFWwindow* GetInternalWindow() { return m_window; }
 
-    // A window is valid only if the internal window is valid
-    inline bool IsValid() const { return m_window != nullptr; }
+    // A window is valid only if the internal window (or the headless context) is valid
+    inline bool IsValid() const { return m_window != nullptr || m_headlessContext != nullptr; }
+
+    inline bool IsHeadless() const { return m_headlessContext != nullptr; }
+
+    // Make the OpenGL context of the window current in this thread
+    bool MakeContextCurrent();
+
+    // Get the function that loads the OpenGL functions of the context
+    ProcAddressFunction GetProcAddressFunction() const;
 
     // Get the current dimensions (width and height) of the window
     void GetDimensions(int& width, int& height) const;
@@ -75,7 +89,15 @@ public:
     void SetMousePosition(glm::vec2 mousePosition, bool normalized = false) const;
 
 
+private:
+    // Create the EGL display, pbuffer and context of a headless window
+    void InitializeHeadless(int width, int height);
+
 private:
     // Pointer to a GLFW window object. Its lifetime should match the lifetime of this object
     GLFWwindow* m_window;
+
+    // EGL objects of a headless window. Null for windows with a display
+    struct HeadlessContext;
+    std::unique_ptr<HeadlessContext> m_headlessContext;
 };
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <functional>
+#include <future>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+
+// Worker pool used by the asset loaders to load assets asynchronously
+// File reading and decoding run on the worker threads. Anything that creates GL objects
+// is queued as an upload, and runs when the thread owning the GL context calls ProcessUploads
+// When the queue is destroyed, the tasks that didn't start and the pending uploads are dropped without running
+class AssetLoadQueue
+{
+public:
+    using Task = std::function<void()>;
+
+public:
+    static AssetLoadQueue& GetInstance();
+
+    inline unsigned int GetWorkerCount() const { return static_cast<unsigned int>(m_workers.size()); }
+
+    // Queue a task to run on one of the worker threads. Exceptions thrown by the task are logged and ignored
+    void EnqueueWork(Task task);
+
+    // Queue a task to run on the GL thread, the next time ProcessUploads is called
+    void EnqueueUpload(Task task);
+
+    // Run all the pending uploads. Must be called from the thread that owns the GL context
+    // Returns the number of uploads processed
+    unsigned int ProcessUploads();
+
+    // Block until the future is ready, processing uploads while waiting
+    // Must be called from the thread that owns the GL context, or it will never finish
+    template<typename TFuture>
+    void Wait(const TFuture& future);
+
+private:
+    AssetLoadQueue(unsigned int workerCount);
+    ~AssetLoadQueue();
+
+    AssetLoadQueue(const AssetLoadQueue&) = delete;
+    void operator = (const AssetLoadQueue&) = delete;
+
+    // Main loop of the worker threads
+    void WorkerMain();
+
+    // Wait until there is at least one upload queued
+    void WaitForUploads();
+
+private:
+    std::vector<std::thread> m_workers;
+
+    // Tasks waiting for a worker thread
+    std::deque<Task> m_work;
+    std::mutex m_workMutex;
+    std::condition_variable m_workCondition;
+
+    // Set when the workers must finish
+    bool m_stopping;
+
+    // Tasks waiting for the GL thread
+    std::deque<Task> m_uploads;
+    std::mutex m_uploadMutex;
+    std::condition_variable m_uploadCondition;
+};
+
+template<typename TFuture>
+void AssetLoadQueue::Wait(const TFuture& future)
+{
+    ProcessUploads();
+    while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        WaitForUploads();
+        ProcessUploads();
+    }
+}
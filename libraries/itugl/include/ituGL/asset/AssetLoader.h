@@ -1,13 +1,31 @@
 #pragma once
 
+#include <ituGL/asset/AssetLoadQueue.h>
+#include <ituGL/asset/AssetRegistry.h>
+
 #include <unordered_map>
 #include <string>
 #include <memory>
+#include <functional>
+#include <future>
+#include <exception>
+#include <stdexcept>
+#include <iostream>
 
 // Base class for all asset loaders
 template <typename T>
 class AssetLoader
 {
+public:
+    // Function that creates the asset on the GL thread, from the data decoded on a worker thread
+    using FinishFunction = std::function<std::shared_ptr<T>()>;
+
+    // Function that reads and decodes the asset on a worker thread
+    using DecodeTask = std::function<FinishFunction()>;
+
+    // Future that will hold the asset once it is created on the GL thread
+    using SharedFuture = std::shared_future<std::shared_ptr<T>>;
+
 public:
     AssetLoader();
 
@@ -22,20 +40,62 @@ public:
     virtual T* LoadNew(const char* path);
 
     // Load the asset from a path into a shared pointer
+    // Shared assets are kept in the AssetRegistry, so files with the same contents and settings are only loaded once
     virtual std::shared_ptr<T> LoadShared(const char* path);
 
     // Load the asset from a path into the object passed as a parameter
     virtual bool LoadInto(const char* path, T&);
 
+    // Load the asset from a path into a shared pointer, decoding it on the AssetLoadQueue worker threads
+    // The GL objects are created when AssetLoadQueue::ProcessUploads is called on the GL thread
+    // If decoding or creating the asset throws, the error is logged and the future holds nullptr
+    // If the load is dropped before it finishes, because the queue shut down, the future holds an exception
+    // The loader must stay alive until the returned future is ready
+    SharedFuture LoadSharedAsync(const char* path);
+
+    // Get a previously loaded shared asset, with the current settings, or nullptr if it was not loaded
+    std::shared_ptr<T> FindShared(const char* path) const;
+
+    // Add an asset created externally to the shared assets, as if it was loaded with the current settings
+    void AddShared(const char* path, std::shared_ptr<T> asset);
+
+    // Import settings of the shared assets, with the current settings. Captured to build registry keys on other threads
+    inline std::string GetSharedSettings() const { return GetImportSettings(); }
+
     inline bool GetKeepShared() const { return m_keepShared; }
     inline void SetKeepShared(bool keepShared) { m_keepShared = keepShared; }
 
+protected:
+    // Create the task that decodes the asset on a worker thread. Called on the thread that requested the load
+    // The task must only use the data it captured, because the loader settings can change while it runs
+    // By default, nothing is done on the worker and the asset is loaded completely on the GL thread
+    virtual DecodeTask CreateDecodeTask(const char* path);
+
+    // Settings that change the loaded asset. Assets loaded with different settings are different assets in the registry
+    virtual std::string GetImportSettings() const;
+
+    // Memory used by the asset, in bytes, to limit the memory kept by the registry. Called on the GL thread
+    virtual size_t GetMemorySize(const T& asset) const;
+
 private:
-    // If true, keep a reference to assets loaded as shared, to avoid loading twice
+    // Promise of an async load. Fails with an exception if it is released without a value
+    struct LoadPromise
+    {
+        std::promise<std::shared_ptr<T>> promise;
+        bool fulfilled = false;
+
+        void SetValue(std::shared_ptr<T> t);
+        ~LoadPromise();
+    };
+
+    // Log an exception thrown while loading the asset in the path
+    static void LogLoadError(const std::string& path, std::exception_ptr exception);
+
+    // If true, keep the assets loaded as shared in the registry, to avoid loading twice
     bool m_keepShared;
 
-    // Map of loaded shared assets
-    std::unordered_map<std::string, std::shared_ptr<T>> m_sharedAssets;
+    // Map of shared assets requested asynchronously that are still loading, by path and import settings
+    std::unordered_map<std::string, SharedFuture> m_pendingAssets;
 };
 
 template <typename T>
@@ -68,20 +128,12 @@ std::shared_ptr<T> AssetLoader<T>::LoadShared(const char* path)
     if (IsValid(path))
     {
         // Try to find the asset on the previously loaded
-        std::string pathString(path);
-        auto itAsset = m_sharedAssets.find(pathString);
-        if (itAsset != m_sharedAssets.end())
-        {
-            t = itAsset->second;
-        }
-        else
+        t = FindShared(path);
+        if (!t)
         {
             // If not found, create a new one
             t = std::make_shared<T>(Load(path));
-            if (m_keepShared)
-            {
-                m_sharedAssets.insert(std::make_pair(pathString, t));
-            }
+            AddShared(path, t);
         }
     }
     return t;
@@ -97,3 +149,177 @@ bool AssetLoader<T>::LoadInto(const char* path, T& t)
     }
     return valid;
 }
+
+template <typename T>
+typename AssetLoader<T>::SharedFuture AssetLoader<T>::LoadSharedAsync(const char* path)
+{
+    std::string pathString(path);
+    std::string importSettings = GetImportSettings();
+
+    // If it is already loading with the same settings, share the same future. Unshared loads always get their own asset
+    // Loads of the same contents from other paths or loaders are shared later, by the registry
+    std::string pendingKey = pathString + '\n' + importSettings;
+    if (m_keepShared)
+    {
+        auto itPending = m_pendingAssets.find(pendingKey);
+        if (itPending != m_pendingAssets.end())
+        {
+            return itPending->second;
+        }
+    }
+
+    std::shared_ptr<LoadPromise> promise = std::make_shared<LoadPromise>();
+    SharedFuture future = promise->promise.get_future().share();
+
+    // If it is not valid, there is nothing to wait for
+    if (!IsValid(path))
+    {
+        promise->SetValue(nullptr);
+        return future;
+    }
+
+    // Called on the GL thread, where the pending assets are tracked
+    std::function<void(std::shared_ptr<T>)> setAsset = [this, pendingKey, keepShared = m_keepShared, promise](std::shared_ptr<T> t)
+        {
+            if (keepShared)
+            {
+                m_pendingAssets.erase(pendingKey);
+            }
+            promise->SetValue(t);
+        };
+
+    AssetLoadQueue& queue = AssetLoadQueue::GetInstance();
+    queue.EnqueueWork([this, &queue, pathString, setAsset, keepShared = m_keepShared, importSettings, decodeTask = CreateDecodeTask(path)]()
+        {
+            // Hashing the file happens on the worker too. Then, if the same contents are loaded or being loaded, by any loader, just wait for them
+            AssetRegistry& registry = AssetRegistry::GetInstance();
+            AssetRegistry::Key key = registry.GetKey<T>(pathString.c_str(), importSettings);
+            std::shared_ptr<T> t;
+            AssetRegistry::Reservation reservation = keepShared ? registry.Reserve<T>(key, t, setAsset) : AssetRegistry::Reservation::Reserved;
+            if (reservation == AssetRegistry::Reservation::Found)
+            {
+                queue.EnqueueUpload([setAsset, t]() { setAsset(t); });
+            }
+            else if (reservation == AssetRegistry::Reservation::Reserved)
+            {
+                // Errors on the worker are reported on the GL thread, as a failed load
+                FinishFunction finish;
+                try
+                {
+                    finish = decodeTask();
+                }
+                catch (...)
+                {
+                    std::exception_ptr exception = std::current_exception();
+                    finish = [pathString, exception]() { LogLoadError(pathString, exception); return nullptr; };
+                }
+
+                queue.EnqueueUpload([this, &registry, key, pathString, setAsset, keepShared, finish]()
+                    {
+                        // Creating the asset can also fail. The reservation must be released anyway
+                        std::shared_ptr<T> t;
+                        try
+                        {
+                            t = finish();
+                        }
+                        catch (...)
+                        {
+                            LogLoadError(pathString, std::current_exception());
+                        }
+
+                        if (keepShared)
+                        {
+                            if (t)
+                            {
+                                registry.Add<T>(key, t, GetMemorySize(*t), pathString);
+                            }
+                            else
+                            {
+                                registry.Cancel(key);
+                            }
+                        }
+                        setAsset(t);
+                    });
+            }
+        });
+
+    if (m_keepShared)
+    {
+        m_pendingAssets.insert(std::make_pair(pendingKey, future));
+    }
+    return future;
+}
+
+template <typename T>
+void AssetLoader<T>::LoadPromise::SetValue(std::shared_ptr<T> t)
+{
+    promise.set_value(t);
+    fulfilled = true;
+}
+
+template <typename T>
+AssetLoader<T>::LoadPromise::~LoadPromise()
+{
+    if (!fulfilled)
+    {
+        promise.set_exception(std::make_exception_ptr(std::runtime_error("The asset load queue shut down before the load finished")));
+    }
+}
+
+template <typename T>
+void AssetLoader<T>::LogLoadError(const std::string& path, std::exception_ptr exception)
+{
+    try
+    {
+        std::rethrow_exception(exception);
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "ERROR::ASSET::LOAD_FAILED\n" << path << ": " << e.what() << std::endl;
+    }
+    catch (...)
+    {
+        std::cout << "ERROR::ASSET::LOAD_FAILED\n" << path << ": unknown exception" << std::endl;
+    }
+}
+
+template <typename T>
+std::shared_ptr<T> AssetLoader<T>::FindShared(const char* path) const
+{
+    AssetRegistry& registry = AssetRegistry::GetInstance();
+    return m_keepShared ? registry.Find<T>(registry.GetKey<T>(path, GetImportSettings())) : nullptr;
+}
+
+template <typename T>
+void AssetLoader<T>::AddShared(const char* path, std::shared_ptr<T> asset)
+{
+    if (m_keepShared)
+    {
+        AssetRegistry& registry = AssetRegistry::GetInstance();
+        registry.Add<T>(registry.GetKey<T>(path, GetImportSettings()), asset, GetMemorySize(*asset), path);
+    }
+}
+
+template <typename T>
+typename AssetLoader<T>::DecodeTask AssetLoader<T>::CreateDecodeTask(const char* path)
+{
+    std::string pathString(path);
+    return [this, pathString]()
+        {
+            return [this, pathString]() { return std::make_shared<T>(Load(pathString.c_str())); };
+        };
+}
+
+template <typename T>
+std::string AssetLoader<T>::GetImportSettings() const
+{
+    // By default, there are no settings
+    return std::string();
+}
+
+template <typename T>
+size_t AssetLoader<T>::GetMemorySize(const T& asset) const
+{
+    // By default, only the object itself
+    return sizeof(T);
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <unordered_map>
+#include <typeindex>
+#include <functional>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <list>
+#include <cstdint>
+#include <cassert>
+
+// Process-wide cache of the assets created by all the loaders
+// Assets are identified by the hash of the file contents and of the import settings, so the same data is never decoded
+// or uploaded twice, even if it is loaded with different loaders or from different paths
+// The registry only holds weak references to the assets in use. Recently used assets are also kept alive, in LRU order,
+// until their memory goes over the memory cap
+// All the methods can be called from any thread, but assets are only released by Add, SetMemoryCap and Clear,
+// so those must be called on the GL thread
+class AssetRegistry
+{
+public:
+    // Identifies the contents of an asset, imported with some settings
+    struct Key
+    {
+        std::uint64_t contentHash = 0;
+        std::uint64_t settingsHash = 0;
+        std::type_index type = std::type_index(typeid(void));
+
+        bool operator == (const Key& other) const;
+    };
+
+    // Result of reserving a key
+    enum class Reservation
+    {
+        // The asset is already loaded
+        Found,
+        // The asset is being loaded. The callback will receive it when it is added
+        Pending,
+        // The caller must load the asset, and then call Add, or Cancel if it failed
+        Reserved
+    };
+
+    // Lookup statistics
+    struct Stats
+    {
+        // Requests that found the asset, loaded or pending
+        unsigned int hits = 0;
+        // Requests that had to load the asset
+        unsigned int misses = 0;
+        // Assets released because they were the least recently used when over the memory cap
+        unsigned int evictions = 0;
+
+        inline float GetHitRate() const { return hits + misses > 0 ? static_cast<float>(hits) / (hits + misses) : 0.0f; }
+    };
+
+public:
+    static AssetRegistry& GetInstance();
+
+    // Build the key of the file, loaded as type T with the import settings. Reads the file the first time it is used
+    template<typename T>
+    Key GetKey(const char* path, const std::string& importSettings);
+
+    // Find a loaded asset. Counts as a hit or a miss
+    template<typename T>
+    std::shared_ptr<T> Find(const Key& key);
+
+    // Check if the asset is loaded, without using it. Doesn't count as a hit or a miss
+    // Safe on worker threads, because it never holds a reference that could release the asset there
+    bool IsLoaded(const Key& key) const;
+
+    // Find a loaded asset, or wait for the pending load, or reserve the key to load it
+    template<typename T>
+    Reservation Reserve(const Key& key, std::shared_ptr<T>& asset, std::function<void(std::shared_ptr<T>)> onAdded);
+
+    // Add a loaded asset, with its memory size in bytes. Calls the callbacks waiting for it, on this thread
+    template<typename T>
+    void Add(const Key& key, std::shared_ptr<T> asset, size_t memorySize, const std::string& name);
+
+    // Release a reservation that failed to load. The callbacks waiting for it receive nullptr
+    void Cancel(const Key& key);
+
+    // Maximum memory of the unused assets kept alive
+    inline size_t GetMemoryCap() const { return m_memoryCap; }
+    void SetMemoryCap(size_t memoryCap);
+
+    // Memory of the assets kept alive by the registry
+    size_t GetRetainedBytes() const;
+
+    // Number of assets registered, in use or retained
+    size_t GetAssetCount() const;
+
+    Stats GetStats() const;
+    void ResetStats();
+
+    // Release all the assets retained, and forget the ones that are not in use
+    void Clear();
+
+    // 64-bit FNV-1a hash
+    static std::uint64_t Hash(const void* data, size_t size, std::uint64_t hash = 14695981039346656037ull);
+
+private:
+    using AddedFunction = std::function<void(std::shared_ptr<void>)>;
+
+    struct KeyHasher
+    {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Entry
+    {
+        std::string name;
+        std::weak_ptr<void> asset;
+        // Strong reference, while the entry is in the LRU list
+        std::shared_ptr<void> retained;
+        size_t memorySize = 0;
+        unsigned int useCount = 0;
+        std::list<Key>::iterator lruPosition;
+        // Set while the asset is being loaded
+        bool pending = false;
+        std::vector<AddedFunction> onAdded;
+    };
+
+    // Cached hash of a file, valid while its size and modification time don't change
+    struct FileHash
+    {
+        std::uint64_t hash;
+        std::uintmax_t fileSize;
+        std::int64_t writeTime;
+    };
+
+private:
+    AssetRegistry();
+
+    AssetRegistry(const AssetRegistry&) = delete;
+    void operator = (const AssetRegistry&) = delete;
+
+    // Get the hash of the file contents. Only reads the file if it changed since the last time
+    std::uint64_t GetContentHash(const char* path);
+
+    std::shared_ptr<void> Find(const Key& key);
+    Reservation Reserve(const Key& key, std::shared_ptr<void>& asset, AddedFunction onAdded);
+    void Add(const Key& key, std::shared_ptr<void> asset, size_t memorySize, const std::string& name);
+
+    // Mark the entry as the most recently used, and keep it alive
+    void Touch(Entry& entry, const Key& key, std::shared_ptr<void> asset);
+
+    // Release the least recently used assets until the retained memory fits in the cap. Requires the lock
+    // The released references are moved to the vector, so they are destroyed after unlocking
+    void Evict(std::vector<std::shared_ptr<void>>& released);
+
+private:
+    mutable std::mutex m_mutex;
+
+    std::unordered_map<Key, Entry, KeyHasher> m_entries;
+
+    // Keys of the retained entries, most recently used first
+    std::list<Key> m_lru;
+
+    size_t m_memoryCap;
+    size_t m_retainedBytes;
+
+    std::unordered_map<std::string, FileHash> m_fileHashes;
+
+    Stats m_stats;
+};
+
+template<typename T>
+AssetRegistry::Key AssetRegistry::GetKey(const char* path, const std::string& importSettings)
+{
+    return Key{ GetContentHash(path), Hash(importSettings.data(), importSettings.size()), std::type_index(typeid(T)) };
+}
+
+template<typename T>
+std::shared_ptr<T> AssetRegistry::Find(const Key& key)
+{
+    assert(key.type == std::type_index(typeid(T)));
+    return std::static_pointer_cast<T>(Find(key));
+}
+
+template<typename T>
+AssetRegistry::Reservation AssetRegistry::Reserve(const Key& key, std::shared_ptr<T>& asset, std::function<void(std::shared_ptr<T>)> onAdded)
+{
+    assert(key.type == std::type_index(typeid(T)));
+    std::shared_ptr<void> voidAsset;
+    Reservation reservation = Reserve(key, voidAsset, [onAdded](std::shared_ptr<void> addedAsset) { onAdded(std::static_pointer_cast<T>(addedAsset)); });
+    asset = std::static_pointer_cast<T>(voidAsset);
+    return reservation;
+}
+
+template<typename T>
+void AssetRegistry::Add(const Key& key, std::shared_ptr<T> asset, size_t memorySize, const std::string& name)
+{
+    assert(key.type == std::type_index(typeid(T)));
+    Add(key, std::static_pointer_cast<void>(asset), memorySize, name);
+}
@@ -6,7 +6,11 @@
 #include <ituGL/geometry/Mesh.h>
 #include <ituGL/asset/Texture2DLoader.h>
 #include <vector>
+#include <span>
+#include <atomic>
+#include <cstdint>
 
+struct aiScene;
 struct aiMesh;
 struct aiMaterial;
 class VertexFormat;
@@ -27,6 +31,10 @@ public:
     bool GetCreateMaterials() const;
     void SetCreateMaterials(bool createMaterials);
 
+    // If enabled, submeshes with the same vertex format are packed in one VBO and one EBO, and drawn with a base vertex
+    bool GetPackGeometry() const;
+    void SetPackGeometry(bool packGeometry);
+
     Texture2DLoader& GetTexture2DLoader();
     const Texture2DLoader& GetTexture2DLoader() const;
 
@@ -39,16 +47,68 @@ public:
     // Maps a material property to a uniform in the shader program used by the material
     bool SetMaterialProperty(MaterialProperty materialProperty, const char* uniformName);
 
+protected:
+    // Import the file and collect the vertex, element and texture data on the worker thread
+    // Buffers, textures and materials are created on the GL thread
+    DecodeTask CreateDecodeTask(const char* path) override;
+
+    // The material, the attribute and property maps and the texture settings change the model
+    std::string GetImportSettings() const override;
+
+    // Memory of the vertex and element buffers. Textures are counted as separate assets
+    size_t GetMemorySize(const Model& model) const override;
+
 private:
-    // Generate a submesh from the loaded mesh data
-    void GenerateSubmesh(Mesh& mesh, const aiMesh& meshData);
+    // AssetBenchmarks times CopyBuffer and CollectVertexData, the per-vertex copies of the import
+    friend class AssetBenchmarks;
+
+    // Vertex and element data of a submesh, collected from the loaded mesh data
+    struct SubmeshData;
+
+    // Loader settings used to create the model on the GL thread, copied when the load starts
+    struct BuildSettings;
+
+    // Textures decoded ahead of time, by path
+    using DecodedTextureMap = std::unordered_map<std::string, std::shared_ptr<const TextureLoaderUtils::TextureData>>;
+
+    // Compute the bounds of all the vertices in the scene
+    static AabbBounds ComputeBounds(const aiScene& scene);
+
+    // Collect the data of a submesh. Does not use GL, can be called from any thread
+    static SubmeshData CollectSubmeshData(const aiMesh& meshData);
+
+    // Copy the current settings, to load the model in the path
+    BuildSettings GetBuildSettings(const char* path) const;
+
+    // Import settings of the shared textures of each material property, to find them in the registry from the worker
+    // Empty if the texture loader doesn't keep shared textures
+    std::unordered_map<MaterialProperty, std::string> GetTextureSharedSettings(const BuildSettings& settings) const;
+
+    // Create the buffers and add the submeshes from the collected data
+    static void AddSubmeshData(Mesh& mesh, const SubmeshData& submeshData, const BuildSettings& settings);
+
+    // Add the submeshes of all the loaded meshes, in order. Packs their buffers if enabled
+    static void AddMeshData(Mesh& mesh, std::span<const SubmeshData> submeshes, const BuildSettings& settings);
+
+    // Add the submeshes with one VBO and one EBO for each vertex format
+    static void AddPackedMeshData(Mesh& mesh, std::span<const SubmeshData> submeshes, const BuildSettings& settings);
 
     // Generate a material from the loaded material data
-    std::shared_ptr<Material> GenerateMaterial(const aiMaterial& materialData);
+    std::shared_ptr<Material> GenerateMaterial(const aiMaterial& materialData, const BuildSettings& settings, const DecodedTextureMap* decodedTextures = nullptr);
+
+    // Load the texture of the material property in the location. Uses the decoded texture if available
+    bool LoadTexture(const aiMaterial& materialData, MaterialProperty materialProperty, Material& material, ShaderProgram::Location location,
+        const std::string& baseFolder, const DecodedTextureMap* decodedTextures) const;
+
+    // Get the texture type and formats used to load a texture material property. Returns false if it is not a texture
+    static bool GetTextureInfo(MaterialProperty materialProperty, int& textureType,
+        TextureObject::Format& format, TextureObject::InternalFormat& internalFormat);
+
+    // Get the path of the texture in the material, relative to the base folder. Returns false if it has no texture
+    static bool GetTexturePath(const aiMaterial& materialData, int textureType, const std::string& baseFolder, std::string& texturePath);
 
-    // Load a texture of the specific type in the location
-    bool LoadTexture(const aiMaterial& materialData, int textureType, Material& material, ShaderProgram::Location location,
-        TextureObject::Format format, TextureObject::InternalFormat internalFormat) const;
+    // Get the folder of the path, including the last slash
+    static std::string GetBaseFolder(const char* path);
 
     // Build the vertex data from the mesh data
     static std::vector<GLubyte> CollectVertexData(const aiMesh& meshData, VertexFormat& vertexFormat, bool interleaved);
@@ -60,6 +120,10 @@ private:
     // Get the correct vertex data pointer for a specific semantic
     static const void* GetVertexDataPointer(const aiMesh& meshData, VertexAttribute::Semantic semantic, int& stride);
 
+    // Append the element data, converted to a type at least as wide
+    static void AppendElementData(std::vector<GLubyte>& elementData, Data::Type elementType,
+        std::span<const GLubyte> srcElementData, Data::Type srcElementType);
+
     // Copy one buffer to another preserving the stride
     static void CopyBuffer(void* dstBuffer, size_t dstStride, const void* srcBuffer, size_t srcStride, size_t count, size_t size);
 
@@ -67,12 +131,13 @@ private:
     static Drawcall::Primitive GetPrimitiveType(int elementCount);
 
 private:
-    // Path to the base folder where we are loading the current model
-    std::string m_baseFolder;
-
     // Pointer to the reference material
     std::shared_ptr<Material> m_referenceMaterial;
 
+    // Identifies the reference material in the import settings, 0 if there is none
+    // The address can't be used, a new material could be allocated at the address of one that was released
+    std::uint64_t m_referenceMaterialId;
+
     // Maps the semantic to attributes in the reference material
     Mesh::SemanticMap m_materialAttributeMap;
 
@@ -82,8 +147,14 @@ private:
     // Should create new materials for each submesh or use the reference material
     bool m_createMaterials;
 
+    // Should pack the submeshes with the same vertex format in shared buffers
+    bool m_packGeometry;
+
     // Texture loader to cache already loaded shared textures
     mutable Texture2DLoader m_textureLoader;
+
+    // Last reference material id assigned, by any loader
+    static std::atomic<std::uint64_t> s_referenceMaterialCount;
 };
 
 enum class ModelLoader::MaterialProperty
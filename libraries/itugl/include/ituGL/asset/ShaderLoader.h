@@ -3,12 +3,37 @@
 #include <ituGL/asset/AssetLoader.h>
 #include <ituGL/shader/Shader.h>
 #include <span>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <mutex>
 
+// Loads shaders from one or more source files, concatenated in order
+// Sources can use #include "path", relative to the file that includes it. Each file is included only once per shader,
+// so shared files work as if they had include guards. Files are read once and kept in memory
+// Missing files are reported, and the shader is not compiled
+// Defines can be added to the source, after the #version line, to compile different variants of the same files
 class ShaderLoader : AssetLoader<Shader>
 {
+public:
+    // Compilation statistics, of all the loaders
+    struct Stats
+    {
+        // Shaders compiled, and seconds spent compiling them
+        unsigned int compileCount = 0;
+        float compileTime = 0.0f;
+        // Shaders requested with LoadShared that were already compiled
+        unsigned int sharedCount = 0;
+    };
+
 public:
     ShaderLoader(Shader::Type type);
 
+    // Defines added to the source, as "NAME" or "NAME value"
+    inline const std::vector<std::string>& GetDefines() const { return m_defines; }
+    inline void SetDefines(std::span<const std::string> defines) { m_defines.assign(defines.begin(), defines.end()); }
+
     using AssetLoader<Shader>::IsValid;
     bool IsValid(std::span<const char*> paths);
 
@@ -22,8 +47,47 @@ public:
 
     static Shader Load(Shader::Type type, const char* path);
 
+    // Load the shader, or share a shader already compiled from the same expanded source
+    // Shaders can be attached to any number of programs, so identical stages are only compiled once
+    // If waitCompile is false, the compilation is only submitted, and the result must be checked later with CheckCompiled
+    // Returns nullptr if any of the files, or the files they include, can't be read
+    std::shared_ptr<Shader> LoadShared(std::span<const char*> paths, bool waitCompile = true);
+
+    // Check if the shader was compiled, and print the errors if it wasn't
+    static bool CheckCompiled(const Shader& shader);
+
+    // Concatenate the sources of the paths, resolving the #include directives, and add the defines after the #version line
+    // Returns false if any of the files can't be read
+    static bool ExpandSource(std::span<const char*> paths, std::span<const std::string> defines, std::string& source);
+
+    // Forget the sources in memory, so the next loads read the files again
+    static void ClearSourceCache();
+
+    static Stats GetStats();
+    static void ResetStats();
+
 private:
-    void Compile(Shader& shader);
+    void Compile(Shader& shader, bool waitCompile = true);
+
+    // Get the contents of the file, reading it only the first time. Returns nullptr if it can't be read
+    // The contents stay valid even if the cache is cleared by another thread
+    static std::shared_ptr<const std::string> ReadSource(const std::string& path);
+
+    // Append the source of the file to the expanded source, replacing the #include directives with the included files
+    // Returns false if the file, or any file included, can't be read
+    static bool ExpandIncludes(const std::string& path, std::unordered_set<std::string>& includedPaths, std::string& source);
+
+    // Insert the defines after the #version line, that must be the first one, or at the start if there isn't one
+    // Only the defines mentioned in the source are inserted
+    static void InsertDefines(std::span<const std::string> defines, std::string& source);
 
     Shader::Type m_type;
+
+    std::vector<std::string> m_defines;
+
+    // Sources read, by normalized path
+    static std::unordered_map<std::string, std::shared_ptr<const std::string>> s_sources;
+    static std::mutex s_mutex;
+
+    static Stats s_stats;
 };
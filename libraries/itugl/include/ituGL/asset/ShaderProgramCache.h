@@ -0,0 +1,123 @@
+#pragma once
+
+#include <ituGL/shader/Shader.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <span>
+#include <cstdint>
+
+class ShaderProgram;
+
+// Disk cache of linked shader program binaries, to skip compiling and linking the shaders on the next runs
+// Entries are keyed by the hash of the source files of every stage, the stage types and the driver vendor, renderer
+// and version, so any change in the sources or the driver builds the program again
+// If the driver doesn't support program binaries, or it rejects a cached one, the shaders are compiled as usual
+// Several programs can be built in one batch, so the driver can compile them in parallel with GL_KHR_parallel_shader_compile
+class ShaderProgramCache
+{
+public:
+    // Source files of one shader stage, concatenated in order
+    struct Stage
+    {
+        Shader::Type type;
+        std::span<const char*> paths;
+    };
+
+    // A program to build in a batch, with the defines added to all its stages
+    struct Request
+    {
+        ShaderProgram* shaderProgram;
+        std::span<const Stage> stages;
+        std::span<const std::string> defines;
+    };
+
+    // Time spent setting up programs, and how they were built
+    struct Stats
+    {
+        // Programs loaded from the cache
+        unsigned int hits = 0;
+        // Programs compiled and linked, because they were not cached
+        unsigned int misses = 0;
+        // Cached binaries that the driver did not accept
+        unsigned int rejected = 0;
+        // Seconds spent in Build
+        float setupTime = 0.0f;
+    };
+
+public:
+    static ShaderProgramCache& GetInstance();
+
+    // Folder where the binaries are stored. Created when the first entry is written
+    inline const std::string& GetDirectory() const { return m_directory; }
+    inline void SetDirectory(const std::string& directory) { m_directory = directory; }
+
+    // If disabled, programs are always compiled and nothing is written
+    inline bool GetEnabled() const { return m_enabled; }
+    inline void SetEnabled(bool enabled) { m_enabled = enabled; }
+
+    inline const Stats& GetStats() const { return m_stats; }
+    inline void ResetStats() { m_stats = Stats(); }
+
+    // If the driver compiles and links in background threads. Known after the first build
+    inline bool GetParallelCompile() const { return m_parallelCompile; }
+
+    // Build the program with the stages, from the cached binary if possible. Returns true if the program is linked
+    bool Build(ShaderProgram& shaderProgram, std::span<const Stage> stages, std::span<const std::string> defines = {});
+
+    // Helper for the common case with vertex and fragment stages
+    bool Build(ShaderProgram& shaderProgram, std::span<const char*> vertexShaderPaths, std::span<const char*> fragmentShaderPaths,
+        std::span<const std::string> defines = {});
+
+    // Build several programs. All the compilations and links are submitted before checking any result, so they can
+    // run in parallel in the driver. Returns true if all the programs are linked
+    bool Build(std::span<const Request> requests);
+
+private:
+    ShaderProgramCache();
+
+    ShaderProgramCache(const ShaderProgramCache&) = delete;
+    void operator = (const ShaderProgramCache&) = delete;
+
+    // Check the support for program binaries and parallel compilation, and hash the driver strings
+    // Needs the GL context, so it is done on the first build
+    void QueryDriver();
+
+    // Hash the driver strings, the stage types and the expanded sources, with the defines
+    // Returns false if any of the source files can't be read
+    bool ComputeKey(std::span<const Stage> stages, std::span<const std::string> defines, std::uint64_t& key) const;
+
+    // Path of the entry file for the key
+    std::string GetEntryPath(std::uint64_t key) const;
+
+    // Try to load the program binary of the entry. Returns false if it is missing, invalid or rejected
+    bool LoadEntry(ShaderProgram& shaderProgram, std::uint64_t key);
+
+    // Write the program binary of the entry. The file is written to a temporary path and then renamed,
+    // so other processes never read a partial entry
+    void StoreEntry(const ShaderProgram& shaderProgram, std::uint64_t key) const;
+
+    // Submit the compilation of the stages. Identical stages are shared with other programs, and only compiled once
+    // Returns false if any of the source files can't be read
+    static bool SubmitCompile(std::span<const Stage> stages, std::span<const std::string> defines, std::vector<std::shared_ptr<Shader>>& shaders);
+
+    // Check the compiled shaders and submit the link of the program. Returns false if any shader failed
+    static bool SubmitLink(ShaderProgram& shaderProgram, std::span<const std::shared_ptr<Shader>> shaders);
+
+private:
+    std::string m_directory;
+
+    bool m_enabled;
+
+    // Set once the driver was queried, and if it supports at least one binary format
+    bool m_driverQueried;
+    bool m_supported;
+
+    // Set if the driver supports GL_KHR_parallel_shader_compile, or the ARB version
+    bool m_parallelCompile;
+
+    // Hash of the driver vendor, renderer and version
+    std::uint64_t m_driverHash;
+
+    Stats m_stats;
+};
@@ -3,6 +3,8 @@
 #include <ituGL/asset/TextureLoader.h>
 #include <ituGL/texture/Texture2DObject.h>
 
+class TextureStreamingManager;
+
 // Asset loader for Texture2DObject
 class Texture2DLoader : public TextureLoader<Texture2DObject>
 {
@@ -13,6 +15,13 @@ public:
     // Load the texture from the path
     Texture2DObject Load(const char* path) override;
 
+    // Create the texture from already decoded data
+    static Texture2DObject CreateTexture(const TextureLoaderUtils::TextureData& textureData, bool generateMipmap);
+
+    // Create the texture storage and queue the decoded data in the upload ring. Mipmaps are generated when the upload completes
+    static std::shared_ptr<Texture2DObject> CreateTextureStreamed(std::shared_ptr<const TextureLoaderUtils::TextureData> textureData, bool generateMipmap,
+        TextureUploadRing& uploadRing);
+
     // Helper to easily load a shared texture
     static std::shared_ptr<Texture2DObject> LoadTextureShared(const char* path,
         TextureObject::Format format, TextureObject::InternalFormat internalFormat,
@@ -21,8 +30,26 @@ public:
     inline bool GetFlipVertical() const { return m_flipVertical; }
     inline void SetFlipVertical(bool flipVertical) { m_flipVertical = flipVertical; }
 
+    // If set, textures loaded with LoadSharedAsync get their mip levels streamed by the manager, depending on their use
+    // The mip levels are filtered on the worker thread, and generateMipmap is ignored
+    inline TextureStreamingManager* GetStreamingManager() const { return m_streamingManager; }
+    inline void SetStreamingManager(TextureStreamingManager* streamingManager) { m_streamingManager = streamingManager; }
+
+protected:
+    // Decode the image on the worker thread, and upload it on the GL thread
+    DecodeTask CreateDecodeTask(const char* path) override;
+
+    // Flipped and streamed textures are different assets
+    std::string GetImportSettings() const override;
+
 private:
+    // Set the shared sampler for the mipmaps. If generateMipmap is false, only the base level is used
+    static void SetupMipmap(Texture2DObject& texture2D, bool generateMipmap);
+
     // If true, the texture will be flipped vertically on load
     // This option exists because some systems define the vertical origin as "up", and others as "down"
     bool m_flipVertical;
+
+    // Manager of the streamed mip levels, if any
+    TextureStreamingManager* m_streamingManager;
 };
@@ -13,12 +13,26 @@ public:
     // Load the texture from the path
     TextureCubemapObject Load(const char* path) override;
 
+    // Create the cubemap from already decoded data, in cross layout
+    static TextureCubemapObject CreateTexture(const TextureLoaderUtils::TextureData& textureData, bool generateMipmap);
+
+    // Create the cubemap storage and queue the faces of the decoded data in the upload ring. Mipmaps are generated when the upload completes
+    static std::shared_ptr<TextureCubemapObject> CreateTextureStreamed(std::shared_ptr<const TextureLoaderUtils::TextureData> textureData, bool generateMipmap,
+        TextureUploadRing& uploadRing);
+
     // Helper to easily load a shared texture
     static std::shared_ptr<TextureCubemapObject> LoadTextureShared(const char* path,
         TextureObject::Format format, TextureObject::InternalFormat internalFormat,
         bool generateMipmap = true);
 
+protected:
+    // Decode the image on the worker thread, and upload it on the GL thread
+    DecodeTask CreateDecodeTask(const char* path) override;
+
 private:
-    void LoadFace(TextureCubemapObject& textureCubemap, TextureCubemapObject::Face face, std::span<const std::byte> dataSrc, std::span<std::byte> dataDst, int x, int y, int side, Data::Type dataType);
+    // AssetBenchmarks times LoadFace, that copies each face out of the cross image
+    friend class AssetBenchmarks;
+
+    static void LoadFace(TextureCubemapObject& textureCubemap, TextureCubemapObject::Face face, const TextureLoaderUtils::TextureData& textureData, std::span<std::byte> dataDst, int x, int y, int side);
 };
 
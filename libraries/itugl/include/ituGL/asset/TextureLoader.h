@@ -4,6 +4,10 @@
 
 #include <ituGL/texture/TextureObject.h>
 #include <ituGL/core/Data.h>
+#include <vector>
+#include <string>
+
+class TextureUploadRing;
 
 // Base class for all Texture asset loaders
 template<typename T>
@@ -22,7 +26,17 @@ public:
     inline bool GetGenerateMipmap() const { return m_generateMipmap; }
     inline void SetGenerateMipmap(bool generateMipmap) { m_generateMipmap = generateMipmap; }
 
+    // If set, textures loaded with LoadSharedAsync are streamed through the ring instead of uploaded at once
+    inline TextureUploadRing* GetUploadRing() const { return m_uploadRing; }
+    inline void SetUploadRing(TextureUploadRing* uploadRing) { m_uploadRing = uploadRing; }
+
 protected:
+    // The formats and mipmap generation change the texture
+    std::string GetImportSettings() const override;
+
+    // Memory reported by the driver for all the levels
+    size_t GetMemorySize(const T& texture) const override;
+
     std::span<const std::byte> LoadTexture2DData(const char* path, int& width, int& height, Data::Type& dataType, bool flipVertical = false);
     void FreeTexture2DData(std::span<const std::byte> data);
 
@@ -35,15 +49,66 @@ protected:
 
     // If the texture object should generate mipmaps after
     bool m_generateMipmap;
+
+    // Ring used to stream the texture data, if any
+    TextureUploadRing* m_uploadRing;
 };
 
 class TextureLoaderUtils
 {
 public:
+    // Decoded texture data, with the formats it was decoded for. Frees the data when destroyed
+    struct TextureData
+    {
+        TextureData() = default;
+        ~TextureData();
+
+        TextureData(const TextureData&) = delete;
+        void operator = (const TextureData&) = delete;
+
+        int width = 0;
+        int height = 0;
+        Data::Type dataType = Data::Type::None;
+        TextureObject::Format format = TextureObject::FormatInvalid;
+        TextureObject::InternalFormat internalFormat = TextureObject::InternalFormatInvalid;
+        std::span<const std::byte> data;
+
+        // Mip levels filtered on the CPU, starting at level 1. Only filled if requested when decoding
+        struct MipLevel
+        {
+            int width = 0;
+            int height = 0;
+            std::vector<std::byte> data;
+        };
+        std::vector<MipLevel> mipLevels;
+
+        // Number of levels, including level 0
+        inline int GetLevelCount() const { return 1 + static_cast<int>(mipLevels.size()); }
+
+        // Get the size and data of any level
+        std::span<const std::byte> GetLevel(int level, int& levelWidth, int& levelHeight) const;
+    };
+
+public:
+    // Decode the texture file. Can be called from any thread
+    // If generateMipLevels is true, the whole mip chain is also filtered, so it can be uploaded level by level
+    static std::shared_ptr<const TextureData> LoadTextureData(const char* path, TextureObject::Format format, TextureObject::InternalFormat internalFormat, bool flipVertical,
+        bool generateMipLevels = false);
+
     static std::span<const std::byte> LoadTexture2DData(const char* path, int& width, int& height, Data::Type& dataType, TextureObject::Format format, TextureObject::InternalFormat internalFormat, bool flipVertical);
     static void FreeTexture2DData(std::span<const std::byte> data);
 private:
     static bool IsHDR(TextureObject::InternalFormat internalFormat);
+
+    // Swap the rows of the image, in place
+    static void FlipVertical(std::span<const std::byte> data, int height);
+
+    // Filter the mip chain of the texture data with a box filter
+    static void GenerateMipLevels(TextureData& textureData);
+
+    // Downsample one level to half its size, averaging 2x2 blocks
+    template<typename T>
+    static void DownsampleLevel(std::span<const std::byte> source, int width, int height, int componentCount, TextureData::MipLevel& destination);
 };
 
 template<typename T>
@@ -54,8 +119,23 @@ TextureLoader<T>::TextureLoader()
 
 template<typename T>
 TextureLoader<T>::TextureLoader(TextureObject::Format format, TextureObject::InternalFormat internalFormat)
-    : m_format(format), m_internalFormat(internalFormat), m_generateMipmap(false)
+    : m_format(format), m_internalFormat(internalFormat), m_generateMipmap(false), m_uploadRing(nullptr)
+{
+}
+
+template<typename T>
+std::string TextureLoader<T>::GetImportSettings() const
+{
+    return std::to_string(m_format) + " " + std::to_string(m_internalFormat) + " " + std::to_string(m_generateMipmap);
+}
+
+template<typename T>
+size_t TextureLoader<T>::GetMemorySize(const T& texture) const
 {
+    texture.Bind();
+    size_t memorySize = texture.GetMemorySize();
+    T::Unbind();
+    return memorySize;
 }
 
 template<typename T>
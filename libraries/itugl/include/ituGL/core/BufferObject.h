@@ -13,6 +13,10 @@ public:
         ArrayBuffer = GL_ARRAY_BUFFER,
         // Element Buffer Object
         ElementArrayBuffer = GL_ELEMENT_ARRAY_BUFFER,
+        // Pixel Buffer Object, used as source for texture uploads
+        PixelUnpackBuffer = GL_PIXEL_UNPACK_BUFFER,
+        // Uniform Buffer Object, storage for uniform blocks
+        UniformBuffer = GL_UNIFORM_BUFFER,
         // TODO: There are more types, add them when they are supported
     };
 
@@ -51,6 +55,8 @@ public:
     // Each derived class will return its Target
     virtual Target GetTarget() const = 0;
 
+    // Methods that edit the buffer need it bound, unless the device has direct state access
+
     // Allocate the buffer, specifying the size and the usage. We can also provide initial contents
     void AllocateData(size_t size, Usage usage);
     void AllocateData(std::span<const std::byte> data, Usage usage);
@@ -58,11 +64,30 @@ public:
     // Modify the contents of the buffer, starting at offset
     void UpdateData(std::span<const std::byte> data, size_t offset = 0);
 
+    // Copy the contents of the buffer, starting at offset, into client memory. Stalls until the GPU has written them
+    void ReadData(std::span<std::byte> data, size_t offset = 0) const;
+
+    // Allocate immutable storage for the buffer, required for persistent mapping. Only available from GL 4.4
+    void AllocateStorage(size_t size, GLbitfield flags);
+
+    // Map a range of the buffer into client memory, with the GL_MAP_* access flags
+    std::span<std::byte> MapData(size_t offset, size_t size, GLbitfield access);
+
+    // Release the mapping of the buffer. Returns false if the data was corrupted while mapped
+    bool UnmapData();
+
+    // Size of the last allocation, in bytes
+    inline size_t GetSize() const { return m_size; }
+
 protected:
     // Bind the specific target. Used by the Bind() method in derived classes
     void Bind(Target target) const;
     // Unbind the specific target. It is static because we dont need any objects to do it
     static void Unbind(Target target);
+
+private:
+    // Allocated size, in bytes
+    size_t m_size;
 };
 
 // (C++) 5
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define ITUGL_PROFILER_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define ITUGL_PROFILER_RDTSC
+#endif
+
+// Hierarchical CPU profiler. Zones are recorded with the macros at the end of the file
+// Each thread writes its zones to its own ring, without locks, so only the last zones of each thread are kept
+// Zones are compiled out if ITUGL_PROFILER is not defined. If compiled in but disabled, a zone only tests a flag
+// Nesting is not stored, it comes from the zones containing each other in the trace
+class CpuProfiler
+{
+    class ThreadBuffer;
+
+public:
+    // Zones kept for each thread
+    static constexpr unsigned int ThreadCapacity = 1 << 16;
+
+    // Scope being measured. The name must stay valid until the profiler is exported
+    class Zone
+    {
+    public:
+        inline Zone(const char* name)
+            : m_buffer(s_enabled.load(std::memory_order_relaxed) ? GetThreadBuffer() : nullptr)
+            , m_name(name)
+            , m_start(m_buffer ? GetTimestamp() : 0)
+        {
+        }
+
+        inline ~Zone()
+        {
+            if (m_buffer)
+            {
+                m_buffer->Add(m_name, m_start, GetTimestamp());
+            }
+        }
+
+        Zone(const Zone&) = delete;
+        void operator = (const Zone&) = delete;
+
+    private:
+        ThreadBuffer* m_buffer;
+        const char* m_name;
+        uint64_t m_start;
+    };
+
+public:
+    static CpuProfiler& GetInstance();
+
+    // Zones are only recorded while enabled
+    static bool GetEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+    void SetEnabled(bool enabled);
+
+    // Name shown for the current thread in the trace. Like zone names, it must stay valid
+    static void SetThreadName(const char* name);
+
+    // Keep a copy of a name that is not a literal, so it can be used in zones. Locks, so intern once and keep the result
+    const char* InternName(std::string_view name);
+
+    // Zones recorded by all the threads, that are still in their rings
+    unsigned int GetZoneCount() const;
+
+    // Forget all the zones
+    void Clear();
+
+    // Write the zones in the Chrome trace event format, that can be opened in Perfetto or chrome://tracing
+    // Zones that the threads overwrite while exporting are skipped. Returns false if the file can't be written
+    bool ExportChromeTrace(const char* path) const;
+
+private:
+    CpuProfiler();
+
+    // Zone as stored in the rings, in timestamp ticks
+    struct Event
+    {
+        const char* name;
+        uint64_t start;
+        uint64_t end;
+    };
+
+    // Ring of one thread. Only the owner thread writes it
+    class ThreadBuffer
+    {
+    public:
+        ThreadBuffer(unsigned int threadId);
+
+        inline void Add(const char* name, uint64_t start, uint64_t end)
+        {
+            uint64_t written = m_written.load(std::memory_order_relaxed);
+            m_events[written % ThreadCapacity] = Event{ name, start, end };
+            m_written.store(written + 1, std::memory_order_release);
+        }
+
+        // Copy the events still in the ring, oldest first
+        // The owner thread can keep writing, the events it overwrites during the copy are dropped
+        void CopyEvents(std::vector<Event>& events) const;
+
+        unsigned int GetCount() const;
+        void Clear();
+
+        unsigned int GetThreadId() const { return m_threadId; }
+
+        const char* GetName() const { return m_name.load(std::memory_order_relaxed); }
+        void SetName(const char* name) { m_name.store(name, std::memory_order_relaxed); }
+
+    private:
+        std::unique_ptr<Event[]> m_events;
+        std::atomic<uint64_t> m_written;
+        // Events before this one were cleared
+        std::atomic<uint64_t> m_cleared;
+
+        unsigned int m_threadId;
+
+        std::atomic<const char*> m_name;
+    };
+
+    static inline ThreadBuffer* GetThreadBuffer()
+    {
+        return s_threadBuffer ? s_threadBuffer : GetInstance().CreateThreadBuffer();
+    }
+    ThreadBuffer* CreateThreadBuffer();
+
+    static inline uint64_t GetTimestamp()
+    {
+#ifdef ITUGL_PROFILER_RDTSC
+        return __rdtsc();
+#else
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+
+    // Nanoseconds for each timestamp tick, measured against the steady clock since the profiler was created
+    double GetTickDuration() const;
+
+private:
+    static std::atomic<bool> s_enabled;
+
+    static thread_local ThreadBuffer* s_threadBuffer;
+    static thread_local const char* s_threadName;
+
+    // Guards the buffer list and the interned names
+    mutable std::mutex m_mutex;
+
+    std::vector<std::unique_ptr<ThreadBuffer>> m_threadBuffers;
+
+    std::unordered_set<std::string> m_names;
+
+    // Reference points to convert the timestamps
+    uint64_t m_startTimestamp;
+    int64_t m_startTime;
+};
+
+#ifdef ITUGL_PROFILER
+#define ITUGL_PROFILE_CONCAT_INNER(a, b) a##b
+#define ITUGL_PROFILE_CONCAT(a, b) ITUGL_PROFILE_CONCAT_INNER(a, b)
+// Measure the rest of the current scope
+#define ITUGL_PROFILE_ZONE(name) CpuProfiler::Zone ITUGL_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define ITUGL_PROFILE_FUNCTION() ITUGL_PROFILE_ZONE(__func__)
+#else
+#define ITUGL_PROFILE_ZONE(name)
+#define ITUGL_PROFILE_FUNCTION()
+#endif
@@ -1,7 +1,11 @@
 #pragma once
 
 #include <ituGL/core/Color.h>
+#include <ituGL/core/RenderState.h>
 #include <glad/glad.h>
+#include <array>
+#include <vector>
+#include <unordered_map>
 
 class Window;
 struct GLFWwindow;
@@ -10,6 +14,43 @@ struct GLFWwindow;
 // Implemented as a Singleton pattern, as there can only be one
 class DeviceGL
 {
+public:
+    // Render state changes since the last reset
+    struct RenderStateStats
+    {
+        // Calls to SetRenderState that set at least one group, and groups set
+        unsigned int changes = 0;
+        unsigned int groupsSet = 0;
+        // Calls to SetRenderState that didn't need any GL call
+        unsigned int skipped = 0;
+    };
+
+    // Texture and sampler binds since the last reset
+    struct TextureBindStats
+    {
+        // Textures and samplers bound, and binds skipped because they were already bound in the unit
+        unsigned int binds = 0;
+        unsigned int skipped = 0;
+        unsigned int samplerBinds = 0;
+        unsigned int samplersSkipped = 0;
+        // Changes of the active texture unit
+        unsigned int unitChanges = 0;
+    };
+
+    // Vertex array binds, and buffers attached to vertex arrays, since the last reset
+    struct VertexBindStats
+    {
+        // Vertex arrays bound, and binds skipped because the vertex array was already bound
+        unsigned int vertexArrayBinds = 0;
+        unsigned int vertexArraysSkipped = 0;
+        // Vertex and element buffers attached, and attachments skipped because the vertex array already had them
+        unsigned int bufferBinds = 0;
+        unsigned int buffersSkipped = 0;
+    };
+
+    // Texture units with cached bindings. Units above are bound directly
+    static constexpr GLint TextureUnitCount = 32;
+
 public:
     DeviceGL();
     ~DeviceGL();
@@ -23,9 +64,19 @@ public:
     // Check if device is initialized
     inline bool IsReady() const { return m_contextLoaded; }
 
+    // If objects are created and edited with GL 4.5 direct state access, so editing them doesn't need to bind them
+    // Used if the context supports it. Otherwise, objects must be bound before editing them, as in GL 3.3
+    inline static bool HasDirectStateAccess() { return s_directStateAccessEnabled && GLAD_GL_VERSION_4_5; }
+
+    // Disable direct state access, even if the context supports it. Only change it before creating any object
+    inline static void SetDirectStateAccessEnabled(bool enabled) { s_directStateAccessEnabled = enabled; }
+
     // Set the window that OpenGL will use for rendering
     void SetCurrentWindow(Window &window);
 
+    // Use the recording GL entry points instead of a window context, see RecordingGL. The device state starts unknown
+    bool LoadRecordingContext();
+
     // Set the dimensions of the viewport
     void SetViewport(GLint x, GLint y, GLsizei width, GLsizei height);
 
@@ -46,6 +97,65 @@ public:
     inline void EnableFeature(GLenum feature) { SetFeatureEnabled(feature, true); }
     inline void DisableFeature(GLenum feature) { SetFeatureEnabled(feature, false); }
 
+    // Set the depth, stencil and blend states of the block, only for the groups in the mask
+    // The device remembers the block that set each group, and only sets the groups with different values
+    void SetRenderState(const RenderState& renderState, unsigned int groupMask = RenderState::AllGroups);
+
+    // Forget the current render state, so the next SetRenderState sets all the groups. Call it after changing those states directly
+    void InvalidateRenderState();
+
+    inline const RenderStateStats& GetRenderStateStats() const { return m_renderStateStats; }
+    inline void ResetRenderStateStats() { m_renderStateStats = RenderStateStats(); }
+
+    // Set the active texture unit, unless it already is
+    void SetActiveTextureUnit(GLint textureUnit);
+    inline GLint GetActiveTextureUnit() const { return m_activeTextureUnit; }
+
+    // Bind the texture to the target in the active unit, unless it is already bound
+    void BindTexture(GLenum target, GLuint texture);
+
+    // Bind the texture and the sampler to the unit, to be sampled by the shaders
+    // The active unit only changes if the texture is not bound in the unit yet
+    void BindTexture(GLint textureUnit, GLenum target, GLuint texture, GLuint sampler);
+
+    // Bind the sampler to the unit, unless it is already bound. Sampler 0 uses the parameters of the texture
+    void BindSampler(GLint textureUnit, GLuint sampler);
+
+    // Texture bound to the target in the active unit, as far as the device knows
+    GLuint GetBoundTexture(GLenum target) const;
+
+    // Forget the texture or sampler in all the units. GL unbinds them when they are deleted
+    void ForgetTexture(GLuint texture);
+    void ForgetSampler(GLuint sampler);
+
+    // Forget all the texture bindings, so they are set again. Call it after binding textures directly
+    void InvalidateTextureBindings();
+
+    inline const TextureBindStats& GetTextureBindStats() const { return m_textureBindStats; }
+    inline void ResetTextureBindStats() { m_textureBindStats = TextureBindStats(); }
+
+    // Bind the vertex array, unless it is already bound
+    void BindVertexArray(GLuint vertexArray);
+    inline GLuint GetBoundVertexArray() const { return m_vertexArray; }
+
+    // Attach the buffer to the binding index of the vertex array, unless it is already attached with the same offset and stride
+    // Needs GL 4.3. Without direct state access, the vertex array is bound first
+    void BindVertexBuffer(GLuint vertexArray, GLuint bindingIndex, GLuint buffer, GLintptr offset, GLsizei stride);
+
+    // Set the element buffer of the vertex array, unless it is already set
+    // Without direct state access, the vertex array is bound first
+    void BindElementBuffer(GLuint vertexArray, GLuint buffer);
+
+    // Forget the vertex array, or the buffer in all the vertex arrays. GL unbinds them when they are deleted
+    void ForgetVertexArray(GLuint vertexArray);
+    void ForgetBuffer(GLuint buffer);
+
+    // Forget all the vertex array bindings, so they are set again. Call it after binding vertex arrays or element buffers directly
+    void InvalidateVertexBindings();
+
+    inline const VertexBindStats& GetVertexBindStats() const { return m_vertexBindStats; }
+    inline void ResetVertexBindStats() { m_vertexBindStats = VertexBindStats(); }
+
     // enable / disable wireframe mode
     void SetWireframeEnabled(bool enabled);
 
@@ -56,10 +166,55 @@ private:
     // Has a context been loaded? We use the context of the current window
     bool m_contextLoaded;
 
+    // Block that set the current values of each render state group, or null if unknown
+    std::array<const RenderState*, RenderState::GroupCount> m_renderStates;
+
+    RenderStateStats m_renderStateStats;
+
+    // Textures bound to each texture target, and sampler, of each texture unit. UnknownBinding if not known
+    struct TextureUnitBindings
+    {
+        std::array<GLuint, 11> textures;
+        GLuint sampler;
+    };
+    std::array<TextureUnitBindings, TextureUnitCount> m_textureUnits;
+
+    // Active texture unit, -1 if not known
+    GLint m_activeTextureUnit;
+
+    TextureBindStats m_textureBindStats;
+
+    // Buffers attached to a vertex array through the device. UnknownBinding if not known
+    struct VertexArrayBindings
+    {
+        struct VertexBuffer
+        {
+            GLuint buffer;
+            GLintptr offset;
+            GLsizei stride;
+        };
+        std::vector<VertexBuffer> vertexBuffers;
+        GLuint elementBuffer;
+    };
+    std::unordered_map<GLuint, VertexArrayBindings> m_vertexArrays;
+
+    // Vertex array currently bound. UnknownBinding if not known
+    GLuint m_vertexArray;
+
+    VertexBindStats m_vertexBindStats;
+
 private:
     // Singleton instance
     static DeviceGL* m_instance;
 
+    static bool s_directStateAccessEnabled;
+
+    // Marks the bindings that are not known, and must be set again
+    static constexpr GLuint UnknownBinding = ~0u;
+
+    // Index of the texture target in TextureUnitBindings::textures
+    static unsigned int GetTextureTargetIndex(GLenum target);
+
     // Callback called when the framebuffer changes size
     static void FrameBufferResized(GLFWwindow* window, GLsizei width, GLsizei height);
 };
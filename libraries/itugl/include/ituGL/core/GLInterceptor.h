@@ -0,0 +1,189 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <array>
+#include <cstdarg>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class DearImGui;
+
+// Optional layer over the glad function pointers, to see what the GL calls cost the driver
+// Counts every entry point per frame and per render pass, and detects redundant calls:
+// binding what is already bound, enabling what is already enabled, and setting identical state or uniform values
+// It also collects the performance warnings and errors reported with GL_KHR_debug
+// Only sees the calls made through glad, on the thread that owns the context. Dear ImGui uses its own loader
+class GLInterceptor
+{
+public:
+    enum class Category
+    {
+        Draw,
+        Bind,
+        Uniform,
+        State,
+        Query,
+        Other,
+        Count
+    };
+
+    struct CallCounts
+    {
+        unsigned int calls = 0;
+        // Calls that did not change the state tracked by the interceptor
+        unsigned int redundant = 0;
+    };
+
+    // GL_KHR_debug message, reported once with the number of times it was received
+    struct DebugMessage
+    {
+        GLenum source;
+        GLenum type;
+        GLuint id;
+        GLenum severity;
+        std::string text;
+        // Pass where it was first received
+        std::string pass;
+        unsigned int count;
+    };
+
+public:
+    static GLInterceptor& GetInstance();
+
+    GLInterceptor(const GLInterceptor&) = delete;
+    void operator = (const GLInterceptor&) = delete;
+
+    static inline bool IsEnabled() { return s_enabled; }
+
+    // Install or remove the glad callback. Enabling also turns on the debug output, if the context supports it
+    void SetEnabled(bool enabled);
+
+    // Close the current frame, that becomes the last frame, and start a new one. Call it once per frame
+    void NextFrame();
+
+    // Attribute the calls to a pass until EndPass. Calls outside passes go to the first pass
+    void BeginPass(const std::string& name);
+    void EndPass();
+
+    // Counts of the last complete frame
+    inline unsigned int GetPassCount() const { return static_cast<unsigned int>(m_lastFrame.size()); }
+    inline const std::string& GetPassName(unsigned int passIndex) const { return m_lastFrame[passIndex].name; }
+    CallCounts GetPassCounts(unsigned int passIndex) const;
+    CallCounts GetFrameCounts() const;
+    CallCounts GetFrameCounts(Category category) const;
+
+    inline unsigned int GetFrameCount() const { return m_frameCount; }
+    inline const std::vector<DebugMessage>& GetDebugMessages() const { return m_debugMessages; }
+
+    static const char* GetCategoryName(Category category);
+
+    // Forget the counts and the messages
+    void Clear();
+
+    // Write the counts of the last frame per pass and entry point, the totals and the debug messages. Returns false if the file can't be written
+    bool ExportJson(const char* path) const;
+
+    // Draw the counts of the last frame and the debug messages
+    void DrawGUI(DearImGui& imGui);
+
+private:
+    GLInterceptor();
+    ~GLInterceptor();
+
+    // How the redundancy of a call is detected
+    enum class Check
+    {
+        None,
+        UseProgram,
+        BindVertexArray,
+        BindBuffer,
+        BindBufferIndexed,
+        BindFramebuffer,
+        ActiveTexture,
+        BindTexture,
+        BindTextureUnit,
+        BindSampler,
+        Enable,
+        Disable,
+        // State setter, redundant if called with the same arguments
+        State,
+        Uniform,
+        ProgramUniform,
+        // Deleting objects or linking programs changes what the shadow state refers to
+        Invalidate,
+    };
+
+    struct Entry
+    {
+        std::string name;
+        Category category;
+        Check check;
+
+        // State setters: arguments as read from the call, and the states it sets
+        const char* signature;
+        unsigned int keyArguments;
+        int state;
+        int relatedState;
+
+        // Uniforms: values passed by pointer, components of each value and their size
+        bool uniformVector;
+        bool uniformMatrix;
+        unsigned int uniformComponents;
+        unsigned int uniformComponentSize;
+        char uniformType;
+    };
+
+    struct PassCounts
+    {
+        std::string name;
+        // Indexed by entry, grows with the entries
+        std::vector<CallCounts> counts;
+    };
+
+    static void PreCallback(const char* name, void* function, int argumentCount, ...);
+    static void NoCallback(const char* name, void* function, int argumentCount, ...);
+    static void APIENTRY DebugCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam);
+
+    void OnCall(const char* name, void* function, va_list arguments);
+    unsigned int AddEntry(const char* name);
+
+    // Returns true if the call does not change the shadow state, and updates it otherwise
+    bool IsRedundant(const Entry& entry, va_list arguments);
+    bool SetShadow(uint64_t key, const std::array<uint64_t, 4>& value);
+    bool SetUniformShadow(const Entry& entry, GLuint program, va_list arguments);
+    void InvalidateShadow();
+
+    void EnableDebugOutput(bool enabled);
+    void AddDebugMessage(GLenum source, GLenum type, GLuint id, GLenum severity, const char* text);
+
+    static CallCounts Sum(const PassCounts& pass);
+
+private:
+    static bool s_enabled;
+
+    std::unordered_map<void*, unsigned int> m_entryIndices;
+    std::vector<Entry> m_entries;
+
+    std::vector<PassCounts> m_currentFrame;
+    std::vector<PassCounts> m_lastFrame;
+    unsigned int m_currentPass;
+
+    // Counts of all the frames, indexed by entry
+    std::vector<CallCounts> m_totals;
+    unsigned int m_frameCount;
+
+    // Last values set, by kind of state and target. Missing values are unknown
+    std::unordered_map<uint64_t, std::array<uint64_t, 4>> m_shadow;
+    // Last uniform values set, by program and location
+    std::unordered_map<uint64_t, std::vector<unsigned char>> m_uniformShadow;
+    std::vector<unsigned char> m_uniformValue;
+    GLuint m_program;
+    GLuint m_activeTextureUnit;
+    bool m_activeTextureUnitKnown;
+
+    std::vector<DebugMessage> m_debugMessages;
+    bool m_debugOutput;
+
+    std::string m_exportStatus;
+};
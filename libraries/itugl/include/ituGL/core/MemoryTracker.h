@@ -0,0 +1,137 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class DearImGui;
+
+// Estimated memory of the GL objects and of the asset data kept on the CPU
+// Sizes are computed from the allocations, without asking the driver, so they don't include padding, alignment or
+// compression. Buffers and textures report their allocations, and textures attached to framebuffers become render targets
+// Objects are identified by their type and handle, so moving the C++ object keeps its entry
+// All the methods can be called from any thread
+class MemoryTracker
+{
+public:
+    enum class Category
+    {
+        RenderTarget,
+        Texture,
+        VertexBuffer,
+        IndexBuffer,
+        UniformBuffer,
+        // Pixel unpack buffers, used to upload textures
+        StagingBuffer,
+        // CPU memory of decoded assets, like texture data kept for streaming
+        AssetData,
+        Count
+    };
+
+    enum class ObjectType
+    {
+        Buffer,
+        Texture,
+        // CPU allocations, identified by address
+        Cpu,
+    };
+
+    struct Totals
+    {
+        size_t bytes = 0;
+        size_t peakBytes = 0;
+        unsigned int objectCount = 0;
+    };
+
+    // Row of the per-object table
+    struct ObjectInfo
+    {
+        ObjectType type;
+        std::uint64_t id;
+        Category category;
+        size_t bytes;
+        // Size of level 0, for textures
+        GLsizei width;
+        GLsizei height;
+        std::string name;
+    };
+
+public:
+    static MemoryTracker& GetInstance();
+
+    MemoryTracker(const MemoryTracker&) = delete;
+    void operator = (const MemoryTracker&) = delete;
+
+    // Set the size of a buffer, replacing the previous one
+    void SetBufferSize(GLuint handle, Category category, size_t bytes);
+
+    // Set the size of one image of a texture: level * faceCount + face. Images set to 0 bytes are released
+    // Keeps the category of the texture if it is tracked already
+    void SetTextureImage(GLuint handle, unsigned int image, size_t bytes, GLsizei width, GLsizei height);
+
+    // Add the levels generated from level 0, for each face
+    void SetTextureMipmaps(GLuint handle, unsigned int faceCount);
+
+    // Change the category of a tracked object, like a texture attached to a framebuffer
+    void SetCategory(ObjectType type, GLuint handle, Category category);
+
+    // Forget the object, when it is deleted
+    void RemoveObject(ObjectType type, GLuint handle);
+
+    // CPU allocations, identified by the address of their owner
+    void SetCpuAllocation(const void* owner, Category category, size_t bytes, const std::string& name);
+    void RemoveCpuAllocation(const void* owner);
+
+    Totals GetTotals(Category category) const;
+    // Sum of the GPU or CPU categories. The peak is the peak of the sum, not the sum of the peaks
+    Totals GetGpuTotals() const;
+    Totals GetCpuTotals() const;
+
+    // Objects tracked, the largest first
+    std::vector<ObjectInfo> GetObjects() const;
+
+    // Start the peaks again from the current values
+    void ResetPeaks();
+
+    static const char* GetCategoryName(Category category);
+    static const char* GetObjectTypeName(ObjectType type);
+    static bool IsGpuCategory(Category category) { return category != Category::AssetData; }
+
+    // Draw the totals per category and the table of objects
+    void DrawGUI(DearImGui& imGui);
+
+private:
+    MemoryTracker();
+
+    struct Object
+    {
+        Category category;
+        size_t bytes = 0;
+        GLsizei width = 0;
+        GLsizei height = 0;
+        // Textures: size of each image
+        std::vector<size_t> imageBytes;
+        std::string name;
+    };
+
+    static std::uint64_t GetKey(ObjectType type, std::uint64_t id);
+
+    // Update the totals with the change of size of the object. Requires the lock
+    void Resize(Object& object, size_t bytes);
+    void Add(Category category, size_t bytes);
+    void Subtract(Category category, size_t bytes);
+
+private:
+    mutable std::mutex m_mutex;
+
+    std::unordered_map<std::uint64_t, Object> m_objects;
+
+    std::array<Totals, static_cast<size_t>(Category::Count)> m_totals;
+    // Object counts are summed when requested
+    Totals m_gpuTotals;
+    Totals m_cpuTotals;
+};
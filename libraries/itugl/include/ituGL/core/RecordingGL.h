@@ -0,0 +1,57 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// GL entry points that need no context or driver. They hand out fake handles, keep the state that the library reads back,
+// and append the calls to an in-memory command buffer while recording
+// The renderer, the passes, the materials and the loaders run unchanged, so their CPU cost can be measured apart from the driver,
+// and two command streams can be compared to check that an optimization issues the same calls
+// Programs report the uniforms and vertex inputs declared in their GLSL sources. Uniform blocks are not reported
+// Entry points that the library does not use are loaded as stubs that return zero, and are not recorded
+class RecordingGL
+{
+public:
+    // Recorded call: the entry point, and its arguments as 64 bit words, followed by any payload
+    // Integers keep their value, floats are stored as doubles, and typed pointers only record if they are null
+    // Untyped pointers that fit in 32 bits are offsets into a bound buffer and keep their value, larger ones are client memory
+    // Uniform and parameter arrays append their values as payload, buffer uploads append a hash of their data
+    struct Command
+    {
+        unsigned int entryPoint;
+        std::span<const uint64_t> words;
+    };
+
+public:
+    // Point the glad entry points to the recording ones, and reset the state. The version reported is 4.6
+    static bool Load();
+    static bool IsLoaded();
+
+    // Forget all objects, state and commands, so the handles start again from 1
+    static void Reset();
+
+    // Append the calls to the command buffer. Off by default, so the CPU cost is measured without the buffer
+    static void SetRecording(bool recording);
+    static bool IsRecording();
+
+    // Recorded commands, encoded as a header word with the entry point and the number of words that follow
+    static const std::vector<uint64_t>& GetCommandBuffer();
+    static unsigned int GetCommandCount();
+    static void ClearCommands();
+
+    static const char* GetEntryPointName(unsigned int entryPoint);
+
+    // Decode the command that starts at offset in the buffer. Returns the offset of the next command
+    static size_t ReadCommand(std::span<const uint64_t> commandBuffer, size_t offset, Command& command);
+
+    // Hash of a command buffer, to compare streams quickly
+    static uint64_t GetHash(std::span<const uint64_t> commandBuffer);
+
+    // Index of the first command that differs between the buffers, or -1 if they are the same
+    static int FindFirstDifference(std::span<const uint64_t> commandBuffer, std::span<const uint64_t> otherCommandBuffer);
+
+    // Write one command per line, with the entry point name and the words in hexadecimal, so two streams can be diffed
+    static bool WriteCommands(std::span<const uint64_t> commandBuffer, const char* path);
+};
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <ituGL/core/Color.h>
+#include <array>
+#include <memory>
+
+// Immutable block with the depth, stencil and blend states, set with DeviceGL::SetRenderState
+// Blocks are created with Get, that returns the same block for the same states, so the device can compare them by pointer
+class RenderState
+{
+public:
+    // Different conditions for depth and stencil tests
+    enum class TestFunction : GLenum;
+
+    // Operation to perform when a stencil condition is met
+    enum class StencilOperation : GLenum;
+
+    // Different types of blending equations
+    enum class BlendEquation : GLenum;
+
+    // Parameters to be used to control each of the 4 components of the blending equation:
+    // source color, destination color, source alpha, destination alpha
+    enum class BlendParam : GLenum;
+
+    // Groups of states that are set with the same GL calls. Used as bitmasks to set some of them, or to compare two blocks
+    enum Group : unsigned int
+    {
+        DepthFunction = 1 << 0,
+        DepthWrite = 1 << 1,
+        StencilFunctions = 1 << 2,
+        StencilOperations = 1 << 3,
+        BlendEnable = 1 << 4,
+        BlendEquations = 1 << 5,
+        BlendParams = 1 << 6,
+        BlendColor = 1 << 7,
+
+        DepthGroups = DepthFunction | DepthWrite,
+        StencilGroups = StencilFunctions | StencilOperations,
+        BlendGroups = BlendEnable | BlendEquations | BlendParams | BlendColor,
+        AllGroups = DepthGroups | StencilGroups | BlendGroups
+    };
+    static const unsigned int GroupCount = 8;
+
+    // Values of all the states. Arrays with 2 values are front and back, or color and alpha
+    struct Desc
+    {
+        // Test function for depth. Default: Less
+        TestFunction depthTestFunction;
+        // If it should write to depth or not. Default: True
+        bool depthWrite;
+
+        // Test functions, ref values and masks for front and back stencil. Default: Never, 0, ~0
+        std::array<TestFunction, 2> stencilTestFunctions;
+        std::array<int, 2> stencilRefValues;
+        std::array<unsigned int, 2> stencilMasks;
+
+        // Stencil operations if stencil test fails, if depth test fails and if depth test passes, front and back. Default: Keep
+        std::array<StencilOperation, 2> stencilFail;
+        std::array<StencilOperation, 2> stencilDepthFail;
+        std::array<StencilOperation, 2> stencilDepthPass;
+
+        // Blend equation for color and alpha. Default: None, that disables blending if both are None
+        std::array<BlendEquation, 2> blendEquations;
+        // Blend parameters for source color, destination color, source alpha and destination alpha. Default: One, Zero, One, Zero
+        std::array<BlendParam, 4> blendParams;
+        // Blend color to use with ConstantColor or ConstantAlpha parameters. Default: black
+        Color blendColor;
+
+        Desc();
+
+        bool operator == (const Desc& desc) const;
+    };
+
+public:
+    // Get the block with these states, creating it the first time
+    // Blocks are never destroyed, usually there are only a few different ones
+    static std::shared_ptr<const RenderState> Get(const Desc& desc);
+
+    inline const Desc& GetDesc() const { return m_desc; }
+
+    // Groups that the block sets. Blend equations and params are not set if blending is disabled, and the color only if a param uses it
+    inline unsigned int GetGroups() const { return m_groups; }
+
+    // Groups with different values in the other block, from the ones that this block sets
+    unsigned int GetDifferentGroups(const RenderState& renderState) const;
+
+    // Set the states of the groups in the mask
+    void Apply(unsigned int groupMask) const;
+
+private:
+    RenderState(const Desc& desc);
+
+    RenderState(const RenderState&) = delete;
+    void operator = (const RenderState&) = delete;
+
+    static size_t ComputeHash(const Desc& desc);
+
+private:
+    Desc m_desc;
+
+    unsigned int m_groups;
+
+    // Blend equations and params as they are set. There is no "None" equation, it is replaced with (Source * 1 + Dest * 0)
+    std::array<GLenum, 2> m_blendEquations;
+    std::array<GLenum, 4> m_blendParams;
+};
+
+// Different conditions for depth and stencil tests
+enum class RenderState::TestFunction : GLenum
+{
+    Always = GL_ALWAYS,
+    Never = GL_NEVER,
+    Equal = GL_EQUAL,
+    NotEqual = GL_NOTEQUAL,
+    Less = GL_LESS,
+    LessEqual = GL_LEQUAL,
+    Greater = GL_GREATER,
+    GreaterEqual = GL_GEQUAL
+};
+
+// Operation to perform when a stencil condition is met
+enum class RenderState::StencilOperation : GLenum
+{
+    // Keep the same value (do nothing)
+    Keep = GL_KEEP,
+    // Set the value to zero (only the bits affected by the mask)
+    Zero = GL_ZERO,
+    // Replace the value with the reference value (only the bits affected by the mask)
+    Replace = GL_REPLACE,
+    // Increase the value. If the maximum is reached, do nothing
+    Increase = GL_INCR,
+    // Increase the value. If the maximum is reached, back to 0
+    IncreaseWrap = GL_INCR_WRAP,
+    // Decrease the value. If 0 is reached, do nothing
+    Decrease = GL_DECR,
+    // Decrease the value. If 0 is reached, set to maximum value
+    DecreaseWrap = GL_DECR_WRAP,
+    // Invert the bits affected by the mask
+    Invert = GL_INVERT
+};
+
+// Different types of blending equations
+enum class RenderState::BlendEquation : GLenum
+{
+    None = GL_NONE,
+    Add = GL_FUNC_ADD,
+    Substract = GL_FUNC_SUBTRACT,
+    ReverseSubstract = GL_FUNC_REVERSE_SUBTRACT,
+    Min = GL_MIN,
+    Max = GL_MAX
+};
+
+// Parameters to be used to control each of the 4 components of the blending equation:
+// source color, destination color, source alpha, destination alpha
+enum class RenderState::BlendParam : GLenum
+{
+    Zero = GL_ZERO,
+    One = GL_ONE,
+    SourceColor = GL_SRC_COLOR,
+    OneMinusSourceColor = GL_ONE_MINUS_SRC_COLOR,
+    SourceAlpha = GL_SRC_ALPHA,
+    OneMinusSourceAlpha = GL_ONE_MINUS_SRC_ALPHA,
+    DestColor = GL_DST_COLOR,
+    OneMinusDestColor = GL_ONE_MINUS_DST_COLOR,
+    DestAlpha = GL_DST_ALPHA,
+    OneMinusDestAlpha = GL_ONE_MINUS_DST_ALPHA,
+    ConstantColor = GL_CONSTANT_COLOR,
+    OneMinusConstantColor = GL_ONE_MINUS_CONSTANT_COLOR,
+    ConstantAlpha = GL_CONSTANT_ALPHA,
+    OneMinusConstantAlpha = GL_ONE_MINUS_CONSTANT_ALPHA
+};
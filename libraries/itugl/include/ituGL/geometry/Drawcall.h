@@ -26,11 +26,19 @@ public:
 public:
     Drawcall();
     Drawcall(Primitive primitive, GLsizei count, GLint first = 0);
-    Drawcall(Primitive primitive, GLsizei count, Data::Type eboType, GLint first = 0);
+    // With an EBO, first is the index of the first element, and baseVertex is added to every element
+    // Submeshes packed in the same VBO and EBO use them to find their vertices and elements
+    Drawcall(Primitive primitive, GLsizei count, Data::Type eboType, GLint first = 0, GLint baseVertex = 0);
 
     // Check if the drawcall is valid
     inline bool IsValid() const { return m_primitive != Primitive::Invalid && m_count > 0; }
 
+    inline Primitive GetPrimitive() const { return m_primitive; }
+    inline GLint GetFirst() const { return m_first; }
+    inline GLsizei GetCount() const { return m_count; }
+    inline Data::Type GetEboType() const { return m_eboType; }
+    inline GLint GetBaseVertex() const { return m_baseVertex; }
+
     // Execute the drawcall
     void Draw() const;
 
@@ -46,4 +54,7 @@ private:
 
     // Data type of the elements in the EBO (int, uint, short, byte, etc.). A value of None means no EBO
     Data::Type m_eboType;
+
+    // Value added to the elements before reading the vertices. Only used with an EBO
+    GLint m_baseVertex;
 };
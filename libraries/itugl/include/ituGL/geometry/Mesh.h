@@ -8,15 +8,26 @@
 #include <ituGL/shader/ShaderProgram.h>
 #include <vector>
 #include <unordered_map>
+#include <memory>
 
 // Class that groups several VBO, EBO and VAO that are part of the same object
 // Can contain several drawcalls using the data in those objects
+// If the context supports separate attribute formats, submeshes with the same vertex format share a VAO with other meshes,
+// and only attach their VBOs and EBO to it before drawing
 class Mesh
 {
 public:
     // Maps vertex attribute semantics with their location on a shader program
     using SemanticMap = std::unordered_map<VertexAttribute::Semantic, ShaderProgram::Location>;
 
+    // Attribute read by a submesh: the VBO it reads from, its layout in the VBO, and the location it was assigned
+    struct AttributeBinding
+    {
+        unsigned int vboIndex;
+        VertexAttribute::Layout layout;
+        GLuint location;
+    };
+
 public:
     Mesh();
 
@@ -77,6 +88,20 @@ public:
         unsigned int vboIndex, unsigned int eboIndex,
         TIterator it, const TIterator itEnd, const SemanticMap& locations = SemanticMap());
 
+    // (C++) 7
+    // Adds a new submesh, adding a new VAO that uses a single VBO and an EBO, with the Drawcall to render it
+    // The Drawcall can have a first element and a base vertex, if the VBO and EBO contain the data of several submeshes
+    template<typename TIterator>
+    unsigned int AddSubmesh(const Drawcall& drawcall, unsigned int vboIndex, unsigned int eboIndex,
+        TIterator it, const TIterator itEnd, const SemanticMap& locations = SemanticMap());
+
+    // Adds a new submesh that uses the same VAO and buffers as another submesh, with a different Drawcall
+    unsigned int AddSubmeshFrom(unsigned int submeshIndex, const Drawcall& drawcall);
+
+    // Adds a new submesh with attributes read from any of the VBOs at explicit locations, like the ones returned by GetSubmeshAttributes
+    // eboIndex is -1 if there is no EBO
+    unsigned int AddSubmesh(const Drawcall& drawcall, std::span<const AttributeBinding> attributes, int eboIndex);
+
     // (C++) 7
     // Adds a new submesh, adding a new VAO that uses several VBOs and an EBO, and providing the parameters to create a Drawcall
     // vboIndices are the indices inside m_vbos of the VBOs to be used
@@ -110,19 +135,43 @@ public:
     inline const VertexArrayObject& GetVertexArray(unsigned int vaoIndex) const { return m_vaos[vaoIndex]; }
 
     inline unsigned int GetSubmeshCount() const { return static_cast<unsigned int>(m_submeshes.size()); }
-    inline const VertexArrayObject& GetSubmeshVertexArray(unsigned int submeshIndex) const { return m_vaos[m_submeshes[submeshIndex].vaoIndex]; }
+    const VertexArrayObject& GetSubmeshVertexArray(unsigned int submeshIndex) const;
     inline const Drawcall& GetSubmeshDrawcall(unsigned int submeshIndex) const { return m_submeshes[submeshIndex].drawcall; }
 
+    // Attributes of a submesh, as they were added with the iterators. Empty if the VAO was set up outside the mesh
+    std::span<const AttributeBinding> GetSubmeshAttributes(unsigned int submeshIndex) const;
+    // Index of the EBO of a submesh, or -1 if it has none
+    inline int GetSubmeshElementBufferIndex(unsigned int submeshIndex) const { return m_submeshes[submeshIndex].eboIndex; }
+
+    // Binds the VAO of a submesh, attaching the buffers of the submesh if the VAO is shared
+    void BindSubmesh(int submeshIndex) const;
+
     // Draws a submesh
     void DrawSubmesh(int submeshIndex) const;
 
 private:
 
+    // VBO attached to a binding index of a shared VAO. The binding index is the position in Submesh::vertexBuffers
+    struct VertexBufferBinding
+    {
+        unsigned int vboIndex;
+        GLintptr offset;
+        GLsizei stride;
+    };
+
     // Helper structure that contains a drawcall and its VAO to be bound
     struct Submesh
     {
-        unsigned int vaoIndex;
+        unsigned int vaoIndex = 0;
         Drawcall drawcall;
+
+        // Shared VAO used instead of the one in vaoIndex, with the VBOs and EBO to attach to it
+        std::shared_ptr<VertexArrayObject> sharedVao;
+        std::vector<VertexBufferBinding> vertexBuffers;
+        // Attributes of the shared VAO. The attributes of an owned VAO are in m_vertexArrayAttributes
+        std::vector<AttributeBinding> attributes;
+        // Index of the EBO, or -1 if there is none
+        int eboIndex = -1;
     };
 
 private:
@@ -137,7 +186,18 @@ private:
     inline Submesh& GetSubmesh(unsigned int submeshIndex) { return m_submeshes[submeshIndex]; }
 
     // Set a vertex attribute in a VAO, using the specified layout, and increases the location index according to the size of the attribute
-    void SetupVertexAttribute(VertexArrayObject& vao, const VertexAttribute::Layout& attributeLayout, GLuint& location, const SemanticMap& locations);
+    void SetupVertexAttribute(unsigned int vaoIndex, unsigned int vboIndex, const VertexAttribute::Layout& attributeLayout, GLuint& location, const SemanticMap& locations);
+
+    // Adds a new submesh using a shared VAO, with the attribute formats of the iterator. eboIndex is -1 if there is no EBO
+    // vboIndices are used in the same way as in AddVertexArray
+    template<typename TIterator>
+    unsigned int AddSharedSubmesh(std::span<const unsigned int> vboIndices, int eboIndex,
+        TIterator& it, const TIterator itEnd, const SemanticMap& locations, const Drawcall& drawcall);
+
+    // Add the format of the attribute, and the VBO binding it reads from, and increases the location index like SetupVertexAttribute
+    // Interleaved attributes read from the same binding, with different relative offsets
+    void AddSharedAttribute(Submesh& submesh, std::vector<VertexArrayObject::AttributeFormat>& formats, unsigned int vboIndex,
+        const VertexAttribute::Layout& attributeLayout, GLuint& location, const SemanticMap& locations);
 
 private:
     // All the VBOs used in this mesh
@@ -149,6 +209,9 @@ private:
     // All the VAOs used in this mesh
     std::vector<VertexArrayObject> m_vaos;
 
+    // Attributes set up in each VAO, indexed like m_vaos
+    std::vector<std::vector<AttributeBinding>> m_vertexArrayAttributes;
+
     // Submeshes contained in this mesh
     std::vector<Submesh> m_submeshes;
 };
@@ -169,6 +232,8 @@ unsigned int Mesh::AddElementData(std::span<const T> elements)
 {
     unsigned int index = GetElementBufferCount();
     ElementBufferObject& ebo = m_ebos.emplace_back();
+    // Binding the EBO would attach it to the VAO currently bound
+    VertexArrayObject::Unbind();
     ebo.Bind();
     ebo.AllocateData(elements);
     ebo.Unbind();
@@ -184,11 +249,9 @@ unsigned int Mesh::AddVertexArray(unsigned int vboIndex, TIterator& it, const TI
     vao.Bind();
 
     GLuint location = 0;
-    const VertexBufferObject& vbo = GetVertexBuffer(vboIndex);
-    vbo.Bind();
     while (it != itEnd)
     {
-        SetupVertexAttribute(vao, *it, location, locations);
+        SetupVertexAttribute(vaoIndex, vboIndex, *it, location, locations);
         it++;
     }
 
@@ -203,7 +266,7 @@ unsigned int Mesh::AddVertexArray(std::span<unsigned int> vboIndices, TIterator&
 {
     unsigned int vaoIndex = AddVertexArray();
 
-    const VertexArrayObject& vao = GetVertexArray(vaoIndex);
+    VertexArrayObject& vao = GetVertexArray(vaoIndex);
     vao.Bind();
 
     GLuint location = 0;
@@ -214,11 +277,9 @@ unsigned int Mesh::AddVertexArray(std::span<unsigned int> vboIndices, TIterator&
         if (i < vboIndices.size() && vboIndex != vboIndices[i])
         {
             vboIndex = vboIndices[i];
-            VertexBufferObject& vbo = m_vbos[vboIndex];
-            vbo.Bind();
             i++;
         }
-        SetupVertexAttribute(vao, *it, location, locations);
+        SetupVertexAttribute(vaoIndex, vboIndex, *it, location, locations);
         it++;
     }
 
@@ -233,6 +294,12 @@ unsigned int Mesh::AddSubmesh(Drawcall::Primitive primitive, int firstVertex, in
     unsigned int vboIndex,
     TIterator it, const TIterator itEnd, const SemanticMap& locations)
 {
+    if (VertexArrayObject::IsSharingSupported())
+    {
+        return AddSharedSubmesh(std::span<const unsigned int>(&vboIndex, 1), -1, it, itEnd, locations,
+            Drawcall(primitive, vertexCount, Data::Type::None, firstVertex));
+    }
+
     unsigned int vaoIndex = AddVertexArray(vboIndex, it, itEnd, locations);
     return AddSubmesh(vaoIndex, primitive, firstVertex, vertexCount, Data::Type::None);
 }
@@ -242,6 +309,12 @@ unsigned int Mesh::AddSubmesh(Drawcall::Primitive primitive, int firstVertex, in
     std::span<unsigned int> vboIndices,
     TIterator it, const TIterator itEnd, const SemanticMap& locations)
 {
+    if (VertexArrayObject::IsSharingSupported())
+    {
+        return AddSharedSubmesh(std::span<const unsigned int>(vboIndices), -1, it, itEnd, locations,
+            Drawcall(primitive, vertexCount, Data::Type::None, firstVertex));
+    }
+
     unsigned int vaoIndex = AddVertexArray(vboIndices, it, itEnd, locations);
     return AddSubmesh(vaoIndex, primitive, firstVertex, vertexCount, Data::Type::None);
 }
@@ -251,18 +324,32 @@ unsigned int Mesh::AddSubmesh(Drawcall::Primitive primitive, int firstElement, i
     unsigned int vboIndex, unsigned int eboIndex,
     TIterator it, const TIterator itEnd, const SemanticMap& locations)
 {
+    return AddSubmesh(Drawcall(primitive, elementCount, elementType, firstElement), vboIndex, eboIndex, it, itEnd, locations);
+}
+
+template<typename TIterator>
+unsigned int Mesh::AddSubmesh(const Drawcall& drawcall, unsigned int vboIndex, unsigned int eboIndex,
+    TIterator it, const TIterator itEnd, const SemanticMap& locations)
+{
+    if (VertexArrayObject::IsSharingSupported())
+    {
+        return AddSharedSubmesh(std::span<const unsigned int>(&vboIndex, 1), eboIndex, it, itEnd, locations, drawcall);
+    }
+
     unsigned int vaoIndex = AddVertexArray(vboIndex, it, itEnd, locations);
 
     VertexArrayObject& vao = GetVertexArray(vaoIndex);
     vao.Bind();
 
     const ElementBufferObject& ebo = GetElementBuffer(eboIndex);
-    ebo.Bind();
+    vao.SetElementBuffer(ebo);
 
     VertexArrayObject::Unbind();
     ElementBufferObject::Unbind();
 
-    return AddSubmesh(vaoIndex, primitive, firstElement, elementCount, elementType);
+    unsigned int submeshIndex = AddSubmesh(vaoIndex, drawcall);
+    GetSubmesh(submeshIndex).eboIndex = eboIndex;
+    return submeshIndex;
 }
 
 template<typename TIterator>
@@ -270,18 +357,55 @@ unsigned int Mesh::AddSubmesh(Drawcall::Primitive primitive, int firstElement, i
     std::span<unsigned int> vboIndices, unsigned int eboIndex,
     TIterator it, const TIterator itEnd, const SemanticMap& locations)
 {
+    if (VertexArrayObject::IsSharingSupported())
+    {
+        return AddSharedSubmesh(std::span<const unsigned int>(vboIndices), eboIndex, it, itEnd, locations,
+            Drawcall(primitive, elementCount, elementType, firstElement));
+    }
+
     unsigned int vaoIndex = AddVertexArray(vboIndices, it, itEnd, locations);
 
     VertexArrayObject& vao = m_vaos[vaoIndex];
     vao.Bind();
 
     ElementBufferObject& ebo = m_ebos[eboIndex];
-    ebo.Bind();
+    vao.SetElementBuffer(ebo);
 
     VertexArrayObject::Unbind();
     ElementBufferObject::Unbind();
 
-    return AddSubmesh(vaoIndex, primitive, firstElement, elementCount, elementType);
+    unsigned int submeshIndex = AddSubmesh(vaoIndex, primitive, firstElement, elementCount, elementType);
+    GetSubmesh(submeshIndex).eboIndex = eboIndex;
+    return submeshIndex;
+}
+
+template<typename TIterator>
+unsigned int Mesh::AddSharedSubmesh(std::span<const unsigned int> vboIndices, int eboIndex,
+    TIterator& it, const TIterator itEnd, const SemanticMap& locations, const Drawcall& drawcall)
+{
+    Submesh submesh;
+    submesh.drawcall = drawcall;
+    submesh.eboIndex = eboIndex;
+
+    std::vector<VertexArrayObject::AttributeFormat> formats;
+    GLuint location = 0;
+    size_t i = 0;
+    int vboIndex = -1;
+    while (it != itEnd)
+    {
+        if (i < vboIndices.size() && vboIndex != static_cast<int>(vboIndices[i]))
+        {
+            vboIndex = static_cast<int>(vboIndices[i]);
+            i++;
+        }
+        AddSharedAttribute(submesh, formats, vboIndex, *it, location, locations);
+        it++;
+    }
+    submesh.sharedVao = VertexArrayObject::GetShared(formats);
+
+    unsigned int submeshIndex = GetSubmeshCount();
+    m_submeshes.push_back(std::move(submesh));
+    return submeshIndex;
 }
 
 template<typename TVertex, typename TIterator>
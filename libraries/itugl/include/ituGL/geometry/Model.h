@@ -1,5 +1,6 @@
 #pragma once
 
+#include <ituGL/scene/Bounds.h>
 #include <memory>
 #include <vector>
 
@@ -16,6 +17,7 @@ public:
 
     Mesh& GetMesh();
     const Mesh& GetMesh() const;
+    inline bool HasMesh() const { return m_mesh != nullptr; }
 
     void SetMesh(std::shared_ptr<Mesh> mesh);
 
@@ -36,10 +38,17 @@ public:
     // Draw all the submeshes of the mesh, each one with a material on the list
     void Draw();
 
+    // Bounds of the vertices, in model space. By default, a box from -1 to 1
+    inline const AabbBounds& GetBounds() const { return m_bounds; }
+    inline void SetBounds(const AabbBounds& bounds) { m_bounds = bounds; }
+
 private:
     // Pointer to the model Mesh
     std::shared_ptr<Mesh> m_mesh;
 
     // List of material pointers, one for each submesh
     std::vector<std::shared_ptr<Material>> m_materials;
+
+    // Bounds of the vertices, in model space
+    AabbBounds m_bounds;
 };
@@ -1,13 +1,34 @@
 #pragma once
 
 #include <ituGL/core/Object.h>
+#include <memory>
+#include <span>
+#include <vector>
 
 class VertexAttribute;
+class VertexBufferObject;
+class ElementBufferObject;
 
 // Vertex Array Object (VAO) is an OpenGL Object that stores all of the state needed to supply vertex data
 // Data is provided as a set of VertexAttributes
 class VertexArrayObject : public Object
 {
+public:
+    // Format of an attribute, and the buffer binding index it reads from
+    // With separate formats (GL 4.3), the same VertexArrayObject can read from different buffers
+    struct AttributeFormat
+    {
+        GLuint location;
+        GLint components;
+        GLenum type;
+        GLboolean normalized;
+        // Offset of the attribute inside each vertex of the buffer binding
+        GLuint relativeOffset;
+        GLuint bindingIndex;
+
+        bool operator == (const AttributeFormat& other) const = default;
+    };
+
 public:
     VertexArrayObject();
     virtual ~VertexArrayObject();
@@ -27,6 +48,35 @@ public:
     // stride: how far each element is from the previous one. Default value 0 will use the attribute size
     void SetAttribute(GLuint location, const VertexAttribute& attribute, GLint offset, GLsizei stride = 0);
 
+    // Same, reading the data from the VertexBufferObject
+    // With direct state access, neither the VertexArrayObject nor the VertexBufferObject need to be bound
+    void SetAttribute(GLuint location, const VertexAttribute& attribute, const VertexBufferObject& vbo, GLint offset, GLsizei stride = 0);
+
+    // Set the ElementBufferObject used to draw with this VertexArrayObject
+    // With direct state access, the VertexArrayObject doesn't need to be bound
+    void SetElementBuffer(const ElementBufferObject& ebo);
+
+    // Sets the format of the attribute in its location, without attaching any buffer
+    // Without direct state access, the VertexArrayObject must be bound
+    void SetAttributeFormat(const AttributeFormat& format);
+
+    // Attach the VertexBufferObject to the binding index, with the offset of the first vertex and the stride between vertices
+    // The device skips it if the same buffer is already attached. Without direct state access, the VertexArrayObject must be bound
+    void SetVertexBuffer(GLuint bindingIndex, const VertexBufferObject& vbo, GLintptr offset, GLsizei stride);
+
+    // If meshes with the same attribute formats share a VertexArrayObject, and only attach their buffers before drawing
+    // Used if the context supports separate attribute formats (GL 4.3)
+    inline static bool IsSharingSupported() { return s_sharingEnabled && GLAD_GL_VERSION_4_3; }
+
+    // Disable sharing, even if the context supports it. Only change it before creating any mesh
+    inline static void SetSharingEnabled(bool enabled) { s_sharingEnabled = enabled; }
+
+    // Get the VertexArrayObject with these attribute formats, created the first time. It is released with the last mesh using it
+    static std::shared_ptr<VertexArrayObject> GetShared(std::span<const AttributeFormat> formats);
+
+    // Number of shared VertexArrayObjects alive
+    static unsigned int GetSharedCount();
+
 #ifndef NDEBUG
     // Check if there is any VertexArrayObject currently bound
     inline static bool IsAnyBound() { return s_boundHandle != Object::NullHandle; }
@@ -34,6 +84,16 @@ public:
 
 protected:
 
+    // Shared VertexArrayObject, with the formats used to find it
+    struct SharedEntry
+    {
+        std::vector<AttributeFormat> formats;
+        std::weak_ptr<VertexArrayObject> vao;
+    };
+    static std::vector<SharedEntry> s_sharedEntries;
+
+    static bool s_sharingEnabled;
+
 #ifndef NDEBUG
     // Check if this VertexArrayObject is currently bound
     inline bool IsBound() const override { return s_boundHandle == GetHandle(); }
@@ -24,6 +24,9 @@ public:
     // Removes all the attributes
     void Clear();
 
+    // Formats are equal if they have the same attributes in the same order
+    inline bool operator == (const VertexFormat& other) const { return m_attributes == other.m_attributes; }
+
     // Adds a new attribute (for integer types)
     template<typename T>
     void AddVertexAttribute(int components, bool normalized, VertexAttribute::Semantic semantic = VertexAttribute::Semantic::Unknown);
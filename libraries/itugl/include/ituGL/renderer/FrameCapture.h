@@ -0,0 +1,203 @@
+#pragma once
+
+#include <ituGL/core/RenderState.h>
+#include <ituGL/geometry/Drawcall.h>
+#include <ituGL/geometry/VertexAttribute.h>
+#include <ituGL/lighting/Light.h>
+#include <ituGL/texture/TextureObject.h>
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Renderer;
+class Mesh;
+class Material;
+class ShaderProgram;
+
+// Records the frames submitted to the renderer in a compact binary file, to replay them without the application
+// Each frame keeps the camera, the lights, the world matrices, the drawcall packets and the names of the passes
+// Meshes, programs, materials and textures are stored once, in tables that the frames reference by index,
+// each one with a hash of its contents to compare captures
+// Vertex and element data are read back, programs are stored as driver binaries, and materials keep their keywords,
+// property values and render states, as they were the first time they were used. Textures only keep their description,
+// the replay creates them with the same size and format, without contents
+class FrameCapture
+{
+public:
+    struct TextureInfo
+    {
+        std::uint64_t hash;
+        TextureObject::Target target;
+        GLint width;
+        GLint height;
+        GLint internalFormat;
+        GLint levelCount;
+    };
+
+    // Attribute of a submesh, like Mesh::AttributeBinding
+    struct AttributeInfo
+    {
+        unsigned int vboIndex;
+        GLuint location;
+        Data::Type type;
+        int components;
+        bool normalized;
+        VertexAttribute::Semantic semantic;
+        GLint offset;
+        GLsizei stride;
+    };
+
+    struct SubmeshInfo
+    {
+        Drawcall::Primitive primitive;
+        GLint first;
+        GLsizei count;
+        Data::Type eboType;
+        GLint baseVertex;
+        // Index of the EBO, or -1 if there is none
+        int eboIndex;
+        // Empty if the mesh didn't know the attributes of the submesh. Its packets are skipped
+        std::vector<AttributeInfo> attributes;
+    };
+
+    struct MeshInfo
+    {
+        std::uint64_t hash;
+        std::vector<std::vector<std::byte>> vertexBuffers;
+        std::vector<std::vector<std::byte>> elementBuffers;
+        std::vector<SubmeshInfo> submeshes;
+    };
+
+    // Program binary, and if the renderer had functions to update its transforms and lights
+    struct ProgramInfo
+    {
+        std::uint64_t hash;
+        GLenum binaryFormat;
+        std::vector<std::byte> binary;
+        bool updateTransforms;
+        bool updateLights;
+    };
+
+    struct VariantInfo
+    {
+        unsigned int keywordMask;
+        unsigned int programIndex;
+    };
+
+    // Value of a material property. Texture properties have the index of the texture, or -1 if they had none
+    struct PropertyInfo
+    {
+        std::string name;
+        bool isTexture;
+        int textureIndex;
+        std::vector<std::byte> data;
+    };
+
+    struct MaterialInfo
+    {
+        std::uint64_t hash;
+        // Program of the material, or the variant without keywords
+        unsigned int programIndex;
+        // Keywords declared by the shader variants, the variants built and the keywords enabled. Empty without variants
+        std::vector<std::string> keywords;
+        std::vector<VariantInfo> variants;
+        unsigned int keywordMask;
+        RenderState::Desc renderState;
+        bool transparent;
+        std::vector<PropertyInfo> properties;
+    };
+
+    struct LightInfo
+    {
+        Light::Type type;
+        glm::vec3 color;
+        float intensity;
+        glm::vec3 position;
+        glm::vec3 direction;
+        // Only used by point and spot lights
+        glm::vec2 distanceAttenuation;
+        // Only used by spot lights
+        float angle;
+        glm::vec2 angleAttenuation;
+    };
+
+    // Drawcall submitted with Renderer::AddModel, with the assets as indices in the tables
+    struct Packet
+    {
+        unsigned int worldMatrixIndex;
+        unsigned int meshIndex;
+        unsigned int submeshIndex;
+        unsigned int materialIndex;
+    };
+
+    struct Frame
+    {
+        glm::mat4 viewMatrix;
+        glm::mat4 projectionMatrix;
+        std::vector<LightInfo> lights;
+        std::vector<glm::mat4> worldMatrices;
+        std::vector<Packet> packets;
+        // Passes of the renderer, in order. The replay uses its own passes
+        std::vector<std::string> passNames;
+    };
+
+public:
+    FrameCapture();
+
+    // Capture the next frames that the renderer draws, after the frames already captured
+    void Start(unsigned int frameCount);
+    inline bool IsCapturing() const { return m_remainingFrames > 0; }
+
+    // Forget the frames and the assets
+    void Clear();
+
+    // Write the frames and the assets. Returns false if the file can't be written
+    bool Save(const char* path) const;
+
+    // Read a file written with Save, replacing the frames and assets. Returns false if the file is not a valid capture
+    bool Load(const char* path);
+
+    inline const std::vector<Frame>& GetFrames() const { return m_frames; }
+    inline const std::vector<TextureInfo>& GetTextures() const { return m_textures; }
+    inline const std::vector<MeshInfo>& GetMeshes() const { return m_meshes; }
+    inline const std::vector<ProgramInfo>& GetPrograms() const { return m_programs; }
+    inline const std::vector<MaterialInfo>& GetMaterials() const { return m_materials; }
+
+    // Drawcalls not captured, because their program had no binary or their mesh didn't know their attributes
+    inline unsigned int GetSkippedPacketCount() const { return m_skippedPacketCount; }
+
+private:
+    // Called by the renderer before rendering the passes
+    void AddFrame(const Renderer& renderer);
+
+    // Add the assets the first time they are found. Return the index in the table, or -1 if they can't be captured
+    int AddTexture(const TextureObject& texture);
+    int AddMesh(const Mesh& mesh);
+    int AddProgram(const std::shared_ptr<const ShaderProgram>& shaderProgram, const Renderer& renderer);
+    int AddMaterial(const Material& material, const Renderer& renderer);
+
+    // Visit all the values of the capture, in the order they are stored in the file
+    template<typename TArchive>
+    void Serialize(TArchive& archive);
+
+    friend class Renderer;
+
+private:
+    unsigned int m_remainingFrames;
+    unsigned int m_skippedPacketCount;
+
+    std::vector<Frame> m_frames;
+    std::vector<TextureInfo> m_textures;
+    std::vector<MeshInfo> m_meshes;
+    std::vector<ProgramInfo> m_programs;
+    std::vector<MaterialInfo> m_materials;
+
+    // Index of the assets already captured, by address, or -1 if they can't be captured
+    // Only kept while capturing, the addresses could be reused later. Assets used again in a later capture are stored again
+    std::unordered_map<const void*, int> m_assetIndices;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ituGL/renderer/RenderPass.h>
+#include <ituGL/core/RenderState.h>
 
 #include <memory>
 
@@ -17,4 +18,7 @@ public:
 private:
     std::shared_ptr<Material> m_material;
     std::shared_ptr<FramebufferObject> m_framebuffer;
+
+    // Depth test always passes, so it writes directly to depth buffer
+    std::shared_ptr<const RenderState> m_renderState;
 };
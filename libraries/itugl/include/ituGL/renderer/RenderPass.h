@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 class Renderer;
 class FramebufferObject;
@@ -13,6 +14,13 @@ public:
 
     std::shared_ptr<const FramebufferObject> GetTargetFramebuffer() const;
 
+    // Name used to identify the pass in the profiler
+    const std::string& GetName() const;
+    void SetName(const std::string& name);
+
+    // Name kept by the CPU profiler, valid after the pass is destroyed
+    const char* GetProfilerZoneName() const;
+
     virtual void Render() = 0;
 
 protected:
@@ -28,4 +36,7 @@ private:
 
 private:
     Renderer* m_renderer;
+
+    std::string m_name;
+    const char* m_profilerZoneName;
 };
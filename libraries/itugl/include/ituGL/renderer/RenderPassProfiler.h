@@ -0,0 +1,138 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+class DearImGui;
+
+// Measures the GPU and CPU time of each render pass, over the last frames
+// GPU times use GL_TIME_ELAPSED queries, from a ring with one set of queries for each frame in flight
+// Results are read some frames later, only once they are available, so measuring never stalls the pipeline
+// Passes must be measured one after the other, time elapsed queries can't be nested
+class RenderPassProfiler
+{
+public:
+    // Frames that can be in flight before their queries are reused
+    static constexpr unsigned int FrameLatency = 4;
+
+    // Samples kept for each pass, unless changed with SetHistorySize
+    static constexpr unsigned int DefaultHistorySize = 256;
+
+    // Statistics of the samples in the history, in milliseconds
+    struct Summary
+    {
+        float last = 0.0f;
+        float min = 0.0f;
+        float avg = 0.0f;
+        float p99 = 0.0f;
+        unsigned int count = 0;
+    };
+
+public:
+    RenderPassProfiler();
+    ~RenderPassProfiler();
+
+    RenderPassProfiler(const RenderPassProfiler&) = delete;
+    void operator = (const RenderPassProfiler&) = delete;
+
+    // If disabled, passes are not measured, but the results already issued are still collected
+    inline bool GetEnabled() const { return m_enabled; }
+    inline void SetEnabled(bool enabled) { m_enabled = enabled; }
+
+    // Collect the results that are available, and move to the next set of queries
+    void BeginFrame();
+    void EndFrame();
+
+    // Measure a pass. passIndex identifies the pass across frames
+    void BeginPass(unsigned int passIndex, const std::string& name);
+    void EndPass(unsigned int passIndex);
+
+    inline unsigned int GetPassCount() const { return static_cast<unsigned int>(m_passes.size()); }
+    inline const std::string& GetPassName(unsigned int passIndex) const { return m_passes[passIndex].name; }
+
+    inline Summary GetGpuSummary(unsigned int passIndex) const { return m_passes[passIndex].gpuTimes.GetSummary(); }
+    inline Summary GetCpuSummary(unsigned int passIndex) const { return m_passes[passIndex].cpuTimes.GetSummary(); }
+
+    // Frames whose queries had to be reused before their results were available
+    inline unsigned int GetDroppedFrames() const { return m_droppedFrames; }
+
+    // Samples kept for each pass. Changing it forgets the samples
+    inline unsigned int GetHistorySize() const { return m_historySize; }
+    void SetHistorySize(unsigned int historySize);
+
+    // Wait for the GPU to finish the frames already issued, and collect their results. Stalls, so only use it outside the frame loop
+    void WaitForResults();
+
+    // Forget all the samples
+    void Clear();
+
+    // Write the samples of every pass, oldest first, as comma separated values. Returns false if the file can't be written
+    bool ExportCsv(const char* path) const;
+
+    // Draw the times of the passes, and a bar with the GPU time of each pass in the frame
+    void DrawGUI(DearImGui& imGui);
+
+private:
+    // Ring with the last samples, in milliseconds
+    class History
+    {
+    public:
+        void Add(float value);
+        void Clear();
+
+        // Clears the samples too
+        void SetCapacity(unsigned int capacity);
+
+        Summary GetSummary() const;
+
+        inline unsigned int GetCount() const { return m_count; }
+        // Sample by age, 0 is the oldest
+        float GetSample(unsigned int index) const;
+
+    private:
+        std::vector<float> m_values;
+        unsigned int m_count = 0;
+        unsigned int m_next = 0;
+    };
+
+    // Samples of one pass
+    struct PassTimes
+    {
+        std::string name;
+        History gpuTimes;
+        History cpuTimes;
+    };
+
+    // Queries issued in one frame, one for each pass
+    struct FrameQueries
+    {
+        std::vector<GLuint> queries;
+        // Passes measured in the frame. The queries after them were not issued
+        unsigned int passCount = 0;
+        // Results not read yet
+        bool pending = false;
+    };
+
+    // Read the results of the frames that are available, or of all the frames issued if wait is true
+    void CollectResults(bool wait = false);
+
+private:
+    bool m_enabled;
+
+    std::array<FrameQueries, FrameLatency> m_frames;
+    unsigned int m_frameIndex;
+
+    std::vector<PassTimes> m_passes;
+    unsigned int m_historySize;
+
+    // Start of the pass being measured on the CPU
+    std::chrono::steady_clock::time_point m_passStart;
+
+    unsigned int m_droppedFrames;
+
+    // Result of the last CSV export, shown in the GUI
+    std::string m_exportStatus;
+};
@@ -2,6 +2,8 @@
 
 #include <ituGL/core/DeviceGL.h>
 #include <ituGL/renderer/RenderPass.h>
+#include <ituGL/renderer/RenderPassProfiler.h>
+#include <ituGL/renderer/FrameCapture.h>
 #include <ituGL/geometry/Drawcall.h>
 #include <ituGL/geometry/Mesh.h>
 #include <glm/mat4x4.hpp>
@@ -9,6 +11,7 @@
 #include <unordered_map>
 #include <memory>
 #include <span>
+#include <string>
 #include <functional>
 
 class Camera;
@@ -25,14 +28,16 @@ class Renderer
 public:
     struct DrawcallInfo
     {
-        DrawcallInfo(const Material& material, unsigned int worldMatrixIndex, const VertexArrayObject& vao, const Drawcall& drawcall)
-            : material(material), worldMatrixIndex(worldMatrixIndex), vao(vao), drawcall(drawcall)
+        DrawcallInfo(const Material& material, unsigned int worldMatrixIndex, const Mesh& mesh, unsigned int submeshIndex)
+            : material(material), worldMatrixIndex(worldMatrixIndex), mesh(mesh), submeshIndex(submeshIndex), drawcall(mesh.GetSubmeshDrawcall(submeshIndex))
         {
         }
 
         const Material& material;
         unsigned int worldMatrixIndex;
-        const VertexArrayObject& vao;
+        // The submesh binds its VAO, and the buffers if the VAO is shared
+        const Mesh& mesh;
+        unsigned int submeshIndex;
         const Drawcall& drawcall;
     };
 
@@ -49,6 +54,14 @@ public:
 
     int AddRenderPass(std::unique_ptr<RenderPass> renderPass);
 
+    // GPU and CPU times of each render pass
+    const RenderPassProfiler& GetProfiler() const { return m_profiler; }
+    RenderPassProfiler& GetProfiler() { return m_profiler; }
+
+    // Records the frames submitted, when started
+    const FrameCapture& GetFrameCapture() const { return m_frameCapture; }
+    FrameCapture& GetFrameCapture() { return m_frameCapture; }
+
     bool HasCamera() const;
     const Camera& GetCurrentCamera() const;
     void SetCurrentCamera(const Camera& camera);
@@ -63,6 +76,10 @@ public:
     std::span<const DrawcallInfo> GetDrawcalls(unsigned int collectionIndex) const;
     void AddModel(const Model& model, const glm::mat4& worldMatrix);
 
+    // Add the drawcalls one by one, with the index of a world matrix added in the same frame. AddModel uses them
+    unsigned int AddWorldMatrix(const glm::mat4& worldMatrix);
+    void AddDrawcall(const Material& material, unsigned int worldMatrixIndex, const Mesh& mesh, unsigned int submeshIndex);
+
     const Mesh& GetFullscreenMesh() const;
 
     void RegisterShaderProgram(std::shared_ptr<const ShaderProgram> shaderProgramPtr,
@@ -75,7 +92,8 @@ public:
     UpdateLightsFunction GetDefaultUpdateLightsFunction(const ShaderProgram& shaderProgram);
     bool UpdateLights(std::shared_ptr<const ShaderProgram> shaderProgramPtr, std::span<const Light* const> lights, unsigned int& lightIndex) const;
 
-    void PrepareDrawcall(const DrawcallInfo& drawcallInfo);
+    // Use the material, with the variant for the keywords of the pass, and update the transforms
+    void PrepareDrawcall(const DrawcallInfo& drawcallInfo, std::span<const std::string> passKeywords = {});
 
     void SetLightingRenderStates(bool firstPass);
 
@@ -86,6 +104,8 @@ private:
 
     void InitializeFullscreenMesh();
 
+    friend class FrameCapture;
+
 private:
     DeviceGL& m_device;
 
@@ -107,5 +127,13 @@ private:
 
     Mesh m_fullscreenMesh;
 
+    // Render states for the first light, and for the additional lights blended on top
+    std::shared_ptr<const RenderState> m_firstLightRenderState;
+    std::shared_ptr<const RenderState> m_additionalLightRenderState;
+
     std::vector<std::unique_ptr<RenderPass>> m_passes;
+
+    RenderPassProfiler m_profiler;
+
+    FrameCapture m_frameCapture;
 };
@@ -3,6 +3,7 @@
 #include <ituGL/renderer/RenderPass.h>
 
 #include <ituGL/shader/ShaderProgram.h>
+#include <ituGL/core/RenderState.h>
 #include <memory>
 
 class TextureCubemapObject;
@@ -24,4 +25,7 @@ private:
     ShaderProgram::Location m_cameraPositionLocation;
     ShaderProgram::Location m_invViewProjMatrixLocation;
     ShaderProgram::Location m_skyboxTextureLocation;
+
+    // Only writes where depth == 1
+    std::shared_ptr<const RenderState> m_renderState;
 };
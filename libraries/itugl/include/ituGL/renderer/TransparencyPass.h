@@ -1,7 +1,12 @@
 #pragma once
 
 #include <ituGL/renderer/RenderPass.h>
+#include <ituGL/core/RenderState.h>
+#include <string>
+#include <vector>
 
+// Forward pass for transparent materials, blending the contribution of each light
+// Materials with shader variants are rendered with the FORWARD_PASS keyword enabled
 class TransparencyPass : public RenderPass
 {
 public:
@@ -12,4 +17,11 @@ public:
 
 private:
     int m_drawcallCollectionIndex;
+
+    // Keywords added to the materials rendered in this pass
+    std::vector<std::string> m_passKeywords;
+
+    // Alpha blending for the first light, and additive blending where the first light was drawn for the other lights
+    std::shared_ptr<const RenderState> m_firstLightRenderState;
+    std::shared_ptr<const RenderState> m_additionalLightRenderState;
 };
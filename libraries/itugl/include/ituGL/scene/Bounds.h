@@ -2,6 +2,7 @@
 
 #include <glm/vec3.hpp>
 #include <glm/mat3x3.hpp>
+#include <cassert>
 
 class Bounds
 {
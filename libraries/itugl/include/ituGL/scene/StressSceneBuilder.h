@@ -0,0 +1,102 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+class Scene;
+class Model;
+class Material;
+class Transform;
+
+// Fills a scene with many models and lights, to measure how the scene, the renderer and the passes scale
+// The layout only depends on the settings, so the same seed builds the same scene on any platform
+class StressSceneBuilder
+{
+public:
+    // Called for each material of a model variant, after copying it, to make it different from the others
+    using MaterialVariantFunction = std::function<void(Material& material, unsigned int variantIndex)>;
+
+    struct Settings
+    {
+        unsigned int seed = 1;
+
+        unsigned int modelCount = 1000;
+        unsigned int lightCount = 1;
+
+        // Transforms above each model. With 0, the models have no parent
+        unsigned int hierarchyDepth = 0;
+        // Children of each transform of the hierarchy
+        unsigned int hierarchyBranching = 4;
+
+        // Models and lights are placed in a box from -extent to extent, on the ground from y = 0 to extent / 4
+        float extent = 100.0f;
+
+        // Copies of the models given, each one with copies of their materials. With 0, all the instances share them
+        unsigned int modelVariantCount = 0;
+        // Optional, to change a property of the copied materials
+        MaterialVariantFunction materialVariantFunction;
+
+        // Proportion of each type of light
+        float pointLightWeight = 0.7f;
+        float spotLightWeight = 0.25f;
+        float directionalLightWeight = 0.05f;
+
+        // Prefix of the names of the nodes, so several builds can go in the same scene
+        std::string namePrefix = "stress";
+    };
+
+    // Nodes and objects created by the last build
+    struct Stats
+    {
+        unsigned int modelNodeCount = 0;
+        unsigned int lightNodeCount = 0;
+        unsigned int pointLightCount = 0;
+        unsigned int spotLightCount = 0;
+        unsigned int directionalLightCount = 0;
+        unsigned int hierarchyTransformCount = 0;
+        unsigned int modelCount = 0;
+        unsigned int materialCount = 0;
+    };
+
+public:
+    StressSceneBuilder(const Settings& settings);
+
+    // Add the models and the lights to the scene. Each instance uses one of the models, or one of their variants
+    void Build(Scene& scene, std::span<const std::shared_ptr<Model>> models);
+
+    inline const Settings& GetSettings() const { return m_settings; }
+    inline const Stats& GetStats() const { return m_stats; }
+
+private:
+    // Deterministic generator. The standard distributions are not, their results change between implementations
+    class Random
+    {
+    public:
+        Random(unsigned int seed);
+
+        // Uniform in [0, 1)
+        float GetFloat();
+        float GetFloat(float min, float max);
+        unsigned int GetIndex(unsigned int count);
+
+    private:
+        // The engine is specified by the standard, only its output is used
+        std::mt19937 m_engine;
+    };
+
+    std::vector<std::shared_ptr<Model>> CreateModelVariants(std::span<const std::shared_ptr<Model>> models);
+
+    // Transforms of the deepest level of the hierarchy
+    std::vector<std::shared_ptr<Transform>> CreateHierarchy(Random& random);
+
+    void AddModels(Scene& scene, std::span<const std::shared_ptr<Model>> models, Random& random);
+    void AddLights(Scene& scene, Random& random);
+
+private:
+    Settings m_settings;
+    Stats m_stats;
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <ituGL/scene/SceneVisitor.h>
+
+class TextureStreamingManager;
+class Camera;
+class SceneModel;
+
+// Requests the texture levels needed by each model, from its size on screen seen from the camera
+class TextureStreamingSceneVisitor : public SceneVisitor
+{
+public:
+    TextureStreamingSceneVisitor(TextureStreamingManager& streamingManager, const Camera& camera, int viewportHeight);
+
+    void VisitModel(SceneModel& sceneModel) override;
+
+private:
+    TextureStreamingManager& m_streamingManager;
+    const Camera& m_camera;
+    int m_viewportHeight;
+};
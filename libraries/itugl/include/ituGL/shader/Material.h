@@ -1,9 +1,11 @@
 #pragma once
 
 #include <ituGL/shader/ShaderUniformCollection.h>
+#include <ituGL/shader/ShaderProgramVariants.h>
 
-#include <ituGL/core/Color.h>
+#include <ituGL/core/RenderState.h>
 #include <functional>
+#include <unordered_map>
 #include <array>
 
 // Class to group all the properties that may affect the look of a rendered geometry
@@ -20,17 +22,17 @@ public:
     };
 
     // Different conditions for depth and stencil tests
-    enum class TestFunction : GLenum;
+    using TestFunction = RenderState::TestFunction;
 
     // Operation to perform when a stencil condition is met
-    enum class StencilOperation : GLenum;
+    using StencilOperation = RenderState::StencilOperation;
 
     // Different types of blending equations
-    enum class BlendEquation : GLenum;
+    using BlendEquation = RenderState::BlendEquation;
 
     // Parameters to be used to control each of the 4 components of the blending equation:
     // source color, destination color, source alpha, destination alpha
-    enum class BlendParam : GLenum;
+    using BlendParam = RenderState::BlendParam;
 
     // Function pointer to prepare the shader used by the material that is being rendered
     using ShaderSetupFunction = std::function<void(ShaderProgram&)>;
@@ -39,6 +41,19 @@ public:
     Material();
     // Initialize with the shader program, will extract all the properties. Skip the names in filtered uniforms
     Material(std::shared_ptr<ShaderProgram> shaderProgram, const NameSet& filteredUniforms = NameSet());
+    // Initialize with the variant without keywords, that defines the properties. Other variants are selected when used
+    Material(std::shared_ptr<ShaderProgramVariants> shaderVariants, const NameSet& filteredUniforms = NameSet());
+
+    // The shader variants, or null if the material uses a single shader program
+    inline std::shared_ptr<ShaderProgramVariants> GetShaderVariants() const { return m_shaderVariants; }
+
+    // Enable or disable a keyword declared by the shader variants
+    bool IsKeywordEnabled(const std::string& keyword) const;
+    void SetKeyword(const std::string& keyword, bool enabled);
+
+    // Get the shader program for the material keywords plus the keywords of the pass. Keywords not declared are ignored
+    // Without shader variants, it is always the shader program of the material
+    std::shared_ptr<const ShaderProgram> GetVariant(std::span<const std::string> passKeywords = {}) const;
 
 
     // The function that will be executed for additional shader program setup
@@ -101,128 +116,48 @@ public:
     // Set the blend color to use with ConstantColor param
     void SetBlendColor(Color blendColor);
 
+    // Block with the depth, stencil and blend states. Created again after changing any of them
+    const RenderState& GetRenderState() const;
+    // Set all the depth, stencil and blend states at once
+    void SetRenderState(const RenderState::Desc& desc);
+
 
     // Use the shader program, set all uniforms, set depth properties, stencil properties, and blending
     // You can skip depth, stencil or blending using the override flags
     void Use(OverrideFlags overrideFlags = OverrideFlags::NoOverride) const;
+    // Same, using the variant for the material keywords plus the keywords of the pass
+    void Use(std::span<const std::string> passKeywords, OverrideFlags overrideFlags = OverrideFlags::NoOverride) const;
 
     void SetTransparency(bool isTransparent);
 
     const bool GetTransparency() const;
 
 private:
-    // Set all the properties relative to depth
-    void UseDepthTest() const;
+    // Get the variant for the material keywords plus the keywords of the pass
+    std::shared_ptr<ShaderProgram> GetVariant(std::span<const std::string> passKeywords, ShaderProgramVariants::KeywordMask& keywordMask) const;
 
-    // Set all the properties relative to stencil
-    void UseStencilTest() const;
-
-    // Set all the properties relative to blending
-    void UseBlend() const;
+    // Get the states to change them. The block is created again on the next use
+    RenderState::Desc& GetRenderStateDesc();
 
 private:
     // Function pointer to prepare the shader used by the material
     ShaderSetupFunction m_shaderSetupFunction;
 
-    // Test function for depth. Default: Less
-    TestFunction m_depthTestFunction;
+    // Variants of the shader program, selected by keywords
+    std::shared_ptr<ShaderProgramVariants> m_shaderVariants;
+
+    // Keywords enabled in the material
+    ShaderProgramVariants::KeywordMask m_keywordMask;
 
-    // If it should write to depth or not. Default: True
-    bool m_depthWrite;
+    // Locations of the properties in the other variants used, by keyword mask
+    mutable std::unordered_map<ShaderProgramVariants::KeywordMask, std::vector<ShaderProgram::Location>> m_variantLocations;
 
     // If the material should be treated as transparent
     bool m_isTransparent;
 
-    // Test functions for front and back stencil. Default: Never
-    std::array<TestFunction, 2> m_stencilTestFunctions;
-
-    // Ref values for front and back stencil. Default: 0
-    std::array<int, 2> m_stencilRefValues;
-
-    // Mask for front and back stencil. Default: ~0
-    std::array<unsigned int, 2> m_stencilMasks;
-
-    // Stencil operation to perform if stencil test fails, front and back. Default: Keep
-    std::array<StencilOperation, 2> m_stencilFail;
-
-    // Stencil operation to perform if depth test fails, front and back. Default: Keep
-    std::array<StencilOperation, 2> m_stencilDepthFail;
-
-    // Stencil operation to perform if depth test passes, front and back. Default: Keep
-    std::array<StencilOperation, 2>m_stencilDepthPass;
-
-    // Blend equation for color and alpha. Default: None
-    std::array<BlendEquation, 2> m_blendEquations;
-
-    // Blend parameters for source color, destination color, source alpha and destination alpha
-    // Default: One, Zero, One, Zero
-    std::array<BlendParam, 4> m_blendParams;
+    // Depth, stencil and blend states
+    RenderState::Desc m_renderStateDesc;
 
-    // Blend color to use with ConstantColor or ConstantAlpha parameters. Default: white
-    Color m_blendColor;
-};
-
-// Different conditions for depth and stencil tests
-enum class Material::TestFunction : GLenum
-{
-    Always = GL_ALWAYS,
-    Never = GL_NEVER,
-    Equal = GL_EQUAL,
-    NotEqual = GL_NOTEQUAL,
-    Less = GL_LESS,
-    LessEqual = GL_LEQUAL,
-    Greater = GL_GREATER,
-    GreaterEqual = GL_GEQUAL
-};
-
-// Operation to perform when a stencil condition is met
-enum class Material::StencilOperation : GLenum
-{
-    // Keep the same value (do nothing)
-    Keep = GL_KEEP,
-    // Set the value to zero (only the bits affected by the mask)
-    Zero = GL_ZERO,
-    // Replace the value with the reference value (only the bits affected by the mask)
-    Replace = GL_REPLACE,
-    // Increase the value. If the maximum is reached, do nothing
-    Increase = GL_INCR,
-    // Increase the value. If the maximum is reached, back to 0
-    IncreaseWrap = GL_INCR_WRAP,
-    // Decrease the value. If 0 is reached, do nothing
-    Decrease = GL_DECR,
-    // Decrease the value. If 0 is reached, set to maximum value
-    DecreaseWrap = GL_DECR_WRAP,
-    // Invert the bits affected by the mask
-    Invert = GL_INVERT
-};
-
-// Different types of blending equations
-enum class Material::BlendEquation : GLenum
-{
-    None = GL_NONE,
-    Add = GL_FUNC_ADD,
-    Substract = GL_FUNC_SUBTRACT,
-    ReverseSubstract = GL_FUNC_REVERSE_SUBTRACT,
-    Min = GL_MIN,
-    Max = GL_MAX
-};
-
-// Parameters to be used to control each of the 4 components of the blending equation:
-// source color, destination color, source alpha, destination alpha
-enum class Material::BlendParam : GLenum
-{
-    Zero = GL_ZERO,
-    One = GL_ONE,
-    SourceColor = GL_SRC_COLOR,
-    OneMinusSourceColor = GL_ONE_MINUS_SRC_COLOR,
-    SourceAlpha = GL_SRC_ALPHA,
-    OneMinusSourceAlpha = GL_ONE_MINUS_SRC_ALPHA,
-    DestColor = GL_DST_COLOR,
-    OneMinusDestColor = GL_ONE_MINUS_DST_COLOR,
-    DestAlpha = GL_DST_ALPHA,
-    OneMinusDestAlpha = GL_ONE_MINUS_DST_ALPHA,
-    ConstantColor = GL_CONSTANT_COLOR,
-    OneMinusConstantColor = GL_ONE_MINUS_CONSTANT_COLOR,
-    ConstantAlpha = GL_CONSTANT_ALPHA,
-    OneMinusConstantAlpha = GL_ONE_MINUS_CONSTANT_ALPHA
+    // Block with the states, or null if they changed since it was created
+    mutable std::shared_ptr<const RenderState> m_renderState;
 };
@@ -47,6 +47,10 @@ public:
     // Compile the shader source code
     bool Compile();
 
+    // Start compiling the shader source code, without waiting for the result. Check it later with IsCompiled
+    // With GL_KHR_parallel_shader_compile, the driver compiles it in the background until then
+    void SubmitCompile();
+
     // Check if the shader has been successfully compiled
     bool IsCompiled() const;
 
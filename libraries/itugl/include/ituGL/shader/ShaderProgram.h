@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ituGL/core/Object.h>
+#include <ituGL/shader/ShaderUniform.h>
 
 // Include the glm types for vectors and matrices
 #include <glm/vec2.hpp>
@@ -17,6 +18,9 @@
 #include <glm/mat4x4.hpp>
 
 #include <span>
+#include <vector>
+#include <cstddef>
+#include <type_traits>
 
 class Shader;
 class TextureObject;
@@ -29,6 +33,15 @@ public:
     // Declare the type used for uniform locations
     using Location = GLint;
 
+    // Counters of the uniform uploads of all the programs
+    struct UniformStats
+    {
+        // glUniform calls issued
+        unsigned int uploads = 0;
+        // Uploads skipped, because the program already had the same values
+        unsigned int skipped = 0;
+    };
+
 public:
     ShaderProgram();
     virtual ~ShaderProgram();
@@ -71,9 +84,26 @@ public:
         return Build(vertexShader, fragmentShader, tesselationControlShader, &tesselationEvaluationShader, &geometryShader);
     }
 
+    // Attach the shaders and start linking, without waiting for the result. Check it later with IsLinked
+    // With GL_KHR_parallel_shader_compile, the driver links in the background until then
+    void SubmitBuild(const Shader& computeShader);
+    void SubmitBuild(const Shader& vertexShader, const Shader& fragmentShader,
+        const Shader* tesselationControlShader, const Shader* tesselationEvaluationShader,
+        const Shader* geometryShader);
+
     // Check if shaders have been linked to create a valid program
     bool IsLinked() const;
 
+    // Hint the driver to keep the binary of the program available. Must be set before linking
+    void SetBinaryRetrievable(bool retrievable);
+
+    // Get the binary of the linked program, in a format that depends on the driver
+    bool GetBinary(GLenum& format, std::vector<std::byte>& binary) const;
+
+    // Load a binary obtained with GetBinary, instead of attaching and linking shaders
+    // Returns false if the driver rejected it, for example after a driver update
+    bool SetBinary(GLenum format, std::span<const std::byte> binary);
+
     // Get a string with linking error messages
     // The max length of the string returned is determined by the capacity of the span
     void GetLinkingErrors(std::span<char> errors) const;
@@ -84,12 +114,34 @@ public:
     // Find a uniform location by name
     Location GetUniformLocation(const char *name) const;
 
+    // Get the location of a uniform with a fixed location in the shaders, or -1 if the program doesn't use it
+    // Members of uniform blocks don't have a location, they always get -1
+    // It is found by name the first time, and then stored by its fixed location
+    template<typename T>
+    Location GetUniformLocation(const ShaderUniform<T>& uniform) const;
+
+    // If the driver supports GL_ARB_explicit_uniform_location, so the locations fixed in the shaders are used
+    // Otherwise the driver assigns the locations, and they can be different in each program
+    inline static bool HasExplicitUniformLocations() { return s_explicitUniformLocations; }
+
     // Get how many uniforms exist in this shader program
     unsigned int GetUniformCount() const;
 
     // Get information about a specific uniform
     void GetUniformInfo(unsigned int index, int& size, GLenum& glType, std::span<char> uniformName) const;
 
+    // Get the uniform block of a uniform, or -1 if it is not in a block, and where the uniform is stored inside the block
+    void GetUniformBlockLayout(unsigned int index, int& blockIndex, int& offset, int& arrayStride, int& matrixStride) const;
+
+    // Find a uniform block by name, or -1 if the program doesn't use it
+    int GetUniformBlockIndex(const char* name) const;
+
+    // Get the name and the size in bytes of a uniform block
+    void GetUniformBlockInfo(int blockIndex, int& dataSize, std::span<char> blockName) const;
+
+    // Set the binding point where the program reads the uniform block from
+    void SetUniformBlockBinding(int blockIndex, GLuint binding) const;
+
     // Template method combinations to simplify getting uniforms
     template<typename T>
     void GetUniform(Location location, T& value) const;
@@ -101,6 +153,7 @@ public:
     void GetUniforms(Location location, std::span<T> values) const;
 
     // Template method combinations to simplify setting uniforms
+    // The program must be in use, unless the device has direct state access
     template<typename T>
     void SetUniform(Location location, const T& value) const;
     template<typename T>
@@ -110,12 +163,46 @@ public:
     template<typename T, int C, int R>
     void SetUniforms(Location location, std::span<const glm::mat<C, R, T>> values) const;
 
+    // Set a uniform with a fixed location in the shaders. The value must convert to the type of the uniform
+    template<typename T>
+    void SetUniform(const ShaderUniform<T>& uniform, const std::type_identity_t<T>& value) const;
+
     // Set texture value for a texture uniform
     void SetTexture(Location location, GLint textureUnit, const TextureObject& texture) const;
+    inline void SetTexture(const ShaderUniform<TextureObject>& uniform, GLint textureUnit, const TextureObject& texture) const
+    {
+        SetTexture(GetUniformLocation(uniform), textureUnit, texture);
+    }
+
+    // Set texture value for a texture uniform, in the texture unit of its location
+    inline void SetTexture(Location location, const TextureObject& texture) const
+    {
+        SetTexture(location, GetTextureUnit(location), texture);
+    }
+    inline void SetTexture(const ShaderUniform<TextureObject>& uniform, const TextureObject& texture) const
+    {
+        SetTexture(GetUniformLocation(uniform), texture);
+    }
+
+    // Texture unit for the texture uniform in the location, assigned the first time and kept after
+    // With fixed locations, each location gets the same unit in all the programs, so textures can stay bound when switching them
+    // If the fixed locations need more units than GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, the units are assigned per program
+    GLint GetTextureUnit(Location location) const;
 
     // Set the shader program as the active one to be used for rendering
     void Use() const;
 
+    // Check if the program still has the values that a ShaderUniformCollection set with this version
+    // If it does, the uploads of its uniformCount values are counted as skipped
+    bool CheckUniformSource(unsigned int version, unsigned int uniformCount) const;
+
+    // Record that the values in the locations were set by a ShaderUniformCollection with this version
+    // If anything else changes one of them, the program doesn't have that version anymore
+    void SetUniformSource(unsigned int version, std::span<const Location> locations) const;
+
+    inline static const UniformStats& GetUniformStats() { return s_uniformStats; }
+    inline static void ResetUniformStats() { s_uniformStats = UniformStats(); }
+
 private:
     // Build (Attach and link) all shaders provided for the rasterization pipeline
     bool Build(const Shader& vertexShader, const Shader& fragmentShader,
@@ -128,6 +215,25 @@ private:
     // Link currently attached shaders
     bool Link();
 
+    // Start linking the attached shaders, the status is not queried
+    void SubmitLink();
+
+    // Find the uniform by name the first time, and store the location by its fixed location
+    Location ResolveUniformLocation(Location fixedLocation, const char* name) const;
+
+    // Compare the values with the last ones uploaded to the location, and store them if they are different
+    // Returns false if the upload can be skipped
+    bool UpdateUniformShadow(Location location, const void* values, size_t size) const;
+
+    // Forget the values uploaded, linking resets them
+    void ResetUniformShadow();
+
+    // Forget the texture units assigned to the locations, linking can change the locations
+    void ResetTextureUnits();
+
+    // Check the driver extensions and the texture unit limit, the first time a program is created
+    static void QueryDriverSupport();
+
     // Helper template method for getting uniforms
     template<typename T>
     void GetUniform(Location location, std::span<T> value) const;
@@ -139,6 +245,41 @@ private:
     void SetUniforms(Location location, const T* values, GLsizei count) const;
 
 private:
+    // Locations found by ResolveUniformLocation, indexed by fixed location. Cleared when the program is linked
+    mutable std::vector<Location> m_resolvedUniformLocations;
+
+    // Last values uploaded to a location, stored in m_uniformShadowValues
+    struct UniformShadow
+    {
+        unsigned int offset = 0;
+        unsigned int size = 0;
+        // Set by a ShaderUniformCollection, see SetUniformSource
+        bool fromSource = false;
+    };
+
+    // Shadow of the uniform values, indexed by location
+    mutable std::vector<UniformShadow> m_uniformShadows;
+    mutable std::vector<std::byte> m_uniformShadowValues;
+
+    // Version of the ShaderUniformCollection that set the values, 0 if none or if they were changed after
+    mutable unsigned int m_uniformSourceVersion;
+
+    // Texture units assigned to the locations, -1 if not assigned. Only used without shared texture units
+    mutable std::vector<GLint> m_textureUnits;
+    mutable GLint m_textureUnitCount;
+
+    static UniformStats s_uniformStats;
+
+    static bool s_driverQueried;
+    static bool s_explicitUniformLocations;
+    static GLint s_maxTextureUnits;
+
+    // Texture units assigned to the fixed locations, shared by all the programs
+    // Disabled when there are no fixed locations, or when the locations need more units than the driver has
+    static bool s_sharedTextureUnits;
+    static std::vector<GLint> s_textureUnits;
+    static GLint s_textureUnitCount;
+
 #ifndef NDEBUG
     inline bool IsUsed() const { return s_usedHandle == GetHandle(); }
     static Handle s_usedHandle;
@@ -153,6 +294,13 @@ template<> void ShaderProgram::GetUniform<GLuint>(Location location, std::span<G
 template<> void ShaderProgram::GetUniform<GLfloat>(Location location, std::span<GLfloat> valueBytes) const;
 template<> void ShaderProgram::GetUniform<GLdouble>(Location location, std::span<GLdouble> valueBytes) const;
 
+template<typename T>
+inline ShaderProgram::Location ShaderProgram::GetUniformLocation(const ShaderUniform<T>& uniform) const
+{
+    // Even with explicit locations, the uniforms that the program doesn't use have to be found, to skip them
+    return ResolveUniformLocation(uniform.location, uniform.name);
+}
+
 template<typename T>
 void ShaderProgram::GetUniform(Location location, T& value) const
 {
@@ -187,6 +335,12 @@ void ShaderProgram::SetUniform(Location location, const T& value) const
     SetUniforms(location, std::span(&value, 1));
 }
 
+template<typename T>
+inline void ShaderProgram::SetUniform(const ShaderUniform<T>& uniform, const std::type_identity_t<T>& value) const
+{
+    SetUniform(GetUniformLocation(uniform), value);
+}
+
 template<typename T>
 void ShaderProgram::SetUniforms(Location location, std::span<const T> values) const
 {
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+#include <string>
+#include <vector>
+#include <memory>
+#include <span>
+
+class ShaderProgram;
+
+// Set of shader programs built from the same source files, each one with a different combination of keywords
+// Each enabled keyword is added to the sources as a define, so the shaders can use #ifdef instead of branching on uniforms
+// Variants are built the first time they are requested, or in advance with Prewarm
+class ShaderProgramVariants
+{
+public:
+    // One bit for each keyword, in the order they were declared
+    using KeywordMask = unsigned int;
+
+    // Function called once for each variant built, for example to register it with the renderer
+    using VariantCreatedFunction = std::function<void(std::shared_ptr<ShaderProgram>)>;
+
+public:
+    // Declare the source files, and the keywords that the shaders support
+    ShaderProgramVariants(std::span<const char*> vertexShaderPaths, std::span<const char*> fragmentShaderPaths,
+        std::span<const char* const> keywords);
+
+    inline const std::vector<std::string>& GetKeywords() const { return m_keywords; }
+
+    // Index of the keyword, or -1 if it is not declared
+    int GetKeywordIndex(const std::string& keyword) const;
+
+    // Mask with the bits of the keywords. Keywords not declared are ignored
+    KeywordMask GetKeywordMask(std::span<const std::string> keywords) const;
+
+    // Get the variant with the keywords in the mask, building it if needed
+    std::shared_ptr<ShaderProgram> GetVariant(KeywordMask keywordMask);
+
+    // Build all the variants in the list that don't exist yet, in one batch
+    void Prewarm(std::span<const KeywordMask> keywordMasks);
+
+    inline unsigned int GetVariantCount() const { return static_cast<unsigned int>(m_variants.size()); }
+
+    // Variants built so far, by keyword mask
+    inline const std::unordered_map<KeywordMask, std::shared_ptr<ShaderProgram>>& GetVariants() const { return m_variants; }
+
+    // Add a variant built outside, for example from a program binary, replacing any variant with the same mask
+    void AddVariant(KeywordMask keywordMask, std::shared_ptr<ShaderProgram> shaderProgram);
+
+    // Set the function to call for each new variant. It is also called for the variants already built
+    void SetVariantCreatedFunction(VariantCreatedFunction variantCreatedFunction);
+
+private:
+    // Get the defines for the keywords in the mask
+    void GetDefines(KeywordMask keywordMask, std::vector<std::string>& defines) const;
+
+private:
+    std::vector<std::string> m_vertexShaderPaths;
+    std::vector<std::string> m_fragmentShaderPaths;
+
+    std::vector<std::string> m_keywords;
+
+    // Variants built, by keyword mask
+    std::unordered_map<KeywordMask, std::shared_ptr<ShaderProgram>> m_variants;
+
+    VariantCreatedFunction m_variantCreatedFunction;
+};
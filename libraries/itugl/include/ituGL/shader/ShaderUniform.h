@@ -0,0 +1,18 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// Uniform declared in the shaders with a fixed location, and the C++ type of its value
+// They are generated from the shaders with GenerateShaderInterface.cmake, so the code doesn't need to look up uniforms by name
+// Texture uniforms use TextureObject as type
+template<typename T>
+struct ShaderUniform
+{
+    using Type = T;
+
+    // Location fixed in the shaders
+    GLint location;
+
+    // Name in the shaders, to find the location if the driver doesn't support explicit uniform locations
+    const char* name;
+};
@@ -1,21 +1,37 @@
 #pragma once
 
 #include <ituGL/shader/ShaderProgram.h>
+#include <ituGL/shader/UniformBufferArena.h>
 #include <ituGL/texture/TextureObject.h>
 #include <ituGL/core/Data.h>
 #include <vector>
-#include <unordered_map>
 #include <unordered_set>
+#include <unordered_map>
 #include <string>
 #include <cstring>
 #include <memory>
 
+// If the shader declares the data properties in a uniform block, the values are stored in a slice of the shared UniformBufferArena
+// Changing a property only writes the range that changed, and using the collection binds its slice to BlockBinding
 class ShaderUniformCollection
 {
 public:
     // Alias for a set of names
     using NameSet = std::unordered_set<std::string>;
 
+    // Binding point where the programs read the uniform block of the properties
+    static const GLuint BlockBinding = 0;
+
+    // Value of a property, to copy it by name to a collection of a program built from the same sources
+    // Data properties keep their values as bytes, and texture properties keep the texture
+    struct PropertyValue
+    {
+        std::string name;
+        bool isTexture = false;
+        std::vector<std::byte> data;
+        std::shared_ptr<TextureObject> texture;
+    };
+
 public:
     ShaderUniformCollection();
     // Initialize with the shader program, will extract all the properties. Skip the names in filtered uniforms
@@ -62,9 +78,35 @@ public:
     template<typename T>
     void SetUniformValues(ShaderProgram::Location location, std::span<const T> value);
 
+    // Set uniform value using a uniform with a fixed location in the shaders
+    template<typename T>
+    void SetUniformValue(const ShaderUniform<T>& uniform, const std::type_identity_t<T>& value);
+    template<typename T>
+    void SetUniformValue(const ShaderUniform<TextureObject>& uniform, const std::shared_ptr<T>& value);
+
     // Set all the properties to the shader. Requires the shader program to be in use
+    // Only the values that the program doesn't have yet are uploaded
     void SetUniforms() const;
 
+    // Get the locations of the properties in another program built from the same sources, like a variant, matching them by name
+    // Properties that the other program doesn't use get -1
+    void GetUniformLocations(const ShaderProgram& shaderProgram, std::vector<ShaderProgram::Location>& locations) const;
+
+    // Set all the properties to the other program, with the locations returned by GetUniformLocations. Requires that program to be in use
+    void SetUniforms(const ShaderProgram& shaderProgram, std::span<const ShaderProgram::Location> locations) const;
+
+    // Changes every time a property changes. Unique among all the collections, except for copies with the same values
+    inline unsigned int GetVersion() const { return m_version; }
+
+    // Append the textures assigned to texture uniforms. Uniforms without texture are skipped
+    void GetTextures(std::vector<const TextureObject*>& textures) const;
+
+    // Append the values of all the properties
+    void GetPropertyValues(std::vector<PropertyValue>& values) const;
+
+    // Set the properties with the same name, kind and size as the values. Returns how many were set
+    unsigned int SetPropertyValues(std::span<const PropertyValue> values);
+
 private:
     // Different dimensions of the properties
     enum class UniformDimension
@@ -91,6 +133,11 @@ private:
         unsigned int count;
         // Index in the data buffer
         int index;
+        // Offset in the uniform block, or -1 if the property is not in the block
+        int blockOffset;
+        // Distance between the elements of an array, and between the columns of a matrix, in the uniform block
+        int arrayStride;
+        int matrixStride;
     };
 
     // Struct to store a texture property
@@ -104,6 +151,22 @@ private:
         std::shared_ptr<TextureObject> texture;
     };
 
+    // Slice of the shared uniform buffer with the values of the block. A copy gets its own slice, with the same contents
+    struct BlockStorage
+    {
+        BlockStorage() = default;
+        BlockStorage(const BlockStorage& blockStorage);
+        BlockStorage& operator = (const BlockStorage& blockStorage);
+        ~BlockStorage();
+
+        void Allocate(size_t size);
+        void Free();
+
+        // Kept until the slice is freed
+        std::shared_ptr<UniformBufferArena> arena;
+        UniformBufferArena::Slice slice;
+    };
+
 private:
     // Get a data uniform
     DataUniform& GetDataUniform(ShaderProgram::Location location);
@@ -129,11 +192,20 @@ private:
     void AddUniform(const DataUniform& uniform);
     void AddUniform(const TextureUniform& uniform);
 
-    // Use uniform property
-    void UseUniform(const DataUniform& uniform) const;
+    // Copy the values of a property in the uniform block to the block data, so they are uploaded on the next use
+    void WriteBlockValues(const DataUniform& uniform);
+
+    // Upload the block data that changed, and bind the slice
+    void UseUniformBlock() const;
+
+    // Make the program read the uniform block from BlockBinding
+    void SetupUniformBlock(const ShaderProgram& shaderProgram) const;
+
+    // Use uniform property, setting it at the location of the target program
+    void UseUniform(const DataUniform& uniform, const ShaderProgram& targetProgram, ShaderProgram::Location targetLocation) const;
     template<typename T>
-    void UseUniform(const DataUniform& uniform) const;
-    void UseUniform(const TextureUniform& uniform) const;
+    void UseUniform(const DataUniform& uniform, const ShaderProgram& targetProgram, ShaderProgram::Location targetLocation) const;
+    void UseUniform(const TextureUniform& uniform, const ShaderProgram& targetProgram, ShaderProgram::Location targetLocation) const;
 
     // Get the buffer where data values are stored for a certain type
     template<typename T>
@@ -155,12 +227,21 @@ private:
     template<typename T, int C, int R>
     void GetDataValues(ShaderProgram::Location location, std::span<const glm::mat<C, R, T>>& values) const;
 
+    // Get the stored values of a data property, as bytes
+    const std::byte* GetDataBytes(const DataUniform& uniform) const;
+
     // Get the size of a data property
     int GetDataUniformSize(const DataUniform& uniform) const;
 
+    // Get the columns of a dimension, and the components in each column
+    static void GetDimensionSize(UniformDimension dimension, int& columns, int& rows);
+
     // Delete all the properties and set the shader program to null
     void Reset();
 
+    // Take a new version after changing a property
+    inline void UpdateVersion() { m_version = ++s_lastVersion; }
+
 #ifndef NDEBUG
     bool IsScalar(UniformDimension dimension) const;
     bool IsVector(UniformDimension dimension) const;
@@ -179,10 +260,30 @@ private:
     // The list of texture properties
     std::vector<TextureUniform> m_textureUniforms;
 
-    // Map to find data properties in the data list
-    std::unordered_map<ShaderProgram::Location, int> m_locationDataIndex;
-    // Map to find texture properties in the texture list
-    std::unordered_map<ShaderProgram::Location, int> m_locationTextureIndex;
+    // Index of the data property in each location, or -1
+    std::vector<int> m_locationDataIndex;
+    // Index of the texture property in each location, or -1
+    std::vector<int> m_locationTextureIndex;
+
+    // Locations of the data properties and then the texture properties, as GetUniformLocations returns them for our program
+    std::vector<ShaderProgram::Location> m_uniformLocations;
+
+    // Uniform block where the shader declares the data properties, or empty if there is none
+    std::string m_blockName;
+    // The properties in the block don't have a location in the program, they get one after the last location of the program
+    std::unordered_map<std::string, ShaderProgram::Location> m_blockLocations;
+    // Number of data properties in the block
+    unsigned int m_blockUniformCount;
+    // Values of the block, in the layout of the program
+    std::vector<std::byte> m_blockData;
+    // Range of the block data changed since it was uploaded. Empty if the begin is not before the end
+    mutable size_t m_blockDirtyBegin;
+    mutable size_t m_blockDirtyEnd;
+    BlockStorage m_blockStorage;
+
+    // Version of the values, shared by all the collections so the versions are never reused
+    unsigned int m_version;
+    static unsigned int s_lastVersion;
 
     // Buffers that store the values for data properties
     std::vector<int> m_intDataValues;
@@ -219,7 +320,7 @@ inline void ShaderUniformCollection::GetUniformValue(const char* name, T& value)
 template<typename T>
 inline void ShaderUniformCollection::GetUniformValue(ShaderProgram::Location location, T& value) const
 {
-    GetUniformValue(location, std::span(&value, 1));
+    GetUniformValues(location, std::span(&value, 1));
 }
 
 template<typename T>
@@ -277,6 +378,31 @@ void ShaderUniformCollection::SetUniformValue(ShaderProgram::Location location,
 template<>
 void ShaderUniformCollection::SetUniformValue(ShaderProgram::Location location, const std::shared_ptr<TextureObject>& value);
 
+template<typename T>
+inline void ShaderUniformCollection::SetUniformValue(const ShaderUniform<T>& uniform, const std::type_identity_t<T>& value)
+{
+    ShaderProgram::Location location = m_shaderProgram->GetUniformLocation(uniform);
+    if (location < 0 && !m_blockLocations.empty())
+    {
+        // Properties in the uniform block are found by name
+        location = GetUniformLocation(uniform.name);
+    }
+    if (location >= 0)
+    {
+        SetUniformValue(location, value);
+    }
+}
+
+template<typename T>
+inline void ShaderUniformCollection::SetUniformValue(const ShaderUniform<TextureObject>& uniform, const std::shared_ptr<T>& value)
+{
+    ShaderProgram::Location location = m_shaderProgram->GetUniformLocation(uniform);
+    if (location >= 0)
+    {
+        SetUniformValue(location, value);
+    }
+}
+
 template<typename T>
 inline void ShaderUniformCollection::SetUniformValues(const char* name, std::span<const T> values)
 {
@@ -292,6 +418,11 @@ void ShaderUniformCollection::SetUniformValues(ShaderProgram::Location location,
     GetDataValues(location, storedValues);
     assert(values.size() == storedValues.size());
     std::memcpy(storedValues.data(), values.data(), values.size_bytes());
+    if (!m_blockName.empty())
+    {
+        WriteBlockValues(GetDataUniform(location));
+    }
+    UpdateVersion();
 }
 
 template<typename T>
@@ -366,7 +497,11 @@ void ShaderUniformCollection::GetDataValues(ShaderProgram::Location location, st
 template<typename T>
 void ShaderUniformCollection::AddUniform(const DataUniform& uniform)
 {
-    m_locationDataIndex.insert(std::make_pair(uniform.location, static_cast<int>(m_dataUniforms.size())));
+    if (uniform.location >= static_cast<ShaderProgram::Location>(m_locationDataIndex.size()))
+    {
+        m_locationDataIndex.resize(uniform.location + 1, -1);
+    }
+    m_locationDataIndex[uniform.location] = static_cast<int>(m_dataUniforms.size());
     m_dataUniforms.push_back(uniform);
 
     std::vector<T>& values = GetDataValues<T>();
@@ -376,25 +511,25 @@ void ShaderUniformCollection::AddUniform(const DataUniform& uniform)
 }
 
 template<>
-void ShaderUniformCollection::UseUniform<float>(const DataUniform& uniform) const;
+void ShaderUniformCollection::UseUniform<float>(const DataUniform& uniform, const ShaderProgram& targetProgram, ShaderProgram::Location targetLocation) const;
 
 template<typename T>
-void ShaderUniformCollection::UseUniform(const DataUniform& uniform) const
+void ShaderUniformCollection::UseUniform(const DataUniform& uniform, const ShaderProgram& targetProgram, ShaderProgram::Location targetLocation) const
 {
     ShaderProgram::Location location = uniform.location;
     switch (uniform.dimension)
     {
     case UniformDimension::Scalar:
-        m_shaderProgram->SetUniforms<T>(location, GetDataValues<T>(location));
+        targetProgram.SetUniforms<T>(targetLocation, GetDataValues<T>(location));
         break;
     case UniformDimension::Vector2:
-        m_shaderProgram->SetUniforms<T, 2>(location, GetDataValues<glm::vec<2, T>>(location));
+        targetProgram.SetUniforms<T, 2>(targetLocation, GetDataValues<glm::vec<2, T>>(location));
         break;
     case UniformDimension::Vector3:
-        m_shaderProgram->SetUniforms<T, 3>(location, GetDataValues<glm::vec<3, T>>(location));
+        targetProgram.SetUniforms<T, 3>(targetLocation, GetDataValues<glm::vec<3, T>>(location));
         break;
     case UniformDimension::Vector4:
-        m_shaderProgram->SetUniforms<T, 4>(location, GetDataValues<glm::vec<4, T>>(location));
+        targetProgram.SetUniforms<T, 4>(targetLocation, GetDataValues<glm::vec<4, T>>(location));
         break;
     default:
         assert(false);
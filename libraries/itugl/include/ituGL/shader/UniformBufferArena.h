@@ -0,0 +1,85 @@
+#pragma once
+
+#include <ituGL/shader/UniformBufferObject.h>
+#include <vector>
+#include <memory>
+#include <span>
+#include <cstddef>
+
+// One uniform buffer shared by the uniform blocks of many materials, each one in its own slice
+// Changing a value only updates the range that changed, and switching materials only binds another range of the same buffer
+// The contents are also kept in memory, so the buffer can grow without reading it back
+class UniformBufferArena
+{
+public:
+    // Range of the buffer owned by one block
+    struct Slice
+    {
+        size_t offset = 0;
+        size_t size = 0;
+    };
+
+    // Work done since the last reset
+    struct Stats
+    {
+        // glBufferSubData calls, and bytes written with them
+        unsigned int updates = 0;
+        size_t updatedBytes = 0;
+        // Ranges bound, and binds skipped because the range was already bound
+        unsigned int binds = 0;
+        unsigned int skippedBinds = 0;
+    };
+
+public:
+    // Shared, so the owners of slices keep the arena alive until they free them
+    static std::shared_ptr<UniformBufferArena> GetInstance();
+
+    // Public for make_shared, use GetInstance instead
+    UniformBufferArena();
+
+    // Reserve a slice of at least this size. The buffer grows if there is no free range big enough
+    Slice Allocate(size_t size);
+
+    // Return the slice, so its range can be reused
+    void Free(const Slice& slice);
+
+    // Write data inside the slice, starting at offset
+    void Update(const Slice& slice, size_t offset, std::span<const std::byte> data);
+
+    // Get the contents of the slice, as they were last written
+    inline std::span<const std::byte> GetData(const Slice& slice) const { return std::span(m_data).subspan(slice.offset, slice.size); }
+
+    // Bind the slice to the binding point, unless it is already bound
+    void Bind(GLuint binding, const Slice& slice);
+
+    // Size of the buffer, in bytes
+    inline size_t GetCapacity() const { return m_data.size(); }
+
+    inline const Stats& GetStats() const { return m_stats; }
+    inline void ResetStats() { m_stats = Stats(); }
+
+private:
+    UniformBufferArena(const UniformBufferArena&) = delete;
+    void operator = (const UniformBufferArena&) = delete;
+
+    // Find a free range for the size, first fit. Returns false if there is none
+    bool TakeFreeRange(size_t size, Slice& slice);
+
+    // Create a bigger buffer, with the current contents
+    void Grow(size_t minCapacity);
+
+private:
+    // Created on the first allocation, and replaced when it grows
+    std::unique_ptr<UniformBufferObject> m_buffer;
+
+    // Copy of the contents of the buffer
+    std::vector<std::byte> m_data;
+
+    // Free ranges, sorted by offset and never adjacent
+    std::vector<Slice> m_freeSlices;
+
+    // Range bound to each binding point, to skip binding it again
+    std::vector<Slice> m_boundSlices;
+
+    Stats m_stats;
+};
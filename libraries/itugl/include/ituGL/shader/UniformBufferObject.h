@@ -0,0 +1,17 @@
+#pragma once
+
+#include <ituGL/core/BufferObject.h>
+
+// Uniform Buffer Object (UBO) is the common term for a BufferObject when it is used as storage for uniform blocks
+// Ranges of the buffer are bound to indexed binding points, and each program reads its blocks from those binding points
+class UniformBufferObject : public BufferObjectBase<BufferObject::UniformBuffer>
+{
+public:
+    UniformBufferObject();
+
+    // Bind a range of the buffer to the binding point. The offset must be a multiple of GetOffsetAlignment()
+    void BindRange(GLuint binding, size_t offset, size_t size) const;
+
+    // Alignment required for the offsets of the ranges, queried once from the driver
+    static size_t GetOffsetAlignment();
+};
@@ -27,8 +27,10 @@ public:
     static void Unbind();
     static void Unbind(Target target);
 
+    // Attach the texture. Without direct state access, the framebuffer must be bound to the target
     void SetTexture(Target target, Attachment attachment, const Texture2DObject& texture, int level = 0);
 
+    // Set the attachments to draw to. Without direct state access, the framebuffer must be bound
     void SetDrawBuffers(std::span<const Attachment> attachments);
 
     static std::shared_ptr<const FramebufferObject> GetDefault();
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <ituGL/core/BufferObject.h>
+
+// Pixel Buffer Object (PBO) is the common term for a BufferObject when it is used as a source for texture uploads
+// While it is bound, the data pointers passed to texture image functions are offsets inside the buffer
+class PixelBufferObject : public BufferObjectBase<BufferObject::PixelUnpackBuffer>
+{
+public:
+    PixelBufferObject();
+};
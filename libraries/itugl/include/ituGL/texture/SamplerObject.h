@@ -0,0 +1,54 @@
+#pragma once
+
+#include <ituGL/texture/TextureObject.h>
+#include <memory>
+#include <span>
+
+// OpenGL object with the sampling parameters of textures: filters, wrap modes, LOD range...
+// A sampler bound to a texture unit overrides the parameters of the texture bound there, so textures with the same
+// parameters can share one sampler instead of storing copies of them
+class SamplerObject : public Object
+{
+public:
+    // Common samplers, shared by all the textures that use them
+    enum class Preset
+    {
+        LinearMipmapRepeat,
+        LinearRepeat,
+        LinearMipmapClamp,
+        LinearClamp,
+        NearestRepeat,
+        NearestClamp,
+        Count
+    };
+
+public:
+    SamplerObject();
+    virtual ~SamplerObject();
+
+    // Move semantics
+    SamplerObject(SamplerObject&&) = default;
+    SamplerObject& operator = (SamplerObject&&) = default;
+
+    // Bind the sampler to the active texture unit
+    void Bind() const override;
+
+    // Bind the sampler to the texture unit
+    void Bind(GLint textureUnit) const;
+
+    // Unbind the sampler of the texture unit, so the unit uses the parameters of its texture
+    static void Unbind(GLint textureUnit);
+
+    // Get the shared sampler of the preset, created the first time
+    static std::shared_ptr<const SamplerObject> GetPreset(Preset preset);
+
+    // Samplers have the sampling parameters of TextureObject. They don't need to be bound to set them
+    void GetParameter(TextureObject::ParameterFloat pname, GLfloat& param) const;
+    void SetParameter(TextureObject::ParameterFloat pname, GLfloat param);
+
+    void GetParameter(TextureObject::ParameterEnum pname, GLenum& param) const;
+    void SetParameter(TextureObject::ParameterEnum pname, GLenum param);
+
+    void GetParameter(TextureObject::ParameterColor pname, std::span<GLfloat, 4> params) const;
+    void SetParameter(TextureObject::ParameterColor pname, std::span<const GLfloat, 4> params);
+};
@@ -20,6 +20,11 @@ public:
         GLsizei width, GLsizei height,
         Format format, InternalFormat internalFormat,
         std::span<const T> data, Data::Type type = Data::Type::None);
+
+    // Update a region of the texture2D with the data in the bound PixelBufferObject, starting at bufferOffset
+    void SetSubImage(GLint level, GLint x, GLint y,
+        GLsizei width, GLsizei height,
+        Format format, Data::Type type, size_t bufferOffset);
 };
 
 // Set image with data in bytes
@@ -28,6 +28,11 @@ public:
     void SetImage(GLint level, Face face, GLsizei side,
         Format format, InternalFormat internalFormat,
         std::span<const T> data, Data::Type type = Data::Type::None);
+
+    // Update a region of one face with the data in the bound PixelBufferObject, starting at bufferOffset
+    void SetSubImage(GLint level, Face face, GLint x, GLint y,
+        GLsizei width, GLsizei height,
+        Format format, Data::Type type, size_t bufferOffset);
 };
 
 // Set image with data in bytes
@@ -2,6 +2,9 @@
 
 #include <ituGL/core/Object.h>
 #include <span>
+#include <memory>
+
+class SamplerObject;
 
 // Abstract OpenGL object that encapsulates a Texture
 // There are different subtypes depending on the target
@@ -25,7 +28,7 @@ public:
     enum class ParameterColor : GLenum;
 
 public:
-    TextureObject();
+    TextureObject(Target target);
     virtual ~TextureObject();
 
     // (C++) 8
@@ -44,6 +47,14 @@ public:
     // Generate mipmaps automatically for this texture
     void GenerateMipmap();
 
+    // Get the GPU memory used by all the allocated levels, as reported by the driver
+    size_t GetMemorySize() const;
+
+    // Get the size and the internal format of a level, as reported by the driver. The size is 0 if the level is not allocated
+    void GetLevelInfo(GLint level, GLint& width, GLint& height, GLint& internalFormat) const;
+
+    // Methods that edit or query the texture need it bound, unless the device has direct state access
+
     // Get value of the texture parameter of type float
     void GetParameter(ParameterFloat pname, GLfloat& param) const;
     // Set value of the texture parameter of type float
@@ -75,14 +86,30 @@ public:
     // Get number of components of the data type of the texture (packed components count as 1)
     static int GetDataComponentCount(InternalFormat internalFormat);
 
+    // Estimate the bits per pixel that the driver uses to store the internal format. 3 component formats are padded to 4
+    static int GetPixelBits(InternalFormat internalFormat);
+
     // Set active texture unit
     static void SetActiveTexture(GLint textureUnit);
 
+    // Shared sampler with the parameters used to sample the texture. If null, the parameters of the texture are used
+    inline const std::shared_ptr<const SamplerObject>& GetSampler() const { return m_sampler; }
+    inline void SetSampler(std::shared_ptr<const SamplerObject> sampler) { m_sampler = sampler; }
+
+    // Bind the texture and its sampler to the texture unit, to sample it in the shaders
+    // The active unit is only changed if the texture is not bound there yet
+    virtual void BindTextureUnit(GLint textureUnit) const = 0;
+
 protected:
     // Bind the specific target. Used by the Bind() method in derived classes
     void Bind(Target target) const;
     // Unbind the specific target. It is static because we dont need any objects to do it
     static void Unbind(Target target);
+    // Bind the specific target in the texture unit. Used by the BindTextureUnit() method in derived classes
+    // Returns the texture now bound to the target in the active unit
+    Handle BindTextureUnit(Target target, GLint textureUnit) const;
+    // Report the estimated size of an image to the MemoryTracker. The image is the level, times 6 plus the face for cubemaps
+    void TrackImageMemory(unsigned int image, GLsizei width, GLsizei height, InternalFormat internalFormat) const;
 
 #ifndef NDEBUG
     // Get active texture unit
@@ -92,6 +119,8 @@ protected:
     static bool IsValidFormat(Format format, InternalFormat internalFormat);
 #endif
 
+private:
+    std::shared_ptr<const SamplerObject> m_sampler;
 };
 
 // (C++) 5
@@ -101,7 +130,7 @@ template<TextureObject::Target T>
 class TextureObjectBase : public TextureObject
 {
 public:
-    inline TextureObjectBase() {}
+    inline TextureObjectBase() : TextureObject(T) {}
 
     // Return the templated enum value T
     inline Target GetTarget() const override { return T; }
@@ -112,6 +141,9 @@ public:
     // When unbinding this class, we unbind the corresponding Target
     static inline void Unbind();
 
+    // Bind to the corresponding Target of the texture unit
+    void BindTextureUnit(GLint textureUnit) const override;
+
 #ifndef NDEBUG
     // Check if there is any TextureObject currently bound to this target
     inline static bool IsAnyBound() { return s_boundHandle != Object::NullHandle; }
@@ -142,6 +174,15 @@ void TextureObjectBase<T>::Bind() const
 #endif
 }
 
+template<TextureObject::Target T>
+void TextureObjectBase<T>::BindTextureUnit(GLint textureUnit) const
+{
+    Handle boundHandle = TextureObject::BindTextureUnit(T, textureUnit);
+#ifndef NDEBUG
+    s_boundHandle = boundHandle;
+#endif
+}
+
 template<TextureObject::Target T>
 void TextureObjectBase<T>::Unbind()
 {
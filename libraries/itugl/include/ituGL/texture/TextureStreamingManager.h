@@ -0,0 +1,111 @@
+#pragma once
+
+#include <ituGL/texture/Texture2DObject.h>
+#include <ituGL/asset/TextureLoader.h>
+#include <unordered_map>
+#include <string>
+#include <memory>
+#include <vector>
+
+class TextureUploadRing;
+class DearImGui;
+class Model;
+
+// Keeps only the mip levels that the scene needs resident on the GPU
+// Textures start with their coarse levels only. Every frame, the models request the level they need, based on their
+// size on screen, and finer levels are streamed in through the upload ring, or evicted to stay under the memory budget
+// The levels missing are excluded with BaseLevel, and MinLod/MaxLod are clamped to fade in the new levels smoothly
+class TextureStreamingManager
+{
+public:
+    TextureStreamingManager(TextureUploadRing& uploadRing, size_t memoryBudget = 64 << 20);
+
+    TextureStreamingManager(const TextureStreamingManager&) = delete;
+    void operator = (const TextureStreamingManager&) = delete;
+
+    // Maximum GPU memory used by the streamed levels, in bytes. Coarse levels are always kept
+    inline size_t GetMemoryBudget() const { return m_memoryBudget; }
+    inline void SetMemoryBudget(size_t memoryBudget) { m_memoryBudget = memoryBudget; }
+
+    // Levels up to this size are always resident
+    inline int GetResidentSize() const { return m_residentSize; }
+    inline void SetResidentSize(int residentSize) { m_residentSize = residentSize; }
+
+    // Bias added to the estimated level. Positive values request coarser levels
+    inline float GetLodBias() const { return m_lodBias; }
+    inline void SetLodBias(float lodBias) { m_lodBias = lodBias; }
+
+    // Estimated GPU memory of the resident levels, including the ones being uploaded
+    inline size_t GetResidentBytes() const { return m_residentBytes; }
+
+    // Create a texture with only the coarse levels resident. The data must have been decoded with the mip levels
+    std::shared_ptr<Texture2DObject> AddTexture(const std::string& name, std::shared_ptr<const TextureLoaderUtils::TextureData> textureData);
+
+    // Request the levels needed by the textures of the model, drawn with this size in pixels
+    void RequestModel(Model& model, float screenSize);
+
+    // Evict and stream levels for the requests of this frame. Call once per frame, after the requests, on the GL thread
+    void Update(float deltaTime);
+
+    // Draw the resident memory of each texture
+    void DrawGUI(DearImGui& imGui);
+
+private:
+    // Streaming state of one texture
+    struct Entry
+    {
+        std::string name;
+        std::shared_ptr<Texture2DObject> texture;
+        std::shared_ptr<const TextureLoaderUtils::TextureData> textureData;
+
+        // Finest level with storage allocated. Levels below are being uploaded until uploadLevel is done
+        int firstLevel;
+        // Finest level that can be sampled
+        int baseLevel;
+        // Level being uploaded, or -1
+        int uploadLevel;
+        // Coarsest level that is always resident
+        int residentLevel;
+
+        // Finest level requested this frame, and the one requested in the last update
+        int requestedLevel;
+        int neededLevel;
+
+        // Minimum LOD while the last level fades in
+        float minLod;
+
+        size_t residentBytes;
+    };
+
+    // Estimated size of one level in GPU memory
+    static size_t GetLevelBytes(const TextureLoaderUtils::TextureData& textureData, int level);
+
+    // Allocate and queue the upload of the level above the first one
+    void StreamLevel(Entry& entry);
+
+    // Free the finest level of the texture
+    void EvictLevel(Entry& entry);
+
+    // Called when the upload ring finished uploading a level
+    void OnLevelUploaded(const Texture2DObject* texture, int level);
+
+    // Update BaseLevel and the LOD range of the texture after the resident levels changed
+    static void UpdateLodRange(Entry& entry);
+
+private:
+    TextureUploadRing& m_uploadRing;
+
+    size_t m_memoryBudget;
+    int m_residentSize;
+    float m_lodBias;
+
+    // Seconds to fade in a new level
+    float m_fadeTime;
+
+    size_t m_residentBytes;
+
+    std::vector<Entry> m_entries;
+
+    // Index of each texture in the entries
+    std::unordered_map<const TextureObject*, size_t> m_entryIndices;
+};
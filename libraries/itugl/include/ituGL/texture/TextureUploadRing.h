@@ -0,0 +1,138 @@
+#pragma once
+
+#include <ituGL/texture/PixelBufferObject.h>
+#include <ituGL/texture/Texture2DObject.h>
+#include <ituGL/texture/TextureCubemapObject.h>
+#include <functional>
+#include <memory>
+#include <deque>
+#include <chrono>
+
+// Streams texture data to the GPU through a ring of pixel buffer memory
+// Each frame, up to the frame budget of pending data is copied into the ring and uploaded with glTexSubImage2D
+// The ring is persistently mapped when GL 4.4 is available, otherwise each chunk is mapped unsynchronized
+// Fences mark when the GPU is done reading each chunk, so its memory can be reused
+class TextureUploadRing
+{
+public:
+    // Statistics collected while streaming
+    struct Stats
+    {
+        // Total bytes copied through the ring
+        size_t uploadedBytes = 0;
+        // Number of texture images completely uploaded
+        unsigned int completedUploads = 0;
+        // Number of frames where the ring had no free memory left
+        unsigned int ringFullFrames = 0;
+        // Seconds elapsed while there was data streaming
+        float streamingTime = 0.0f;
+        // Longest frame while there was data streaming, in seconds
+        float worstFrameTime = 0.0f;
+        // Longest time spent inside Update, in seconds
+        float worstUpdateTime = 0.0f;
+
+        // Average throughput while streaming, in bytes per second
+        inline float GetThroughput() const { return streamingTime > 0.0f ? uploadedBytes / streamingTime : 0.0f; }
+    };
+
+    // Called when the last rows of an image have been uploaded
+    using CompletionFunction = std::function<void()>;
+
+public:
+    TextureUploadRing(size_t ringSize = 16 << 20, size_t frameBudget = 4 << 20);
+    ~TextureUploadRing();
+
+    TextureUploadRing(const TextureUploadRing&) = delete;
+    void operator = (const TextureUploadRing&) = delete;
+
+    inline size_t GetRingSize() const { return m_ringSize; }
+
+    // Maximum number of bytes uploaded each frame. At least one row is always uploaded
+    inline size_t GetFrameBudget() const { return m_frameBudget; }
+    inline void SetFrameBudget(size_t frameBudget) { m_frameBudget = frameBudget; }
+
+    // True if the ring is mapped once for its whole lifetime
+    inline bool IsPersistentlyMapped() const { return m_mappedData != nullptr; }
+
+    // True if there is data waiting to be uploaded
+    inline bool IsStreaming() const { return !m_uploads.empty(); }
+
+    // Number of bytes waiting to be uploaded
+    size_t GetPendingBytes() const;
+
+    // Queue the upload of one level of a 2D texture. The texture storage must be already allocated
+    // The data is not copied, dataOwner must keep it alive until the upload is complete
+    void QueueUpload(std::shared_ptr<Texture2DObject> texture, GLint level, GLsizei width, GLsizei height,
+        TextureObject::Format format, Data::Type dataType, std::span<const std::byte> data,
+        std::shared_ptr<const void> dataOwner, CompletionFunction completion = nullptr);
+
+    // Queue the upload of one level of a cubemap face. The texture storage must be already allocated
+    // The face can be a region of a bigger image, with rows that are dataStride bytes apart
+    void QueueUpload(std::shared_ptr<TextureCubemapObject> texture, TextureCubemapObject::Face face, GLint level, GLsizei side,
+        TextureObject::Format format, Data::Type dataType, std::span<const std::byte> data, size_t dataStride,
+        std::shared_ptr<const void> dataOwner, CompletionFunction completion = nullptr);
+
+    // Upload up to the frame budget of pending data. Call once per frame, on the GL thread
+    void Update();
+
+    inline const Stats& GetStats() const { return m_stats; }
+    inline void ResetStats() { m_stats = Stats(); }
+
+private:
+    // Sets the texture rows from the bound pixel buffer, at the offset
+    using SetRowsFunction = std::function<void(GLint firstRow, GLsizei rowCount, size_t bufferOffset)>;
+
+    // Texture image waiting to be uploaded
+    struct Upload
+    {
+        SetRowsFunction setRows;
+        const std::byte* data;
+        size_t rowSize;
+        size_t dataStride;
+        GLsizei rowCount;
+        GLsizei nextRow;
+        std::shared_ptr<const void> dataOwner;
+        CompletionFunction completion;
+    };
+
+    // Range of the ring that the GPU could still be reading
+    struct Segment
+    {
+        size_t begin;
+        size_t end;
+        GLsync fence;
+    };
+
+    // Find free space in the ring. Returns false if the ring is full
+    bool Allocate(size_t size, size_t& offset);
+
+    // Release the segments that the GPU finished reading
+    void RetireSegments();
+
+    // Copy the rows to the ring and upload them. Returns false if the ring is full
+    bool UploadRows(Upload& upload, GLsizei rowCount);
+
+private:
+    PixelBufferObject m_buffer;
+
+    // Pointer to the buffer memory, if it is persistently mapped
+    std::byte* m_mappedData;
+
+    size_t m_ringSize;
+    size_t m_frameBudget;
+
+    // Next free position in the ring
+    size_t m_head;
+
+    // Segments in use by the GPU, from oldest to newest
+    std::deque<Segment> m_segments;
+
+    // Images waiting to be uploaded, in order
+    std::deque<Upload> m_uploads;
+
+    Stats m_stats;
+
+    // Used to measure the frame time while streaming
+    std::chrono::steady_clock::time_point m_lastUpdateTime;
+    bool m_streamedLastFrame;
+};
@@ -28,4 +28,8 @@ public:
     void EndFrame();
 
     Window UseWindow(const char* name);
+
+private:
+    // Set when the window is headless. It has no GLFW window, so the display size is set here instead of by the GLFW backend
+    ::Window* m_headlessWindow;
 };
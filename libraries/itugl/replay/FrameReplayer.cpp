@@ -0,0 +1,327 @@
+#include "FrameReplayer.h"
+
+#include <ituGL/geometry/Mesh.h>
+#include <ituGL/lighting/DirectionalLight.h>
+#include <ituGL/lighting/PointLight.h>
+#include <ituGL/lighting/SpotLight.h>
+#include <ituGL/shader/Material.h>
+#include <ituGL/shader/ShaderProgram.h>
+#include <ituGL/shader/ShaderProgramVariants.h>
+#include <ituGL/texture/Texture2DObject.h>
+#include <ituGL/texture/TextureCubemapObject.h>
+#include <ituGL/texture/SamplerObject.h>
+#include <glm/gtc/matrix_inverse.hpp>
+#include <unordered_set>
+#include <cassert>
+
+FrameReplayer::FrameReplayer(const FrameCapture& capture, Renderer& renderer)
+    : m_capture(capture)
+    , m_renderer(renderer)
+{
+}
+
+bool FrameReplayer::Initialize()
+{
+    for (const FrameCapture::TextureInfo& info : m_capture.GetTextures())
+    {
+        m_textures.push_back(CreateTexture(info));
+    }
+
+    for (const FrameCapture::MeshInfo& info : m_capture.GetMeshes())
+    {
+        m_meshes.push_back(CreateMesh(info));
+    }
+
+    for (const FrameCapture::ProgramInfo& info : m_capture.GetPrograms())
+    {
+        std::shared_ptr<ShaderProgram> shaderProgram = std::make_shared<ShaderProgram>();
+        if (!shaderProgram->SetBinary(info.binaryFormat, info.binary))
+        {
+            return false;
+        }
+        m_renderer.RegisterShaderProgram(shaderProgram,
+            info.updateTransforms ? GetUpdateTransformsFunction(*shaderProgram) : nullptr,
+            info.updateLights ? m_renderer.GetDefaultUpdateLightsFunction(*shaderProgram) : nullptr);
+        m_programs.push_back(shaderProgram);
+    }
+
+    for (const FrameCapture::MaterialInfo& info : m_capture.GetMaterials())
+    {
+        m_materials.push_back(CreateMaterial(info));
+    }
+
+    for (const FrameCapture::Frame& frame : m_capture.GetFrames())
+    {
+        CreateLights(frame, m_frameLights.emplace_back());
+    }
+
+    return true;
+}
+
+void FrameReplayer::SubmitFrame(unsigned int frameIndex)
+{
+    const FrameCapture::Frame& frame = m_capture.GetFrames()[frameIndex];
+
+    m_camera.SetViewMatrix(frame.viewMatrix);
+    m_camera.SetProjectionMatrix(frame.projectionMatrix);
+    m_renderer.SetCurrentCamera(m_camera);
+
+    for (const std::unique_ptr<Light>& light : m_frameLights[frameIndex])
+    {
+        m_renderer.AddLight(*light);
+    }
+
+    // The packets keep the world matrix indices of the capture
+    for (const glm::mat4& worldMatrix : frame.worldMatrices)
+    {
+        m_renderer.AddWorldMatrix(worldMatrix);
+    }
+    for (const FrameCapture::Packet& packet : frame.packets)
+    {
+        m_renderer.AddDrawcall(*m_materials[packet.materialIndex], packet.worldMatrixIndex, *m_meshes[packet.meshIndex], packet.submeshIndex);
+    }
+}
+
+// Format accepted by glTexImage with the internal format, for any internal format that TextureObject declares
+static TextureObject::Format GetCompatibleFormat(TextureObject::InternalFormat internalFormat)
+{
+    switch (internalFormat)
+    {
+    case TextureObject::InternalFormatDepth:
+    case TextureObject::InternalFormatDepth16:
+    case TextureObject::InternalFormatDepth24:
+    case TextureObject::InternalFormatDepth32:
+    case TextureObject::InternalFormatDepth32F:
+        return TextureObject::FormatDepth;
+    case TextureObject::InternalFormatDepthStencil:
+    case TextureObject::InternalFormatDepth24Stencil8:
+    case TextureObject::InternalFormatDepth32FStencil8:
+        return TextureObject::FormatDepthStencil;
+    // Packed formats count as one component
+    case TextureObject::InternalFormatR11G11B10:
+        return TextureObject::FormatRGB;
+    case TextureObject::InternalFormatRGB10A2:
+        return TextureObject::FormatRGBA;
+    default:
+        break;
+    }
+
+    switch (TextureObject::GetDataComponentCount(internalFormat))
+    {
+    case 1:
+        return TextureObject::FormatR;
+    case 2:
+        return TextureObject::FormatRG;
+    case 3:
+        return TextureObject::FormatRGB;
+    default:
+        return TextureObject::FormatRGBA;
+    }
+}
+
+std::shared_ptr<TextureObject> FrameReplayer::CreateTexture(const FrameCapture::TextureInfo& info) const
+{
+    // The format only describes the data uploaded, and there is none. Use one compatible with the internal format
+    TextureObject::InternalFormat internalFormat = static_cast<TextureObject::InternalFormat>(info.internalFormat);
+    TextureObject::Format format = GetCompatibleFormat(internalFormat);
+
+    std::shared_ptr<TextureObject> texture;
+    if (info.target == TextureObject::Texture2D)
+    {
+        std::shared_ptr<Texture2DObject> texture2D = std::make_shared<Texture2DObject>();
+        texture2D->Bind();
+        texture2D->SetImage(0, info.width, info.height, format, internalFormat);
+        texture = texture2D;
+    }
+    else if (info.target == TextureObject::TextureCubemap)
+    {
+        std::shared_ptr<TextureCubemapObject> textureCubemap = std::make_shared<TextureCubemapObject>();
+        textureCubemap->Bind();
+        textureCubemap->SetImage(0, info.width, format, internalFormat);
+        texture = textureCubemap;
+    }
+    else
+    {
+        // Other targets don't have texture classes yet, the property is left empty
+        return nullptr;
+    }
+
+    if (info.levelCount > 1)
+    {
+        texture->GenerateMipmap();
+    }
+    texture->SetSampler(SamplerObject::GetPreset(info.levelCount > 1 ? SamplerObject::Preset::LinearMipmapRepeat : SamplerObject::Preset::LinearRepeat));
+    return texture;
+}
+
+std::shared_ptr<Mesh> FrameReplayer::CreateMesh(const FrameCapture::MeshInfo& info) const
+{
+    std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+    for (const std::vector<std::byte>& data : info.vertexBuffers)
+    {
+        mesh->AddVertexData(std::span<const std::byte>(data));
+    }
+    for (const std::vector<std::byte>& data : info.elementBuffers)
+    {
+        // The index type is in the drawcalls, the bytes are uploaded as they are
+        mesh->AddElementData(std::span<const unsigned char>(reinterpret_cast<const unsigned char*>(data.data()), data.size()));
+    }
+
+    std::vector<Mesh::AttributeBinding> attributes;
+    for (const FrameCapture::SubmeshInfo& submesh : info.submeshes)
+    {
+        attributes.clear();
+        for (const FrameCapture::AttributeInfo& attribute : submesh.attributes)
+        {
+            VertexAttribute vertexAttribute(attribute.type, attribute.components, attribute.normalized, attribute.semantic);
+            attributes.push_back(Mesh::AttributeBinding{ attribute.vboIndex, VertexAttribute::Layout(vertexAttribute, attribute.offset, attribute.stride), attribute.location });
+        }
+        Drawcall drawcall(submesh.primitive, submesh.count, submesh.eboType, submesh.first, submesh.baseVertex);
+        mesh->AddSubmesh(drawcall, attributes, submesh.eboIndex);
+    }
+    return mesh;
+}
+
+std::shared_ptr<Material> FrameReplayer::CreateMaterial(const FrameCapture::MaterialInfo& info) const
+{
+    std::unordered_set<std::string> propertyNames;
+    std::vector<ShaderUniformCollection::PropertyValue> values;
+    for (const FrameCapture::PropertyInfo& property : info.properties)
+    {
+        propertyNames.insert(property.name);
+        ShaderUniformCollection::PropertyValue& value = values.emplace_back();
+        value.name = property.name;
+        value.isTexture = property.isTexture;
+        value.data = property.data;
+        value.texture = property.textureIndex >= 0 ? m_textures[property.textureIndex] : nullptr;
+    }
+
+    // The uniforms that were not properties were filtered out by the application
+    const ShaderProgram& shaderProgram = *m_programs[info.programIndex];
+    ShaderUniformCollection::NameSet filteredUniforms;
+    for (unsigned int i = 0; i < shaderProgram.GetUniformCount(); ++i)
+    {
+        int size;
+        GLenum glType;
+        char uniformName[256];
+        shaderProgram.GetUniformInfo(i, size, glType, std::span(uniformName, sizeof(uniformName)));
+        if (!propertyNames.contains(uniformName))
+        {
+            filteredUniforms.insert(uniformName);
+        }
+    }
+
+    std::shared_ptr<Material> material;
+    if (!info.keywords.empty())
+    {
+        // The variants come from the capture, there are no sources to build others
+        std::vector<const char*> keywords;
+        for (const std::string& keyword : info.keywords)
+        {
+            keywords.push_back(keyword.c_str());
+        }
+        std::shared_ptr<ShaderProgramVariants> shaderVariants = std::make_shared<ShaderProgramVariants>(std::span<const char*>(), std::span<const char*>(), keywords);
+        for (const FrameCapture::VariantInfo& variant : info.variants)
+        {
+            shaderVariants->AddVariant(variant.keywordMask, m_programs[variant.programIndex]);
+        }
+        material = std::make_shared<Material>(shaderVariants, filteredUniforms);
+        for (unsigned int keywordIndex = 0; keywordIndex < info.keywords.size(); ++keywordIndex)
+        {
+            if (info.keywordMask & (1u << keywordIndex))
+            {
+                material->SetKeyword(info.keywords[keywordIndex], true);
+            }
+        }
+    }
+    else
+    {
+        material = std::make_shared<Material>(m_programs[info.programIndex], filteredUniforms);
+    }
+
+    material->SetPropertyValues(values);
+    material->SetRenderState(info.renderState);
+    material->SetTransparency(info.transparent);
+    return material;
+}
+
+void FrameReplayer::CreateLights(const FrameCapture::Frame& frame, std::vector<std::unique_ptr<Light>>& lights) const
+{
+    for (const FrameCapture::LightInfo& info : frame.lights)
+    {
+        std::unique_ptr<Light> light;
+        switch (info.type)
+        {
+        case Light::Type::Directional:
+        {
+            std::unique_ptr<DirectionalLight> directionalLight = std::make_unique<DirectionalLight>();
+            directionalLight->SetDirection(info.direction);
+            light = std::move(directionalLight);
+            break;
+        }
+        case Light::Type::Point:
+        {
+            std::unique_ptr<PointLight> pointLight = std::make_unique<PointLight>();
+            pointLight->SetPosition(info.position);
+            pointLight->SetDistanceAttenuation(info.distanceAttenuation);
+            light = std::move(pointLight);
+            break;
+        }
+        case Light::Type::Spot:
+        {
+            std::unique_ptr<SpotLight> spotLight = std::make_unique<SpotLight>();
+            spotLight->SetPosition(info.position);
+            spotLight->SetDirection(info.direction);
+            spotLight->SetDistanceAttenuation(info.distanceAttenuation);
+            spotLight->SetAngle(info.angle);
+            spotLight->SetAngleAttenuation(info.angleAttenuation);
+            light = std::move(spotLight);
+            break;
+        }
+        default:
+            assert(false);
+            continue;
+        }
+        light->SetColor(info.color);
+        light->SetIntensity(info.intensity);
+        lights.push_back(std::move(light));
+    }
+}
+
+Renderer::UpdateTransformsFunction FrameReplayer::GetUpdateTransformsFunction(const ShaderProgram& shaderProgram)
+{
+    // The application functions are not captured. This one sets the matrix uniforms that the programs declare
+    ShaderProgram::Location worldMatrixLocation = shaderProgram.GetUniformLocation("WorldMatrix");
+    ShaderProgram::Location worldViewMatrixLocation = shaderProgram.GetUniformLocation("WorldViewMatrix");
+    ShaderProgram::Location worldViewProjMatrixLocation = shaderProgram.GetUniformLocation("WorldViewProjMatrix");
+    ShaderProgram::Location projectionMatrixLocation = shaderProgram.GetUniformLocation("ProjectionMatrix");
+    ShaderProgram::Location invProjMatrixLocation = shaderProgram.GetUniformLocation("InvProjMatrix");
+    ShaderProgram::Location invViewMatrixLocation = shaderProgram.GetUniformLocation("InvViewMatrix");
+    ShaderProgram::Location invViewProjMatrixLocation = shaderProgram.GetUniformLocation("InvViewProjMatrix");
+    ShaderProgram::Location cameraPositionLocation = shaderProgram.GetUniformLocation("CameraPosition");
+
+    return [=](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
+        {
+            if (worldMatrixLocation >= 0)
+                shaderProgram.SetUniform(worldMatrixLocation, worldMatrix);
+            if (worldViewMatrixLocation >= 0)
+                shaderProgram.SetUniform(worldViewMatrixLocation, camera.GetViewMatrix() * worldMatrix);
+            if (worldViewProjMatrixLocation >= 0)
+                shaderProgram.SetUniform(worldViewProjMatrixLocation, camera.GetViewProjectionMatrix() * worldMatrix);
+
+            if (!cameraChanged)
+                return;
+
+            glm::mat4 invViewMatrix = glm::inverse(camera.GetViewMatrix());
+            if (projectionMatrixLocation >= 0)
+                shaderProgram.SetUniform(projectionMatrixLocation, camera.GetProjectionMatrix());
+            if (invProjMatrixLocation >= 0)
+                shaderProgram.SetUniform(invProjMatrixLocation, glm::inverse(camera.GetProjectionMatrix()));
+            if (invViewMatrixLocation >= 0)
+                shaderProgram.SetUniform(invViewMatrixLocation, invViewMatrix);
+            if (invViewProjMatrixLocation >= 0)
+                shaderProgram.SetUniform(invViewProjMatrixLocation, glm::inverse(camera.GetViewProjectionMatrix()));
+            if (cameraPositionLocation >= 0)
+                shaderProgram.SetUniform(cameraPositionLocation, glm::vec3(invViewMatrix[3]));
+        };
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <ituGL/renderer/FrameCapture.h>
+#include <ituGL/renderer/Renderer.h>
+#include <ituGL/camera/Camera.h>
+#include <memory>
+#include <vector>
+
+class Mesh;
+class Material;
+class ShaderProgram;
+class TextureObject;
+
+// Creates the assets of a capture, and submits its frames to a renderer as the application did
+// Programs that had a transforms function get one that sets the usual matrix uniforms by name, and programs that had
+// a lights function get the default one. Other uniforms set by the application keep the values of the material
+class FrameReplayer
+{
+public:
+    FrameReplayer(const FrameCapture& capture, Renderer& renderer);
+
+    // Create the GL objects and register the programs. Returns false if the driver rejects a program binary
+    bool Initialize();
+
+    inline unsigned int GetFrameCount() const { return static_cast<unsigned int>(m_capture.GetFrames().size()); }
+
+    // Set the camera and add the lights and drawcalls of the frame to the renderer
+    void SubmitFrame(unsigned int frameIndex);
+
+private:
+    std::shared_ptr<TextureObject> CreateTexture(const FrameCapture::TextureInfo& info) const;
+    std::shared_ptr<Mesh> CreateMesh(const FrameCapture::MeshInfo& info) const;
+    std::shared_ptr<Material> CreateMaterial(const FrameCapture::MaterialInfo& info) const;
+    void CreateLights(const FrameCapture::Frame& frame, std::vector<std::unique_ptr<Light>>& lights) const;
+
+    static Renderer::UpdateTransformsFunction GetUpdateTransformsFunction(const ShaderProgram& shaderProgram);
+
+private:
+    const FrameCapture& m_capture;
+    Renderer& m_renderer;
+
+    std::vector<std::shared_ptr<TextureObject>> m_textures;
+    std::vector<std::shared_ptr<Mesh>> m_meshes;
+    std::vector<std::shared_ptr<ShaderProgram>> m_programs;
+    std::vector<std::shared_ptr<Material>> m_materials;
+
+    // Lights of each frame, created once
+    std::vector<std::vector<std::unique_ptr<Light>>> m_frameLights;
+
+    // The renderer keeps a pointer to the camera until the frame is rendered
+    Camera m_camera;
+};
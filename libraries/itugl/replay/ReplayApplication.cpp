@@ -0,0 +1,159 @@
+#include "ReplayApplication.h"
+
+#include <ituGL/renderer/ForwardRenderPass.h>
+#include <ituGL/renderer/GBufferRenderPass.h>
+#include <ituGL/renderer/TransparencyPass.h>
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+ReplayApplication::ReplayApplication(const Settings& settings)
+    : Application(1024, 1024, "Replay")
+    , m_settings(settings)
+    , m_renderer(GetDevice())
+    , m_frameIndex(0)
+{
+}
+
+void ReplayApplication::Initialize()
+{
+    Application::Initialize();
+
+    if (!m_capture.Load(m_settings.capturePath.c_str()))
+    {
+        Terminate(-3, "Could not load the capture");
+        return;
+    }
+    if (m_capture.GetFrames().empty())
+    {
+        Terminate(-3, "The capture has no frames");
+        return;
+    }
+
+    m_replayer = std::make_unique<FrameReplayer>(m_capture, m_renderer);
+    if (!m_replayer->Initialize())
+    {
+        Terminate(-4, "The driver rejected a program binary of the capture");
+        return;
+    }
+
+    if (!InitializeRenderer())
+    {
+        Terminate(-5, "Unknown pass name");
+        return;
+    }
+
+    // The renderer enables vsync, the frames must not wait for the display
+    GetDevice().SetVSyncEnabled(false);
+
+    m_frameTimes.reserve(m_settings.measuredFrames);
+}
+
+bool ReplayApplication::InitializeRenderer()
+{
+    int width, height;
+    GetMainWindow().GetDimensions(width, height);
+
+    for (const std::string& pass : m_settings.passes)
+    {
+        if (pass == "forward")
+        {
+            m_renderer.AddRenderPass(std::make_unique<ForwardRenderPass>());
+        }
+        else if (pass == "gbuffer")
+        {
+            m_renderer.AddRenderPass(std::make_unique<GBufferRenderPass>(width, height));
+        }
+        else if (pass == "transparency")
+        {
+            m_renderer.AddRenderPass(std::make_unique<TransparencyPass>(nullptr));
+        }
+        else
+        {
+            std::cout << "Unknown pass: " << pass << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void ReplayApplication::Update()
+{
+    Application::Update();
+
+    RenderPassProfiler& profiler = m_renderer.GetProfiler();
+    if (m_frameIndex == m_settings.warmupFrames)
+    {
+        // Keep every measured frame, and drop the results of the warm-up frames still in flight
+        profiler.WaitForResults();
+        profiler.SetHistorySize(std::max(m_settings.measuredFrames, 1u));
+        profiler.Clear();
+    }
+
+    // Frame time from the start of the previous frame
+    std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+    if (m_frameIndex > m_settings.warmupFrames && m_frameTimes.size() < m_settings.measuredFrames)
+    {
+        std::chrono::duration<float, std::milli> frameTime = frameStart - m_frameStart;
+        m_frameTimes.push_back(frameTime.count());
+    }
+    m_frameStart = frameStart;
+
+    // The measured frames are done, this one is only rendered before closing
+    if (m_frameIndex == m_settings.warmupFrames + m_settings.measuredFrames)
+    {
+        profiler.WaitForResults();
+        PrintReport();
+        Close();
+    }
+    ++m_frameIndex;
+}
+
+void ReplayApplication::Render()
+{
+    Application::Render();
+
+    GetDevice().Clear(true, Color(0.0f, 0.0f, 0.0f, 1.0f), true, 1.0f);
+
+    m_replayer->SubmitFrame(m_frameIndex % m_replayer->GetFrameCount());
+
+    m_renderer.Render();
+}
+
+void ReplayApplication::PrintReport() const
+{
+    std::printf("Capture: %s, %u frames, %zu meshes, %zu materials, %zu programs, %u drawcalls skipped when captured\n",
+        m_settings.capturePath.c_str(), m_replayer->GetFrameCount(), m_capture.GetMeshes().size(),
+        m_capture.GetMaterials().size(), m_capture.GetPrograms().size(), m_capture.GetSkippedPacketCount());
+
+    // Passes of the application that recorded the capture, to compare with the passes replayed
+    std::printf("Captured passes:");
+    const std::vector<std::string>& passNames = m_capture.GetFrames()[0].passNames;
+    for (unsigned int passIndex = 0; passIndex < passNames.size(); ++passIndex)
+    {
+        std::printf("%s %s", passIndex ? "," : "", passNames[passIndex].c_str());
+    }
+    std::printf("\n");
+
+    std::vector<float> sortedFrameTimes(m_frameTimes);
+    std::sort(sortedFrameTimes.begin(), sortedFrameTimes.end());
+    if (!sortedFrameTimes.empty())
+    {
+        float sum = 0.0f;
+        for (float frameTime : sortedFrameTimes)
+        {
+            sum += frameTime;
+        }
+        std::printf("Frame ms: avg %.3f, min %.3f, p50 %.3f, max %.3f (%zu frames)\n", sum / sortedFrameTimes.size(),
+            sortedFrameTimes.front(), sortedFrameTimes[sortedFrameTimes.size() / 2], sortedFrameTimes.back(), sortedFrameTimes.size());
+    }
+
+    const RenderPassProfiler& profiler = m_renderer.GetProfiler();
+    for (unsigned int passIndex = 0; passIndex < profiler.GetPassCount(); ++passIndex)
+    {
+        RenderPassProfiler::Summary gpuSummary = profiler.GetGpuSummary(passIndex);
+        RenderPassProfiler::Summary cpuSummary = profiler.GetCpuSummary(passIndex);
+        std::printf("  %-16s gpu avg %.3f p99 %.3f, cpu avg %.3f p99 %.3f\n", profiler.GetPassName(passIndex).c_str(),
+            gpuSummary.avg, gpuSummary.p99, cpuSummary.avg, cpuSummary.p99);
+    }
+}
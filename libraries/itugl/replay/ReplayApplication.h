@@ -0,0 +1,52 @@
+#pragma once
+
+#include "FrameReplayer.h"
+
+#include <ituGL/application/Application.h>
+#include <ituGL/renderer/FrameCapture.h>
+#include <ituGL/renderer/Renderer.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Loads a capture and renders its frames in a loop with a configurable set of passes,
+// then prints the frame times and the times of each pass
+class ReplayApplication : public Application
+{
+public:
+    struct Settings
+    {
+        std::string capturePath;
+        // Passes added to the renderer, in order: "forward", "gbuffer" or "transparency"
+        std::vector<std::string> passes = { "forward" };
+        // Frames rendered before measuring, and frames measured. The captured frames are repeated as needed
+        unsigned int warmupFrames = 10;
+        unsigned int measuredFrames = 100;
+    };
+
+    ReplayApplication(const Settings& settings);
+
+protected:
+    void Initialize() override;
+    void Update() override;
+    void Render() override;
+
+private:
+    bool InitializeRenderer();
+
+    void PrintReport() const;
+
+private:
+    Settings m_settings;
+
+    FrameCapture m_capture;
+    Renderer m_renderer;
+    std::unique_ptr<FrameReplayer> m_replayer;
+
+    unsigned int m_frameIndex;
+    std::chrono::steady_clock::time_point m_frameStart;
+
+    // Wall time of each measured frame, in milliseconds
+    std::vector<float> m_frameTimes;
+};
@@ -0,0 +1,69 @@
+#include "ReplayApplication.h"
+
+#include <ituGL/core/DeviceGL.h>
+#include <ituGL/geometry/VertexArrayObject.h>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <sstream>
+
+// Usage: itugl_replay CAPTURE [--passes forward,gbuffer,transparency] [--warmup N] [--frames M] [--size WIDTHxHEIGHT]
+//        [--no-dsa] [--no-shared-vao] [--windowed]
+// Runs headless unless --windowed is set. The capture must be recorded with the same GL driver, to load its program binaries
+int main(int argc, char** argv)
+{
+    ReplayApplication::Settings settings;
+    Application::HeadlessSettings headlessSettings;
+    headlessSettings.enabled = true;
+    for (int i = 1; i < argc; ++i)
+    {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--passes") == 0 && hasValue)
+        {
+            settings.passes.clear();
+            std::istringstream passes(argv[++i]);
+            std::string pass;
+            while (std::getline(passes, pass, ','))
+            {
+                settings.passes.push_back(pass);
+            }
+        }
+        else if (std::strcmp(argv[i], "--warmup") == 0 && hasValue)
+        {
+            settings.warmupFrames = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--frames") == 0 && hasValue)
+        {
+            settings.measuredFrames = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--size") == 0 && hasValue)
+        {
+            std::sscanf(argv[++i], "%dx%d", &headlessSettings.width, &headlessSettings.height);
+        }
+        else if (std::strcmp(argv[i], "--no-dsa") == 0)
+        {
+            DeviceGL::SetDirectStateAccessEnabled(false);
+        }
+        else if (std::strcmp(argv[i], "--no-shared-vao") == 0)
+        {
+            VertexArrayObject::SetSharingEnabled(false);
+        }
+        else if (std::strcmp(argv[i], "--windowed") == 0)
+        {
+            headlessSettings.enabled = false;
+        }
+        else if (argv[i][0] != '-')
+        {
+            settings.capturePath = argv[i];
+        }
+    }
+    if (settings.capturePath.empty())
+    {
+        std::printf("Usage: itugl_replay CAPTURE [--passes forward,gbuffer,transparency] [--warmup N] [--frames M] [--size WIDTHxHEIGHT] [--no-dsa] [--no-shared-vao] [--windowed]\n");
+        return 1;
+    }
+    Application::SetHeadlessSettings(headlessSettings);
+
+    ReplayApplication replayApplication(settings);
+    return replayApplication.Run();
+}
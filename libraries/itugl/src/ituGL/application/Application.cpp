@@ -1,5 +1,8 @@
 #include <ituGL/application/Application.h>
 
+#include <ituGL/core/CpuProfiler.h>
+#include <ituGL/core/GLInterceptor.h>
+
 // For breaking execution in debug when an unexpected condition is found
 #include <cassert>
 // For accurate application time
@@ -7,14 +10,19 @@
 // For error messages
 #include <iostream>
 
+Application::HeadlessSettings Application::s_headlessSettings;
+
 // DeviceGL and main Window are constructed in the correct order because they were declared like that!
 Application::Application(int width, int height, const char* title)
-    : m_mainWindow(width, height, title), m_currentTime(0), m_deltaTime(0), m_exitCode(0)
+    : m_mainWindow(s_headlessSettings.enabled && s_headlessSettings.width > 0 ? s_headlessSettings.width : width,
+        s_headlessSettings.enabled && s_headlessSettings.height > 0 ? s_headlessSettings.height : height,
+        title, s_headlessSettings.enabled)
+    , m_currentTime(0), m_deltaTime(0), m_fixedTimeStep(0), m_exitCode(0)
 {
     // If the main window is not valid, exit with error
     if (!m_mainWindow.IsValid())
     {
-        Terminate(-1, "Failed to create GLFW window");
+        Terminate(-1, s_headlessSettings.enabled ? "Failed to create headless EGL context" : "Failed to create GLFW window");
         return;
     }
 
@@ -42,25 +50,61 @@ int Application::Run()
     // If the application is not in error state, run
     if (!m_exitCode)
     {
+        CpuProfiler::SetThreadName("Main");
+
         Initialize();
 
         // current time when the application started
         auto startTime = std::chrono::steady_clock::now();
 
+        // Headless runs can stop after a number of frames
+        unsigned int frameCount = s_headlessSettings.enabled ? s_headlessSettings.frameCount : 0;
+        unsigned int frameIndex = 0;
+
         // Main loop
         while (IsRunning())
         {
-            // set current time relative to start time
-            std::chrono::duration<float> duration = std::chrono::steady_clock::now() - startTime;
-            UpdateTime(duration.count());
-
-            Update();
-
-            Render();
+            ITUGL_PROFILE_ZONE("Frame");
+
+            // set current time relative to start time, or advance it a fixed step
+            if (m_fixedTimeStep > 0.0f)
+            {
+                UpdateTime(m_currentTime + m_fixedTimeStep);
+            }
+            else
+            {
+                std::chrono::duration<float> duration = std::chrono::steady_clock::now() - startTime;
+                UpdateTime(duration.count());
+            }
+
+            {
+                ITUGL_PROFILE_ZONE("Update");
+                Update();
+            }
+
+            {
+                ITUGL_PROFILE_ZONE("Render");
+                Render();
+            }
 
             // Swap buffers and poll events at the end of the frame
-            m_mainWindow.SwapBuffers();
-            m_device.PollEvents();
+            {
+                ITUGL_PROFILE_ZONE("SwapBuffers");
+                m_mainWindow.SwapBuffers();
+            }
+            {
+                ITUGL_PROFILE_ZONE("PollEvents");
+                m_device.PollEvents();
+            }
+            if (GLInterceptor::IsEnabled())
+            {
+                GLInterceptor::GetInstance().NextFrame();
+            }
+
+            if (frameCount > 0 && ++frameIndex >= frameCount)
+            {
+                Close();
+            }
         }
 
         Cleanup();
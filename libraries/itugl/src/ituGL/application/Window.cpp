@@ -1,8 +1,33 @@
 #include <ituGL/application/Window.h>
 
+#ifdef ITUGL_HEADLESS
+// Keep the X11 headers (and their macros) out, headless contexts don't use them
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+struct Window::HeadlessContext
+{
+#ifdef ITUGL_HEADLESS
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLSurface surface = EGL_NO_SURFACE;
+    EGLContext context = EGL_NO_CONTEXT;
+#endif
+    int width = 0;
+    int height = 0;
+    bool shouldClose = false;
+};
+
 // Create the internal GLFW window. We provide some hints about it to OpenGL
-Window::Window(int width, int height, const char* title) : m_window(nullptr)
+Window::Window(int width, int height, const char* title, bool headless) : m_window(nullptr)
 {
+    if (headless)
+    {
+        InitializeHeadless(width, height);
+        return;
+    }
+
     // Set some hints for window creation
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
@@ -19,11 +44,113 @@ Window::~Window()
     {
         glfwDestroyWindow(m_window);
     }
+#ifdef ITUGL_HEADLESS
+    if (m_headlessContext)
+    {
+        eglMakeCurrent(m_headlessContext->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(m_headlessContext->display, m_headlessContext->context);
+        eglDestroySurface(m_headlessContext->display, m_headlessContext->surface);
+        eglTerminate(m_headlessContext->display);
+    }
+#endif
+}
+
+void Window::InitializeHeadless(int width, int height)
+{
+#ifdef ITUGL_HEADLESS
+    // Prefer the Mesa surfaceless platform, that uses a render node (or llvmpipe) without a display server
+    EGLDisplay display = EGL_NO_DISPLAY;
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay)
+    {
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+    if (display == EGL_NO_DISPLAY)
+    {
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+    {
+        return;
+    }
+
+    // The pbuffer is the default framebuffer, with the same formats that GLFW requests by default
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_DEPTH_SIZE, 24, EGL_STENCIL_SIZE, 8,
+        EGL_NONE };
+    EGLConfig config;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0 || !eglBindAPI(EGL_OPENGL_API))
+    {
+        eglTerminate(display);
+        return;
+    }
+
+    const EGLint surfaceAttributes[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+    EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+
+    // Same version and profile as the GLFW windows
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 4,
+        EGL_CONTEXT_MINOR_VERSION, 1,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_CONTEXT_OPENGL_FORWARD_COMPATIBLE, EGL_TRUE,
+        EGL_NONE };
+    EGLContext context = surface != EGL_NO_SURFACE ? eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes) : EGL_NO_CONTEXT;
+    if (context == EGL_NO_CONTEXT)
+    {
+        if (surface != EGL_NO_SURFACE)
+        {
+            eglDestroySurface(display, surface);
+        }
+        eglTerminate(display);
+        return;
+    }
+
+    m_headlessContext = std::make_unique<HeadlessContext>();
+    m_headlessContext->display = display;
+    m_headlessContext->surface = surface;
+    m_headlessContext->context = context;
+    m_headlessContext->width = width;
+    m_headlessContext->height = height;
+#endif
+}
+
+bool Window::MakeContextCurrent()
+{
+#ifdef ITUGL_HEADLESS
+    if (m_headlessContext)
+    {
+        return eglMakeCurrent(m_headlessContext->display, m_headlessContext->surface, m_headlessContext->surface, m_headlessContext->context);
+    }
+#endif
+    glfwMakeContextCurrent(m_window);
+    return m_window != nullptr;
+}
+
+Window::ProcAddressFunction Window::GetProcAddressFunction() const
+{
+#ifdef ITUGL_HEADLESS
+    if (m_headlessContext)
+    {
+        return reinterpret_cast<ProcAddressFunction>(eglGetProcAddress);
+    }
+#endif
+    return reinterpret_cast<ProcAddressFunction>(glfwGetProcAddress);
 }
 
 // Get the current dimensions (width and height) of the window
 void Window::GetDimensions(int& width, int& height) const
 {
+    if (m_headlessContext)
+    {
+        width = m_headlessContext->width;
+        height = m_headlessContext->height;
+        return;
+    }
     glfwGetWindowSize(m_window, &width, &height);
 }
 
@@ -38,45 +165,82 @@ float Window::GetAspectRatio() const
 // Tell the window that it should close
 void Window::Close()
 {
+    if (m_headlessContext)
+    {
+        m_headlessContext->shouldClose = true;
+        return;
+    }
     glfwSetWindowShouldClose(m_window, GL_TRUE);
 }
 
 // Get if the window should be closed this frame
 bool Window::ShouldClose() const
 {
+    if (m_headlessContext)
+    {
+        return m_headlessContext->shouldClose;
+    }
     return glfwWindowShouldClose(m_window);
 }
 
 // Swaps the front and back buffers of the window
 void Window::SwapBuffers()
 {
+    // A pbuffer has no front buffer, but swapping still marks the end of the frame for the driver
+#ifdef ITUGL_HEADLESS
+    if (m_headlessContext)
+    {
+        eglSwapBuffers(m_headlessContext->display, m_headlessContext->surface);
+        return;
+    }
+#endif
     glfwSwapBuffers(m_window);
 }
 
+// Headless windows have no input, keys and buttons are always released
 Window::PressedState Window::GetKeyState(int keyCode) const
 {
+    if (m_headlessContext)
+    {
+        return PressedState::Released;
+    }
     return static_cast<PressedState>(glfwGetKey(m_window, keyCode));
 }
 
 Window::PressedState Window::GetMouseButtonState(MouseButton button) const
 {
+    if (m_headlessContext)
+    {
+        return PressedState::Released;
+    }
     return static_cast<PressedState>(glfwGetMouseButton(m_window, static_cast<int>(button)));
 }
 
 bool Window::IsMouseVisible() const
 {
+    if (m_headlessContext)
+    {
+        return true;
+    }
     return glfwGetInputMode(m_window, GLFW_CURSOR) == GLFW_CURSOR_NORMAL;
 }
 
 void Window::SetMouseVisible(bool visible) const
 {
+    if (m_headlessContext)
+    {
+        return;
+    }
     glfwSetInputMode(m_window, GLFW_CURSOR, visible ? GLFW_CURSOR_NORMAL : GLFW_CURSOR_DISABLED);
 }
 
 glm::vec2 Window::GetMousePosition(bool normalized) const
 {
-    double x, y;
-    glfwGetCursorPos(m_window, &x, &y);
+    double x = 0.0, y = 0.0;
+    if (!m_headlessContext)
+    {
+        glfwGetCursorPos(m_window, &x, &y);
+    }
 
     glm::vec2 mousePosition(static_cast<float>(x), static_cast<float>(y));
 
@@ -100,5 +264,9 @@ void Window::SetMousePosition(glm::vec2 mousePosition, bool normalized) const
         mousePosition.y = (mousePosition.y * 0.5f - 0.5f) * -height;
     }
 
+    if (m_headlessContext)
+    {
+        return;
+    }
     glfwSetCursorPos(m_window, mousePosition.x, mousePosition.y);
 }
@@ -0,0 +1,129 @@
+#include <ituGL/asset/AssetLoadQueue.h>
+
+#include <ituGL/core/CpuProfiler.h>
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+AssetLoadQueue::AssetLoadQueue(unsigned int workerCount) : m_stopping(false)
+{
+    for (unsigned int i = 0; i < workerCount; ++i)
+    {
+        m_workers.emplace_back(&AssetLoadQueue::WorkerMain, this);
+    }
+}
+
+AssetLoadQueue::~AssetLoadQueue()
+{
+    // Work that didn't start is dropped, the workers only finish the tasks they are running
+    std::deque<Task> droppedWork;
+    {
+        std::lock_guard<std::mutex> lock(m_workMutex);
+        m_stopping = true;
+        droppedWork.swap(m_work);
+    }
+    m_workCondition.notify_all();
+
+    for (std::thread& worker : m_workers)
+    {
+        worker.join();
+    }
+
+    // Nothing will process the uploads anymore
+    std::deque<Task> droppedUploads;
+    {
+        std::lock_guard<std::mutex> lock(m_uploadMutex);
+        droppedUploads.swap(m_uploads);
+    }
+
+    // Destroying the tasks releases their loads, that fail their futures. See AssetLoader::LoadSharedAsync
+    if (!droppedWork.empty() || !droppedUploads.empty())
+    {
+        std::cout << "ERROR::ASSET::QUEUE_SHUT_DOWN\n" << droppedWork.size() << " tasks and " << droppedUploads.size()
+            << " uploads were dropped" << std::endl;
+    }
+}
+
+AssetLoadQueue& AssetLoadQueue::GetInstance()
+{
+    // Keep one hardware thread for the GL thread
+    static AssetLoadQueue instance(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    return instance;
+}
+
+void AssetLoadQueue::EnqueueWork(Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_workMutex);
+        m_work.push_back(std::move(task));
+    }
+    m_workCondition.notify_one();
+}
+
+void AssetLoadQueue::EnqueueUpload(Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_uploadMutex);
+        m_uploads.push_back(std::move(task));
+    }
+    m_uploadCondition.notify_all();
+}
+
+unsigned int AssetLoadQueue::ProcessUploads()
+{
+    // Take the whole queue at once, so uploads can be queued while we process them
+    std::deque<Task> uploads;
+    {
+        std::lock_guard<std::mutex> lock(m_uploadMutex);
+        uploads.swap(m_uploads);
+    }
+
+    ITUGL_PROFILE_ZONE("AssetLoadQueue::ProcessUploads");
+    for (Task& upload : uploads)
+    {
+        upload();
+    }
+    return static_cast<unsigned int>(uploads.size());
+}
+
+void AssetLoadQueue::WaitForUploads()
+{
+    std::unique_lock<std::mutex> lock(m_uploadMutex);
+    m_uploadCondition.wait(lock, [this] { return !m_uploads.empty(); });
+}
+
+void AssetLoadQueue::WorkerMain()
+{
+    CpuProfiler::SetThreadName("Asset worker");
+
+    while (true)
+    {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(m_workMutex);
+            m_workCondition.wait(lock, [this] { return m_stopping || !m_work.empty(); });
+            if (m_stopping)
+            {
+                break;
+            }
+            task = std::move(m_work.front());
+            m_work.pop_front();
+        }
+        ITUGL_PROFILE_ZONE("AssetLoadQueue::Task");
+
+        // The loaders report their own errors. This only keeps other exceptions from terminating the application
+        try
+        {
+            task();
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "ERROR::ASSET::WORKER_TASK_FAILED\n" << e.what() << std::endl;
+        }
+        catch (...)
+        {
+            std::cout << "ERROR::ASSET::WORKER_TASK_FAILED" << std::endl;
+        }
+    }
+}
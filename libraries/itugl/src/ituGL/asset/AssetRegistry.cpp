@@ -0,0 +1,278 @@
+#include <ituGL/asset/AssetRegistry.h>
+
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <cassert>
+
+bool AssetRegistry::Key::operator == (const Key& other) const
+{
+    return contentHash == other.contentHash && settingsHash == other.settingsHash && type == other.type;
+}
+
+size_t AssetRegistry::KeyHasher::operator()(const Key& key) const
+{
+    // The hashes are already well distributed, combine them with different multipliers
+    return static_cast<size_t>(key.contentHash ^ (key.settingsHash * 0x9E3779B97F4A7C15ull) ^ (key.type.hash_code() * 0xC2B2AE3D27D4EB4Full));
+}
+
+AssetRegistry::AssetRegistry() : m_memoryCap(256 << 20), m_retainedBytes(0)
+{
+}
+
+AssetRegistry& AssetRegistry::GetInstance()
+{
+    static AssetRegistry instance;
+    return instance;
+}
+
+std::uint64_t AssetRegistry::Hash(const void* data, size_t size, std::uint64_t hash)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::uint64_t AssetRegistry::GetContentHash(const char* path)
+{
+    // The size and time tell if the cached hash is still valid. Missing files get the hash of their path
+    std::error_code error;
+    std::uintmax_t fileSize = std::filesystem::file_size(path, error);
+    if (error)
+    {
+        return Hash(path, std::strlen(path));
+    }
+    std::int64_t writeTime = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto itFileHash = m_fileHashes.find(path);
+        if (itFileHash != m_fileHashes.end() && itFileHash->second.fileSize == fileSize && itFileHash->second.writeTime == writeTime)
+        {
+            return itFileHash->second.hash;
+        }
+    }
+
+    // Hash outside the lock, other threads can hash other files meanwhile
+    std::uint64_t hash = Hash(nullptr, 0);
+    std::ifstream file(path, std::ios::binary);
+    std::vector<char> buffer(1 << 16);
+    while (file)
+    {
+        file.read(buffer.data(), buffer.size());
+        hash = Hash(buffer.data(), static_cast<size_t>(file.gcount()), hash);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_fileHashes[path] = FileHash{ hash, fileSize, writeTime };
+    return hash;
+}
+
+std::shared_ptr<void> AssetRegistry::Find(const Key& key)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto itEntry = m_entries.find(key);
+    std::shared_ptr<void> asset = itEntry != m_entries.end() ? itEntry->second.asset.lock() : nullptr;
+    if (asset)
+    {
+        ++m_stats.hits;
+        Touch(itEntry->second, key, asset);
+    }
+    else
+    {
+        ++m_stats.misses;
+    }
+    return asset;
+}
+
+bool AssetRegistry::IsLoaded(const Key& key) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto itEntry = m_entries.find(key);
+    return itEntry != m_entries.end() && !itEntry->second.asset.expired();
+}
+
+AssetRegistry::Reservation AssetRegistry::Reserve(const Key& key, std::shared_ptr<void>& asset, AddedFunction onAdded)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Entry& entry = m_entries[key];
+    if (entry.pending)
+    {
+        ++m_stats.hits;
+        entry.onAdded.push_back(onAdded);
+        return Reservation::Pending;
+    }
+
+    asset = entry.asset.lock();
+    if (asset)
+    {
+        ++m_stats.hits;
+        Touch(entry, key, asset);
+        return Reservation::Found;
+    }
+
+    ++m_stats.misses;
+    entry.pending = true;
+    return Reservation::Reserved;
+}
+
+void AssetRegistry::Add(const Key& key, std::shared_ptr<void> asset, size_t memorySize, const std::string& name)
+{
+    std::vector<AddedFunction> onAdded;
+    std::vector<std::shared_ptr<void>> released;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        Entry& entry = m_entries[key];
+        if (entry.retained)
+        {
+            // Replacing an asset that was loaded again
+            m_retainedBytes -= entry.memorySize;
+            m_lru.erase(entry.lruPosition);
+            released.push_back(std::move(entry.retained));
+        }
+        entry.name = name;
+        entry.asset = asset;
+        entry.memorySize = memorySize;
+        entry.pending = false;
+        onAdded.swap(entry.onAdded);
+
+        Touch(entry, key, asset);
+        Evict(released);
+    }
+
+    // Outside the lock, the callbacks could use the registry
+    for (AddedFunction& function : onAdded)
+    {
+        function(asset);
+    }
+}
+
+void AssetRegistry::Cancel(const Key& key)
+{
+    std::vector<AddedFunction> onAdded;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto itEntry = m_entries.find(key);
+        assert(itEntry != m_entries.end() && itEntry->second.pending);
+        onAdded.swap(itEntry->second.onAdded);
+        if (!itEntry->second.retained)
+        {
+            m_entries.erase(itEntry);
+        }
+        else
+        {
+            itEntry->second.pending = false;
+        }
+    }
+
+    for (AddedFunction& function : onAdded)
+    {
+        function(nullptr);
+    }
+}
+
+void AssetRegistry::SetMemoryCap(size_t memoryCap)
+{
+    std::vector<std::shared_ptr<void>> released;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_memoryCap = memoryCap;
+    Evict(released);
+}
+
+size_t AssetRegistry::GetRetainedBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_retainedBytes;
+}
+
+size_t AssetRegistry::GetAssetCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+AssetRegistry::Stats AssetRegistry::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void AssetRegistry::ResetStats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats = Stats();
+}
+
+void AssetRegistry::Clear()
+{
+    std::vector<std::shared_ptr<void>> released;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto itEntry = m_entries.begin(); itEntry != m_entries.end();)
+        {
+            Entry& entry = itEntry->second;
+            if (entry.retained)
+            {
+                released.push_back(std::move(entry.retained));
+            }
+            if (!entry.pending && entry.asset.use_count() <= 1)
+            {
+                itEntry = m_entries.erase(itEntry);
+            }
+            else
+            {
+                ++itEntry;
+            }
+        }
+        m_lru.clear();
+        m_retainedBytes = 0;
+    }
+    // The assets are destroyed here, outside the lock
+}
+
+void AssetRegistry::Touch(Entry& entry, const Key& key, std::shared_ptr<void> asset)
+{
+    ++entry.useCount;
+    if (entry.retained)
+    {
+        m_lru.splice(m_lru.begin(), m_lru, entry.lruPosition);
+    }
+    else
+    {
+        entry.retained = asset;
+        m_lru.push_front(key);
+        entry.lruPosition = m_lru.begin();
+        m_retainedBytes += entry.memorySize;
+    }
+}
+
+void AssetRegistry::Evict(std::vector<std::shared_ptr<void>>& released)
+{
+    // The most recently used asset is always kept, even if it doesn't fit alone
+    while (m_retainedBytes > m_memoryCap && m_lru.size() > 1)
+    {
+        auto itEntry = m_entries.find(m_lru.back());
+        assert(itEntry != m_entries.end());
+        Entry& entry = itEntry->second;
+
+        m_lru.pop_back();
+        m_retainedBytes -= entry.memorySize;
+        ++m_stats.evictions;
+
+        // If nobody else uses the asset, it is destroyed and the entry is forgotten
+        released.push_back(std::move(entry.retained));
+        if (entry.asset.use_count() == 1 && !entry.pending)
+        {
+            m_entries.erase(itEntry);
+        }
+    }
+}
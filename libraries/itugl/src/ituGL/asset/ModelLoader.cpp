@@ -3,15 +3,49 @@
 #include <ituGL/geometry/VertexFormat.h>
 #include <ituGL/shader/Material.h>
 #include <ituGL/asset/Texture2DLoader.h>
+#include <ituGL/texture/TextureStreamingManager.h>
+#include <ituGL/core/CpuProfiler.h>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
+#include <glm/common.hpp>
 #include <iostream>
+#include <sstream>
+#include <map>
+#include <algorithm>
 #include <bit>
+#include <cstring>
+#include <limits>
+
+struct ModelLoader::SubmeshData
+{
+    VertexFormat vertexFormat;
+    std::vector<GLubyte> vertexData;
+
+    Data::Type elementType = Data::Type::None;
+    std::vector<Drawcall::Primitive> primitives;
+    std::vector<int> elementCounts;
+    std::vector<GLubyte> elementData;
+};
+
+struct ModelLoader::BuildSettings
+{
+    // Folder of the model, including the last slash. Texture paths are relative to it
+    std::string baseFolder;
+    std::shared_ptr<Material> referenceMaterial;
+    Mesh::SemanticMap materialAttributeMap;
+    std::unordered_map<MaterialProperty, ShaderProgram::Location> materialPropertyMap;
+    bool createMaterials;
+    bool packGeometry;
+};
+
+std::atomic<std::uint64_t> ModelLoader::s_referenceMaterialCount(0);
 
 ModelLoader::ModelLoader(std::shared_ptr<Material> referenceMaterial)
     : m_referenceMaterial(referenceMaterial)
+    , m_referenceMaterialId(referenceMaterial ? ++s_referenceMaterialCount : 0)
     , m_createMaterials(false)
+    , m_packGeometry(false)
 {
     m_textureLoader.SetGenerateMipmap(true);
 }
@@ -26,7 +60,9 @@ void ModelLoader::SetReferenceMaterial(std::shared_ptr<Material> referenceMateri
     // Clear the previous attribute map
     m_materialAttributeMap.clear();
 
+    // Models loaded with another material are different assets, even if it is the same one set again
     m_referenceMaterial = referenceMaterial;
+    m_referenceMaterialId = referenceMaterial ? ++s_referenceMaterialCount : 0;
 }
 
 bool ModelLoader::GetCreateMaterials() const
@@ -39,6 +75,16 @@ void ModelLoader::SetCreateMaterials(bool createMaterials)
     m_createMaterials = createMaterials;
 }
 
+bool ModelLoader::GetPackGeometry() const
+{
+    return m_packGeometry;
+}
+
+void ModelLoader::SetPackGeometry(bool packGeometry)
+{
+    m_packGeometry = packGeometry;
+}
+
 Texture2DLoader& ModelLoader::GetTexture2DLoader()
 {
     return m_textureLoader;
@@ -75,6 +121,7 @@ bool ModelLoader::SetMaterialProperty(MaterialProperty materialProperty, const c
 
 Model ModelLoader::Load(const char* path)
 {
+    ITUGL_PROFILE_ZONE("ModelLoader::Load");
     Model model;
 
     // Read the file using Assimp importer
@@ -82,24 +129,32 @@ Model ModelLoader::Load(const char* path)
     const aiScene* scene = importer.ReadFile(path,
         aiProcess_CalcTangentSpace | aiProcess_GenNormals | aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_SortByPType);
 
-    m_baseFolder = path;
-    m_baseFolder.resize(m_baseFolder.rfind('/') + 1);
+    BuildSettings settings = GetBuildSettings(path);
 
     // If the file was loaded, load all the meshes as submeshes
     if (scene)
     {
+        model.SetBounds(ComputeBounds(*scene));
+
+        std::vector<SubmeshData> submeshes;
+        for (unsigned int meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex)
+        {
+            submeshes.push_back(CollectSubmeshData(*scene->mMeshes[meshIndex]));
+        }
+
         model.SetMesh(std::make_shared<Mesh>());
         Mesh& mesh = model.GetMesh();
+        AddMeshData(mesh, submeshes, settings);
+
         for (unsigned int meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex)
         {
             aiMesh& meshData = *scene->mMeshes[meshIndex];
-            GenerateSubmesh(mesh, meshData);
 
-            std::shared_ptr<Material> material = m_referenceMaterial;
-            if (m_createMaterials)
+            std::shared_ptr<Material> material = settings.referenceMaterial;
+            if (settings.createMaterials)
             {
                 // Create a new material with the material data
-                material = GenerateMaterial(*scene->mMaterials[meshData.mMaterialIndex]);
+                material = GenerateMaterial(*scene->mMaterials[meshData.mMaterialIndex], settings);
             }
             model.AddMaterial(material);
         }
@@ -108,40 +163,325 @@ Model ModelLoader::Load(const char* path)
     return model;
 }
 
-void ModelLoader::GenerateSubmesh(Mesh& mesh, const aiMesh& meshData)
+ModelLoader::DecodeTask ModelLoader::CreateDecodeTask(const char* path)
+{
+    // Copy the settings, they could change before the task runs. The worker doesn't use the loader
+    std::string pathString(path);
+    std::shared_ptr<const BuildSettings> settings = std::make_shared<BuildSettings>(GetBuildSettings(path));
+    bool flipVertical = m_textureLoader.GetFlipVertical();
+    bool generateMipLevels = m_textureLoader.GetStreamingManager() != nullptr;
+    std::unordered_map<MaterialProperty, std::string> textureSharedSettings = GetTextureSharedSettings(*settings);
+
+    // Only the finish function, on the GL thread, uses the loader, to create the textures
+    return [this, pathString, settings, flipVertical, generateMipLevels, textureSharedSettings]() -> FinishFunction
+        {
+            ITUGL_PROFILE_ZONE("ModelLoader::Decode");
+
+            // Read the file using Assimp importer. Keep the importer alive until the model is created
+            std::shared_ptr<Assimp::Importer> importer = std::make_shared<Assimp::Importer>();
+            const aiScene* scene = importer->ReadFile(pathString,
+                aiProcess_CalcTangentSpace | aiProcess_GenNormals | aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_SortByPType);
+
+            std::shared_ptr<std::vector<SubmeshData>> submeshes = std::make_shared<std::vector<SubmeshData>>();
+            std::shared_ptr<DecodedTextureMap> decodedTextures = std::make_shared<DecodedTextureMap>();
+            if (scene)
+            {
+                // Collect the vertex and element data
+                for (unsigned int meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex)
+                {
+                    submeshes->push_back(CollectSubmeshData(*scene->mMeshes[meshIndex]));
+                }
+
+                // Decode the textures used by the materials. Textures already loaded, by any loader, are not decoded again
+                AssetRegistry& registry = AssetRegistry::GetInstance();
+                for (unsigned int materialIndex = 0; settings->createMaterials && materialIndex < scene->mNumMaterials; ++materialIndex)
+                {
+                    const aiMaterial& materialData = *scene->mMaterials[materialIndex];
+                    for (auto& materialPropertyPair : settings->materialPropertyMap)
+                    {
+                        int textureType;
+                        TextureObject::Format format;
+                        TextureObject::InternalFormat internalFormat;
+                        std::string texturePath;
+                        if (GetTextureInfo(materialPropertyPair.first, textureType, format, internalFormat)
+                            && GetTexturePath(materialData, textureType, settings->baseFolder, texturePath)
+                            && decodedTextures->find(texturePath) == decodedTextures->end())
+                        {
+                            // If the texture is released before the model is created, it is loaded again on the GL thread
+                            auto itSharedSettings = textureSharedSettings.find(materialPropertyPair.first);
+                            if (itSharedSettings != textureSharedSettings.end()
+                                && registry.IsLoaded(registry.GetKey<Texture2DObject>(texturePath.c_str(), itSharedSettings->second)))
+                            {
+                                continue;
+                            }
+                            (*decodedTextures)[texturePath] = TextureLoaderUtils::LoadTextureData(texturePath.c_str(), format, internalFormat, flipVertical, generateMipLevels);
+                        }
+                    }
+                }
+            }
+
+            AabbBounds bounds = scene ? ComputeBounds(*scene) : AabbBounds(glm::vec3(0.0f), glm::vec3(1.0f));
+
+            return [this, importer, settings, submeshes, decodedTextures, bounds]()
+                {
+                    std::shared_ptr<Model> modelPtr = std::make_shared<Model>();
+                    Model& model = *modelPtr;
+
+                    // If the file was loaded, create all the meshes as submeshes
+                    const aiScene* scene = importer->GetScene();
+                    if (scene)
+                    {
+                        model.SetBounds(bounds);
+
+                        model.SetMesh(std::make_shared<Mesh>());
+                        Mesh& mesh = model.GetMesh();
+                        AddMeshData(mesh, *submeshes, *settings);
+
+                        for (unsigned int meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex)
+                        {
+                            std::shared_ptr<Material> material = settings->referenceMaterial;
+                            if (settings->createMaterials)
+                            {
+                                // Create a new material with the material data
+                                material = GenerateMaterial(*scene->mMaterials[scene->mMeshes[meshIndex]->mMaterialIndex], *settings, decodedTextures.get());
+                            }
+                            model.AddMaterial(material);
+                        }
+                    }
+
+                    return modelPtr;
+                };
+        };
+}
+
+ModelLoader::BuildSettings ModelLoader::GetBuildSettings(const char* path) const
+{
+    return BuildSettings{ GetBaseFolder(path), m_referenceMaterial, m_materialAttributeMap, m_materialPropertyMap, m_createMaterials, m_packGeometry };
+}
+
+std::unordered_map<ModelLoader::MaterialProperty, std::string> ModelLoader::GetTextureSharedSettings(const BuildSettings& settings) const
 {
+    std::unordered_map<MaterialProperty, std::string> textureSharedSettings;
+    if (m_textureLoader.GetKeepShared())
+    {
+        for (auto& materialPropertyPair : settings.materialPropertyMap)
+        {
+            int textureType;
+            TextureObject::Format format;
+            TextureObject::InternalFormat internalFormat;
+            if (GetTextureInfo(materialPropertyPair.first, textureType, format, internalFormat))
+            {
+                // Same formats that LoadTexture sets before looking for the texture
+                m_textureLoader.SetFormat(format);
+                m_textureLoader.SetInternalFormat(internalFormat);
+                textureSharedSettings[materialPropertyPair.first] = m_textureLoader.GetSharedSettings();
+            }
+        }
+    }
+    return textureSharedSettings;
+}
+
+std::string ModelLoader::GetImportSettings() const
+{
+    std::ostringstream settings;
+    settings << m_referenceMaterialId << " " << m_createMaterials << " " << m_packGeometry;
+
+    // Sort the maps, so the same settings always give the same string
+    std::map<VertexAttribute::Semantic, ShaderProgram::Location> attributeMap(m_materialAttributeMap.begin(), m_materialAttributeMap.end());
+    for (auto& attributePair : attributeMap)
+    {
+        settings << " a" << static_cast<int>(attributePair.first) << "=" << attributePair.second;
+    }
+    std::map<MaterialProperty, ShaderProgram::Location> propertyMap(m_materialPropertyMap.begin(), m_materialPropertyMap.end());
+    for (auto& propertyPair : propertyMap)
+    {
+        settings << " p" << static_cast<int>(propertyPair.first) << "=" << propertyPair.second;
+    }
+
+    // Flipped or streamed textures make a different model
+    settings << " " << m_textureLoader.GetFlipVertical() << " " << m_textureLoader.GetStreamingManager();
+    return settings.str();
+}
+
+size_t ModelLoader::GetMemorySize(const Model& model) const
+{
+    size_t memorySize = sizeof(Model);
+    if (model.HasMesh())
+    {
+        const Mesh& mesh = model.GetMesh();
+        for (unsigned int vboIndex = 0; vboIndex < mesh.GetVertexBufferCount(); ++vboIndex)
+        {
+            memorySize += mesh.GetVertexBuffer(vboIndex).GetSize();
+        }
+        for (unsigned int eboIndex = 0; eboIndex < mesh.GetElementBufferCount(); ++eboIndex)
+        {
+            memorySize += mesh.GetElementBuffer(eboIndex).GetSize();
+        }
+    }
+    return memorySize;
+}
+
+AabbBounds ModelLoader::ComputeBounds(const aiScene& scene)
+{
+    glm::vec3 min(std::numeric_limits<float>::max());
+    glm::vec3 max(std::numeric_limits<float>::lowest());
+    for (unsigned int meshIndex = 0; meshIndex < scene.mNumMeshes; ++meshIndex)
+    {
+        const aiMesh& meshData = *scene.mMeshes[meshIndex];
+        for (unsigned int vertexIndex = 0; vertexIndex < meshData.mNumVertices; ++vertexIndex)
+        {
+            const aiVector3D& position = meshData.mVertices[vertexIndex];
+            glm::vec3 vertex(position.x, position.y, position.z);
+            min = glm::min(min, vertex);
+            max = glm::max(max, vertex);
+        }
+    }
+
+    // Empty scene, keep the default bounds
+    if (min.x > max.x)
+    {
+        return AabbBounds(glm::vec3(0.0f), glm::vec3(1.0f));
+    }
+    return AabbBounds(0.5f * (min + max), 0.5f * (max - min));
+}
+
+ModelLoader::SubmeshData ModelLoader::CollectSubmeshData(const aiMesh& meshData)
+{
+    SubmeshData submeshData;
+
     // Collect vertex data
-    VertexFormat vertexFormat;
     bool interleaved = true;
-    std::vector<GLubyte> vertexData = CollectVertexData(meshData, vertexFormat, interleaved);
-    int vboIndex = mesh.AddVertexData<GLubyte>(vertexData);
+    submeshData.vertexData = CollectVertexData(meshData, submeshData.vertexFormat, interleaved);
 
     // Collect element data
-    Data::Type elementType;
-    std::vector<Drawcall::Primitive> primitives;
-    std::vector<int> elementCounts;
-    std::vector<GLubyte> elementData = CollectElementData(meshData, elementType, primitives, elementCounts);
-    int eboIndex = mesh.AddElementData<GLubyte>(elementData);
+    submeshData.elementData = CollectElementData(meshData, submeshData.elementType, submeshData.primitives, submeshData.elementCounts);
+
+    return submeshData;
+}
+
+void ModelLoader::AddSubmeshData(Mesh& mesh, const SubmeshData& submeshData, const BuildSettings& settings)
+{
+    // Vertex data is always collected interleaved
+    bool interleaved = true;
+    VertexFormat vertexFormat = submeshData.vertexFormat;
+
+    int vboIndex = mesh.AddVertexData<GLubyte>(submeshData.vertexData);
+    int eboIndex = mesh.AddElementData<GLubyte>(submeshData.elementData);
 
     // Add submeshes
     int start = 0;
-    assert(primitives.size() == elementCounts.size());
-    for (int i = 0; i < primitives.size(); ++i)
+    assert(submeshData.primitives.size() == submeshData.elementCounts.size());
+    for (int i = 0; i < submeshData.primitives.size(); ++i)
     {
-        Drawcall::Primitive primitive = primitives[i];
-        int end = elementCounts[i];
-        mesh.AddSubmesh(primitive, start, end - start, elementType, eboIndex, vboIndex, vertexFormat.LayoutBegin(static_cast<int>(vertexData.size()), interleaved), vertexFormat.LayoutEnd(), m_materialAttributeMap);
+        Drawcall::Primitive primitive = submeshData.primitives[i];
+        int end = submeshData.elementCounts[i];
+        mesh.AddSubmesh(primitive, start, end - start, submeshData.elementType, vboIndex, eboIndex, vertexFormat.LayoutBegin(static_cast<int>(submeshData.vertexData.size()), interleaved), vertexFormat.LayoutEnd(), settings.materialAttributeMap);
         start = end;
     }
 }
 
-std::shared_ptr<Material> ModelLoader::GenerateMaterial(const aiMaterial& materialData)
+void ModelLoader::AddMeshData(Mesh& mesh, std::span<const SubmeshData> submeshes, const BuildSettings& settings)
+{
+    if (settings.packGeometry)
+    {
+        AddPackedMeshData(mesh, submeshes, settings);
+        return;
+    }
+
+    for (const SubmeshData& submeshData : submeshes)
+    {
+        AddSubmeshData(mesh, submeshData, settings);
+    }
+}
+
+void ModelLoader::AddPackedMeshData(Mesh& mesh, std::span<const SubmeshData> submeshes, const BuildSettings& settings)
+{
+    // Buffers shared by the submeshes with the same vertex format
+    struct PackedGroup
+    {
+        const VertexFormat* vertexFormat;
+        // Widest element type of the submeshes in the group
+        Data::Type elementType;
+        std::vector<GLubyte> vertexData;
+        std::vector<GLubyte> elementData;
+        unsigned int vboIndex;
+        unsigned int eboIndex;
+        // First submesh added with the buffers. The others reuse its VAO
+        int firstSubmeshIndex;
+    };
+
+    // Find the group of each submesh
+    std::vector<PackedGroup> groups;
+    std::vector<size_t> groupIndices;
+    for (const SubmeshData& submeshData : submeshes)
+    {
+        auto itGroup = std::find_if(groups.begin(), groups.end(),
+            [&](const PackedGroup& group) { return *group.vertexFormat == submeshData.vertexFormat; });
+        if (itGroup == groups.end())
+        {
+            itGroup = groups.insert(groups.end(), PackedGroup{ &submeshData.vertexFormat, submeshData.elementType, {}, {}, 0, 0, -1 });
+        }
+        else if (Data::GetTypeSize(submeshData.elementType) > Data::GetTypeSize(itGroup->elementType))
+        {
+            itGroup->elementType = submeshData.elementType;
+        }
+        groupIndices.push_back(itGroup - groups.begin());
+    }
+
+    // Append the data of each submesh to its group. Elements are not offset, the base vertex is added when drawing
+    std::vector<GLint> baseVertices;
+    std::vector<GLint> firstElements;
+    for (size_t submeshIndex = 0; submeshIndex < submeshes.size(); ++submeshIndex)
+    {
+        const SubmeshData& submeshData = submeshes[submeshIndex];
+        PackedGroup& group = groups[groupIndices[submeshIndex]];
+        baseVertices.push_back(static_cast<GLint>(group.vertexData.size() / group.vertexFormat->GetSize()));
+        firstElements.push_back(static_cast<GLint>(group.elementData.size() / Data::GetTypeSize(group.elementType)));
+        group.vertexData.insert(group.vertexData.end(), submeshData.vertexData.begin(), submeshData.vertexData.end());
+        AppendElementData(group.elementData, group.elementType, submeshData.elementData, submeshData.elementType);
+    }
+
+    for (PackedGroup& group : groups)
+    {
+        group.vboIndex = mesh.AddVertexData<GLubyte>(group.vertexData);
+        group.eboIndex = mesh.AddElementData<GLubyte>(group.elementData);
+    }
+
+    // Add the submeshes in the original order, so they match the materials
+    bool interleaved = true;
+    for (size_t submeshIndex = 0; submeshIndex < submeshes.size(); ++submeshIndex)
+    {
+        const SubmeshData& submeshData = submeshes[submeshIndex];
+        PackedGroup& group = groups[groupIndices[submeshIndex]];
+
+        int start = 0;
+        assert(submeshData.primitives.size() == submeshData.elementCounts.size());
+        for (int i = 0; i < submeshData.primitives.size(); ++i)
+        {
+            int end = submeshData.elementCounts[i];
+            Drawcall drawcall(submeshData.primitives[i], end - start, group.elementType, firstElements[submeshIndex] + start, baseVertices[submeshIndex]);
+            if (group.firstSubmeshIndex < 0)
+            {
+                VertexFormat vertexFormat = *group.vertexFormat;
+                group.firstSubmeshIndex = mesh.AddSubmesh(drawcall, group.vboIndex, group.eboIndex,
+                    vertexFormat.LayoutBegin(static_cast<int>(group.vertexData.size()), interleaved), vertexFormat.LayoutEnd(), settings.materialAttributeMap);
+            }
+            else
+            {
+                mesh.AddSubmeshFrom(group.firstSubmeshIndex, drawcall);
+            }
+            start = end;
+        }
+    }
+}
+
+std::shared_ptr<Material> ModelLoader::GenerateMaterial(const aiMaterial& materialData, const BuildSettings& settings, const DecodedTextureMap* decodedTextures)
 {
-    std::shared_ptr<Material> material = std::make_shared<Material>(*m_referenceMaterial);
+    std::shared_ptr<Material> material = std::make_shared<Material>(*settings.referenceMaterial);
     float value;
     glm::vec3 HaveTextures(0);
 
-    for (auto& materialPropertyPair : m_materialPropertyMap)
+    for (auto& materialPropertyPair : settings.materialPropertyMap)
     {
         aiColor3D color;
         MaterialProperty materialProperty = materialPropertyPair.first;
@@ -173,15 +513,15 @@ std::shared_ptr<Material> ModelLoader::GenerateMaterial(const aiMaterial& materi
             }
             break;
         case MaterialProperty::DiffuseTexture:
-            if(LoadTexture(materialData, aiTextureType_DIFFUSE, *material, location, TextureObject::FormatRGB, TextureObject::InternalFormatSRGB8))
+            if(LoadTexture(materialData, materialProperty, *material, location, settings.baseFolder, decodedTextures))
                 HaveTextures.x = 1;
             break;
         case MaterialProperty::NormalTexture:
-            if(LoadTexture(materialData, aiTextureType_NORMALS, *material, location, TextureObject::FormatRGB, TextureObject::InternalFormatRGB8))
+            if(LoadTexture(materialData, materialProperty, *material, location, settings.baseFolder, decodedTextures))
                 HaveTextures.y = 1;
             break;
         case MaterialProperty::SpecularTexture:
-            if(LoadTexture(materialData, aiTextureType_SHININESS, *material, location, TextureObject::FormatRGB, TextureObject::InternalFormatSRGB8))
+            if(LoadTexture(materialData, materialProperty, *material, location, settings.baseFolder, decodedTextures))
                 HaveTextures.z = 1;
             break;
         }
@@ -190,27 +530,92 @@ std::shared_ptr<Material> ModelLoader::GenerateMaterial(const aiMaterial& materi
     return material;
 }
 
-bool ModelLoader::LoadTexture(const aiMaterial& materialData, int textureTypeValue, Material& material, ShaderProgram::Location location,
-    TextureObject::Format format, TextureObject::InternalFormat internalFormat) const
+bool ModelLoader::LoadTexture(const aiMaterial& materialData, MaterialProperty materialProperty, Material& material, ShaderProgram::Location location,
+    const std::string& baseFolder, const DecodedTextureMap* decodedTextures) const
+{
+    int textureType;
+    TextureObject::Format format;
+    TextureObject::InternalFormat internalFormat;
+    std::string texturePath;
+    if (GetTextureInfo(materialProperty, textureType, format, internalFormat)
+        && GetTexturePath(materialData, textureType, baseFolder, texturePath))
+    {
+        // The formats are part of the texture settings, set them before looking for it
+        m_textureLoader.SetFormat(format);
+        m_textureLoader.SetInternalFormat(internalFormat);
+
+        std::shared_ptr<Texture2DObject> texture = m_textureLoader.FindShared(texturePath.c_str());
+        if (!texture && decodedTextures)
+        {
+            // Upload the texture that was decoded ahead of time
+            auto itDecoded = decodedTextures->find(texturePath);
+            if (itDecoded != decodedTextures->end())
+            {
+                // Let the streaming manager upload the mip levels, if they were filtered
+                TextureStreamingManager* streamingManager = m_textureLoader.GetStreamingManager();
+                texture = streamingManager && !itDecoded->second->mipLevels.empty() ? streamingManager->AddTexture(texturePath, itDecoded->second)
+                    : std::make_shared<Texture2DObject>(Texture2DLoader::CreateTexture(*itDecoded->second, m_textureLoader.GetGenerateMipmap()));
+                m_textureLoader.AddShared(texturePath.c_str(), texture);
+            }
+        }
+        if (!texture)
+        {
+            texture = m_textureLoader.LoadShared(texturePath.c_str());
+        }
+        material.SetUniformValue(location, texture);
+        return true;
+    }
+    return false;
+}
+
+bool ModelLoader::GetTextureInfo(MaterialProperty materialProperty, int& textureType,
+    TextureObject::Format& format, TextureObject::InternalFormat& internalFormat)
+{
+    switch (materialProperty)
+    {
+    case MaterialProperty::DiffuseTexture:
+        textureType = aiTextureType_DIFFUSE;
+        format = TextureObject::FormatRGB;
+        internalFormat = TextureObject::InternalFormatSRGB8;
+        return true;
+    case MaterialProperty::NormalTexture:
+        textureType = aiTextureType_NORMALS;
+        format = TextureObject::FormatRGB;
+        internalFormat = TextureObject::InternalFormatRGB8;
+        return true;
+    case MaterialProperty::SpecularTexture:
+        textureType = aiTextureType_SHININESS;
+        format = TextureObject::FormatRGB;
+        internalFormat = TextureObject::InternalFormatSRGB8;
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool ModelLoader::GetTexturePath(const aiMaterial& materialData, int textureTypeValue, const std::string& baseFolder, std::string& texturePath)
 {
     aiTextureType textureType = static_cast<aiTextureType>(textureTypeValue);
     if (materialData.GetTextureCount(textureType) > 0)
     {
         assert(materialData.GetTextureCount(textureType) == 1);
-        aiString texturePath;
-        if (materialData.GetTexture(textureType, 0, &texturePath) == aiReturn_SUCCESS)
+        aiString textureName;
+        if (materialData.GetTexture(textureType, 0, &textureName) == aiReturn_SUCCESS)
         {
-            texturePath = m_baseFolder + texturePath.C_Str();
-            m_textureLoader.SetFormat(format);
-            m_textureLoader.SetInternalFormat(internalFormat);
-            std::shared_ptr<Texture2DObject> texture = m_textureLoader.LoadShared(texturePath.C_Str());
-            material.SetUniformValue(location, texture);
+            texturePath = baseFolder + textureName.C_Str();
             return true;
         }
     }
     return false;
 }
 
+std::string ModelLoader::GetBaseFolder(const char* path)
+{
+    std::string baseFolder(path);
+    baseFolder.resize(baseFolder.rfind('/') + 1);
+    return baseFolder;
+}
+
 std::vector<GLubyte> ModelLoader::CollectVertexData(const aiMesh& meshData, VertexFormat& vertexFormat, bool interleaved)
 {
     vertexFormat.Clear();
@@ -299,11 +704,11 @@ std::vector<GLubyte> ModelLoader::CollectElementData(const aiMesh& meshData, Dat
             primitives.push_back(GetPrimitiveType(face.mNumIndices));
             if (currentSize > 0)
             {
-                elementCounts.push_back(currentSize);
+                elementCounts.push_back(currentSize / elementSize);
             }
         }
     }
-    elementCounts.push_back(static_cast<int>(elementData.size()));
+    elementCounts.push_back(static_cast<int>(elementData.size()) / elementSize);
 
     return elementData;
 }
@@ -366,6 +771,52 @@ const void* ModelLoader::GetVertexDataPointer(const aiMesh& meshData, VertexAttr
     return data;
 }
 
+void ModelLoader::AppendElementData(std::vector<GLubyte>& elementData, Data::Type elementType,
+    std::span<const GLubyte> srcElementData, Data::Type srcElementType)
+{
+    if (elementType == srcElementType)
+    {
+        elementData.insert(elementData.end(), srcElementData.begin(), srcElementData.end());
+        return;
+    }
+
+    int elementSize = Data::GetTypeSize(elementType);
+    int srcElementSize = Data::GetTypeSize(srcElementType);
+    assert(elementSize > srcElementSize);
+
+    size_t elementCount = srcElementData.size() / srcElementSize;
+    size_t currentSize = elementData.size();
+    elementData.resize(currentSize + elementCount * elementSize);
+
+    // Read each element with its own type, to keep the value with any endianness
+    for (size_t i = 0; i < elementCount; ++i)
+    {
+        const GLubyte* src = &srcElementData[i * srcElementSize];
+        GLuint element = 0;
+        if (srcElementSize == 1)
+        {
+            element = *src;
+        }
+        else
+        {
+            GLushort shortElement;
+            std::memcpy(&shortElement, src, sizeof(shortElement));
+            element = shortElement;
+        }
+
+        GLubyte* dst = &elementData[currentSize + i * elementSize];
+        if (elementSize == 2)
+        {
+            GLushort shortElement = static_cast<GLushort>(element);
+            std::memcpy(dst, &shortElement, sizeof(shortElement));
+        }
+        else
+        {
+            std::memcpy(dst, &element, sizeof(element));
+        }
+    }
+}
+
 void ModelLoader::CopyBuffer(void* dstBuffer, size_t dstStride, const void* srcBuffer, size_t srcStride, size_t count, size_t size)
 {
     if (srcStride == size && (dstStride == 0 || dstStride == srcStride))
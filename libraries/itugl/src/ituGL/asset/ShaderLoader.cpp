@@ -1,13 +1,20 @@
 #include <ituGL/asset/ShaderLoader.h>
 
+#include <ituGL/asset/AssetRegistry.h>
+#include <filesystem>
 #include <fstream>
 #include <sstream>
 #include <vector>
 #include <array>
+#include <chrono>
 #include <cassert>
 
 #include <iostream>
 
+std::unordered_map<std::string, std::shared_ptr<const std::string>> ShaderLoader::s_sources;
+std::mutex ShaderLoader::s_mutex;
+ShaderLoader::Stats ShaderLoader::s_stats;
+
 ShaderLoader::ShaderLoader(Shader::Type type) : m_type(type)
 {
 }
@@ -24,32 +31,18 @@ bool ShaderLoader::IsValid(std::span<const char*> paths)
 
 Shader ShaderLoader::Load(const char* path)
 {
-    Shader shader(m_type);
-    std::ifstream file(path);
-    assert(file.is_open());
-    std::stringstream stringStream;
-    stringStream << file.rdbuf() << '\0';
-    shader.SetSource(stringStream.str().c_str());
-    Compile(shader);
-    return shader;
+    return Load(std::span(&path, 1));
 }
 
 Shader ShaderLoader::Load(std::span<const char*> paths)
 {
     Shader shader(m_type);
-    std::vector<std::stringstream> stringStreams(paths.size());
-    std::vector<std::string> sourceCodeStrings(paths.size());
-    std::vector<const char*> sourceCode(paths.size());
-    for (int i = 0; i < paths.size(); ++i)
-    {
-        std::ifstream file(paths[i]);
-        assert(file.is_open());
-        stringStreams[i] << file.rdbuf() << '\0';
-        sourceCodeStrings[i] = stringStreams[i].str();
-        sourceCode[i] = sourceCodeStrings[i].c_str();
-    }
-    shader.SetSource(sourceCode);
-    Compile(shader);
+    std::string source;
+    if (ExpandSource(paths, m_defines, source))
+    {
+        shader.SetSource(source.c_str());
+        Compile(shader);
+    }
     return shader;
 }
 
@@ -73,9 +66,177 @@ bool ShaderLoader::LoadInto(Shader& shader, std::span<const char*> paths)
     return valid;
 }
 
-void ShaderLoader::Compile(Shader& shader)
+std::shared_ptr<Shader> ShaderLoader::LoadShared(std::span<const char*> paths, bool waitCompile)
+{
+    // The defines are in the expanded source, so each variant is a different asset
+    std::string source;
+    if (!ExpandSource(paths, m_defines, source))
+    {
+        return nullptr;
+    }
+
+    // The type is part of the settings, the same source could be used in different stages
+    AssetRegistry& registry = AssetRegistry::GetInstance();
+    AssetRegistry::Key key{ AssetRegistry::Hash(source.data(), source.size()), AssetRegistry::Hash(&m_type, sizeof(m_type)), std::type_index(typeid(Shader)) };
+    std::shared_ptr<Shader> shader = registry.Find<Shader>(key);
+    if (shader)
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        ++s_stats.sharedCount;
+    }
+    else
+    {
+        shader = std::make_shared<Shader>(m_type);
+        shader->SetSource(source.c_str());
+        Compile(*shader, waitCompile);
+        registry.Add<Shader>(key, shader, source.size(), paths.empty() ? std::string() : paths.back());
+    }
+    return shader;
+}
+
+bool ShaderLoader::ExpandSource(std::span<const char*> paths, std::span<const std::string> defines, std::string& source)
+{
+    source.clear();
+    std::unordered_set<std::string> includedPaths;
+    for (const char* path : paths)
+    {
+        if (!ExpandIncludes(std::filesystem::path(path).lexically_normal().generic_string(), includedPaths, source))
+        {
+            return false;
+        }
+    }
+    InsertDefines(defines, source);
+    return true;
+}
+
+void ShaderLoader::InsertDefines(std::span<const std::string> defines, std::string& source)
+{
+    if (defines.empty())
+    {
+        return;
+    }
+
+    // Defines that the source doesn't mention are skipped, so the stages that don't use a keyword are the same in all variants
+    std::string defineLines;
+    for (const std::string& define : defines)
+    {
+        if (source.find(define.substr(0, define.find(' '))) != std::string::npos)
+        {
+            defineLines += "#define " + define + "\n";
+        }
+    }
+
+    size_t versionStart = source.find_first_not_of(" \t\r\n");
+    size_t insertPosition = 0;
+    if (versionStart != std::string::npos && source.compare(versionStart, 8, "#version") == 0)
+    {
+        size_t versionEnd = source.find('\n', versionStart);
+        insertPosition = versionEnd != std::string::npos ? versionEnd + 1 : source.size();
+    }
+    source.insert(insertPosition, defineLines);
+}
+
+void ShaderLoader::ClearSourceCache()
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_sources.clear();
+}
+
+ShaderLoader::Stats ShaderLoader::GetStats()
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    return s_stats;
+}
+
+void ShaderLoader::ResetStats()
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_stats = Stats();
+}
+
+std::shared_ptr<const std::string> ShaderLoader::ReadSource(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    auto itSource = s_sources.find(path);
+    if (itSource == s_sources.end())
+    {
+        // Missing files are not cached, they can be created before the next load
+        std::ifstream file(path);
+        if (!file.is_open())
+        {
+            return nullptr;
+        }
+        std::stringstream stringStream;
+        stringStream << file.rdbuf();
+        itSource = s_sources.emplace(path, std::make_shared<const std::string>(stringStream.str())).first;
+    }
+    return itSource->second;
+}
+
+bool ShaderLoader::ExpandIncludes(const std::string& path, std::unordered_set<std::string>& includedPaths, std::string& source)
+{
+    // Each file is included once, the next includes are ignored
+    if (!includedPaths.insert(path).second)
+    {
+        return true;
+    }
+
+    std::shared_ptr<const std::string> fileSource = ReadSource(path);
+    if (!fileSource)
+    {
+        std::cout << "ERROR::SHADER::FILE_NOT_FOUND\n" << path << std::endl;
+        return false;
+    }
+
+    std::istringstream lines(*fileSource);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        size_t directiveStart = line.find_first_not_of(" \t");
+        if (directiveStart == std::string::npos || line.compare(directiveStart, 8, "#include") != 0)
+        {
+            source += line;
+            source += '\n';
+            continue;
+        }
+
+        // The included path is relative to the folder of this file
+        size_t nameStart = line.find_first_of("\"<", directiveStart + 8);
+        size_t nameEnd = nameStart != std::string::npos ? line.find_first_of("\">", nameStart + 1) : std::string::npos;
+        if (nameEnd == std::string::npos)
+        {
+            std::cout << "ERROR::SHADER::INCLUDE_INVALID\n" << path << ": " << line << std::endl;
+            continue;
+        }
+        std::filesystem::path includePath = std::filesystem::path(path).parent_path() / line.substr(nameStart + 1, nameEnd - nameStart - 1);
+        if (!ExpandIncludes(includePath.lexically_normal().generic_string(), includedPaths, source))
+        {
+            std::cout << "Included from " << path << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void ShaderLoader::Compile(Shader& shader, bool waitCompile)
+{
+    // Without waiting, the time is only the submission, the driver compiles in the background
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    shader.SubmitCompile();
+    if (waitCompile)
+    {
+        CheckCompiled(shader);
+    }
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    ++s_stats.compileCount;
+    s_stats.compileTime += std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+bool ShaderLoader::CheckCompiled(const Shader& shader)
 {
-    if (!shader.Compile())
+    bool compiled = shader.IsCompiled();
+    if (!compiled)
     {
         std::array<char, 512> infoLog;
         shader.GetCompilationErrors(infoLog);
@@ -104,6 +265,7 @@ void ShaderLoader::Compile(Shader& shader)
         }
         std::cout << "ERROR::SHADER::" << typeName << "::COMPILATION_FAILED\n" << infoLog.data() << std::endl;
     }
+    return compiled;
 }
 
 Shader ShaderLoader::Load(Shader::Type type, const char* path)
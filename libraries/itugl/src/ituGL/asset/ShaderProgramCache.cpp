@@ -0,0 +1,328 @@
+#include <ituGL/asset/ShaderProgramCache.h>
+
+#include <ituGL/asset/ShaderLoader.h>
+#include <ituGL/asset/AssetRegistry.h>
+#include <ituGL/shader/ShaderProgram.h>
+#include <ituGL/core/CpuProfiler.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <array>
+#include <cstring>
+#include <cassert>
+
+#include <iostream>
+
+// Header of the entry files, followed by the binary
+struct ShaderProgramCacheEntryHeader
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t key;
+    std::uint32_t format;
+    std::uint32_t size;
+};
+
+static constexpr std::uint32_t s_entryMagic = 0x42505449; // "ITPB"
+static constexpr std::uint32_t s_entryVersion = 1;
+
+ShaderProgramCache::ShaderProgramCache()
+    : m_directory("shadercache")
+    , m_enabled(true)
+    , m_driverQueried(false)
+    , m_supported(false)
+    , m_parallelCompile(false)
+    , m_driverHash(0)
+{
+}
+
+ShaderProgramCache& ShaderProgramCache::GetInstance()
+{
+    static ShaderProgramCache instance;
+    return instance;
+}
+
+bool ShaderProgramCache::Build(ShaderProgram& shaderProgram, std::span<const char*> vertexShaderPaths, std::span<const char*> fragmentShaderPaths,
+    std::span<const std::string> defines)
+{
+    Stage stages[] = { { Shader::VertexShader, vertexShaderPaths }, { Shader::FragmentShader, fragmentShaderPaths } };
+    return Build(shaderProgram, stages, defines);
+}
+
+bool ShaderProgramCache::Build(ShaderProgram& shaderProgram, std::span<const Stage> stages, std::span<const std::string> defines)
+{
+    Request request{ &shaderProgram, stages, defines };
+    return Build(std::span(&request, 1));
+}
+
+bool ShaderProgramCache::Build(std::span<const Request> requests)
+{
+    ITUGL_PROFILE_ZONE("ShaderProgramCache::Build");
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    if (!m_driverQueried)
+    {
+        QueryDriver();
+    }
+
+    bool useCache = m_enabled && m_supported;
+    bool allLinked = true;
+
+    // Programs that were not cached, with their key and shaders
+    struct Pending
+    {
+        const Request* request;
+        std::uint64_t key;
+        std::vector<std::shared_ptr<Shader>> shaders;
+    };
+    std::vector<Pending> pendingPrograms;
+
+    for (const Request& request : requests)
+    {
+        std::uint64_t key = 0;
+        bool sourcesFound = !useCache || ComputeKey(request.stages, request.defines, key);
+        if (useCache && sourcesFound && LoadEntry(*request.shaderProgram, key))
+        {
+            ++m_stats.hits;
+            continue;
+        }
+        ++m_stats.misses;
+
+        // If a binary was rejected, the program is just left unlinked, and shaders can be attached as usual
+        request.shaderProgram->SetBinaryRetrievable(useCache);
+        std::vector<std::shared_ptr<Shader>> shaders;
+        if (!sourcesFound || !SubmitCompile(request.stages, request.defines, shaders))
+        {
+            // The missing file was already reported
+            allLinked = false;
+            continue;
+        }
+        pendingPrograms.emplace_back(Pending{ &request, key, std::move(shaders) });
+    }
+
+    // Only check the shaders once all of them were submitted
+    for (Pending& pending : pendingPrograms)
+    {
+        if (!SubmitLink(*pending.request->shaderProgram, pending.shaders))
+        {
+            pending.request = nullptr;
+            allLinked = false;
+        }
+    }
+
+    for (const Pending& pending : pendingPrograms)
+    {
+        if (!pending.request)
+        {
+            continue;
+        }
+
+        const ShaderProgram& shaderProgram = *pending.request->shaderProgram;
+        if (!shaderProgram.IsLinked())
+        {
+            std::array<char, 512> errors;
+            shaderProgram.GetLinkingErrors(errors);
+            std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << errors.data() << std::endl;
+            allLinked = false;
+        }
+        else if (useCache)
+        {
+            StoreEntry(shaderProgram, pending.key);
+        }
+    }
+
+    m_stats.setupTime += std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count();
+    return allLinked;
+}
+
+void ShaderProgramCache::QueryDriver()
+{
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    m_supported = formatCount > 0;
+
+    // The driver uses its default number of threads. The status queries are the only points where it waits for them
+    GLint extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    for (GLint i = 0; i < extensionCount && !m_parallelCompile; ++i)
+    {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        m_parallelCompile = std::strcmp(extension, "GL_KHR_parallel_shader_compile") == 0
+            || std::strcmp(extension, "GL_ARB_parallel_shader_compile") == 0;
+    }
+
+    // Binaries are only valid for the same driver
+    m_driverHash = AssetRegistry::Hash(nullptr, 0);
+    for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+    {
+        const char* value = reinterpret_cast<const char*>(glGetString(name));
+        if (value)
+        {
+            m_driverHash = AssetRegistry::Hash(value, std::strlen(value) + 1, m_driverHash);
+        }
+    }
+    m_driverQueried = true;
+}
+
+bool ShaderProgramCache::ComputeKey(std::span<const Stage> stages, std::span<const std::string> defines, std::uint64_t& key) const
+{
+    key = m_driverHash;
+    std::string source;
+    for (const Stage& stage : stages)
+    {
+        // The expanded source contains the included files and the defines, so changing them changes the key too
+        if (!ShaderLoader::ExpandSource(stage.paths, defines, source))
+        {
+            return false;
+        }
+        key = AssetRegistry::Hash(&stage.type, sizeof(stage.type), key);
+        key = AssetRegistry::Hash(source.c_str(), source.size(), key);
+    }
+    return true;
+}
+
+std::string ShaderProgramCache::GetEntryPath(std::uint64_t key) const
+{
+    std::ostringstream path;
+    path << m_directory << "/" << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return path.str();
+}
+
+bool ShaderProgramCache::LoadEntry(ShaderProgram& shaderProgram, std::uint64_t key)
+{
+    std::string path = GetEntryPath(key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    ShaderProgramCacheEntryHeader header;
+    std::vector<std::byte> binary;
+    bool valid = file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        && header.magic == s_entryMagic && header.version == s_entryVersion && header.key == key;
+    if (valid)
+    {
+        binary.resize(header.size);
+        valid = static_cast<bool>(file.read(reinterpret_cast<char*>(binary.data()), binary.size()));
+    }
+    file.close();
+
+    if (valid && shaderProgram.SetBinary(header.format, binary))
+    {
+        return true;
+    }
+
+    // Remove the entry, it will be written again after compiling
+    ++m_stats.rejected;
+    std::error_code error;
+    std::filesystem::remove(path, error);
+    return false;
+}
+
+void ShaderProgramCache::StoreEntry(const ShaderProgram& shaderProgram, std::uint64_t key) const
+{
+    GLenum format;
+    std::vector<std::byte> binary;
+    if (!shaderProgram.GetBinary(format, binary))
+    {
+        return;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+
+    // Unique temporary name, in case several processes write the same entry
+    std::string path = GetEntryPath(key);
+    std::string temporaryPath = path + "." + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        ShaderProgramCacheEntryHeader header{ s_entryMagic, s_entryVersion, key, format, static_cast<std::uint32_t>(binary.size()) };
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(binary.data()), binary.size());
+        if (!file)
+        {
+            file.close();
+            std::filesystem::remove(temporaryPath, error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error)
+    {
+        std::filesystem::remove(temporaryPath, error);
+    }
+}
+
+bool ShaderProgramCache::SubmitCompile(std::span<const Stage> stages, std::span<const std::string> defines, std::vector<std::shared_ptr<Shader>>& shaders)
+{
+    for (const Stage& stage : stages)
+    {
+        ShaderLoader loader(stage.type);
+        loader.SetDefines(defines);
+        std::shared_ptr<Shader> shader = loader.LoadShared(stage.paths, false);
+        if (!shader)
+        {
+            return false;
+        }
+        shaders.push_back(shader);
+    }
+    return true;
+}
+
+bool ShaderProgramCache::SubmitLink(ShaderProgram& shaderProgram, std::span<const std::shared_ptr<Shader>> shaders)
+{
+    const Shader* computeShader = nullptr;
+    const Shader* vertexShader = nullptr;
+    const Shader* fragmentShader = nullptr;
+    const Shader* tesselationControlShader = nullptr;
+    const Shader* tesselationEvaluationShader = nullptr;
+    const Shader* geometryShader = nullptr;
+
+    bool compiled = true;
+    for (const std::shared_ptr<Shader>& shaderPtr : shaders)
+    {
+        const Shader& shader = *shaderPtr;
+        compiled &= ShaderLoader::CheckCompiled(shader);
+        switch (shader.GetType())
+        {
+        case Shader::ComputeShader:
+            computeShader = &shader;
+            break;
+        case Shader::VertexShader:
+            vertexShader = &shader;
+            break;
+        case Shader::FragmentShader:
+            fragmentShader = &shader;
+            break;
+        case Shader::TesselationControlShader:
+            tesselationControlShader = &shader;
+            break;
+        case Shader::TesselationEvaluationShader:
+            tesselationEvaluationShader = &shader;
+            break;
+        case Shader::GeometryShader:
+            geometryShader = &shader;
+            break;
+        }
+    }
+
+    if (!compiled)
+    {
+        return false;
+    }
+
+    if (computeShader)
+    {
+        shaderProgram.SubmitBuild(*computeShader);
+    }
+    else
+    {
+        assert(vertexShader && fragmentShader);
+        shaderProgram.SubmitBuild(*vertexShader, *fragmentShader, tesselationControlShader, tesselationEvaluationShader, geometryShader);
+    }
+    return true;
+}
@@ -1,57 +1,129 @@
 #include <ituGL/asset/Texture2DLoader.h>
 
+#include <ituGL/texture/SamplerObject.h>
+#include <ituGL/texture/TextureUploadRing.h>
+#include <ituGL/texture/TextureStreamingManager.h>
+
 #include <cassert>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
 
 Texture2DLoader::Texture2DLoader()
     : m_flipVertical(false)
+    , m_streamingManager(nullptr)
 {
 }
 
 Texture2DLoader::Texture2DLoader(TextureObject::Format format, TextureObject::InternalFormat internalFormat)
     : TextureLoader(format, internalFormat)
     , m_flipVertical(false)
+    , m_streamingManager(nullptr)
 {
 }
 
 Texture2DObject Texture2DLoader::Load(const char* path)
 {
-    Texture2DObject texture2D;
-
     // Load texture data using stbimage library
-    int width, height;
-    Data::Type dataType;
-    std::span<const std::byte> data = LoadTexture2DData(path, width, height, dataType, m_flipVertical);
+    std::shared_ptr<const TextureLoaderUtils::TextureData> textureData = TextureLoaderUtils::LoadTextureData(path, m_format, m_internalFormat, m_flipVertical);
+    return CreateTexture(*textureData, m_generateMipmap);
+}
+
+Texture2DObject Texture2DLoader::CreateTexture(const TextureLoaderUtils::TextureData& textureData, bool generateMipmap)
+{
+    Texture2DObject texture2D;
 
     // If data was loaded, copy it to the texture object
-    assert(!data.empty());
-    if (!data.empty())
+    assert(!textureData.data.empty());
+    if (!textureData.data.empty())
     {
+        int width = textureData.width;
+        int height = textureData.height;
+
         texture2D.Bind();
-        texture2D.SetImage<std::byte>(0, width, height, m_format, m_internalFormat, data, dataType);
+        texture2D.SetImage<std::byte>(0, width, height, textureData.format, textureData.internalFormat, textureData.data, textureData.dataType);
 
-        texture2D.SetParameter(TextureObject::ParameterEnum::MinFilter, GL_LINEAR);
-        texture2D.SetParameter(TextureObject::ParameterEnum::MagFilter, GL_LINEAR);
+        SetupMipmap(texture2D, generateMipmap);
 
-        // Generate mipmap if needed
-        if (m_generateMipmap)
-        {
-            texture2D.GenerateMipmap();
-            texture2D.SetParameter(TextureObject::ParameterEnum::MinFilter, GL_LINEAR_MIPMAP_LINEAR);
+        texture2D.Unbind();
+    }
+    return texture2D;
+}
 
-            // Adjust mip levels
-            texture2D.SetParameter(TextureObject::ParameterFloat::MinLod, 0.0f);
-            float maxLod = 1.0f + std::floorf(std::log2f(static_cast<float>(std::max(width, height))));
-            texture2D.SetParameter(TextureObject::ParameterFloat::MaxLod, maxLod);
-        }
+std::shared_ptr<Texture2DObject> Texture2DLoader::CreateTextureStreamed(std::shared_ptr<const TextureLoaderUtils::TextureData> textureData, bool generateMipmap,
+    TextureUploadRing& uploadRing)
+{
+    std::shared_ptr<Texture2DObject> texture2D = std::make_shared<Texture2DObject>();
 
-        texture2D.Unbind();
+    assert(!textureData->data.empty());
+    if (!textureData->data.empty())
+    {
+        int width = textureData->width;
+        int height = textureData->height;
 
-        // Free loaded data (not needed anymore)
-        FreeTexture2DData(data);
+        // Allocate the storage only, and sample the base level until the mipmaps are generated
+        texture2D->Bind();
+        texture2D->SetImage(0, width, height, textureData->format, textureData->internalFormat);
+        SetupMipmap(*texture2D, false);
+        Texture2DObject::Unbind();
+
+        uploadRing.QueueUpload(texture2D, 0, width, height, textureData->format, textureData->dataType, textureData->data, textureData,
+            [=]()
+            {
+                texture2D->Bind();
+                SetupMipmap(*texture2D, generateMipmap);
+                Texture2DObject::Unbind();
+            });
     }
     return texture2D;
 }
 
+void Texture2DLoader::SetupMipmap(Texture2DObject& texture2D, bool generateMipmap)
+{
+    // Filters are in a shared sampler, the texture keeps its default parameters
+    texture2D.SetSampler(SamplerObject::GetPreset(SamplerObject::Preset::LinearRepeat));
+
+    // Generate mipmap if needed
+    if (generateMipmap)
+    {
+        texture2D.GenerateMipmap();
+        texture2D.SetSampler(SamplerObject::GetPreset(SamplerObject::Preset::LinearMipmapRepeat));
+    }
+}
+
+Texture2DLoader::DecodeTask Texture2DLoader::CreateDecodeTask(const char* path)
+{
+    // Copy the settings, they could change before the task runs
+    std::string pathString(path);
+    TextureObject::Format format = m_format;
+    TextureObject::InternalFormat internalFormat = m_internalFormat;
+    bool generateMipmap = m_generateMipmap;
+    bool flipVertical = m_flipVertical;
+    TextureUploadRing* uploadRing = m_uploadRing;
+    TextureStreamingManager* streamingManager = m_streamingManager;
+
+    return [=]() -> FinishFunction
+        {
+            std::shared_ptr<const TextureLoaderUtils::TextureData> textureData = TextureLoaderUtils::LoadTextureData(pathString.c_str(), format, internalFormat, flipVertical,
+                streamingManager != nullptr);
+            return [=]()
+                {
+                    if (streamingManager)
+                    {
+                        return streamingManager->AddTexture(pathString, textureData);
+                    }
+                    return uploadRing ? CreateTextureStreamed(textureData, generateMipmap, *uploadRing)
+                        : std::make_shared<Texture2DObject>(CreateTexture(*textureData, generateMipmap));
+                };
+        };
+}
+
+std::string Texture2DLoader::GetImportSettings() const
+{
+    // Textures streamed by a manager are owned by it, they can't be shared with other managers
+    return TextureLoader<Texture2DObject>::GetImportSettings() + " " + std::to_string(m_flipVertical) + " " + std::to_string(reinterpret_cast<std::uintptr_t>(m_streamingManager));
+}
+
 std::shared_ptr<Texture2DObject> Texture2DLoader::LoadTextureShared(const char* path,
     TextureObject::Format format, TextureObject::InternalFormat internalFormat, bool generateMipmap, bool flipVertical)
 {
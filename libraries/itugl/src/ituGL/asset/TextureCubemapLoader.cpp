@@ -1,7 +1,15 @@
 #include <ituGL/asset/TextureCubemapLoader.h>
 
+#include <ituGL/texture/SamplerObject.h>
+#include <ituGL/texture/TextureUploadRing.h>
+
 #include <cassert>
-#include <stb_image.h>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <array>
+#include <glm/vec2.hpp>
 
 TextureCubemapLoader::TextureCubemapLoader()
 {
@@ -13,16 +21,21 @@ TextureCubemapLoader::TextureCubemapLoader(TextureObject::Format format, Texture
 }
 
 TextureCubemapObject TextureCubemapLoader::Load(const char* path)
+{
+    std::shared_ptr<const TextureLoaderUtils::TextureData> textureData = TextureLoaderUtils::LoadTextureData(path, m_format, m_internalFormat, false);
+    return CreateTexture(*textureData, m_generateMipmap);
+}
+
+TextureCubemapObject TextureCubemapLoader::CreateTexture(const TextureLoaderUtils::TextureData& textureData, bool generateMipmap)
 {
     TextureCubemapObject textureCubemap;
 
-    int width, height;
-    Data::Type dataType;
-    std::span<const std::byte> data = LoadTexture2DData(path, width, height, dataType);
+    int width = textureData.width;
+    int height = textureData.height;
 
     // If data was loaded, copy it to the texture object
-    assert(!data.empty());
-    if (!data.empty())
+    assert(!textureData.data.empty());
+    if (!textureData.data.empty())
     {
         assert(width % 4 == 0);
         assert(height % 3 == 0);
@@ -32,43 +45,118 @@ TextureCubemapObject TextureCubemapLoader::Load(const char* path)
 
         textureCubemap.Bind();
 
-        int pixelSize = TextureObject::GetComponentCount(m_format) * Data::GetTypeSize(dataType);
+        int pixelSize = TextureObject::GetComponentCount(textureData.format) * Data::GetTypeSize(textureData.dataType);
         std::vector<std::byte> faceData(side * side * pixelSize);
-        LoadFace(textureCubemap, TextureCubemapObject::Face::Left,   data, faceData, 0, 1, side, dataType);
-        LoadFace(textureCubemap, TextureCubemapObject::Face::Right,  data, faceData, 2, 1, side, dataType);
-        LoadFace(textureCubemap, TextureCubemapObject::Face::Bottom, data, faceData, 1, 2, side, dataType);
-        LoadFace(textureCubemap, TextureCubemapObject::Face::Top,    data, faceData, 1, 0, side, dataType);
-        LoadFace(textureCubemap, TextureCubemapObject::Face::Front,  data, faceData, 3, 1, side, dataType);
-        LoadFace(textureCubemap, TextureCubemapObject::Face::Back,   data, faceData, 1, 1, side, dataType);
+        LoadFace(textureCubemap, TextureCubemapObject::Face::Left,   textureData, faceData, 0, 1, side);
+        LoadFace(textureCubemap, TextureCubemapObject::Face::Right,  textureData, faceData, 2, 1, side);
+        LoadFace(textureCubemap, TextureCubemapObject::Face::Bottom, textureData, faceData, 1, 2, side);
+        LoadFace(textureCubemap, TextureCubemapObject::Face::Top,    textureData, faceData, 1, 0, side);
+        LoadFace(textureCubemap, TextureCubemapObject::Face::Front,  textureData, faceData, 3, 1, side);
+        LoadFace(textureCubemap, TextureCubemapObject::Face::Back,   textureData, faceData, 1, 1, side);
 
-        textureCubemap.SetParameter(TextureObject::ParameterEnum::MinFilter, GL_LINEAR);
-        textureCubemap.SetParameter(TextureObject::ParameterEnum::MagFilter, GL_LINEAR);
+        // Clamp to edge to avoid filtering on the edges
+        textureCubemap.SetSampler(SamplerObject::GetPreset(SamplerObject::Preset::LinearClamp));
 
         // Generate mipmap if needed
-        if (m_generateMipmap)
+        if (generateMipmap)
         {
             textureCubemap.GenerateMipmap();
-            textureCubemap.SetParameter(TextureObject::ParameterEnum::MinFilter, GL_LINEAR_MIPMAP_LINEAR);
+            textureCubemap.SetSampler(SamplerObject::GetPreset(SamplerObject::Preset::LinearMipmapClamp));
 
-            // Adjust mip levels
-            textureCubemap.SetParameter(TextureObject::ParameterFloat::MinLod, 0.0f);
-            float maxLod = 1.0f + std::floorf(std::log2f(static_cast<float>(std::max(width, height))));
+            // The sampler has the LOD range, this one is only kept to query the mip levels
+            float maxLod = 1.0f + std::floor(std::log2(static_cast<float>(std::max(width, height))));
             textureCubemap.SetParameter(TextureObject::ParameterFloat::MaxLod, maxLod);
         }
 
-        // Clamp to edge to avoid filtering on the edges
-        textureCubemap.SetParameter(TextureObject::ParameterEnum::WrapR, GL_CLAMP_TO_EDGE);
-        textureCubemap.SetParameter(TextureObject::ParameterEnum::WrapS, GL_CLAMP_TO_EDGE);
-        textureCubemap.SetParameter(TextureObject::ParameterEnum::WrapT, GL_CLAMP_TO_EDGE);
-
         textureCubemap.Unbind();
+    }
+    return textureCubemap;
+}
+
+std::shared_ptr<TextureCubemapObject> TextureCubemapLoader::CreateTextureStreamed(std::shared_ptr<const TextureLoaderUtils::TextureData> textureData, bool generateMipmap,
+    TextureUploadRing& uploadRing)
+{
+    std::shared_ptr<TextureCubemapObject> textureCubemap = std::make_shared<TextureCubemapObject>();
+
+    int width = textureData->width;
+    int height = textureData->height;
+
+    assert(!textureData->data.empty());
+    if (!textureData->data.empty())
+    {
+        assert(width % 4 == 0);
+        assert(height % 3 == 0);
+        assert(width / 4 == height / 3);
+
+        int side = width / 4;
 
-        // Free loaded data (not needed anymore)
-        FreeTexture2DData(data);
+        // Allocate the storage of all the faces
+        textureCubemap->Bind();
+        std::span<const std::byte> empty;
+        std::array<TextureCubemapObject::Face, 6> faces = { TextureCubemapObject::Face::Left, TextureCubemapObject::Face::Right,
+            TextureCubemapObject::Face::Bottom, TextureCubemapObject::Face::Top, TextureCubemapObject::Face::Front, TextureCubemapObject::Face::Back };
+        for (TextureCubemapObject::Face face : faces)
+        {
+            textureCubemap->SetImage<std::byte>(0, face, side, textureData->format, textureData->internalFormat, empty, textureData->dataType);
+        }
+
+        // Sample the base level until the mipmaps are generated. Clamp to edge to avoid filtering on the edges
+        textureCubemap->SetSampler(SamplerObject::GetPreset(SamplerObject::Preset::LinearClamp));
+
+        // Set the mip levels already, so they can be queried while streaming
+        if (generateMipmap)
+        {
+            float maxLod = 1.0f + std::floor(std::log2(static_cast<float>(std::max(width, height))));
+            textureCubemap->SetParameter(TextureObject::ParameterFloat::MaxLod, maxLod);
+        }
+
+        TextureCubemapObject::Unbind();
+
+        // Queue each face as a region of the cross layout image
+        int rowSize = side * TextureObject::GetComponentCount(textureData->format) * Data::GetTypeSize(textureData->dataType);
+        int stride = 4 * rowSize;
+        std::array<glm::ivec2, 6> facePositions = { glm::ivec2(0, 1), glm::ivec2(2, 1), glm::ivec2(1, 2), glm::ivec2(1, 0), glm::ivec2(3, 1), glm::ivec2(1, 1) };
+        for (int i = 0; i < 6; ++i)
+        {
+            int offset = facePositions[i].y * side * stride + facePositions[i].x * rowSize;
+            TextureUploadRing::CompletionFunction completion;
+            if (generateMipmap && i == 5)
+            {
+                completion = [=]()
+                    {
+                        textureCubemap->Bind();
+                        textureCubemap->GenerateMipmap();
+                        textureCubemap->SetSampler(SamplerObject::GetPreset(SamplerObject::Preset::LinearMipmapClamp));
+                        TextureCubemapObject::Unbind();
+                    };
+            }
+            uploadRing.QueueUpload(textureCubemap, faces[i], 0, side, textureData->format, textureData->dataType,
+                textureData->data.subspan(offset), stride, textureData, completion);
+        }
     }
     return textureCubemap;
 }
 
+TextureCubemapLoader::DecodeTask TextureCubemapLoader::CreateDecodeTask(const char* path)
+{
+    // Copy the settings, they could change before the task runs
+    std::string pathString(path);
+    TextureObject::Format format = m_format;
+    TextureObject::InternalFormat internalFormat = m_internalFormat;
+    bool generateMipmap = m_generateMipmap;
+    TextureUploadRing* uploadRing = m_uploadRing;
+
+    return [=]() -> FinishFunction
+        {
+            std::shared_ptr<const TextureLoaderUtils::TextureData> textureData = TextureLoaderUtils::LoadTextureData(pathString.c_str(), format, internalFormat, false);
+            return [=]()
+                {
+                    return uploadRing ? CreateTextureStreamed(textureData, generateMipmap, *uploadRing)
+                        : std::make_shared<TextureCubemapObject>(CreateTexture(*textureData, generateMipmap));
+                };
+        };
+}
+
 std::shared_ptr<TextureCubemapObject> TextureCubemapLoader::LoadTextureShared(const char* path,
     TextureObject::Format format, TextureObject::InternalFormat internalFormat, bool generateMipmap)
 {
@@ -77,9 +165,10 @@ std::shared_ptr<TextureCubemapObject> TextureCubemapLoader::LoadTextureShared(co
     return loader.LoadShared(path);
 }
 
-void TextureCubemapLoader::LoadFace(TextureCubemapObject& textureCubemap, TextureCubemapObject::Face face, std::span<const std::byte> dataSrc, std::span<std::byte> dataDst, int x, int y, int side, Data::Type dataType)
+void TextureCubemapLoader::LoadFace(TextureCubemapObject& textureCubemap, TextureCubemapObject::Face face, const TextureLoaderUtils::TextureData& textureData, std::span<std::byte> dataDst, int x, int y, int side)
 {
-    int pixelSize = TextureObject::GetComponentCount(m_format) * Data::GetTypeSize(dataType);
+    std::span<const std::byte> dataSrc = textureData.data;
+    int pixelSize = TextureObject::GetComponentCount(textureData.format) * Data::GetTypeSize(textureData.dataType);
     int rowSize = side * pixelSize;
     int stride = 4 * rowSize;
     int srcOffset = y * side * stride + x * rowSize;
@@ -88,10 +177,10 @@ void TextureCubemapLoader::LoadFace(TextureCubemapObject& textureCubemap, Textur
     {
         assert(srcOffset + rowSize <= dataSrc.size());
         assert(dstOffset + rowSize <= dataDst.size());
-        memcpy(&dataDst[dstOffset], &dataSrc[srcOffset], rowSize);
+        std::memcpy(&dataDst[dstOffset], &dataSrc[srcOffset], rowSize);
         srcOffset += stride;
         dstOffset += rowSize;
     }
 
-    textureCubemap.SetImage<std::byte>(0, face, side, m_format, m_internalFormat, dataDst, dataType);
+    textureCubemap.SetImage<std::byte>(0, face, side, textureData.format, textureData.internalFormat, dataDst, textureData.dataType);
 }
@@ -1,8 +1,65 @@
 #include <ituGL/asset/TextureLoader.h>
 
+#include <ituGL/core/CpuProfiler.h>
+#include <ituGL/core/MemoryTracker.h>
+
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+#include <cassert>
+
+TextureLoaderUtils::TextureData::~TextureData()
+{
+    MemoryTracker::GetInstance().RemoveCpuAllocation(this);
+    if (!data.empty())
+    {
+        FreeTexture2DData(data);
+    }
+}
+
+std::span<const std::byte> TextureLoaderUtils::TextureData::GetLevel(int level, int& levelWidth, int& levelHeight) const
+{
+    assert(level >= 0 && level < GetLevelCount());
+    if (level == 0)
+    {
+        levelWidth = width;
+        levelHeight = height;
+        return data;
+    }
+
+    const MipLevel& mipLevel = mipLevels[level - 1];
+    levelWidth = mipLevel.width;
+    levelHeight = mipLevel.height;
+    return mipLevel.data;
+}
+
+std::shared_ptr<const TextureLoaderUtils::TextureData> TextureLoaderUtils::LoadTextureData(const char* path, TextureObject::Format format, TextureObject::InternalFormat internalFormat, bool flipVertical,
+    bool generateMipLevels)
+{
+    ITUGL_PROFILE_ZONE("TextureLoaderUtils::LoadTextureData");
+    std::shared_ptr<TextureData> textureData = std::make_shared<TextureData>();
+    textureData->format = format;
+    textureData->internalFormat = internalFormat;
+    textureData->data = LoadTexture2DData(path, textureData->width, textureData->height, textureData->dataType, format, internalFormat, flipVertical);
+    if (generateMipLevels && !textureData->data.empty())
+    {
+        GenerateMipLevels(*textureData);
+    }
+
+    // The decoded data stays in memory while the texture data is in use, like when streaming its levels
+    size_t memorySize = textureData->data.size_bytes();
+    for (const TextureData::MipLevel& mipLevel : textureData->mipLevels)
+    {
+        memorySize += mipLevel.data.size();
+    }
+    MemoryTracker::GetInstance().SetCpuAllocation(textureData.get(), MemoryTracker::Category::AssetData, memorySize, path);
+    return textureData;
+}
+
 std::span<const std::byte> TextureLoaderUtils::LoadTexture2DData(const char* path, int& width, int& height, Data::Type& dataType, TextureObject::Format format, TextureObject::InternalFormat internalFormat, bool flipVertical)
 {
     std::span<const std::byte> dataSpan;
@@ -10,9 +67,7 @@ std::span<const std::byte> TextureLoaderUtils::LoadTexture2DData(const char* pat
     int componentCount = TextureObject::GetComponentCount(format);
     int originalComponentCount;
 
-    // Set flip vertical on load if needed
-    stbi_set_flip_vertically_on_load(flipVertical ? 1 : 0);
-
+    // The stbi flip flag is global, so we flip the rows ourselves to be able to decode from several threads
     if (IsHDR(internalFormat))
     {
         float* data = stbi_loadf(path, &width, &height, &originalComponentCount, componentCount);
@@ -27,6 +82,11 @@ std::span<const std::byte> TextureLoaderUtils::LoadTexture2DData(const char* pat
         dataSpan = Data::GetBytes(dataSpanByte);
         dataType = Data::Type::UByte;
     }
+
+    if (flipVertical && !dataSpan.empty())
+    {
+        FlipVertical(dataSpan, height);
+    }
     return dataSpan;
 }
 
@@ -53,3 +113,79 @@ bool TextureLoaderUtils::IsHDR(TextureObject::InternalFormat internalFormat)
         return false;
     }
 }
+
+void TextureLoaderUtils::FlipVertical(std::span<const std::byte> data, int height)
+{
+    // The data was allocated by stbi, so we own it
+    std::byte* bytes = const_cast<std::byte*>(data.data());
+    size_t rowSize = data.size() / height;
+    std::vector<std::byte> row(rowSize);
+    for (int top = 0, bottom = height - 1; top < bottom; ++top, --bottom)
+    {
+        std::byte* topRow = bytes + top * rowSize;
+        std::byte* bottomRow = bytes + bottom * rowSize;
+        std::memcpy(row.data(), topRow, rowSize);
+        std::memcpy(topRow, bottomRow, rowSize);
+        std::memcpy(bottomRow, row.data(), rowSize);
+    }
+}
+
+void TextureLoaderUtils::GenerateMipLevels(TextureData& textureData)
+{
+    int componentCount = TextureObject::GetComponentCount(textureData.format);
+
+    std::span<const std::byte> source = textureData.data;
+    int width = textureData.width;
+    int height = textureData.height;
+    while (width > 1 || height > 1)
+    {
+        TextureData::MipLevel& mipLevel = textureData.mipLevels.emplace_back();
+        if (textureData.dataType == Data::Type::Float)
+        {
+            DownsampleLevel<float>(source, width, height, componentCount, mipLevel);
+        }
+        else
+        {
+            assert(textureData.dataType == Data::Type::UByte);
+            DownsampleLevel<unsigned char>(source, width, height, componentCount, mipLevel);
+        }
+
+        source = mipLevel.data;
+        width = mipLevel.width;
+        height = mipLevel.height;
+    }
+}
+
+template<typename T>
+void TextureLoaderUtils::DownsampleLevel(std::span<const std::byte> source, int width, int height, int componentCount, TextureData::MipLevel& destination)
+{
+    destination.width = std::max(width / 2, 1);
+    destination.height = std::max(height / 2, 1);
+    destination.data.resize(destination.width * destination.height * componentCount * sizeof(T));
+
+    const T* src = reinterpret_cast<const T*>(source.data());
+    T* dst = reinterpret_cast<T*>(destination.data.data());
+    for (int y = 0; y < destination.height; ++y)
+    {
+        // Odd sizes repeat the last row or column
+        const T* row0 = src + (2 * y) * width * componentCount;
+        const T* row1 = src + std::min(2 * y + 1, height - 1) * width * componentCount;
+        for (int x = 0; x < destination.width; ++x)
+        {
+            int x0 = (2 * x) * componentCount;
+            int x1 = std::min(2 * x + 1, width - 1) * componentCount;
+            for (int c = 0; c < componentCount; ++c)
+            {
+                float sum = static_cast<float>(row0[x0 + c]) + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+                if constexpr (std::is_integral_v<T>)
+                {
+                    *dst++ = static_cast<T>(sum * 0.25f + 0.5f);
+                }
+                else
+                {
+                    *dst++ = static_cast<T>(sum * 0.25f);
+                }
+            }
+        }
+    }
+}
@@ -1,28 +1,66 @@
 #include <ituGL/core/BufferObject.h>
 
+#include <ituGL/core/DeviceGL.h>
+#include <ituGL/core/MemoryTracker.h>
 #include <cassert>
 
+// Category of the memory of the buffers, by their target
+static MemoryTracker::Category GetMemoryCategory(BufferObject::Target target)
+{
+    switch (target)
+    {
+    case BufferObject::ElementArrayBuffer:
+        return MemoryTracker::Category::IndexBuffer;
+    case BufferObject::PixelUnpackBuffer:
+        return MemoryTracker::Category::StagingBuffer;
+    case BufferObject::UniformBuffer:
+        return MemoryTracker::Category::UniformBuffer;
+    default:
+        return MemoryTracker::Category::VertexBuffer;
+    }
+}
+
 // Create the object initially null, get object handle and generate 1 buffer
-BufferObject::BufferObject() : Object(NullHandle)
+// With direct state access it is created already, so it can be edited before binding it
+BufferObject::BufferObject() : Object(NullHandle), m_size(0)
 {
     Handle& handle = GetHandle();
-    glGenBuffers(1, &handle);
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glCreateBuffers(1, &handle);
+    }
+    else
+    {
+        glGenBuffers(1, &handle);
+    }
 }
 
-// Get object handle and delete 1 buffer
+// Get object handle and delete 1 buffer. The device forgets it first, in case it is attached to a vertex array
 BufferObject::~BufferObject()
 {
     Handle& handle = GetHandle();
+    DeviceGL* device = DeviceGL::GetInstancePointer();
+    if (device && handle != NullHandle)
+    {
+        device->ForgetBuffer(handle);
+    }
+    if (handle != NullHandle)
+    {
+        MemoryTracker::GetInstance().RemoveObject(MemoryTracker::ObjectType::Buffer, handle);
+    }
     glDeleteBuffers(1, &handle);
 }
 
-BufferObject::BufferObject(BufferObject&& bufferObject) noexcept : Object(std::move(bufferObject))
+BufferObject::BufferObject(BufferObject&& bufferObject) noexcept : Object(std::move(bufferObject)), m_size(bufferObject.m_size)
 {
+    bufferObject.m_size = 0;
 }
 
 BufferObject& BufferObject::operator = (BufferObject&& bufferObject) noexcept
 {
     Object::operator=(std::move(bufferObject));
+    m_size = bufferObject.m_size;
+    bufferObject.m_size = 0;
     return *this;
 }
 
@@ -43,23 +81,106 @@ void BufferObject::Unbind(Target target)
 // Get buffer Target and allocate buffer data
 void BufferObject::AllocateData(size_t size, Usage usage)
 {
-    assert(IsBound());
-    Target target = GetTarget();
-    glBufferData(target, size, nullptr, usage);
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glNamedBufferData(GetHandle(), size, nullptr, usage);
+    }
+    else
+    {
+        assert(IsBound());
+        Target target = GetTarget();
+        glBufferData(target, size, nullptr, usage);
+    }
+    m_size = size;
+    MemoryTracker::GetInstance().SetBufferSize(GetHandle(), GetMemoryCategory(GetTarget()), m_size);
 }
 
 // Get buffer Target and allocate buffer data
 void BufferObject::AllocateData(std::span<const std::byte> data, Usage usage)
 {
-    assert(IsBound());
-    Target target = GetTarget();
-    glBufferData(target, data.size_bytes(), data.data(), usage);
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glNamedBufferData(GetHandle(), data.size_bytes(), data.data(), usage);
+    }
+    else
+    {
+        assert(IsBound());
+        Target target = GetTarget();
+        glBufferData(target, data.size_bytes(), data.data(), usage);
+    }
+    m_size = data.size_bytes();
+    MemoryTracker::GetInstance().SetBufferSize(GetHandle(), GetMemoryCategory(GetTarget()), m_size);
 }
 
 // Get buffer Target and set buffer subdata
 void BufferObject::UpdateData(std::span<const std::byte> data, size_t offset)
 {
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glNamedBufferSubData(GetHandle(), offset, data.size_bytes(), data.data());
+        return;
+    }
     assert(IsBound());
     Target target = GetTarget();
     glBufferSubData(target, offset, data.size_bytes(), data.data());
 }
+
+void BufferObject::ReadData(std::span<std::byte> data, size_t offset) const
+{
+    assert(offset + data.size_bytes() <= m_size);
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glGetNamedBufferSubData(GetHandle(), offset, data.size_bytes(), data.data());
+        return;
+    }
+    assert(IsBound());
+    Target target = GetTarget();
+    glGetBufferSubData(target, offset, data.size_bytes(), data.data());
+}
+
+// Get buffer Target and allocate immutable buffer storage
+void BufferObject::AllocateStorage(size_t size, GLbitfield flags)
+{
+    assert(GLAD_GL_VERSION_4_4);
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glNamedBufferStorage(GetHandle(), size, nullptr, flags);
+    }
+    else
+    {
+        assert(IsBound());
+        Target target = GetTarget();
+        glBufferStorage(target, size, nullptr, flags);
+    }
+    m_size = size;
+    MemoryTracker::GetInstance().SetBufferSize(GetHandle(), GetMemoryCategory(GetTarget()), m_size);
+}
+
+// Get buffer Target and map the range
+std::span<std::byte> BufferObject::MapData(size_t offset, size_t size, GLbitfield access)
+{
+    std::byte* data = nullptr;
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        data = static_cast<std::byte*>(glMapNamedBufferRange(GetHandle(), offset, size, access));
+    }
+    else
+    {
+        assert(IsBound());
+        Target target = GetTarget();
+        data = static_cast<std::byte*>(glMapBufferRange(target, offset, size, access));
+    }
+    return std::span<std::byte>(data, data ? size : 0);
+}
+
+// Get buffer Target and unmap it
+bool BufferObject::UnmapData()
+{
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        return glUnmapNamedBuffer(GetHandle()) == GL_TRUE;
+    }
+    assert(IsBound());
+    Target target = GetTarget();
+    return glUnmapBuffer(target) == GL_TRUE;
+}
@@ -0,0 +1,191 @@
+#include <ituGL/core/CpuProfiler.h>
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+
+std::atomic<bool> CpuProfiler::s_enabled(false);
+thread_local CpuProfiler::ThreadBuffer* CpuProfiler::s_threadBuffer = nullptr;
+thread_local const char* CpuProfiler::s_threadName = nullptr;
+
+CpuProfiler::CpuProfiler()
+    : m_startTimestamp(GetTimestamp())
+    , m_startTime(std::chrono::steady_clock::now().time_since_epoch().count())
+{
+}
+
+CpuProfiler& CpuProfiler::GetInstance()
+{
+    static CpuProfiler instance;
+    return instance;
+}
+
+void CpuProfiler::SetEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void CpuProfiler::SetThreadName(const char* name)
+{
+    // The ring is created with the first zone, and takes the name then
+    s_threadName = name;
+    if (s_threadBuffer)
+    {
+        s_threadBuffer->SetName(name);
+    }
+}
+
+const char* CpuProfiler::InternName(std::string_view name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_names.emplace(name).first->c_str();
+}
+
+CpuProfiler::ThreadBuffer* CpuProfiler::CreateThreadBuffer()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Rings are kept after their thread exits, so the zones can still be exported
+    m_threadBuffers.push_back(std::make_unique<ThreadBuffer>(static_cast<unsigned int>(m_threadBuffers.size())));
+    s_threadBuffer = m_threadBuffers.back().get();
+    s_threadBuffer->SetName(s_threadName);
+    return s_threadBuffer;
+}
+
+unsigned int CpuProfiler::GetZoneCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    unsigned int count = 0;
+    for (const std::unique_ptr<ThreadBuffer>& threadBuffer : m_threadBuffers)
+    {
+        count += threadBuffer->GetCount();
+    }
+    return count;
+}
+
+void CpuProfiler::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const std::unique_ptr<ThreadBuffer>& threadBuffer : m_threadBuffers)
+    {
+        threadBuffer->Clear();
+    }
+}
+
+double CpuProfiler::GetTickDuration() const
+{
+    int64_t time = std::chrono::steady_clock::now().time_since_epoch().count();
+    uint64_t timestamp = GetTimestamp();
+    if (timestamp == m_startTimestamp)
+    {
+        return 0.0;
+    }
+    using Period = std::chrono::steady_clock::period;
+    double nanoseconds = static_cast<double>(time - m_startTime) * 1.0e9 * Period::num / Period::den;
+    return nanoseconds / static_cast<double>(timestamp - m_startTimestamp);
+}
+
+bool CpuProfiler::ExportChromeTrace(const char* path) const
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        return false;
+    }
+
+    // Timestamps in the trace are in microseconds
+    double tickDuration = GetTickDuration() * 1.0e-3;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Names are only escaped for quotes and backslashes, control characters are not expected
+    auto writeString = [&file](const char* string)
+        {
+            file << '"';
+            for (const char* c = string; *c; ++c)
+            {
+                if (*c == '"' || *c == '\\')
+                {
+                    file << '\\';
+                }
+                file << *c;
+            }
+            file << '"';
+        };
+
+    file << "{\"traceEvents\":[\n";
+    file.precision(3);
+    file << std::fixed;
+
+    bool first = true;
+    std::vector<Event> events;
+    for (const std::unique_ptr<ThreadBuffer>& threadBuffer : m_threadBuffers)
+    {
+        unsigned int threadId = threadBuffer->GetThreadId();
+
+        if (const char* threadName = threadBuffer->GetName())
+        {
+            file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << threadId << ",\"args\":{\"name\":";
+            writeString(threadName);
+            file << "}}";
+            first = false;
+        }
+
+        events.clear();
+        threadBuffer->CopyEvents(events);
+        for (const Event& event : events)
+        {
+            double start = static_cast<double>(static_cast<int64_t>(event.start - m_startTimestamp)) * tickDuration;
+            double duration = static_cast<double>(event.end - event.start) * tickDuration;
+            file << (first ? "" : ",\n") << "{\"name\":";
+            writeString(event.name);
+            file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << threadId << ",\"ts\":" << start << ",\"dur\":" << duration << "}";
+            first = false;
+        }
+    }
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    return static_cast<bool>(file);
+}
+
+CpuProfiler::ThreadBuffer::ThreadBuffer(unsigned int threadId)
+    : m_events(std::make_unique<Event[]>(ThreadCapacity))
+    , m_written(0)
+    , m_cleared(0)
+    , m_threadId(threadId)
+    , m_name(nullptr)
+{
+}
+
+void CpuProfiler::ThreadBuffer::CopyEvents(std::vector<Event>& events) const
+{
+    uint64_t written = m_written.load(std::memory_order_acquire);
+    uint64_t first = std::max(m_cleared.load(std::memory_order_relaxed), written > ThreadCapacity ? written - ThreadCapacity : 0);
+    size_t copyStart = events.size();
+    for (uint64_t index = first; index < written; ++index)
+    {
+        events.push_back(m_events[index % ThreadCapacity]);
+    }
+
+    // Check how far the owner wrote while copying, and drop the events that could be overwritten
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t writtenAfter = m_written.load(std::memory_order_relaxed);
+    if (writtenAfter > first + ThreadCapacity)
+    {
+        uint64_t overwritten = std::min(writtenAfter - ThreadCapacity - first, written - first);
+        events.erase(events.begin() + copyStart, events.begin() + copyStart + overwritten);
+    }
+}
+
+unsigned int CpuProfiler::ThreadBuffer::GetCount() const
+{
+    uint64_t written = m_written.load(std::memory_order_acquire);
+    uint64_t first = std::max(m_cleared.load(std::memory_order_relaxed), written > ThreadCapacity ? written - ThreadCapacity : 0);
+    return static_cast<unsigned int>(written - first);
+}
+
+void CpuProfiler::ThreadBuffer::Clear()
+{
+    // Only the owner thread writes the ring, so clearing just moves where the readers start
+    m_cleared.store(m_written.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
@@ -1,14 +1,21 @@
 #include <ituGL/core/DeviceGL.h>
 
 #include <ituGL/application/Window.h>
+#include <ituGL/core/RecordingGL.h>
 #include <GLFW/glfw3.h>
 #include <cassert>
+#include <bit>
 
 DeviceGL* DeviceGL::m_instance = nullptr;
 
-DeviceGL::DeviceGL() : m_contextLoaded(false)
+bool DeviceGL::s_directStateAccessEnabled = true;
+
+DeviceGL::DeviceGL() : m_contextLoaded(false), m_activeTextureUnit(-1), m_vertexArray(UnknownBinding)
 {
     m_instance = this;
+    m_renderStates.fill(nullptr);
+    InvalidateTextureBindings();
+    InvalidateVertexBindings();
 
     // Init GLFW
     glfwInit();
@@ -25,19 +32,34 @@ DeviceGL::~DeviceGL()
 // Set the window that OpenGL will use for rendering
 void DeviceGL::SetCurrentWindow(Window& window)
 {
-    GLFWwindow* glfwWindow = window.GetInternalWindow();
-    glfwMakeContextCurrent(glfwWindow);
+    // Headless windows use an EGL context instead of GLFW
+    bool isCurrent = window.MakeContextCurrent();
 
     // Load required GL libraries and initialize the context
-    m_contextLoaded = gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+    m_contextLoaded = isCurrent && gladLoadGLLoader((GLADloadproc)window.GetProcAddressFunction());
 
-    if (m_contextLoaded)
+    if (m_contextLoaded && !window.IsHeadless())
     {
+        GLFWwindow* glfwWindow = window.GetInternalWindow();
+
         // Set callback to be called when the window is resized
         glfwSetFramebufferSizeCallback(glfwWindow, FrameBufferResized);
     }
 }
 
+// Use the recording GL entry points instead of a window context
+bool DeviceGL::LoadRecordingContext()
+{
+    m_contextLoaded = RecordingGL::Load();
+
+    // The cached bindings and states refer to the previous context
+    m_renderStates.fill(nullptr);
+    InvalidateTextureBindings();
+    InvalidateVertexBindings();
+
+    return m_contextLoaded;
+}
+
 // Set the dimensions of the viewport
 void DeviceGL::SetViewport(GLint x, GLint y, GLsizei width, GLsizei height)
 {
@@ -91,6 +113,12 @@ bool DeviceGL::IsFeatureEnabled(GLenum feature) const
 // enable / disable a feature
 void DeviceGL::SetFeatureEnabled(GLenum feature, bool enabled)
 {
+    // Blending is also set by the render states, the current block is not known anymore
+    if (feature == GL_BLEND)
+    {
+        m_renderStates[std::countr_zero(static_cast<unsigned int>(RenderState::BlendEnable))] = nullptr;
+    }
+
     if (enabled)
     {
         glEnable(feature);
@@ -101,6 +129,293 @@ void DeviceGL::SetFeatureEnabled(GLenum feature, bool enabled)
     }
 }
 
+// Set the groups of the render state that are different from the current values
+void DeviceGL::SetRenderState(const RenderState& renderState, unsigned int groupMask)
+{
+    groupMask &= renderState.GetGroups();
+
+    // Usually all the groups were set by the same block, so it is compared only once
+    unsigned int changedGroups = 0;
+    const RenderState* comparedState = nullptr;
+    unsigned int differentGroups = 0;
+    for (unsigned int group = 0; group < RenderState::GroupCount; ++group)
+    {
+        unsigned int groupBit = 1u << group;
+        const RenderState*& currentState = m_renderStates[group];
+        if ((groupMask & groupBit) == 0 || currentState == &renderState)
+        {
+            continue;
+        }
+
+        if (!currentState)
+        {
+            changedGroups |= groupBit;
+        }
+        else
+        {
+            if (currentState != comparedState)
+            {
+                comparedState = currentState;
+                differentGroups = renderState.GetDifferentGroups(*currentState);
+            }
+            changedGroups |= differentGroups & groupBit;
+        }
+        currentState = &renderState;
+    }
+
+    if (changedGroups)
+    {
+        renderState.Apply(changedGroups);
+        ++m_renderStateStats.changes;
+        m_renderStateStats.groupsSet += std::popcount(changedGroups);
+    }
+    else
+    {
+        ++m_renderStateStats.skipped;
+    }
+}
+
+void DeviceGL::InvalidateRenderState()
+{
+    m_renderStates.fill(nullptr);
+}
+
+void DeviceGL::SetActiveTextureUnit(GLint textureUnit)
+{
+    if (textureUnit != m_activeTextureUnit)
+    {
+        glActiveTexture(GL_TEXTURE0 + textureUnit);
+        m_activeTextureUnit = textureUnit;
+        ++m_textureBindStats.unitChanges;
+    }
+}
+
+void DeviceGL::BindTexture(GLenum target, GLuint texture)
+{
+    if (m_activeTextureUnit < 0 || m_activeTextureUnit >= TextureUnitCount)
+    {
+        glBindTexture(target, texture);
+        ++m_textureBindStats.binds;
+        return;
+    }
+
+    GLuint& boundTexture = m_textureUnits[m_activeTextureUnit].textures[GetTextureTargetIndex(target)];
+    if (boundTexture != texture)
+    {
+        glBindTexture(target, texture);
+        boundTexture = texture;
+        ++m_textureBindStats.binds;
+    }
+    else
+    {
+        ++m_textureBindStats.skipped;
+    }
+}
+
+void DeviceGL::BindTexture(GLint textureUnit, GLenum target, GLuint texture, GLuint sampler)
+{
+    assert(textureUnit >= 0);
+    if (textureUnit < TextureUnitCount && m_textureUnits[textureUnit].textures[GetTextureTargetIndex(target)] == texture)
+    {
+        ++m_textureBindStats.skipped;
+    }
+    else
+    {
+        SetActiveTextureUnit(textureUnit);
+        BindTexture(target, texture);
+    }
+    BindSampler(textureUnit, sampler);
+}
+
+void DeviceGL::BindSampler(GLint textureUnit, GLuint sampler)
+{
+    // Samplers are bound by unit, they don't need the active unit
+    assert(textureUnit >= 0);
+    if (textureUnit < TextureUnitCount && m_textureUnits[textureUnit].sampler == sampler)
+    {
+        ++m_textureBindStats.samplersSkipped;
+        return;
+    }
+
+    glBindSampler(textureUnit, sampler);
+    if (textureUnit < TextureUnitCount)
+    {
+        m_textureUnits[textureUnit].sampler = sampler;
+    }
+    ++m_textureBindStats.samplerBinds;
+}
+
+GLuint DeviceGL::GetBoundTexture(GLenum target) const
+{
+    if (m_activeTextureUnit < 0 || m_activeTextureUnit >= TextureUnitCount)
+    {
+        return UnknownBinding;
+    }
+    return m_textureUnits[m_activeTextureUnit].textures[GetTextureTargetIndex(target)];
+}
+
+void DeviceGL::ForgetTexture(GLuint texture)
+{
+    // Deleted textures are unbound, the units have the default texture now
+    for (TextureUnitBindings& bindings : m_textureUnits)
+    {
+        for (GLuint& boundTexture : bindings.textures)
+        {
+            if (boundTexture == texture)
+            {
+                boundTexture = 0;
+            }
+        }
+    }
+}
+
+void DeviceGL::ForgetSampler(GLuint sampler)
+{
+    for (TextureUnitBindings& bindings : m_textureUnits)
+    {
+        if (bindings.sampler == sampler)
+        {
+            bindings.sampler = 0;
+        }
+    }
+}
+
+void DeviceGL::InvalidateTextureBindings()
+{
+    for (TextureUnitBindings& bindings : m_textureUnits)
+    {
+        bindings.textures.fill(UnknownBinding);
+        bindings.sampler = UnknownBinding;
+    }
+    m_activeTextureUnit = -1;
+}
+
+void DeviceGL::BindVertexArray(GLuint vertexArray)
+{
+    if (vertexArray != m_vertexArray)
+    {
+        glBindVertexArray(vertexArray);
+        m_vertexArray = vertexArray;
+        ++m_vertexBindStats.vertexArrayBinds;
+    }
+    else
+    {
+        ++m_vertexBindStats.vertexArraysSkipped;
+    }
+}
+
+void DeviceGL::BindVertexBuffer(GLuint vertexArray, GLuint bindingIndex, GLuint buffer, GLintptr offset, GLsizei stride)
+{
+    // Vertex arrays seen for the first time don't have known buffers
+    auto itBindings = m_vertexArrays.try_emplace(vertexArray, VertexArrayBindings{ {}, UnknownBinding }).first;
+    std::vector<VertexArrayBindings::VertexBuffer>& vertexBuffers = itBindings->second.vertexBuffers;
+    if (bindingIndex >= vertexBuffers.size())
+    {
+        vertexBuffers.resize(bindingIndex + 1, VertexArrayBindings::VertexBuffer{ UnknownBinding, 0, 0 });
+    }
+
+    VertexArrayBindings::VertexBuffer& vertexBuffer = vertexBuffers[bindingIndex];
+    if (vertexBuffer.buffer == buffer && vertexBuffer.offset == offset && vertexBuffer.stride == stride)
+    {
+        ++m_vertexBindStats.buffersSkipped;
+        return;
+    }
+
+    if (HasDirectStateAccess())
+    {
+        glVertexArrayVertexBuffer(vertexArray, bindingIndex, buffer, offset, stride);
+    }
+    else
+    {
+        BindVertexArray(vertexArray);
+        glBindVertexBuffer(bindingIndex, buffer, offset, stride);
+    }
+    vertexBuffer = VertexArrayBindings::VertexBuffer{ buffer, offset, stride };
+    ++m_vertexBindStats.bufferBinds;
+}
+
+void DeviceGL::BindElementBuffer(GLuint vertexArray, GLuint buffer)
+{
+    auto itBindings = m_vertexArrays.try_emplace(vertexArray, VertexArrayBindings{ {}, UnknownBinding }).first;
+    GLuint& elementBuffer = itBindings->second.elementBuffer;
+    if (elementBuffer == buffer)
+    {
+        ++m_vertexBindStats.buffersSkipped;
+        return;
+    }
+
+    if (HasDirectStateAccess())
+    {
+        glVertexArrayElementBuffer(vertexArray, buffer);
+    }
+    else
+    {
+        // The element buffer binding is part of the state of the bound vertex array
+        BindVertexArray(vertexArray);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+    }
+    elementBuffer = buffer;
+    ++m_vertexBindStats.bufferBinds;
+}
+
+void DeviceGL::ForgetVertexArray(GLuint vertexArray)
+{
+    // Deleting the bound vertex array binds the default one
+    if (m_vertexArray == vertexArray)
+    {
+        m_vertexArray = 0;
+    }
+    m_vertexArrays.erase(vertexArray);
+}
+
+void DeviceGL::ForgetBuffer(GLuint buffer)
+{
+    // Only the bound vertex array detaches the deleted buffer, the others keep the old name
+    // Mark them as unknown, so a new buffer with the same name is attached again
+    for (auto& vertexArrayPair : m_vertexArrays)
+    {
+        VertexArrayBindings& bindings = vertexArrayPair.second;
+        for (VertexArrayBindings::VertexBuffer& vertexBuffer : bindings.vertexBuffers)
+        {
+            if (vertexBuffer.buffer == buffer)
+            {
+                vertexBuffer.buffer = UnknownBinding;
+            }
+        }
+        if (bindings.elementBuffer == buffer)
+        {
+            bindings.elementBuffer = UnknownBinding;
+        }
+    }
+}
+
+void DeviceGL::InvalidateVertexBindings()
+{
+    m_vertexArrays.clear();
+    m_vertexArray = UnknownBinding;
+}
+
+unsigned int DeviceGL::GetTextureTargetIndex(GLenum target)
+{
+    switch (target)
+    {
+    case GL_TEXTURE_1D: return 0;
+    case GL_TEXTURE_1D_ARRAY: return 1;
+    case GL_TEXTURE_2D: return 2;
+    case GL_TEXTURE_2D_ARRAY: return 3;
+    case GL_TEXTURE_2D_MULTISAMPLE: return 4;
+    case GL_TEXTURE_2D_MULTISAMPLE_ARRAY: return 5;
+    case GL_TEXTURE_3D: return 6;
+    case GL_TEXTURE_CUBE_MAP: return 7;
+    case GL_TEXTURE_CUBE_MAP_ARRAY: return 8;
+    case GL_TEXTURE_BUFFER: return 9;
+    case GL_TEXTURE_RECTANGLE: return 10;
+    default:
+        assert(false);
+        return 0;
+    }
+}
+
 // enable / disable wireframe mode
 void DeviceGL::SetWireframeEnabled(bool enabled)
 {
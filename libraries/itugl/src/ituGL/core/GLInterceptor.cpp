@@ -0,0 +1,868 @@
+#include <ituGL/core/GLInterceptor.h>
+
+#include <ituGL/utils/DearImGui.h>
+#include <imgui.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+
+bool GLInterceptor::s_enabled = false;
+
+// State setters that are redundant if called again with the same arguments
+// Signature of the arguments, as promoted by the glad callback: i = integer, f = double, l = pointer sized integer
+// The first keyArguments select the state, like the face of the stencil functions
+// Setting a state forgets the related one, like glBlendFunc and glBlendFuncSeparate
+struct StateSetter
+{
+    const char* name;
+    const char* signature;
+    unsigned int keyArguments;
+    int relatedState;
+};
+
+static const StateSetter s_stateSetters[] = {
+    { "glBlendFunc", "ii", 0, 1 },
+    { "glBlendFuncSeparate", "iiii", 0, 0 },
+    { "glBlendEquation", "i", 0, 3 },
+    { "glBlendEquationSeparate", "ii", 0, 2 },
+    { "glBlendColor", "ffff", 0, -1 },
+    { "glStencilFunc", "iii", 0, 6 },
+    { "glStencilFuncSeparate", "iiii", 1, 5 },
+    { "glStencilOp", "iii", 0, 8 },
+    { "glStencilOpSeparate", "iiii", 1, 7 },
+    { "glStencilMask", "i", 0, 10 },
+    { "glStencilMaskSeparate", "ii", 1, 9 },
+    { "glDepthFunc", "i", 0, -1 },
+    { "glDepthMask", "i", 0, -1 },
+    { "glDepthRange", "ff", 0, -1 },
+    { "glCullFace", "i", 0, -1 },
+    { "glFrontFace", "i", 0, -1 },
+    { "glColorMask", "iiii", 0, -1 },
+    { "glViewport", "iiii", 0, -1 },
+    { "glScissor", "iiii", 0, -1 },
+    { "glClearColor", "ffff", 0, -1 },
+    { "glClearDepth", "f", 0, 21 },
+    { "glClearDepthf", "f", 0, 20 },
+    { "glClearStencil", "i", 0, -1 },
+    { "glPolygonMode", "ii", 1, -1 },
+    { "glPolygonOffset", "ff", 0, -1 },
+    { "glLineWidth", "f", 0, -1 },
+    { "glPointSize", "f", 0, -1 },
+    { "glPixelStorei", "ii", 1, -1 },
+    { "glPatchParameteri", "ii", 1, -1 },
+};
+
+// Kinds of shadow state, in the high bits of the key. State setters follow, by their index in the table
+enum ShadowKind : uint64_t
+{
+    ShadowProgram,
+    ShadowVertexArray,
+    ShadowBuffer,
+    ShadowBufferIndexed,
+    ShadowFramebuffer,
+    ShadowTexture,
+    ShadowTextureUnit,
+    ShadowSampler,
+    ShadowCapability,
+    ShadowStateSetter,
+};
+
+static inline uint64_t ShadowKey(uint64_t kind, uint64_t target, uint64_t index = 0)
+{
+    return (kind << 56) | ((target & 0xFFFFFF) << 32) | (index & 0xFFFFFFFF);
+}
+
+static bool StartsWith(const char* name, const char* prefix)
+{
+    return std::strncmp(name, prefix, std::strlen(prefix)) == 0;
+}
+
+// Read the arguments of the signature, as their raw bits
+static void ReadArguments(const char* signature, va_list arguments, uint64_t* values)
+{
+    for (const char* c = signature; *c; ++c, ++values)
+    {
+        switch (*c)
+        {
+        case 'i':
+            *values = static_cast<unsigned int>(va_arg(arguments, int));
+            break;
+        case 'f':
+        {
+            double value = va_arg(arguments, double);
+            std::memcpy(values, &value, sizeof(value));
+            break;
+        }
+        case 'l':
+            *values = static_cast<uint64_t>(va_arg(arguments, GLintptr));
+            break;
+        default:
+            assert(false);
+            break;
+        }
+    }
+}
+
+GLInterceptor::GLInterceptor()
+    : m_currentPass(0)
+    , m_frameCount(0)
+    , m_program(0)
+    , m_activeTextureUnit(0)
+    , m_activeTextureUnitKnown(false)
+    , m_debugOutput(false)
+{
+    m_currentFrame.push_back(PassCounts{ "Outside passes" });
+}
+
+GLInterceptor::~GLInterceptor()
+{
+    // Objects destroyed after the interceptor can still make GL calls
+    glad_set_pre_callback(NoCallback);
+    s_enabled = false;
+}
+
+GLInterceptor& GLInterceptor::GetInstance()
+{
+    static GLInterceptor instance;
+    return instance;
+}
+
+void GLInterceptor::SetEnabled(bool enabled)
+{
+    if (enabled == s_enabled)
+    {
+        return;
+    }
+
+    // The debug output is configured with GL calls, so it is changed while the callback is not installed
+    if (!enabled)
+    {
+        glad_set_pre_callback(NoCallback);
+        s_enabled = false;
+        EnableDebugOutput(false);
+    }
+    else
+    {
+        EnableDebugOutput(true);
+        InvalidateShadow();
+        s_enabled = true;
+        glad_set_pre_callback(PreCallback);
+    }
+}
+
+void GLInterceptor::EnableDebugOutput(bool enabled)
+{
+    // Debug output is core since GL 4.3. Contexts created without the debug flag may report fewer messages
+    if (!GLAD_GL_VERSION_4_3 || enabled == m_debugOutput)
+    {
+        return;
+    }
+
+    if (enabled)
+    {
+        // Only performance warnings and errors, reported in the call that causes them
+        glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_FALSE);
+        glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_PERFORMANCE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+        glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_ERROR, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+        glDebugMessageCallback(DebugCallback, this);
+        glEnable(GL_DEBUG_OUTPUT);
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    }
+    else
+    {
+        glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+        glDisable(GL_DEBUG_OUTPUT);
+        glDebugMessageCallback(nullptr, nullptr);
+    }
+    m_debugOutput = enabled;
+}
+
+void GLInterceptor::NextFrame()
+{
+    std::swap(m_lastFrame, m_currentFrame);
+
+    // Keep the passes seen so far, with their counts cleared
+    m_currentFrame.resize(m_lastFrame.size());
+    for (unsigned int passIndex = 0; passIndex < m_lastFrame.size(); ++passIndex)
+    {
+        const PassCounts& lastPass = m_lastFrame[passIndex];
+        m_currentFrame[passIndex].name = lastPass.name;
+        m_currentFrame[passIndex].counts.assign(m_entries.size(), CallCounts());
+
+        for (unsigned int entryIndex = 0; entryIndex < lastPass.counts.size(); ++entryIndex)
+        {
+            m_totals[entryIndex].calls += lastPass.counts[entryIndex].calls;
+            m_totals[entryIndex].redundant += lastPass.counts[entryIndex].redundant;
+        }
+    }
+    m_currentPass = 0;
+    ++m_frameCount;
+
+    // Calls made outside the interceptor, like the ones of Dear ImGui, could have changed the state between frames
+    InvalidateShadow();
+}
+
+void GLInterceptor::BeginPass(const std::string& name)
+{
+    auto itPass = std::find_if(m_currentFrame.begin(), m_currentFrame.end(), [&](const PassCounts& pass) { return pass.name == name; });
+    if (itPass == m_currentFrame.end())
+    {
+        itPass = m_currentFrame.insert(m_currentFrame.end(), PassCounts{ name, std::vector<CallCounts>(m_entries.size()) });
+    }
+    m_currentPass = static_cast<unsigned int>(itPass - m_currentFrame.begin());
+}
+
+void GLInterceptor::EndPass()
+{
+    m_currentPass = 0;
+}
+
+GLInterceptor::CallCounts GLInterceptor::Sum(const PassCounts& pass)
+{
+    CallCounts sum;
+    for (const CallCounts& counts : pass.counts)
+    {
+        sum.calls += counts.calls;
+        sum.redundant += counts.redundant;
+    }
+    return sum;
+}
+
+GLInterceptor::CallCounts GLInterceptor::GetPassCounts(unsigned int passIndex) const
+{
+    return Sum(m_lastFrame[passIndex]);
+}
+
+GLInterceptor::CallCounts GLInterceptor::GetFrameCounts() const
+{
+    CallCounts sum;
+    for (const PassCounts& pass : m_lastFrame)
+    {
+        CallCounts passSum = Sum(pass);
+        sum.calls += passSum.calls;
+        sum.redundant += passSum.redundant;
+    }
+    return sum;
+}
+
+GLInterceptor::CallCounts GLInterceptor::GetFrameCounts(Category category) const
+{
+    CallCounts sum;
+    for (const PassCounts& pass : m_lastFrame)
+    {
+        for (unsigned int entryIndex = 0; entryIndex < pass.counts.size(); ++entryIndex)
+        {
+            if (m_entries[entryIndex].category == category)
+            {
+                sum.calls += pass.counts[entryIndex].calls;
+                sum.redundant += pass.counts[entryIndex].redundant;
+            }
+        }
+    }
+    return sum;
+}
+
+const char* GLInterceptor::GetCategoryName(Category category)
+{
+    switch (category)
+    {
+    case Category::Draw:
+        return "Draw";
+    case Category::Bind:
+        return "Bind";
+    case Category::Uniform:
+        return "Uniform";
+    case Category::State:
+        return "State";
+    case Category::Query:
+        return "Query";
+    default:
+        return "Other";
+    }
+}
+
+void GLInterceptor::Clear()
+{
+    for (PassCounts& pass : m_currentFrame)
+    {
+        pass.counts.assign(m_entries.size(), CallCounts());
+    }
+    m_lastFrame.clear();
+    m_totals.assign(m_entries.size(), CallCounts());
+    m_frameCount = 0;
+    m_debugMessages.clear();
+}
+
+void GLInterceptor::PreCallback(const char* name, void* function, int argumentCount, ...)
+{
+    va_list arguments;
+    va_start(arguments, argumentCount);
+    GetInstance().OnCall(name, function, arguments);
+    va_end(arguments);
+}
+
+void GLInterceptor::NoCallback(const char* name, void* function, int argumentCount, ...)
+{
+}
+
+void GLInterceptor::OnCall(const char* name, void* function, va_list arguments)
+{
+    unsigned int entryIndex;
+    auto itEntry = m_entryIndices.find(function);
+    if (itEntry != m_entryIndices.end())
+    {
+        entryIndex = itEntry->second;
+    }
+    else
+    {
+        entryIndex = AddEntry(name);
+        m_entryIndices[function] = entryIndex;
+    }
+
+    std::vector<CallCounts>& counts = m_currentFrame[m_currentPass].counts;
+    if (entryIndex >= counts.size())
+    {
+        counts.resize(m_entries.size());
+    }
+    ++counts[entryIndex].calls;
+    if (IsRedundant(m_entries[entryIndex], arguments))
+    {
+        ++counts[entryIndex].redundant;
+    }
+}
+
+unsigned int GLInterceptor::AddEntry(const char* name)
+{
+    Entry entry = {};
+    entry.name = name;
+    entry.category = Category::Other;
+    entry.check = Check::None;
+    entry.state = -1;
+    entry.relatedState = -1;
+
+    // Draws, dispatches and anything that writes to the framebuffer
+    if (StartsWith(name, "glDraw") || StartsWith(name, "glMultiDraw") || StartsWith(name, "glDispatch")
+        || std::strcmp(name, "glClear") == 0 || StartsWith(name, "glClearBuffer") || StartsWith(name, "glBlitFramebuffer"))
+    {
+        entry.category = Category::Draw;
+    }
+    // Calls that read back from the driver, and can stall it
+    else if (StartsWith(name, "glGet") || StartsWith(name, "glIs") || StartsWith(name, "glCheck")
+        || std::strcmp(name, "glReadPixels") == 0 || std::strcmp(name, "glFinish") == 0 || std::strcmp(name, "glClientWaitSync") == 0)
+    {
+        entry.category = Category::Query;
+    }
+    else if (StartsWith(name, "glUniform") || StartsWith(name, "glProgramUniform"))
+    {
+        // glUniform{1,2,3,4}{f,i,ui,d}[v] and glUniformMatrix{2,3,4}[x{2,3,4}]{f,d}v, with or without the program
+        entry.category = Category::Uniform;
+        bool program = StartsWith(name, "glProgramUniform");
+        const char* format = name + (program ? std::strlen("glProgramUniform") : std::strlen("glUniform"));
+        if (StartsWith(format, "Matrix"))
+        {
+            format += std::strlen("Matrix");
+            unsigned int columns = format[0] - '0';
+            unsigned int rows = columns;
+            ++format;
+            if (format[0] == 'x')
+            {
+                rows = format[1] - '0';
+                format += 2;
+            }
+            entry.uniformMatrix = true;
+            entry.uniformComponents = columns * rows;
+        }
+        else
+        {
+            entry.uniformComponents = format[0] - '0';
+            ++format;
+        }
+        entry.uniformType = format[0] == 'u' ? 'u' : format[0];
+        format += format[0] == 'u' ? 2 : 1;
+        entry.uniformVector = format[0] == 'v';
+        entry.uniformComponentSize = entry.uniformType == 'd' ? sizeof(GLdouble) : sizeof(GLfloat);
+
+        // Block bindings and subroutines are not checked
+        bool known = entry.uniformComponents >= 1 && entry.uniformComponents <= 16
+            && (entry.uniformType == 'f' || entry.uniformType == 'i' || entry.uniformType == 'u' || entry.uniformType == 'd');
+        entry.check = !known ? Check::None : program ? Check::ProgramUniform : Check::Uniform;
+    }
+    else if (StartsWith(name, "glBind") || std::strcmp(name, "glUseProgram") == 0 || std::strcmp(name, "glActiveTexture") == 0)
+    {
+        entry.category = Category::Bind;
+        if (std::strcmp(name, "glUseProgram") == 0)
+            entry.check = Check::UseProgram;
+        else if (std::strcmp(name, "glBindVertexArray") == 0)
+            entry.check = Check::BindVertexArray;
+        else if (std::strcmp(name, "glBindBuffer") == 0)
+            entry.check = Check::BindBuffer;
+        else if (std::strcmp(name, "glBindBufferBase") == 0 || std::strcmp(name, "glBindBufferRange") == 0)
+            entry.check = Check::BindBufferIndexed;
+        else if (std::strcmp(name, "glBindFramebuffer") == 0)
+            entry.check = Check::BindFramebuffer;
+        else if (std::strcmp(name, "glActiveTexture") == 0)
+            entry.check = Check::ActiveTexture;
+        else if (std::strcmp(name, "glBindTexture") == 0)
+            entry.check = Check::BindTexture;
+        else if (std::strcmp(name, "glBindTextureUnit") == 0)
+            entry.check = Check::BindTextureUnit;
+        else if (std::strcmp(name, "glBindSampler") == 0)
+            entry.check = Check::BindSampler;
+    }
+    else if (std::strcmp(name, "glEnable") == 0 || std::strcmp(name, "glDisable") == 0)
+    {
+        entry.category = Category::State;
+        entry.check = name[2] == 'E' ? Check::Enable : Check::Disable;
+    }
+    else if (StartsWith(name, "glDelete") || std::strcmp(name, "glLinkProgram") == 0 || std::strcmp(name, "glProgramBinary") == 0)
+    {
+        entry.check = Check::Invalidate;
+    }
+
+    for (int state = 0; state < static_cast<int>(std::size(s_stateSetters)); ++state)
+    {
+        const StateSetter& setter = s_stateSetters[state];
+        if (std::strcmp(name, setter.name) == 0)
+        {
+            entry.category = Category::State;
+            entry.check = Check::State;
+            entry.signature = setter.signature;
+            entry.keyArguments = setter.keyArguments;
+            entry.state = state;
+            entry.relatedState = setter.relatedState;
+            break;
+        }
+    }
+
+    m_entries.push_back(entry);
+    m_totals.resize(m_entries.size());
+    return static_cast<unsigned int>(m_entries.size() - 1);
+}
+
+bool GLInterceptor::SetShadow(uint64_t key, const std::array<uint64_t, 4>& value)
+{
+    auto result = m_shadow.try_emplace(key, value);
+    if (result.second)
+    {
+        return false;
+    }
+    if (result.first->second == value)
+    {
+        return true;
+    }
+    result.first->second = value;
+    return false;
+}
+
+void GLInterceptor::InvalidateShadow()
+{
+    m_shadow.clear();
+    m_uniformShadow.clear();
+    m_program = 0;
+    m_activeTextureUnitKnown = false;
+}
+
+bool GLInterceptor::IsRedundant(const Entry& entry, va_list arguments)
+{
+    switch (entry.check)
+    {
+    case Check::UseProgram:
+    {
+        GLuint program = va_arg(arguments, GLuint);
+        // The program is also needed for glUniform. Unknown if it was never set, so the first uniforms are not compared
+        bool redundant = SetShadow(ShadowKey(ShadowProgram, 0), { program });
+        m_program = program;
+        return redundant;
+    }
+    case Check::BindVertexArray:
+    {
+        GLuint vertexArray = va_arg(arguments, GLuint);
+        if (SetShadow(ShadowKey(ShadowVertexArray, 0), { vertexArray }))
+        {
+            return true;
+        }
+        // The element array buffer is part of the vertex array
+        m_shadow.erase(ShadowKey(ShadowBuffer, GL_ELEMENT_ARRAY_BUFFER));
+        return false;
+    }
+    case Check::BindBuffer:
+    {
+        GLenum target = va_arg(arguments, GLenum);
+        GLuint buffer = va_arg(arguments, GLuint);
+        return SetShadow(ShadowKey(ShadowBuffer, target), { buffer });
+    }
+    case Check::BindBufferIndexed:
+    {
+        // glBindBufferBase and glBindBufferRange also bind the buffer to the generic target
+        bool range = entry.name == "glBindBufferRange";
+        GLenum target = va_arg(arguments, GLenum);
+        GLuint index = va_arg(arguments, GLuint);
+        GLuint buffer = va_arg(arguments, GLuint);
+        GLintptr offset = range ? va_arg(arguments, GLintptr) : 0;
+        GLsizeiptr size = range ? va_arg(arguments, GLsizeiptr) : 0;
+        SetShadow(ShadowKey(ShadowBuffer, target), { buffer });
+        return SetShadow(ShadowKey(ShadowBufferIndexed, target, index), { buffer, static_cast<uint64_t>(offset), static_cast<uint64_t>(size) });
+    }
+    case Check::BindFramebuffer:
+    {
+        GLenum target = va_arg(arguments, GLenum);
+        GLuint framebuffer = va_arg(arguments, GLuint);
+        if (target == GL_FRAMEBUFFER)
+        {
+            // Both targets have to be set, so the two shadows are updated
+            bool drawRedundant = SetShadow(ShadowKey(ShadowFramebuffer, GL_DRAW_FRAMEBUFFER), { framebuffer });
+            bool readRedundant = SetShadow(ShadowKey(ShadowFramebuffer, GL_READ_FRAMEBUFFER), { framebuffer });
+            return drawRedundant && readRedundant;
+        }
+        return SetShadow(ShadowKey(ShadowFramebuffer, target), { framebuffer });
+    }
+    case Check::ActiveTexture:
+    {
+        GLenum texture = va_arg(arguments, GLenum);
+        bool redundant = m_activeTextureUnitKnown && m_activeTextureUnit == texture - GL_TEXTURE0;
+        m_activeTextureUnit = texture - GL_TEXTURE0;
+        m_activeTextureUnitKnown = true;
+        return redundant;
+    }
+    case Check::BindTexture:
+    {
+        GLenum target = va_arg(arguments, GLenum);
+        GLuint texture = va_arg(arguments, GLuint);
+        if (!m_activeTextureUnitKnown)
+        {
+            return false;
+        }
+        m_shadow.erase(ShadowKey(ShadowTextureUnit, 0, m_activeTextureUnit));
+        return SetShadow(ShadowKey(ShadowTexture, target, m_activeTextureUnit), { texture });
+    }
+    case Check::BindTextureUnit:
+    {
+        GLuint unit = va_arg(arguments, GLuint);
+        GLuint texture = va_arg(arguments, GLuint);
+        if (SetShadow(ShadowKey(ShadowTextureUnit, 0, unit), { texture }))
+        {
+            return true;
+        }
+        // Binds the texture to its own target, the others are unknown
+        for (GLenum target : { GL_TEXTURE_1D, GL_TEXTURE_2D, GL_TEXTURE_3D, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_1D_ARRAY, GL_TEXTURE_2D_ARRAY,
+            GL_TEXTURE_CUBE_MAP_ARRAY, GL_TEXTURE_RECTANGLE, GL_TEXTURE_BUFFER, GL_TEXTURE_2D_MULTISAMPLE, GL_TEXTURE_2D_MULTISAMPLE_ARRAY })
+        {
+            m_shadow.erase(ShadowKey(ShadowTexture, target, unit));
+        }
+        return false;
+    }
+    case Check::BindSampler:
+    {
+        GLuint unit = va_arg(arguments, GLuint);
+        GLuint sampler = va_arg(arguments, GLuint);
+        return SetShadow(ShadowKey(ShadowSampler, 0, unit), { sampler });
+    }
+    case Check::Enable:
+    case Check::Disable:
+    {
+        GLenum capability = va_arg(arguments, GLenum);
+        return SetShadow(ShadowKey(ShadowCapability, capability), { entry.check == Check::Enable ? 1u : 0u });
+    }
+    case Check::State:
+    {
+        uint64_t values[6] = {};
+        ReadArguments(entry.signature, arguments, values);
+        uint64_t key = entry.keyArguments > 0 ? values[0] : 0;
+        std::array<uint64_t, 4> value = {};
+        std::copy(values + entry.keyArguments, values + std::strlen(entry.signature), value.begin());
+        if (entry.relatedState >= 0)
+        {
+            for (uint64_t relatedKey : { 0, GL_FRONT, GL_BACK, GL_FRONT_AND_BACK })
+            {
+                m_shadow.erase(ShadowKey(ShadowStateSetter + entry.relatedState, relatedKey));
+            }
+        }
+        return SetShadow(ShadowKey(ShadowStateSetter + entry.state, key), value);
+    }
+    case Check::Uniform:
+        return m_program != 0 && SetUniformShadow(entry, m_program, arguments);
+    case Check::ProgramUniform:
+    {
+        GLuint program = va_arg(arguments, GLuint);
+        return SetUniformShadow(entry, program, arguments);
+    }
+    case Check::Invalidate:
+        InvalidateShadow();
+        return false;
+    default:
+        return false;
+    }
+}
+
+bool GLInterceptor::SetUniformShadow(const Entry& entry, GLuint program, va_list arguments)
+{
+    GLint location = va_arg(arguments, GLint);
+    if (location < 0)
+    {
+        return false;
+    }
+
+    // Values are compared as they are passed, so the same value passed with another entry point is not redundant
+    m_uniformValue.clear();
+    if (entry.uniformVector)
+    {
+        GLsizei count = va_arg(arguments, GLsizei);
+        GLboolean transpose = entry.uniformMatrix ? static_cast<GLboolean>(va_arg(arguments, int)) : GL_FALSE;
+        const unsigned char* data = static_cast<const unsigned char*>(va_arg(arguments, const void*));
+        size_t size = static_cast<size_t>(std::max(count, 0)) * entry.uniformComponents * entry.uniformComponentSize;
+        m_uniformValue.push_back(transpose);
+        m_uniformValue.insert(m_uniformValue.end(), data, data + size);
+    }
+    else
+    {
+        // Scalar arguments are promoted to int or double
+        for (unsigned int component = 0; component < entry.uniformComponents; ++component)
+        {
+            uint64_t value;
+            if (entry.uniformType == 'f' || entry.uniformType == 'd')
+            {
+                double promoted = va_arg(arguments, double);
+                std::memcpy(&value, &promoted, sizeof(value));
+            }
+            else
+            {
+                value = static_cast<unsigned int>(va_arg(arguments, int));
+            }
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+            m_uniformValue.insert(m_uniformValue.end(), bytes, bytes + sizeof(value));
+        }
+    }
+
+    uint64_t key = (static_cast<uint64_t>(program) << 32) | static_cast<uint32_t>(location);
+    std::vector<unsigned char>& shadow = m_uniformShadow[key];
+    if (shadow == m_uniformValue)
+    {
+        return true;
+    }
+    shadow = m_uniformValue;
+    return false;
+}
+
+void APIENTRY GLInterceptor::DebugCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void* userParam)
+{
+    if (!s_enabled)
+    {
+        return;
+    }
+    GLInterceptor* interceptor = static_cast<GLInterceptor*>(const_cast<void*>(userParam));
+    interceptor->AddDebugMessage(source, type, id, severity, message);
+}
+
+void GLInterceptor::AddDebugMessage(GLenum source, GLenum type, GLuint id, GLenum severity, const char* text)
+{
+    auto itMessage = std::find_if(m_debugMessages.begin(), m_debugMessages.end(), [&](const DebugMessage& message)
+        {
+            return message.source == source && message.type == type && message.id == id;
+        });
+    if (itMessage != m_debugMessages.end())
+    {
+        ++itMessage->count;
+        itMessage->text = text;
+    }
+    else
+    {
+        m_debugMessages.push_back(DebugMessage{ source, type, id, severity, text, m_currentFrame[m_currentPass].name, 1 });
+    }
+}
+
+bool GLInterceptor::ExportJson(const char* path) const
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        return false;
+    }
+
+    // Control characters in the debug messages are replaced with spaces
+    auto writeString = [&file](const std::string& string)
+        {
+            file << '"';
+            for (char c : string)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    file << '\\' << c;
+                }
+                else
+                {
+                    file << (static_cast<unsigned char>(c) < 0x20 ? ' ' : c);
+                }
+            }
+            file << '"';
+        };
+    auto writeCounts = [&file](const CallCounts& counts)
+        {
+            file << "{\"calls\":" << counts.calls << ",\"redundant\":" << counts.redundant << "}";
+        };
+
+    CallCounts frameCounts = GetFrameCounts();
+    file << "{\n\"frames\":" << m_frameCount << ",\n\"lastFrame\":{\"calls\":" << frameCounts.calls << ",\"redundant\":" << frameCounts.redundant;
+
+    file << ",\"categories\":{";
+    for (unsigned int category = 0; category < static_cast<unsigned int>(Category::Count); ++category)
+    {
+        file << (category ? "," : "") << '"' << GetCategoryName(static_cast<Category>(category)) << "\":";
+        writeCounts(GetFrameCounts(static_cast<Category>(category)));
+    }
+    file << "},\n\"passes\":[";
+
+    for (unsigned int passIndex = 0; passIndex < m_lastFrame.size(); ++passIndex)
+    {
+        const PassCounts& pass = m_lastFrame[passIndex];
+        CallCounts passCounts = Sum(pass);
+        file << (passIndex ? ",\n" : "\n") << "{\"name\":";
+        writeString(pass.name);
+        file << ",\"calls\":" << passCounts.calls << ",\"redundant\":" << passCounts.redundant << ",\"entries\":{";
+        bool first = true;
+        for (unsigned int entryIndex = 0; entryIndex < pass.counts.size(); ++entryIndex)
+        {
+            if (pass.counts[entryIndex].calls > 0)
+            {
+                file << (first ? "" : ",") << '"' << m_entries[entryIndex].name << "\":";
+                writeCounts(pass.counts[entryIndex]);
+                first = false;
+            }
+        }
+        file << "}}";
+    }
+    file << "]},\n\"totals\":{";
+
+    for (unsigned int entryIndex = 0; entryIndex < m_totals.size(); ++entryIndex)
+    {
+        file << (entryIndex ? ",\n" : "\n") << '"' << m_entries[entryIndex].name << "\":";
+        writeCounts(m_totals[entryIndex]);
+    }
+    file << "},\n\"debugMessages\":[";
+
+    for (unsigned int messageIndex = 0; messageIndex < m_debugMessages.size(); ++messageIndex)
+    {
+        const DebugMessage& message = m_debugMessages[messageIndex];
+        file << (messageIndex ? ",\n" : "\n") << "{\"source\":" << message.source << ",\"type\":" << message.type << ",\"id\":" << message.id
+            << ",\"severity\":" << message.severity << ",\"count\":" << message.count << ",\"pass\":";
+        writeString(message.pass);
+        file << ",\"text\":";
+        writeString(message.text);
+        file << "}";
+    }
+    file << "]\n}\n";
+    return static_cast<bool>(file);
+}
+
+void GLInterceptor::DrawGUI(DearImGui& imGui)
+{
+    if (auto window = imGui.UseWindow("GL Calls"))
+    {
+        bool enabled = s_enabled;
+        if (ImGui::Checkbox("Enabled", &enabled))
+        {
+            SetEnabled(enabled);
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Clear"))
+        {
+            Clear();
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Export JSON"))
+        {
+            const char* path = "gl_calls.json";
+            m_exportStatus = ExportJson(path) ? std::string("Saved ") + path : std::string("Could not write ") + path;
+        }
+        if (!m_exportStatus.empty())
+        {
+            ImGui::TextUnformatted(m_exportStatus.c_str());
+        }
+
+        CallCounts frameCounts = GetFrameCounts();
+        ImGui::Text("Last frame: %u calls, %u redundant", frameCounts.calls, frameCounts.redundant);
+        for (unsigned int category = 0; category < static_cast<unsigned int>(Category::Count); ++category)
+        {
+            CallCounts counts = GetFrameCounts(static_cast<Category>(category));
+            ImGui::BulletText("%s: %u calls, %u redundant", GetCategoryName(static_cast<Category>(category)), counts.calls, counts.redundant);
+        }
+
+        if (ImGui::CollapsingHeader("Passes", ImGuiTreeNodeFlags_DefaultOpen) && ImGui::BeginTable("Passes", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+        {
+            ImGui::TableSetupColumn("Pass");
+            ImGui::TableSetupColumn("Calls");
+            ImGui::TableSetupColumn("Redundant");
+            ImGui::TableHeadersRow();
+            for (unsigned int passIndex = 0; passIndex < m_lastFrame.size(); ++passIndex)
+            {
+                CallCounts counts = GetPassCounts(passIndex);
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(m_lastFrame[passIndex].name.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", counts.calls);
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", counts.redundant);
+            }
+            ImGui::EndTable();
+        }
+
+        if (ImGui::CollapsingHeader("Entry points"))
+        {
+            // Calls of the last frame, the most frequent first
+            std::vector<std::pair<unsigned int, CallCounts>> entries;
+            for (unsigned int entryIndex = 0; entryIndex < m_entries.size(); ++entryIndex)
+            {
+                CallCounts counts;
+                for (const PassCounts& pass : m_lastFrame)
+                {
+                    if (entryIndex < pass.counts.size())
+                    {
+                        counts.calls += pass.counts[entryIndex].calls;
+                        counts.redundant += pass.counts[entryIndex].redundant;
+                    }
+                }
+                if (counts.calls > 0)
+                {
+                    entries.emplace_back(entryIndex, counts);
+                }
+            }
+            std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.second.calls > b.second.calls; });
+
+            if (ImGui::BeginTable("Entry points", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+            {
+                ImGui::TableSetupColumn("Entry point");
+                ImGui::TableSetupColumn("Category");
+                ImGui::TableSetupColumn("Calls");
+                ImGui::TableSetupColumn("Redundant");
+                ImGui::TableHeadersRow();
+                for (const auto& entry : entries)
+                {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(m_entries[entry.first].name.c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(GetCategoryName(m_entries[entry.first].category));
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%u", entry.second.calls);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%u", entry.second.redundant);
+                }
+                ImGui::EndTable();
+            }
+        }
+
+        if (ImGui::CollapsingHeader("Debug messages"))
+        {
+            if (!GLAD_GL_VERSION_4_3)
+            {
+                ImGui::TextUnformatted("Debug output needs GL 4.3");
+            }
+            for (const DebugMessage& message : m_debugMessages)
+            {
+                const char* type = message.type == GL_DEBUG_TYPE_PERFORMANCE ? "Performance" : message.type == GL_DEBUG_TYPE_ERROR ? "Error" : "Other";
+                ImGui::TextWrapped("[%s] x%u in %s: %s", type, message.count, message.pass.c_str(), message.text.c_str());
+            }
+        }
+    }
+}
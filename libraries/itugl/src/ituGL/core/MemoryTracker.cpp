@@ -0,0 +1,372 @@
+#include <ituGL/core/MemoryTracker.h>
+
+#include <ituGL/utils/DearImGui.h>
+#include <imgui.h>
+#include <algorithm>
+#include <cassert>
+
+// Never destroyed, so objects released by other static instances at exit can still report it
+MemoryTracker& MemoryTracker::GetInstance()
+{
+    static MemoryTracker* instance = new MemoryTracker();
+    return *instance;
+}
+
+MemoryTracker::MemoryTracker()
+{
+}
+
+// The type goes in the high bits, handles and addresses fit in the low ones
+std::uint64_t MemoryTracker::GetKey(ObjectType type, std::uint64_t id)
+{
+    assert(id < (1ull << 56));
+    return (static_cast<std::uint64_t>(type) << 56) | id;
+}
+
+void MemoryTracker::SetBufferSize(GLuint handle, Category category, size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto result = m_objects.try_emplace(GetKey(ObjectType::Buffer, handle));
+    Object& object = result.first->second;
+    if (result.second)
+    {
+        object.category = category;
+        ++m_totals[static_cast<size_t>(category)].objectCount;
+    }
+    else if (object.category != category)
+    {
+        // Buffers can be allocated again for another use
+        Subtract(object.category, object.bytes);
+        --m_totals[static_cast<size_t>(object.category)].objectCount;
+        object.category = category;
+        Add(category, object.bytes);
+        ++m_totals[static_cast<size_t>(category)].objectCount;
+    }
+    Resize(object, bytes);
+}
+
+void MemoryTracker::SetTextureImage(GLuint handle, unsigned int image, size_t bytes, GLsizei width, GLsizei height)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto result = m_objects.try_emplace(GetKey(ObjectType::Texture, handle));
+    Object& object = result.first->second;
+    if (result.second)
+    {
+        object.category = Category::Texture;
+        ++m_totals[static_cast<size_t>(Category::Texture)].objectCount;
+    }
+
+    if (object.imageBytes.size() <= image)
+    {
+        object.imageBytes.resize(image + 1, 0);
+    }
+    size_t objectBytes = object.bytes - object.imageBytes[image] + bytes;
+    object.imageBytes[image] = bytes;
+
+    // Level 0 gives the size of the texture
+    if (image == 0)
+    {
+        object.width = width;
+        object.height = height;
+    }
+    Resize(object, objectBytes);
+}
+
+void MemoryTracker::SetTextureMipmaps(GLuint handle, unsigned int faceCount)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto itObject = m_objects.find(GetKey(ObjectType::Texture, handle));
+    if (itObject == m_objects.end() || itObject->second.width <= 0 || itObject->second.height <= 0)
+    {
+        return;
+    }
+
+    Object& object = itObject->second;
+    GLsizei width = object.width;
+    GLsizei height = object.height;
+    unsigned int levelCount = 1;
+    while ((width >> levelCount) > 0 || (height >> levelCount) > 0)
+    {
+        ++levelCount;
+    }
+    object.imageBytes.resize(std::max<size_t>(object.imageBytes.size(), levelCount * faceCount), 0);
+
+    // Each level keeps the bytes per pixel of level 0
+    size_t objectBytes = 0;
+    for (unsigned int face = 0; face < faceCount; ++face)
+    {
+        size_t baseBytes = object.imageBytes[face];
+        objectBytes += baseBytes;
+        for (unsigned int level = 1; level < levelCount; ++level)
+        {
+            size_t levelWidth = std::max(width >> level, 1);
+            size_t levelHeight = std::max(height >> level, 1);
+            size_t levelBytes = baseBytes * levelWidth * levelHeight / (static_cast<size_t>(width) * height);
+            object.imageBytes[level * faceCount + face] = levelBytes;
+            objectBytes += levelBytes;
+        }
+    }
+    Resize(object, objectBytes);
+}
+
+void MemoryTracker::SetCategory(ObjectType type, GLuint handle, Category category)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto itObject = m_objects.find(GetKey(type, handle));
+    if (itObject == m_objects.end() || itObject->second.category == category)
+    {
+        return;
+    }
+
+    Object& object = itObject->second;
+    Subtract(object.category, object.bytes);
+    --m_totals[static_cast<size_t>(object.category)].objectCount;
+    object.category = category;
+    Add(category, object.bytes);
+    ++m_totals[static_cast<size_t>(category)].objectCount;
+}
+
+void MemoryTracker::RemoveObject(ObjectType type, GLuint handle)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto itObject = m_objects.find(GetKey(type, handle));
+    if (itObject != m_objects.end())
+    {
+        Subtract(itObject->second.category, itObject->second.bytes);
+        --m_totals[static_cast<size_t>(itObject->second.category)].objectCount;
+        m_objects.erase(itObject);
+    }
+}
+
+void MemoryTracker::SetCpuAllocation(const void* owner, Category category, size_t bytes, const std::string& name)
+{
+    assert(!IsGpuCategory(category));
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto result = m_objects.try_emplace(GetKey(ObjectType::Cpu, reinterpret_cast<std::uintptr_t>(owner)));
+    Object& object = result.first->second;
+    if (result.second)
+    {
+        object.category = category;
+        ++m_totals[static_cast<size_t>(category)].objectCount;
+    }
+    assert(object.category == category);
+    object.name = name;
+    Resize(object, bytes);
+}
+
+void MemoryTracker::RemoveCpuAllocation(const void* owner)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto itObject = m_objects.find(GetKey(ObjectType::Cpu, reinterpret_cast<std::uintptr_t>(owner)));
+    if (itObject != m_objects.end())
+    {
+        Subtract(itObject->second.category, itObject->second.bytes);
+        --m_totals[static_cast<size_t>(itObject->second.category)].objectCount;
+        m_objects.erase(itObject);
+    }
+}
+
+MemoryTracker::Totals MemoryTracker::GetTotals(Category category) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_totals[static_cast<size_t>(category)];
+}
+
+MemoryTracker::Totals MemoryTracker::GetGpuTotals() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Totals totals = m_gpuTotals;
+    for (unsigned int category = 0; category < static_cast<unsigned int>(Category::Count); ++category)
+    {
+        totals.objectCount += IsGpuCategory(static_cast<Category>(category)) ? m_totals[category].objectCount : 0;
+    }
+    return totals;
+}
+
+MemoryTracker::Totals MemoryTracker::GetCpuTotals() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Totals totals = m_cpuTotals;
+    for (unsigned int category = 0; category < static_cast<unsigned int>(Category::Count); ++category)
+    {
+        totals.objectCount += IsGpuCategory(static_cast<Category>(category)) ? 0 : m_totals[category].objectCount;
+    }
+    return totals;
+}
+
+std::vector<MemoryTracker::ObjectInfo> MemoryTracker::GetObjects() const
+{
+    std::vector<ObjectInfo> objects;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        objects.reserve(m_objects.size());
+        for (const auto& [key, object] : m_objects)
+        {
+            ObjectType type = static_cast<ObjectType>(key >> 56);
+            objects.push_back(ObjectInfo{ type, key & ((1ull << 56) - 1), object.category, object.bytes, object.width, object.height, object.name });
+        }
+    }
+    std::sort(objects.begin(), objects.end(), [](const ObjectInfo& a, const ObjectInfo& b) { return a.bytes > b.bytes; });
+    return objects;
+}
+
+void MemoryTracker::ResetPeaks()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (Totals& totals : m_totals)
+    {
+        totals.peakBytes = totals.bytes;
+    }
+    m_gpuTotals.peakBytes = m_gpuTotals.bytes;
+    m_cpuTotals.peakBytes = m_cpuTotals.bytes;
+}
+
+void MemoryTracker::Resize(Object& object, size_t bytes)
+{
+    Subtract(object.category, object.bytes);
+    object.bytes = bytes;
+    Add(object.category, bytes);
+}
+
+void MemoryTracker::Add(Category category, size_t bytes)
+{
+    Totals& totals = m_totals[static_cast<size_t>(category)];
+    totals.bytes += bytes;
+    totals.peakBytes = std::max(totals.peakBytes, totals.bytes);
+
+    Totals& sideTotals = IsGpuCategory(category) ? m_gpuTotals : m_cpuTotals;
+    sideTotals.bytes += bytes;
+    sideTotals.peakBytes = std::max(sideTotals.peakBytes, sideTotals.bytes);
+}
+
+void MemoryTracker::Subtract(Category category, size_t bytes)
+{
+    Totals& totals = m_totals[static_cast<size_t>(category)];
+    assert(totals.bytes >= bytes);
+    totals.bytes -= bytes;
+
+    Totals& sideTotals = IsGpuCategory(category) ? m_gpuTotals : m_cpuTotals;
+    sideTotals.bytes -= bytes;
+}
+
+const char* MemoryTracker::GetCategoryName(Category category)
+{
+    switch (category)
+    {
+    case Category::RenderTarget:
+        return "Render target";
+    case Category::Texture:
+        return "Texture";
+    case Category::VertexBuffer:
+        return "Vertex buffer";
+    case Category::IndexBuffer:
+        return "Index buffer";
+    case Category::UniformBuffer:
+        return "Uniform buffer";
+    case Category::StagingBuffer:
+        return "Staging buffer";
+    case Category::AssetData:
+        return "Asset data";
+    default:
+        return "Unknown";
+    }
+}
+
+const char* MemoryTracker::GetObjectTypeName(ObjectType type)
+{
+    switch (type)
+    {
+    case ObjectType::Buffer:
+        return "Buffer";
+    case ObjectType::Texture:
+        return "Texture";
+    case ObjectType::Cpu:
+        return "CPU";
+    default:
+        return "Unknown";
+    }
+}
+
+void MemoryTracker::DrawGUI(DearImGui& imGui)
+{
+    if (auto window = imGui.UseWindow("Memory"))
+    {
+        const float megabyte = 1024.0f * 1024.0f;
+
+        Totals gpuTotals = GetGpuTotals();
+        Totals cpuTotals = GetCpuTotals();
+        ImGui::Text("GPU: %.2f MB, peak %.2f MB", gpuTotals.bytes / megabyte, gpuTotals.peakBytes / megabyte);
+        ImGui::Text("CPU assets: %.2f MB, peak %.2f MB", cpuTotals.bytes / megabyte, cpuTotals.peakBytes / megabyte);
+        if (ImGui::Button("Reset peaks"))
+        {
+            ResetPeaks();
+        }
+
+        if (ImGui::BeginTable("Categories", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+        {
+            ImGui::TableSetupColumn("Category");
+            ImGui::TableSetupColumn("Objects");
+            ImGui::TableSetupColumn("MB");
+            ImGui::TableSetupColumn("Peak MB");
+            ImGui::TableHeadersRow();
+            for (unsigned int category = 0; category < static_cast<unsigned int>(Category::Count); ++category)
+            {
+                Totals totals = GetTotals(static_cast<Category>(category));
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(GetCategoryName(static_cast<Category>(category)));
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", totals.objectCount);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", totals.bytes / megabyte);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", totals.peakBytes / megabyte);
+            }
+            ImGui::EndTable();
+        }
+
+        if (ImGui::CollapsingHeader("Objects") && ImGui::BeginTable("Objects", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY, ImVec2(0.0f, 300.0f)))
+        {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("Object");
+            ImGui::TableSetupColumn("Category");
+            ImGui::TableSetupColumn("Size");
+            ImGui::TableSetupColumn("KB");
+            ImGui::TableSetupColumn("Name");
+            ImGui::TableHeadersRow();
+
+            std::vector<ObjectInfo> objects = GetObjects();
+            ImGuiListClipper clipper;
+            clipper.Begin(static_cast<int>(objects.size()));
+            while (clipper.Step())
+            {
+                for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
+                {
+                    const ObjectInfo& object = objects[row];
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    if (object.type == ObjectType::Cpu)
+                    {
+                        ImGui::TextUnformatted(GetObjectTypeName(object.type));
+                    }
+                    else
+                    {
+                        ImGui::Text("%s %llu", GetObjectTypeName(object.type), static_cast<unsigned long long>(object.id));
+                    }
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(GetCategoryName(object.category));
+                    ImGui::TableNextColumn();
+                    if (object.width > 0)
+                    {
+                        ImGui::Text("%dx%d", object.width, object.height);
+                    }
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.1f", object.bytes / 1024.0f);
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(object.name.c_str());
+                }
+            }
+            ImGui::EndTable();
+        }
+    }
+}
@@ -0,0 +1,1728 @@
+#include <ituGL/core/RecordingGL.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+
+// Entry points recorded, the ones that the library and the projects call
+#define RECORDED_ENTRY_POINTS(X) \
+    X(glActiveTexture) \
+    X(glAttachShader) \
+    X(glBeginQuery) \
+    X(glBindBuffer) \
+    X(glBindBufferBase) \
+    X(glBindBufferRange) \
+    X(glBindFramebuffer) \
+    X(glBindRenderbuffer) \
+    X(glBindSampler) \
+    X(glBindTexture) \
+    X(glBindTextureUnit) \
+    X(glBindVertexArray) \
+    X(glBindVertexBuffer) \
+    X(glBlendColor) \
+    X(glBlendEquation) \
+    X(glBlendEquationSeparate) \
+    X(glBlendFunc) \
+    X(glBlendFuncSeparate) \
+    X(glBlitFramebuffer) \
+    X(glBufferData) \
+    X(glBufferStorage) \
+    X(glBufferSubData) \
+    X(glCheckFramebufferStatus) \
+    X(glCheckNamedFramebufferStatus) \
+    X(glClear) \
+    X(glClearBufferfi) \
+    X(glClearBufferfv) \
+    X(glClearColor) \
+    X(glClearDepth) \
+    X(glClearDepthf) \
+    X(glClearStencil) \
+    X(glClientWaitSync) \
+    X(glColorMask) \
+    X(glCompileShader) \
+    X(glCopyBufferSubData) \
+    X(glCreateBuffers) \
+    X(glCreateFramebuffers) \
+    X(glCreateProgram) \
+    X(glCreateQueries) \
+    X(glCreateRenderbuffers) \
+    X(glCreateSamplers) \
+    X(glCreateShader) \
+    X(glCreateTextures) \
+    X(glCreateVertexArrays) \
+    X(glCullFace) \
+    X(glDebugMessageCallback) \
+    X(glDebugMessageControl) \
+    X(glDeleteBuffers) \
+    X(glDeleteFramebuffers) \
+    X(glDeleteProgram) \
+    X(glDeleteQueries) \
+    X(glDeleteRenderbuffers) \
+    X(glDeleteSamplers) \
+    X(glDeleteShader) \
+    X(glDeleteSync) \
+    X(glDeleteTextures) \
+    X(glDeleteVertexArrays) \
+    X(glDepthFunc) \
+    X(glDepthMask) \
+    X(glDepthRange) \
+    X(glDisable) \
+    X(glDispatchCompute) \
+    X(glDrawArrays) \
+    X(glDrawArraysInstanced) \
+    X(glDrawBuffer) \
+    X(glDrawBuffers) \
+    X(glDrawElements) \
+    X(glDrawElementsBaseVertex) \
+    X(glDrawElementsInstanced) \
+    X(glDrawElementsInstancedBaseVertex) \
+    X(glEnable) \
+    X(glEnableVertexArrayAttrib) \
+    X(glEnableVertexAttribArray) \
+    X(glEndQuery) \
+    X(glFenceSync) \
+    X(glFinish) \
+    X(glFlush) \
+    X(glFramebufferRenderbuffer) \
+    X(glFramebufferTexture2D) \
+    X(glFrontFace) \
+    X(glGenBuffers) \
+    X(glGenFramebuffers) \
+    X(glGenQueries) \
+    X(glGenRenderbuffers) \
+    X(glGenSamplers) \
+    X(glGenTextures) \
+    X(glGenVertexArrays) \
+    X(glGenerateMipmap) \
+    X(glGenerateTextureMipmap) \
+    X(glGetActiveUniform) \
+    X(glGetActiveUniformBlockName) \
+    X(glGetActiveUniformBlockiv) \
+    X(glGetActiveUniformsiv) \
+    X(glGetAttribLocation) \
+    X(glGetIntegerv) \
+    X(glGetProgramBinary) \
+    X(glGetProgramInfoLog) \
+    X(glGetProgramiv) \
+    X(glGetQueryObjectui64v) \
+    X(glGetQueryObjectuiv) \
+    X(glGetSamplerParameterIuiv) \
+    X(glGetSamplerParameterfv) \
+    X(glGetShaderInfoLog) \
+    X(glGetShaderiv) \
+    X(glGetString) \
+    X(glGetStringi) \
+    X(glGetTexLevelParameteriv) \
+    X(glGetTexParameterIuiv) \
+    X(glGetTexParameterfv) \
+    X(glGetTexParameteriv) \
+    X(glGetTextureLevelParameteriv) \
+    X(glGetTextureParameterIuiv) \
+    X(glGetTextureParameterfv) \
+    X(glGetTextureParameteriv) \
+    X(glGetUniformBlockIndex) \
+    X(glGetUniformLocation) \
+    X(glGetnUniformdv) \
+    X(glGetnUniformfv) \
+    X(glGetnUniformiv) \
+    X(glGetnUniformuiv) \
+    X(glInvalidateFramebuffer) \
+    X(glIsEnabled) \
+    X(glLineWidth) \
+    X(glLinkProgram) \
+    X(glMapBufferRange) \
+    X(glMapNamedBufferRange) \
+    X(glMemoryBarrier) \
+    X(glMultiDrawArraysIndirect) \
+    X(glMultiDrawElementsIndirect) \
+    X(glNamedBufferData) \
+    X(glNamedBufferStorage) \
+    X(glNamedBufferSubData) \
+    X(glNamedFramebufferDrawBuffers) \
+    X(glNamedFramebufferReadBuffer) \
+    X(glNamedFramebufferRenderbuffer) \
+    X(glNamedFramebufferTexture) \
+    X(glNamedRenderbufferStorage) \
+    X(glPixelStorei) \
+    X(glPolygonMode) \
+    X(glPolygonOffset) \
+    X(glProgramBinary) \
+    X(glProgramParameteri) \
+    X(glProgramUniform1dv) \
+    X(glProgramUniform1fv) \
+    X(glProgramUniform1iv) \
+    X(glProgramUniform1uiv) \
+    X(glProgramUniform2dv) \
+    X(glProgramUniform2fv) \
+    X(glProgramUniform2iv) \
+    X(glProgramUniform2uiv) \
+    X(glProgramUniform3dv) \
+    X(glProgramUniform3fv) \
+    X(glProgramUniform3iv) \
+    X(glProgramUniform3uiv) \
+    X(glProgramUniform4dv) \
+    X(glProgramUniform4fv) \
+    X(glProgramUniform4iv) \
+    X(glProgramUniform4uiv) \
+    X(glProgramUniformMatrix2fv) \
+    X(glProgramUniformMatrix2x3fv) \
+    X(glProgramUniformMatrix2x4fv) \
+    X(glProgramUniformMatrix3fv) \
+    X(glProgramUniformMatrix3x2fv) \
+    X(glProgramUniformMatrix3x4fv) \
+    X(glProgramUniformMatrix4fv) \
+    X(glProgramUniformMatrix4x2fv) \
+    X(glProgramUniformMatrix4x3fv) \
+    X(glReadBuffer) \
+    X(glReadPixels) \
+    X(glRenderbufferStorage) \
+    X(glSamplerParameterf) \
+    X(glSamplerParameterfv) \
+    X(glSamplerParameteri) \
+    X(glScissor) \
+    X(glShaderSource) \
+    X(glStencilFunc) \
+    X(glStencilFuncSeparate) \
+    X(glStencilMask) \
+    X(glStencilMaskSeparate) \
+    X(glStencilOp) \
+    X(glStencilOpSeparate) \
+    X(glTexImage2D) \
+    X(glTexParameterIuiv) \
+    X(glTexParameterf) \
+    X(glTexParameterfv) \
+    X(glTexParameteri) \
+    X(glTexStorage2D) \
+    X(glTexSubImage2D) \
+    X(glTextureParameterIuiv) \
+    X(glTextureParameterf) \
+    X(glTextureParameterfv) \
+    X(glTextureParameteri) \
+    X(glTextureStorage2D) \
+    X(glTextureSubImage2D) \
+    X(glTextureSubImage3D) \
+    X(glUniform1dv) \
+    X(glUniform1f) \
+    X(glUniform1fv) \
+    X(glUniform1i) \
+    X(glUniform1iv) \
+    X(glUniform1ui) \
+    X(glUniform1uiv) \
+    X(glUniform2dv) \
+    X(glUniform2f) \
+    X(glUniform2fv) \
+    X(glUniform2iv) \
+    X(glUniform2uiv) \
+    X(glUniform3dv) \
+    X(glUniform3f) \
+    X(glUniform3fv) \
+    X(glUniform3iv) \
+    X(glUniform3uiv) \
+    X(glUniform4dv) \
+    X(glUniform4f) \
+    X(glUniform4fv) \
+    X(glUniform4iv) \
+    X(glUniform4uiv) \
+    X(glUniformBlockBinding) \
+    X(glUniformMatrix2fv) \
+    X(glUniformMatrix2x3fv) \
+    X(glUniformMatrix2x4fv) \
+    X(glUniformMatrix3fv) \
+    X(glUniformMatrix3x2fv) \
+    X(glUniformMatrix3x4fv) \
+    X(glUniformMatrix4fv) \
+    X(glUniformMatrix4x2fv) \
+    X(glUniformMatrix4x3fv) \
+    X(glUnmapBuffer) \
+    X(glUnmapNamedBuffer) \
+    X(glUseProgram) \
+    X(glVertexArrayAttribBinding) \
+    X(glVertexArrayAttribFormat) \
+    X(glVertexArrayElementBuffer) \
+    X(glVertexArrayVertexBuffer) \
+    X(glVertexAttribBinding) \
+    X(glVertexAttribFormat) \
+    X(glVertexAttribPointer) \
+    X(glViewport)
+
+#define ENTRY_POINT_ENUM(name) EntryPoint_##name,
+enum EntryPoint : unsigned int
+{
+    RECORDED_ENTRY_POINTS(ENTRY_POINT_ENUM)
+    EntryPointCount
+};
+#undef ENTRY_POINT_ENUM
+
+#define ENTRY_POINT_NAME(name) #name,
+static const char* const s_entryPointNames[] = { RECORDED_ENTRY_POINTS(ENTRY_POINT_NAME) };
+#undef ENTRY_POINT_NAME
+
+// Uniform or vertex input declared in the GLSL source of a program
+struct ShaderVariable
+{
+    std::string name;
+    GLenum type;
+    GLint size;
+    GLint location;
+};
+
+struct ProgramInfo
+{
+    std::vector<GLuint> shaders;
+    std::vector<ShaderVariable> uniforms;
+    std::vector<ShaderVariable> attributes;
+    bool linked = false;
+};
+
+struct TextureLevel
+{
+    GLint width;
+    GLint height;
+    GLint depth;
+    GLint internalFormat;
+};
+
+// Everything the entry points keep. Objects are never reused, so a single handle counter is enough
+struct RecordingState
+{
+    bool loaded = false;
+    bool recording = false;
+
+    std::vector<uint64_t> commands;
+    size_t lastCommand = 0;
+    unsigned int commandCount = 0;
+
+    GLuint lastHandle = 0;
+
+    // Context state read back by the library
+    std::unordered_set<GLenum> enabledCapabilities;
+    GLuint program = 0;
+    GLuint activeTextureUnit = 0;
+    std::unordered_map<uint64_t, GLuint> boundTextures;
+    std::unordered_map<GLenum, GLuint> boundBuffers;
+    GLint unpackAlignment = 4;
+    GLint packAlignment = 4;
+    GLint viewport[4] = {};
+
+    // Objects
+    std::unordered_map<GLuint, GLenum> shaderTypes;
+    std::unordered_map<GLuint, std::string> shaderSources;
+    std::unordered_map<GLuint, ProgramInfo> programs;
+    std::unordered_map<GLuint, GLsizeiptr> bufferSizes;
+    std::unordered_map<GLuint, std::vector<std::byte>> mappedBuffers;
+    std::unordered_map<GLuint, GLenum> textureTargets;
+    std::unordered_map<uint64_t, TextureLevel> textureLevels;
+    // Texture and sampler parameters, by object and parameter name
+    std::unordered_map<uint64_t, std::array<double, 4>> parameters;
+    // Last uniform values, as set, by program and location
+    std::unordered_map<uint64_t, std::vector<std::byte>> uniformValues;
+};
+
+static RecordingState s_state;
+
+static inline uint64_t MakeKey(uint64_t high, uint64_t low)
+{
+    return (high << 32) | (low & 0xFFFFFFFF);
+}
+
+//
+// Command buffer
+//
+
+template<typename T>
+static inline uint64_t Encode(T value)
+{
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        return std::bit_cast<uint64_t>(static_cast<double>(value));
+    }
+    else if constexpr (std::is_same_v<T, GLsync>)
+    {
+        // Syncs are handles, like the other objects
+        return reinterpret_cast<uintptr_t>(value);
+    }
+    else if constexpr (std::is_same_v<T, const void*> || std::is_same_v<T, void*>)
+    {
+        uintptr_t address = reinterpret_cast<uintptr_t>(value);
+        return address <= 0xFFFFFFFFu ? address : ~uint64_t(0);
+    }
+    else if constexpr (std::is_pointer_v<T>)
+    {
+        return value != nullptr;
+    }
+    else
+    {
+        return static_cast<uint64_t>(static_cast<int64_t>(value));
+    }
+}
+
+template<typename... Arguments>
+static void Record(unsigned int entryPoint, Arguments... arguments)
+{
+    if (!s_state.recording)
+    {
+        return;
+    }
+    std::vector<uint64_t>& commands = s_state.commands;
+    s_state.lastCommand = commands.size();
+    commands.push_back(entryPoint | (static_cast<uint64_t>(sizeof...(Arguments)) << 32));
+    (commands.push_back(Encode(arguments)), ...);
+    ++s_state.commandCount;
+}
+
+// Append the bytes to the last command, padded to whole words
+static void RecordPayload(const void* data, size_t size)
+{
+    if (!s_state.recording || !data || size == 0)
+    {
+        return;
+    }
+    std::vector<uint64_t>& commands = s_state.commands;
+    size_t wordCount = (size + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    size_t offset = commands.size();
+    commands.resize(offset + wordCount, 0);
+    std::memcpy(commands.data() + offset, data, size);
+    commands[s_state.lastCommand] += static_cast<uint64_t>(wordCount) << 32;
+}
+
+// FNV-1a
+static uint64_t HashBytes(const void* data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// Append the hash of the data to the last command, instead of the data. Zero for no data
+static void RecordHash(const void* data, size_t size)
+{
+    if (!s_state.recording)
+    {
+        return;
+    }
+    uint64_t hash = data ? HashBytes(data, size) : 0;
+    RecordPayload(&hash, sizeof(hash));
+}
+
+// Record the call, and return zero. Used for the entry points without any state to keep
+template<unsigned int EntryPoint, typename Function>
+struct Recorder;
+
+template<unsigned int EntryPoint, typename Result, typename... Arguments>
+struct Recorder<EntryPoint, Result (APIENTRYP)(Arguments...)>
+{
+    static Result APIENTRY Call(Arguments... arguments)
+    {
+        Record(EntryPoint, arguments...);
+        return Result();
+    }
+};
+
+#define ENTRY_POINT_RECORDER(name) reinterpret_cast<void*>(&Recorder<EntryPoint_##name, decltype(glad_##name)>::Call),
+static void* const s_recorders[] = { RECORDED_ENTRY_POINTS(ENTRY_POINT_RECORDER) };
+#undef ENTRY_POINT_RECORDER
+
+//
+// GLSL declarations
+//
+
+struct GLSLType
+{
+    const char* name;
+    GLenum type;
+};
+
+static const GLSLType s_glslTypes[] = {
+    { "float", GL_FLOAT }, { "vec2", GL_FLOAT_VEC2 }, { "vec3", GL_FLOAT_VEC3 }, { "vec4", GL_FLOAT_VEC4 },
+    { "double", GL_DOUBLE }, { "dvec2", GL_DOUBLE_VEC2 }, { "dvec3", GL_DOUBLE_VEC3 }, { "dvec4", GL_DOUBLE_VEC4 },
+    { "int", GL_INT }, { "ivec2", GL_INT_VEC2 }, { "ivec3", GL_INT_VEC3 }, { "ivec4", GL_INT_VEC4 },
+    { "uint", GL_UNSIGNED_INT }, { "uvec2", GL_UNSIGNED_INT_VEC2 }, { "uvec3", GL_UNSIGNED_INT_VEC3 }, { "uvec4", GL_UNSIGNED_INT_VEC4 },
+    { "bool", GL_BOOL }, { "bvec2", GL_BOOL_VEC2 }, { "bvec3", GL_BOOL_VEC3 }, { "bvec4", GL_BOOL_VEC4 },
+    { "mat2", GL_FLOAT_MAT2 }, { "mat3", GL_FLOAT_MAT3 }, { "mat4", GL_FLOAT_MAT4 },
+    { "mat2x3", GL_FLOAT_MAT2x3 }, { "mat2x4", GL_FLOAT_MAT2x4 }, { "mat3x2", GL_FLOAT_MAT3x2 },
+    { "mat3x4", GL_FLOAT_MAT3x4 }, { "mat4x2", GL_FLOAT_MAT4x2 }, { "mat4x3", GL_FLOAT_MAT4x3 },
+    { "dmat2", GL_DOUBLE_MAT2 }, { "dmat3", GL_DOUBLE_MAT3 }, { "dmat4", GL_DOUBLE_MAT4 },
+    { "sampler1D", GL_SAMPLER_1D }, { "sampler2D", GL_SAMPLER_2D }, { "sampler3D", GL_SAMPLER_3D }, { "samplerCube", GL_SAMPLER_CUBE },
+    { "sampler1DShadow", GL_SAMPLER_1D_SHADOW }, { "sampler2DShadow", GL_SAMPLER_2D_SHADOW }, { "samplerCubeShadow", GL_SAMPLER_CUBE_SHADOW },
+    { "sampler1DArray", GL_SAMPLER_1D_ARRAY }, { "sampler2DArray", GL_SAMPLER_2D_ARRAY }, { "sampler2DArrayShadow", GL_SAMPLER_2D_ARRAY_SHADOW },
+    { "samplerCubeArray", GL_SAMPLER_CUBE_MAP_ARRAY }, { "samplerCubeArrayShadow", GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW },
+    { "sampler2DMS", GL_SAMPLER_2D_MULTISAMPLE }, { "samplerBuffer", GL_SAMPLER_BUFFER }, { "sampler2DRect", GL_SAMPLER_2D_RECT },
+    { "isampler2D", GL_INT_SAMPLER_2D }, { "isampler3D", GL_INT_SAMPLER_3D }, { "isamplerCube", GL_INT_SAMPLER_CUBE }, { "isampler2DArray", GL_INT_SAMPLER_2D_ARRAY },
+    { "usampler2D", GL_UNSIGNED_INT_SAMPLER_2D }, { "usampler3D", GL_UNSIGNED_INT_SAMPLER_3D }, { "usamplerCube", GL_UNSIGNED_INT_SAMPLER_CUBE }, { "usampler2DArray", GL_UNSIGNED_INT_SAMPLER_2D_ARRAY },
+    { "image2D", GL_IMAGE_2D }, { "image3D", GL_IMAGE_3D }, { "imageCube", GL_IMAGE_CUBE }, { "image2DArray", GL_IMAGE_2D_ARRAY },
+    { "iimage2D", GL_INT_IMAGE_2D }, { "uimage2D", GL_UNSIGNED_INT_IMAGE_2D },
+};
+
+// Identifiers, numbers and single characters. Comments and preprocessor lines are skipped
+static std::vector<std::string_view> Tokenize(std::string_view source)
+{
+    std::vector<std::string_view> tokens;
+    bool lineStart = true;
+    size_t i = 0;
+    while (i < source.size())
+    {
+        char c = source[i];
+        char next = i + 1 < source.size() ? source[i + 1] : '\0';
+        if (c == '\n')
+        {
+            lineStart = true;
+            ++i;
+        }
+        else if (std::isspace(static_cast<unsigned char>(c)))
+        {
+            ++i;
+        }
+        else if (c == '/' && next == '/')
+        {
+            i = std::min(source.find('\n', i), source.size());
+        }
+        else if (c == '/' && next == '*')
+        {
+            size_t end = source.find("*/", i + 2);
+            i = end == std::string_view::npos ? source.size() : end + 2;
+        }
+        else if (c == '#' && lineStart)
+        {
+            // Directives can continue on the next line
+            while (i < source.size() && (source[i] != '\n' || source[i - 1] == '\\'))
+            {
+                ++i;
+            }
+        }
+        else
+        {
+            lineStart = false;
+            size_t start = i;
+            if (std::isalnum(static_cast<unsigned char>(c)) || c == '_')
+            {
+                while (i < source.size() && (std::isalnum(static_cast<unsigned char>(source[i])) || source[i] == '_' || source[i] == '.'))
+                {
+                    ++i;
+                }
+            }
+            else
+            {
+                ++i;
+            }
+            tokens.push_back(source.substr(start, i - start));
+        }
+    }
+    return tokens;
+}
+
+static void AddVariable(std::vector<ShaderVariable>& variables, std::string_view name, GLenum type, GLint size, GLint location)
+{
+    if (std::none_of(variables.begin(), variables.end(), [&](const ShaderVariable& variable) { return variable.name == name; }))
+    {
+        if (location < 0)
+        {
+            location = 0;
+            for (const ShaderVariable& variable : variables)
+            {
+                location = std::max(location, variable.location + variable.size);
+            }
+        }
+        variables.push_back(ShaderVariable{ std::string(name), type, size, location });
+    }
+}
+
+// Add the uniforms, and the vertex inputs, declared at global scope. Blocks and structs are skipped
+// Declarations in all the preprocessor branches are included
+static void ParseDeclarations(std::string_view source, bool vertexShader, ProgramInfo& program)
+{
+    std::vector<std::string_view> tokens = Tokenize(source);
+    int braceDepth = 0;
+    int parenthesisDepth = 0;
+    GLint layoutLocation = -1;
+    for (size_t i = 0; i < tokens.size(); ++i)
+    {
+        std::string_view token = tokens[i];
+        if (token == "{")
+        {
+            ++braceDepth;
+        }
+        else if (token == "}")
+        {
+            --braceDepth;
+        }
+        else if (token == "(")
+        {
+            ++parenthesisDepth;
+        }
+        else if (token == ")")
+        {
+            --parenthesisDepth;
+        }
+        else if (braceDepth > 0 || parenthesisDepth > 0)
+        {
+            continue;
+        }
+        else if (token == ";")
+        {
+            layoutLocation = -1;
+        }
+        else if (token == "layout")
+        {
+            // layout(location = N, ...)
+            for (++i; i < tokens.size() && tokens[i] != ")"; ++i)
+            {
+                if (tokens[i] == "location" && i + 2 < tokens.size() && tokens[i + 1] == "=")
+                {
+                    layoutLocation = std::atoi(std::string(tokens[i + 2]).c_str());
+                }
+            }
+        }
+        else if (token == "uniform" || (token == "in" && vertexShader))
+        {
+            std::vector<ShaderVariable>& variables = token == "uniform" ? program.uniforms : program.attributes;
+            size_t k = i + 1;
+            while (k < tokens.size() && (tokens[k] == "lowp" || tokens[k] == "mediump" || tokens[k] == "highp" || tokens[k] == "flat"))
+            {
+                ++k;
+            }
+            auto itType = k < tokens.size() ? std::find_if(std::begin(s_glslTypes), std::end(s_glslTypes), [&](const GLSLType& type) { return tokens[k] == type.name; }) : std::end(s_glslTypes);
+            if (itType == std::end(s_glslTypes))
+            {
+                continue;
+            }
+
+            // One or more declarators, each with an optional array size
+            for (++k; k < tokens.size() && tokens[k] != ";"; ++k)
+            {
+                std::string_view name = tokens[k];
+                GLint size = 1;
+                if (k + 3 < tokens.size() && tokens[k + 1] == "[" && tokens[k + 3] == "]")
+                {
+                    size = std::max(std::atoi(std::string(tokens[k + 2]).c_str()), 1);
+                }
+                AddVariable(variables, name, itType->type, size, layoutLocation);
+                layoutLocation = -1;
+                while (k + 1 < tokens.size() && tokens[k + 1] != "," && tokens[k + 1] != ";")
+                {
+                    ++k;
+                }
+                if (k + 1 < tokens.size() && tokens[k + 1] == ",")
+                {
+                    ++k;
+                }
+            }
+            i = k;
+            layoutLocation = -1;
+        }
+    }
+}
+
+// Find a variable by name, with an optional array index. Returns -1 if not found
+static GLint FindLocation(const std::vector<ShaderVariable>& variables, std::string_view name)
+{
+    GLint index = 0;
+    size_t bracket = name.find('[');
+    if (bracket != std::string_view::npos)
+    {
+        index = std::atoi(std::string(name.substr(bracket + 1)).c_str());
+        name = name.substr(0, bracket);
+    }
+    for (const ShaderVariable& variable : variables)
+    {
+        if (variable.name == name && index < variable.size)
+        {
+            return variable.location + index;
+        }
+    }
+    return -1;
+}
+
+//
+// Entry points with state
+//
+
+static const GLubyte* APIENTRY StubGetString(GLenum name)
+{
+    Record(EntryPoint_glGetString, name);
+    const char* string = name == GL_VERSION ? "4.6.0 itugl recording" : "itugl recording";
+    return reinterpret_cast<const GLubyte*>(string);
+}
+
+static const GLubyte* APIENTRY StubGetStringi(GLenum name, GLuint index)
+{
+    Record(EntryPoint_glGetStringi, name, index);
+    // glad needs one extension. It is not one that the library checks
+    return reinterpret_cast<const GLubyte*>("GL_ITUGL_recording");
+}
+
+static void APIENTRY StubGetIntegerv(GLenum pname, GLint* data)
+{
+    Record(EntryPoint_glGetIntegerv, pname, data);
+    switch (pname)
+    {
+    case GL_NUM_EXTENSIONS:
+        *data = 1;
+        break;
+    case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT:
+        *data = 256;
+        break;
+    case GL_MAX_TEXTURE_SIZE:
+        *data = 16384;
+        break;
+    case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:
+        *data = 32;
+        break;
+    case GL_MAX_DRAW_BUFFERS:
+    case GL_MAX_COLOR_ATTACHMENTS:
+        *data = 8;
+        break;
+    case GL_UNPACK_ALIGNMENT:
+        *data = s_state.unpackAlignment;
+        break;
+    case GL_PACK_ALIGNMENT:
+        *data = s_state.packAlignment;
+        break;
+    case GL_ACTIVE_TEXTURE:
+        *data = GL_TEXTURE0 + s_state.activeTextureUnit;
+        break;
+    case GL_CURRENT_PROGRAM:
+        *data = s_state.program;
+        break;
+    case GL_VIEWPORT:
+        std::copy(std::begin(s_state.viewport), std::end(s_state.viewport), data);
+        break;
+    default:
+        // Including GL_NUM_PROGRAM_BINARY_FORMATS, so program binaries are not cached
+        *data = 0;
+        break;
+    }
+}
+
+static GLboolean APIENTRY StubIsEnabled(GLenum capability)
+{
+    Record(EntryPoint_glIsEnabled, capability);
+    return s_state.enabledCapabilities.contains(capability) ? GL_TRUE : GL_FALSE;
+}
+
+static void APIENTRY StubEnable(GLenum capability)
+{
+    Record(EntryPoint_glEnable, capability);
+    s_state.enabledCapabilities.insert(capability);
+}
+
+static void APIENTRY StubDisable(GLenum capability)
+{
+    Record(EntryPoint_glDisable, capability);
+    s_state.enabledCapabilities.erase(capability);
+}
+
+static void APIENTRY StubViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    Record(EntryPoint_glViewport, x, y, width, height);
+    s_state.viewport[0] = x;
+    s_state.viewport[1] = y;
+    s_state.viewport[2] = width;
+    s_state.viewport[3] = height;
+}
+
+static void APIENTRY StubPixelStorei(GLenum pname, GLint param)
+{
+    Record(EntryPoint_glPixelStorei, pname, param);
+    if (pname == GL_UNPACK_ALIGNMENT)
+    {
+        s_state.unpackAlignment = param;
+    }
+    else if (pname == GL_PACK_ALIGNMENT)
+    {
+        s_state.packAlignment = param;
+    }
+}
+
+// Objects
+
+static void CreateHandles(GLsizei n, GLuint* handles)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        handles[i] = ++s_state.lastHandle;
+    }
+}
+
+// Handles are consecutive, so only the first one is recorded
+template<unsigned int EntryPoint>
+static void APIENTRY StubGen(GLsizei n, GLuint* handles)
+{
+    CreateHandles(n, handles);
+    Record(EntryPoint, n, n > 0 ? handles[0] : 0);
+}
+
+static void APIENTRY StubCreateTextures(GLenum target, GLsizei n, GLuint* textures)
+{
+    CreateHandles(n, textures);
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        s_state.textureTargets[textures[i]] = target;
+    }
+    Record(EntryPoint_glCreateTextures, target, n, n > 0 ? textures[0] : 0);
+}
+
+static void APIENTRY StubCreateQueries(GLenum target, GLsizei n, GLuint* ids)
+{
+    CreateHandles(n, ids);
+    Record(EntryPoint_glCreateQueries, target, n, n > 0 ? ids[0] : 0);
+}
+
+static GLsync APIENTRY StubFenceSync(GLenum condition, GLbitfield flags)
+{
+    GLsync sync = reinterpret_cast<GLsync>(static_cast<uintptr_t>(++s_state.lastHandle));
+    Record(EntryPoint_glFenceSync, condition, flags, sync);
+    return sync;
+}
+
+static GLenum APIENTRY StubClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+    Record(EntryPoint_glClientWaitSync, sync, flags, timeout);
+    return GL_ALREADY_SIGNALED;
+}
+
+// Shaders and programs
+
+static GLuint APIENTRY StubCreateShader(GLenum type)
+{
+    GLuint shader = ++s_state.lastHandle;
+    s_state.shaderTypes[shader] = type;
+    Record(EntryPoint_glCreateShader, type, shader);
+    return shader;
+}
+
+static void APIENTRY StubShaderSource(GLuint shader, GLsizei count, const GLchar* const* strings, const GLint* lengths)
+{
+    std::string& source = s_state.shaderSources[shader];
+    source.clear();
+    for (GLsizei i = 0; i < count; ++i)
+    {
+        source.append(strings[i], lengths && lengths[i] >= 0 ? static_cast<size_t>(lengths[i]) : std::strlen(strings[i]));
+    }
+    Record(EntryPoint_glShaderSource, shader, count, strings, lengths);
+    RecordHash(source.data(), source.size());
+}
+
+static void APIENTRY StubGetShaderiv(GLuint shader, GLenum pname, GLint* params)
+{
+    Record(EntryPoint_glGetShaderiv, shader, pname, params);
+    switch (pname)
+    {
+    case GL_SHADER_TYPE:
+        *params = s_state.shaderTypes[shader];
+        break;
+    case GL_COMPILE_STATUS:
+        *params = GL_TRUE;
+        break;
+    default:
+        *params = 0;
+        break;
+    }
+}
+
+static void APIENTRY StubGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    Record(EntryPoint_glGetShaderInfoLog, shader, bufSize, length, infoLog);
+    if (bufSize > 0)
+    {
+        infoLog[0] = '\0';
+    }
+    if (length)
+    {
+        *length = 0;
+    }
+}
+
+static GLuint APIENTRY StubCreateProgram()
+{
+    GLuint program = ++s_state.lastHandle;
+    s_state.programs[program];
+    Record(EntryPoint_glCreateProgram, program);
+    return program;
+}
+
+static void APIENTRY StubAttachShader(GLuint program, GLuint shader)
+{
+    Record(EntryPoint_glAttachShader, program, shader);
+    s_state.programs[program].shaders.push_back(shader);
+}
+
+static void APIENTRY StubLinkProgram(GLuint program)
+{
+    Record(EntryPoint_glLinkProgram, program);
+    ProgramInfo& programInfo = s_state.programs[program];
+    programInfo.uniforms.clear();
+    programInfo.attributes.clear();
+    programInfo.linked = true;
+    for (GLuint shader : programInfo.shaders)
+    {
+        ParseDeclarations(s_state.shaderSources[shader], s_state.shaderTypes[shader] == GL_VERTEX_SHADER, programInfo);
+    }
+}
+
+static void APIENTRY StubGetProgramiv(GLuint program, GLenum pname, GLint* params)
+{
+    Record(EntryPoint_glGetProgramiv, program, pname, params);
+    const ProgramInfo& programInfo = s_state.programs[program];
+    switch (pname)
+    {
+    case GL_LINK_STATUS:
+        *params = programInfo.linked ? GL_TRUE : GL_FALSE;
+        break;
+    case GL_VALIDATE_STATUS:
+        *params = GL_TRUE;
+        break;
+    case GL_ACTIVE_UNIFORMS:
+        *params = static_cast<GLint>(programInfo.uniforms.size());
+        break;
+    case GL_ACTIVE_ATTRIBUTES:
+        *params = static_cast<GLint>(programInfo.attributes.size());
+        break;
+    case GL_ATTACHED_SHADERS:
+        *params = static_cast<GLint>(programInfo.shaders.size());
+        break;
+    case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+        *params = 0;
+        for (const ShaderVariable& uniform : programInfo.uniforms)
+        {
+            // With "[0]" for arrays, and the terminator
+            *params = std::max(*params, static_cast<GLint>(uniform.name.size()) + 4);
+        }
+        break;
+    default:
+        // Including GL_PROGRAM_BINARY_LENGTH and GL_ACTIVE_UNIFORM_BLOCKS
+        *params = 0;
+        break;
+    }
+}
+
+static void APIENTRY StubGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    Record(EntryPoint_glGetProgramInfoLog, program, bufSize, length, infoLog);
+    if (bufSize > 0)
+    {
+        infoLog[0] = '\0';
+    }
+    if (length)
+    {
+        *length = 0;
+    }
+}
+
+static void APIENTRY StubGetProgramBinary(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary)
+{
+    Record(EntryPoint_glGetProgramBinary, program, bufSize, length, binaryFormat, binary);
+    if (length)
+    {
+        *length = 0;
+    }
+}
+
+static void APIENTRY StubGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    Record(EntryPoint_glGetActiveUniform, program, index, bufSize, length, size, type, name);
+    const ShaderVariable& uniform = s_state.programs[program].uniforms[index];
+    *size = uniform.size;
+    *type = uniform.type;
+    // Arrays are reported by their first element
+    std::string uniformName = uniform.size > 1 ? uniform.name + "[0]" : uniform.name;
+    GLsizei nameLength = std::max(std::min(static_cast<GLsizei>(uniformName.size()), bufSize - 1), 0);
+    if (bufSize > 0)
+    {
+        std::memcpy(name, uniformName.c_str(), nameLength);
+        name[nameLength] = '\0';
+    }
+    if (length)
+    {
+        *length = nameLength;
+    }
+}
+
+static void APIENTRY StubGetActiveUniformsiv(GLuint program, GLsizei uniformCount, const GLuint* uniformIndices, GLenum pname, GLint* params)
+{
+    Record(EntryPoint_glGetActiveUniformsiv, program, uniformCount, uniformIndices, pname, params);
+    const ProgramInfo& programInfo = s_state.programs[program];
+    for (GLsizei i = 0; i < uniformCount; ++i)
+    {
+        const ShaderVariable& uniform = programInfo.uniforms[uniformIndices[i]];
+        switch (pname)
+        {
+        case GL_UNIFORM_TYPE:
+            params[i] = uniform.type;
+            break;
+        case GL_UNIFORM_SIZE:
+            params[i] = uniform.size;
+            break;
+        case GL_UNIFORM_NAME_LENGTH:
+            params[i] = static_cast<GLint>(uniform.name.size()) + 1;
+            break;
+        default:
+            // The uniforms are not in a block
+            params[i] = -1;
+            break;
+        }
+    }
+}
+
+static GLint APIENTRY StubGetUniformLocation(GLuint program, const GLchar* name)
+{
+    Record(EntryPoint_glGetUniformLocation, program, name);
+    RecordHash(name, std::strlen(name));
+    return FindLocation(s_state.programs[program].uniforms, name);
+}
+
+static GLint APIENTRY StubGetAttribLocation(GLuint program, const GLchar* name)
+{
+    Record(EntryPoint_glGetAttribLocation, program, name);
+    RecordHash(name, std::strlen(name));
+    return FindLocation(s_state.programs[program].attributes, name);
+}
+
+static GLuint APIENTRY StubGetUniformBlockIndex(GLuint program, const GLchar* uniformBlockName)
+{
+    Record(EntryPoint_glGetUniformBlockIndex, program, uniformBlockName);
+    return GL_INVALID_INDEX;
+}
+
+static void APIENTRY StubUseProgram(GLuint program)
+{
+    Record(EntryPoint_glUseProgram, program);
+    s_state.program = program;
+}
+
+// Uniforms keep the values set, as bytes, so they can be read back
+
+static void SetUniformValue(GLuint program, GLint location, const void* value, size_t size)
+{
+    if (location >= 0)
+    {
+        const std::byte* bytes = static_cast<const std::byte*>(value);
+        s_state.uniformValues[MakeKey(program, location)].assign(bytes, bytes + size);
+    }
+}
+
+template<unsigned int EntryPoint, typename T, unsigned int Components>
+static void APIENTRY StubUniform(GLint location, GLsizei count, const T* value)
+{
+    size_t size = count * Components * sizeof(T);
+    Record(EntryPoint, location, count, value);
+    RecordPayload(value, size);
+    SetUniformValue(s_state.program, location, value, size);
+}
+
+template<unsigned int EntryPoint, typename T, unsigned int Components>
+static void APIENTRY StubUniformMatrix(GLint location, GLsizei count, GLboolean transpose, const T* value)
+{
+    size_t size = count * Components * sizeof(T);
+    Record(EntryPoint, location, count, transpose, value);
+    RecordPayload(value, size);
+    SetUniformValue(s_state.program, location, value, size);
+}
+
+template<unsigned int EntryPoint, typename T, unsigned int Components>
+static void APIENTRY StubProgramUniform(GLuint program, GLint location, GLsizei count, const T* value)
+{
+    size_t size = count * Components * sizeof(T);
+    Record(EntryPoint, program, location, count, value);
+    RecordPayload(value, size);
+    SetUniformValue(program, location, value, size);
+}
+
+template<unsigned int EntryPoint, typename T, unsigned int Components>
+static void APIENTRY StubProgramUniformMatrix(GLuint program, GLint location, GLsizei count, GLboolean transpose, const T* value)
+{
+    size_t size = count * Components * sizeof(T);
+    Record(EntryPoint, program, location, count, transpose, value);
+    RecordPayload(value, size);
+    SetUniformValue(program, location, value, size);
+}
+
+template<unsigned int EntryPoint, typename T>
+static void APIENTRY StubGetnUniform(GLuint program, GLint location, GLsizei bufSize, T* params)
+{
+    Record(EntryPoint, program, location, bufSize, params);
+    auto itValue = s_state.uniformValues.find(MakeKey(program, location));
+    size_t size = static_cast<size_t>(std::max(bufSize, 0));
+    if (itValue != s_state.uniformValues.end())
+    {
+        size_t copySize = std::min(size, itValue->second.size());
+        std::memcpy(params, itValue->second.data(), copySize);
+        std::memset(reinterpret_cast<std::byte*>(params) + copySize, 0, size - copySize);
+    }
+    else
+    {
+        std::memset(params, 0, size);
+    }
+}
+
+// Buffers
+
+static GLuint GetBoundBuffer(GLenum target)
+{
+    auto itBuffer = s_state.boundBuffers.find(target);
+    return itBuffer != s_state.boundBuffers.end() ? itBuffer->second : 0;
+}
+
+static void APIENTRY StubBindBuffer(GLenum target, GLuint buffer)
+{
+    Record(EntryPoint_glBindBuffer, target, buffer);
+    s_state.boundBuffers[target] = buffer;
+}
+
+static void APIENTRY StubBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+    Record(EntryPoint_glBufferData, target, size, usage);
+    RecordHash(data, size);
+    s_state.bufferSizes[GetBoundBuffer(target)] = size;
+}
+
+static void APIENTRY StubBufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags)
+{
+    Record(EntryPoint_glBufferStorage, target, size, flags);
+    RecordHash(data, size);
+    s_state.bufferSizes[GetBoundBuffer(target)] = size;
+}
+
+static void APIENTRY StubBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+    Record(EntryPoint_glBufferSubData, target, offset, size);
+    RecordHash(data, size);
+}
+
+static void APIENTRY StubNamedBufferData(GLuint buffer, GLsizeiptr size, const void* data, GLenum usage)
+{
+    Record(EntryPoint_glNamedBufferData, buffer, size, usage);
+    RecordHash(data, size);
+    s_state.bufferSizes[buffer] = size;
+}
+
+static void APIENTRY StubNamedBufferStorage(GLuint buffer, GLsizeiptr size, const void* data, GLbitfield flags)
+{
+    Record(EntryPoint_glNamedBufferStorage, buffer, size, flags);
+    RecordHash(data, size);
+    s_state.bufferSizes[buffer] = size;
+}
+
+static void APIENTRY StubNamedBufferSubData(GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data)
+{
+    Record(EntryPoint_glNamedBufferSubData, buffer, offset, size);
+    RecordHash(data, size);
+}
+
+// Mapped ranges point to memory kept for each buffer, so writes through them are valid
+static void* MapBuffer(GLuint buffer, GLintptr offset, GLsizeiptr length)
+{
+    std::vector<std::byte>& memory = s_state.mappedBuffers[buffer];
+    size_t size = std::max(static_cast<size_t>(s_state.bufferSizes[buffer]), static_cast<size_t>(offset + length));
+    if (memory.size() < size)
+    {
+        memory.resize(size);
+    }
+    return memory.data() + offset;
+}
+
+static void* APIENTRY StubMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    Record(EntryPoint_glMapBufferRange, target, offset, length, access);
+    return MapBuffer(GetBoundBuffer(target), offset, length);
+}
+
+static void* APIENTRY StubMapNamedBufferRange(GLuint buffer, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    Record(EntryPoint_glMapNamedBufferRange, buffer, offset, length, access);
+    return MapBuffer(buffer, offset, length);
+}
+
+static GLboolean APIENTRY StubUnmapBuffer(GLenum target)
+{
+    Record(EntryPoint_glUnmapBuffer, target);
+    return GL_TRUE;
+}
+
+static GLboolean APIENTRY StubUnmapNamedBuffer(GLuint buffer)
+{
+    Record(EntryPoint_glUnmapNamedBuffer, buffer);
+    return GL_TRUE;
+}
+
+// Textures
+
+static GLuint GetBoundTexture(GLenum target)
+{
+    // The faces of a cubemap are set through the cubemap binding
+    if (target >= GL_TEXTURE_CUBE_MAP_POSITIVE_X && target <= GL_TEXTURE_CUBE_MAP_NEGATIVE_Z)
+    {
+        target = GL_TEXTURE_CUBE_MAP;
+    }
+    auto itTexture = s_state.boundTextures.find(MakeKey(s_state.activeTextureUnit, target));
+    return itTexture != s_state.boundTextures.end() ? itTexture->second : 0;
+}
+
+static void APIENTRY StubActiveTexture(GLenum texture)
+{
+    Record(EntryPoint_glActiveTexture, texture);
+    s_state.activeTextureUnit = texture - GL_TEXTURE0;
+}
+
+static void APIENTRY StubBindTexture(GLenum target, GLuint texture)
+{
+    Record(EntryPoint_glBindTexture, target, texture);
+    s_state.boundTextures[MakeKey(s_state.activeTextureUnit, target)] = texture;
+    s_state.textureTargets.try_emplace(texture, target);
+}
+
+static void APIENTRY StubBindTextureUnit(GLuint unit, GLuint texture)
+{
+    Record(EntryPoint_glBindTextureUnit, unit, texture);
+    auto itTarget = s_state.textureTargets.find(texture);
+    if (itTarget != s_state.textureTargets.end())
+    {
+        s_state.boundTextures[MakeKey(unit, itTarget->second)] = texture;
+    }
+}
+
+// The pixels are not recorded, their size depends on the format and the unpack state
+static void APIENTRY StubTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels)
+{
+    Record(EntryPoint_glTexImage2D, target, level, internalformat, width, height, border, format, type, pixels);
+    s_state.textureLevels[MakeKey(GetBoundTexture(target), level)] = TextureLevel{ width, height, 1, internalformat };
+}
+
+static void SetTextureStorage(GLuint texture, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height)
+{
+    for (GLsizei level = 0; level < levels; ++level)
+    {
+        s_state.textureLevels[MakeKey(texture, level)] = TextureLevel{ std::max(width >> level, 1), std::max(height >> level, 1), 1, static_cast<GLint>(internalformat) };
+    }
+}
+
+static void APIENTRY StubTexStorage2D(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height)
+{
+    Record(EntryPoint_glTexStorage2D, target, levels, internalformat, width, height);
+    SetTextureStorage(GetBoundTexture(target), levels, internalformat, width, height);
+}
+
+static void APIENTRY StubTextureStorage2D(GLuint texture, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height)
+{
+    Record(EntryPoint_glTextureStorage2D, texture, levels, internalformat, width, height);
+    SetTextureStorage(texture, levels, internalformat, width, height);
+}
+
+static void GetTextureLevelParameter(GLuint texture, GLint level, GLenum pname, GLint* params)
+{
+    auto itLevel = s_state.textureLevels.find(MakeKey(texture, level));
+    TextureLevel textureLevel = itLevel != s_state.textureLevels.end() ? itLevel->second : TextureLevel{};
+    switch (pname)
+    {
+    case GL_TEXTURE_WIDTH:
+        *params = textureLevel.width;
+        break;
+    case GL_TEXTURE_HEIGHT:
+        *params = textureLevel.height;
+        break;
+    case GL_TEXTURE_DEPTH:
+        *params = textureLevel.depth;
+        break;
+    case GL_TEXTURE_INTERNAL_FORMAT:
+        *params = textureLevel.internalFormat;
+        break;
+    default:
+        *params = 0;
+        break;
+    }
+}
+
+static void APIENTRY StubGetTexLevelParameteriv(GLenum target, GLint level, GLenum pname, GLint* params)
+{
+    Record(EntryPoint_glGetTexLevelParameteriv, target, level, pname, params);
+    GetTextureLevelParameter(GetBoundTexture(target), level, pname, params);
+}
+
+static void APIENTRY StubGetTextureLevelParameteriv(GLuint texture, GLint level, GLenum pname, GLint* params)
+{
+    Record(EntryPoint_glGetTextureLevelParameteriv, texture, level, pname, params);
+    GetTextureLevelParameter(texture, level, pname, params);
+}
+
+// Texture and sampler parameters are stored as doubles, and converted when read, as GL does
+
+static unsigned int GetParameterCount(GLenum pname)
+{
+    return pname == GL_TEXTURE_BORDER_COLOR || pname == GL_TEXTURE_SWIZZLE_RGBA ? 4 : 1;
+}
+
+template<typename T>
+static void SetParameter(GLuint object, GLenum pname, const T* values)
+{
+    std::array<double, 4>& parameter = s_state.parameters[MakeKey(object, pname)];
+    unsigned int count = GetParameterCount(pname);
+    std::copy(values, values + count, parameter.begin());
+    RecordPayload(values, count * sizeof(T));
+}
+
+template<typename T>
+static void GetParameter(GLuint object, GLenum pname, T* values)
+{
+    auto itParameter = s_state.parameters.find(MakeKey(object, pname));
+    std::array<double, 4> parameter = itParameter != s_state.parameters.end() ? itParameter->second : std::array<double, 4>{};
+    for (unsigned int i = 0; i < GetParameterCount(pname); ++i)
+    {
+        values[i] = static_cast<T>(parameter[i]);
+    }
+}
+
+static void APIENTRY StubTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+    Record(EntryPoint_glTexParameteri, target, pname, param);
+    SetParameter(GetBoundTexture(target), pname, &param);
+}
+
+static void APIENTRY StubTexParameterf(GLenum target, GLenum pname, GLfloat param)
+{
+    Record(EntryPoint_glTexParameterf, target, pname, param);
+    SetParameter(GetBoundTexture(target), pname, &param);
+}
+
+static void APIENTRY StubTexParameterfv(GLenum target, GLenum pname, const GLfloat* params)
+{
+    Record(EntryPoint_glTexParameterfv, target, pname, params);
+    SetParameter(GetBoundTexture(target), pname, params);
+}
+
+static void APIENTRY StubTexParameterIuiv(GLenum target, GLenum pname, const GLuint* params)
+{
+    Record(EntryPoint_glTexParameterIuiv, target, pname, params);
+    SetParameter(GetBoundTexture(target), pname, params);
+}
+
+static void APIENTRY StubTextureParameteri(GLuint texture, GLenum pname, GLint param)
+{
+    Record(EntryPoint_glTextureParameteri, texture, pname, param);
+    SetParameter(texture, pname, &param);
+}
+
+static void APIENTRY StubTextureParameterf(GLuint texture, GLenum pname, GLfloat param)
+{
+    Record(EntryPoint_glTextureParameterf, texture, pname, param);
+    SetParameter(texture, pname, &param);
+}
+
+static void APIENTRY StubTextureParameterfv(GLuint texture, GLenum pname, const GLfloat* params)
+{
+    Record(EntryPoint_glTextureParameterfv, texture, pname, params);
+    SetParameter(texture, pname, params);
+}
+
+static void APIENTRY StubTextureParameterIuiv(GLuint texture, GLenum pname, const GLuint* params)
+{
+    Record(EntryPoint_glTextureParameterIuiv, texture, pname, params);
+    SetParameter(texture, pname, params);
+}
+
+static void APIENTRY StubSamplerParameteri(GLuint sampler, GLenum pname, GLint param)
+{
+    Record(EntryPoint_glSamplerParameteri, sampler, pname, param);
+    SetParameter(sampler, pname, &param);
+}
+
+static void APIENTRY StubSamplerParameterf(GLuint sampler, GLenum pname, GLfloat param)
+{
+    Record(EntryPoint_glSamplerParameterf, sampler, pname, param);
+    SetParameter(sampler, pname, &param);
+}
+
+static void APIENTRY StubSamplerParameterfv(GLuint sampler, GLenum pname, const GLfloat* params)
+{
+    Record(EntryPoint_glSamplerParameterfv, sampler, pname, params);
+    SetParameter(sampler, pname, params);
+}
+
+static void APIENTRY StubGetTexParameteriv(GLenum target, GLenum pname, GLint* params)
+{
+    Record(EntryPoint_glGetTexParameteriv, target, pname, params);
+    GetParameter(GetBoundTexture(target), pname, params);
+}
+
+static void APIENTRY StubGetTexParameterfv(GLenum target, GLenum pname, GLfloat* params)
+{
+    Record(EntryPoint_glGetTexParameterfv, target, pname, params);
+    GetParameter(GetBoundTexture(target), pname, params);
+}
+
+static void APIENTRY StubGetTexParameterIuiv(GLenum target, GLenum pname, GLuint* params)
+{
+    Record(EntryPoint_glGetTexParameterIuiv, target, pname, params);
+    GetParameter(GetBoundTexture(target), pname, params);
+}
+
+static void APIENTRY StubGetTextureParameteriv(GLuint texture, GLenum pname, GLint* params)
+{
+    Record(EntryPoint_glGetTextureParameteriv, texture, pname, params);
+    GetParameter(texture, pname, params);
+}
+
+static void APIENTRY StubGetTextureParameterfv(GLuint texture, GLenum pname, GLfloat* params)
+{
+    Record(EntryPoint_glGetTextureParameterfv, texture, pname, params);
+    GetParameter(texture, pname, params);
+}
+
+static void APIENTRY StubGetTextureParameterIuiv(GLuint texture, GLenum pname, GLuint* params)
+{
+    Record(EntryPoint_glGetTextureParameterIuiv, texture, pname, params);
+    GetParameter(texture, pname, params);
+}
+
+static void APIENTRY StubGetSamplerParameterfv(GLuint sampler, GLenum pname, GLfloat* params)
+{
+    Record(EntryPoint_glGetSamplerParameterfv, sampler, pname, params);
+    GetParameter(sampler, pname, params);
+}
+
+static void APIENTRY StubGetSamplerParameterIuiv(GLuint sampler, GLenum pname, GLuint* params)
+{
+    Record(EntryPoint_glGetSamplerParameterIuiv, sampler, pname, params);
+    GetParameter(sampler, pname, params);
+}
+
+// Framebuffers and queries
+
+static GLenum APIENTRY StubCheckFramebufferStatus(GLenum target)
+{
+    Record(EntryPoint_glCheckFramebufferStatus, target);
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+static GLenum APIENTRY StubCheckNamedFramebufferStatus(GLuint framebuffer, GLenum target)
+{
+    Record(EntryPoint_glCheckNamedFramebufferStatus, framebuffer, target);
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+// Queries are available at once, with a zero result
+static void APIENTRY StubGetQueryObjectuiv(GLuint id, GLenum pname, GLuint* params)
+{
+    Record(EntryPoint_glGetQueryObjectuiv, id, pname, params);
+    *params = pname == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+}
+
+static void APIENTRY StubGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params)
+{
+    Record(EntryPoint_glGetQueryObjectui64v, id, pname, params);
+    *params = pname == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+}
+
+struct StubEntry
+{
+    unsigned int entryPoint;
+    void* function;
+};
+
+#define STUB_ENTRY(name, function) { EntryPoint_##name, reinterpret_cast<void*>(&function) }
+#define STUB_GEN_ENTRY(name) { EntryPoint_##name, reinterpret_cast<void*>(&StubGen<EntryPoint_##name>) }
+#define STUB_UNIFORM_ENTRY(name, function, type, components) { EntryPoint_##name, reinterpret_cast<void*>(&function<EntryPoint_##name, type, components>) }
+#define STUB_GET_UNIFORM_ENTRY(name, type) { EntryPoint_##name, reinterpret_cast<void*>(&StubGetnUniform<EntryPoint_##name, type>) }
+
+static const StubEntry s_stubEntries[] = {
+    STUB_ENTRY(glGetString, StubGetString),
+    STUB_ENTRY(glGetStringi, StubGetStringi),
+    STUB_ENTRY(glGetIntegerv, StubGetIntegerv),
+    STUB_ENTRY(glIsEnabled, StubIsEnabled),
+    STUB_ENTRY(glEnable, StubEnable),
+    STUB_ENTRY(glDisable, StubDisable),
+    STUB_ENTRY(glViewport, StubViewport),
+    STUB_ENTRY(glPixelStorei, StubPixelStorei),
+
+    STUB_GEN_ENTRY(glGenBuffers),
+    STUB_GEN_ENTRY(glGenTextures),
+    STUB_GEN_ENTRY(glGenVertexArrays),
+    STUB_GEN_ENTRY(glGenFramebuffers),
+    STUB_GEN_ENTRY(glGenRenderbuffers),
+    STUB_GEN_ENTRY(glGenSamplers),
+    STUB_GEN_ENTRY(glGenQueries),
+    STUB_GEN_ENTRY(glCreateBuffers),
+    STUB_GEN_ENTRY(glCreateVertexArrays),
+    STUB_GEN_ENTRY(glCreateFramebuffers),
+    STUB_GEN_ENTRY(glCreateRenderbuffers),
+    STUB_GEN_ENTRY(glCreateSamplers),
+    STUB_ENTRY(glCreateTextures, StubCreateTextures),
+    STUB_ENTRY(glCreateQueries, StubCreateQueries),
+    STUB_ENTRY(glFenceSync, StubFenceSync),
+    STUB_ENTRY(glClientWaitSync, StubClientWaitSync),
+
+    STUB_ENTRY(glCreateShader, StubCreateShader),
+    STUB_ENTRY(glShaderSource, StubShaderSource),
+    STUB_ENTRY(glGetShaderiv, StubGetShaderiv),
+    STUB_ENTRY(glGetShaderInfoLog, StubGetShaderInfoLog),
+    STUB_ENTRY(glCreateProgram, StubCreateProgram),
+    STUB_ENTRY(glAttachShader, StubAttachShader),
+    STUB_ENTRY(glLinkProgram, StubLinkProgram),
+    STUB_ENTRY(glGetProgramiv, StubGetProgramiv),
+    STUB_ENTRY(glGetProgramInfoLog, StubGetProgramInfoLog),
+    STUB_ENTRY(glGetProgramBinary, StubGetProgramBinary),
+    STUB_ENTRY(glGetActiveUniform, StubGetActiveUniform),
+    STUB_ENTRY(glGetActiveUniformsiv, StubGetActiveUniformsiv),
+    STUB_ENTRY(glGetUniformLocation, StubGetUniformLocation),
+    STUB_ENTRY(glGetAttribLocation, StubGetAttribLocation),
+    STUB_ENTRY(glGetUniformBlockIndex, StubGetUniformBlockIndex),
+    STUB_ENTRY(glUseProgram, StubUseProgram),
+
+    STUB_UNIFORM_ENTRY(glUniform1fv, StubUniform, GLfloat, 1),
+    STUB_UNIFORM_ENTRY(glUniform2fv, StubUniform, GLfloat, 2),
+    STUB_UNIFORM_ENTRY(glUniform3fv, StubUniform, GLfloat, 3),
+    STUB_UNIFORM_ENTRY(glUniform4fv, StubUniform, GLfloat, 4),
+    STUB_UNIFORM_ENTRY(glUniform1iv, StubUniform, GLint, 1),
+    STUB_UNIFORM_ENTRY(glUniform2iv, StubUniform, GLint, 2),
+    STUB_UNIFORM_ENTRY(glUniform3iv, StubUniform, GLint, 3),
+    STUB_UNIFORM_ENTRY(glUniform4iv, StubUniform, GLint, 4),
+    STUB_UNIFORM_ENTRY(glUniform1uiv, StubUniform, GLuint, 1),
+    STUB_UNIFORM_ENTRY(glUniform2uiv, StubUniform, GLuint, 2),
+    STUB_UNIFORM_ENTRY(glUniform3uiv, StubUniform, GLuint, 3),
+    STUB_UNIFORM_ENTRY(glUniform4uiv, StubUniform, GLuint, 4),
+    STUB_UNIFORM_ENTRY(glUniform1dv, StubUniform, GLdouble, 1),
+    STUB_UNIFORM_ENTRY(glUniform2dv, StubUniform, GLdouble, 2),
+    STUB_UNIFORM_ENTRY(glUniform3dv, StubUniform, GLdouble, 3),
+    STUB_UNIFORM_ENTRY(glUniform4dv, StubUniform, GLdouble, 4),
+    STUB_UNIFORM_ENTRY(glUniformMatrix2fv, StubUniformMatrix, GLfloat, 4),
+    STUB_UNIFORM_ENTRY(glUniformMatrix3fv, StubUniformMatrix, GLfloat, 9),
+    STUB_UNIFORM_ENTRY(glUniformMatrix4fv, StubUniformMatrix, GLfloat, 16),
+    STUB_UNIFORM_ENTRY(glUniformMatrix2x3fv, StubUniformMatrix, GLfloat, 6),
+    STUB_UNIFORM_ENTRY(glUniformMatrix2x4fv, StubUniformMatrix, GLfloat, 8),
+    STUB_UNIFORM_ENTRY(glUniformMatrix3x2fv, StubUniformMatrix, GLfloat, 6),
+    STUB_UNIFORM_ENTRY(glUniformMatrix3x4fv, StubUniformMatrix, GLfloat, 12),
+    STUB_UNIFORM_ENTRY(glUniformMatrix4x2fv, StubUniformMatrix, GLfloat, 8),
+    STUB_UNIFORM_ENTRY(glUniformMatrix4x3fv, StubUniformMatrix, GLfloat, 12),
+    STUB_UNIFORM_ENTRY(glProgramUniform1fv, StubProgramUniform, GLfloat, 1),
+    STUB_UNIFORM_ENTRY(glProgramUniform2fv, StubProgramUniform, GLfloat, 2),
+    STUB_UNIFORM_ENTRY(glProgramUniform3fv, StubProgramUniform, GLfloat, 3),
+    STUB_UNIFORM_ENTRY(glProgramUniform4fv, StubProgramUniform, GLfloat, 4),
+    STUB_UNIFORM_ENTRY(glProgramUniform1iv, StubProgramUniform, GLint, 1),
+    STUB_UNIFORM_ENTRY(glProgramUniform2iv, StubProgramUniform, GLint, 2),
+    STUB_UNIFORM_ENTRY(glProgramUniform3iv, StubProgramUniform, GLint, 3),
+    STUB_UNIFORM_ENTRY(glProgramUniform4iv, StubProgramUniform, GLint, 4),
+    STUB_UNIFORM_ENTRY(glProgramUniform1uiv, StubProgramUniform, GLuint, 1),
+    STUB_UNIFORM_ENTRY(glProgramUniform2uiv, StubProgramUniform, GLuint, 2),
+    STUB_UNIFORM_ENTRY(glProgramUniform3uiv, StubProgramUniform, GLuint, 3),
+    STUB_UNIFORM_ENTRY(glProgramUniform4uiv, StubProgramUniform, GLuint, 4),
+    STUB_UNIFORM_ENTRY(glProgramUniform1dv, StubProgramUniform, GLdouble, 1),
+    STUB_UNIFORM_ENTRY(glProgramUniform2dv, StubProgramUniform, GLdouble, 2),
+    STUB_UNIFORM_ENTRY(glProgramUniform3dv, StubProgramUniform, GLdouble, 3),
+    STUB_UNIFORM_ENTRY(glProgramUniform4dv, StubProgramUniform, GLdouble, 4),
+    STUB_UNIFORM_ENTRY(glProgramUniformMatrix2fv, StubProgramUniformMatrix, GLfloat, 4),
+    STUB_UNIFORM_ENTRY(glProgramUniformMatrix3fv, StubProgramUniformMatrix, GLfloat, 9),
+    STUB_UNIFORM_ENTRY(glProgramUniformMatrix4fv, StubProgramUniformMatrix, GLfloat, 16),
+    STUB_UNIFORM_ENTRY(glProgramUniformMatrix2x3fv, StubProgramUniformMatrix, GLfloat, 6),
+    STUB_UNIFORM_ENTRY(glProgramUniformMatrix2x4fv, StubProgramUniformMatrix, GLfloat, 8),
+    STUB_UNIFORM_ENTRY(glProgramUniformMatrix3x2fv, StubProgramUniformMatrix, GLfloat, 6),
+    STUB_UNIFORM_ENTRY(glProgramUniformMatrix3x4fv, StubProgramUniformMatrix, GLfloat, 12),
+    STUB_UNIFORM_ENTRY(glProgramUniformMatrix4x2fv, StubProgramUniformMatrix, GLfloat, 8),
+    STUB_UNIFORM_ENTRY(glProgramUniformMatrix4x3fv, StubProgramUniformMatrix, GLfloat, 12),
+    STUB_GET_UNIFORM_ENTRY(glGetnUniformfv, GLfloat),
+    STUB_GET_UNIFORM_ENTRY(glGetnUniformiv, GLint),
+    STUB_GET_UNIFORM_ENTRY(glGetnUniformuiv, GLuint),
+    STUB_GET_UNIFORM_ENTRY(glGetnUniformdv, GLdouble),
+
+    STUB_ENTRY(glBindBuffer, StubBindBuffer),
+    STUB_ENTRY(glBufferData, StubBufferData),
+    STUB_ENTRY(glBufferStorage, StubBufferStorage),
+    STUB_ENTRY(glBufferSubData, StubBufferSubData),
+    STUB_ENTRY(glNamedBufferData, StubNamedBufferData),
+    STUB_ENTRY(glNamedBufferStorage, StubNamedBufferStorage),
+    STUB_ENTRY(glNamedBufferSubData, StubNamedBufferSubData),
+    STUB_ENTRY(glMapBufferRange, StubMapBufferRange),
+    STUB_ENTRY(glMapNamedBufferRange, StubMapNamedBufferRange),
+    STUB_ENTRY(glUnmapBuffer, StubUnmapBuffer),
+    STUB_ENTRY(glUnmapNamedBuffer, StubUnmapNamedBuffer),
+
+    STUB_ENTRY(glActiveTexture, StubActiveTexture),
+    STUB_ENTRY(glBindTexture, StubBindTexture),
+    STUB_ENTRY(glBindTextureUnit, StubBindTextureUnit),
+    STUB_ENTRY(glTexImage2D, StubTexImage2D),
+    STUB_ENTRY(glTexStorage2D, StubTexStorage2D),
+    STUB_ENTRY(glTextureStorage2D, StubTextureStorage2D),
+    STUB_ENTRY(glGetTexLevelParameteriv, StubGetTexLevelParameteriv),
+    STUB_ENTRY(glGetTextureLevelParameteriv, StubGetTextureLevelParameteriv),
+    STUB_ENTRY(glTexParameteri, StubTexParameteri),
+    STUB_ENTRY(glTexParameterf, StubTexParameterf),
+    STUB_ENTRY(glTexParameterfv, StubTexParameterfv),
+    STUB_ENTRY(glTexParameterIuiv, StubTexParameterIuiv),
+    STUB_ENTRY(glTextureParameteri, StubTextureParameteri),
+    STUB_ENTRY(glTextureParameterf, StubTextureParameterf),
+    STUB_ENTRY(glTextureParameterfv, StubTextureParameterfv),
+    STUB_ENTRY(glTextureParameterIuiv, StubTextureParameterIuiv),
+    STUB_ENTRY(glSamplerParameteri, StubSamplerParameteri),
+    STUB_ENTRY(glSamplerParameterf, StubSamplerParameterf),
+    STUB_ENTRY(glSamplerParameterfv, StubSamplerParameterfv),
+    STUB_ENTRY(glGetTexParameteriv, StubGetTexParameteriv),
+    STUB_ENTRY(glGetTexParameterfv, StubGetTexParameterfv),
+    STUB_ENTRY(glGetTexParameterIuiv, StubGetTexParameterIuiv),
+    STUB_ENTRY(glGetTextureParameteriv, StubGetTextureParameteriv),
+    STUB_ENTRY(glGetTextureParameterfv, StubGetTextureParameterfv),
+    STUB_ENTRY(glGetTextureParameterIuiv, StubGetTextureParameterIuiv),
+    STUB_ENTRY(glGetSamplerParameterfv, StubGetSamplerParameterfv),
+    STUB_ENTRY(glGetSamplerParameterIuiv, StubGetSamplerParameterIuiv),
+
+    STUB_ENTRY(glCheckFramebufferStatus, StubCheckFramebufferStatus),
+    STUB_ENTRY(glCheckNamedFramebufferStatus, StubCheckNamedFramebufferStatus),
+    STUB_ENTRY(glGetQueryObjectuiv, StubGetQueryObjectuiv),
+    STUB_ENTRY(glGetQueryObjectui64v, StubGetQueryObjectui64v),
+};
+
+#undef STUB_ENTRY
+#undef STUB_GEN_ENTRY
+#undef STUB_UNIFORM_ENTRY
+#undef STUB_GET_UNIFORM_ENTRY
+
+// Entry points the library does not call. The arguments are ignored, and the zero return value works for
+// the void, integer and pointer results of GL, with the x64 calling conventions where the caller cleans the stack
+static void* APIENTRY StubDefault()
+{
+    return nullptr;
+}
+
+static void* GetRecordingProcAddress(const char* name)
+{
+    for (unsigned int entryPoint = 0; entryPoint < EntryPointCount; ++entryPoint)
+    {
+        if (std::strcmp(s_entryPointNames[entryPoint], name) == 0)
+        {
+            for (const StubEntry& entry : s_stubEntries)
+            {
+                if (entry.entryPoint == entryPoint)
+                {
+                    return entry.function;
+                }
+            }
+            return s_recorders[entryPoint];
+        }
+    }
+    return reinterpret_cast<void*>(&StubDefault);
+}
+
+//
+// RecordingGL
+//
+
+bool RecordingGL::Load()
+{
+    Reset();
+    s_state.loaded = gladLoadGLLoader(&GetRecordingProcAddress);
+    return s_state.loaded;
+}
+
+bool RecordingGL::IsLoaded()
+{
+    return s_state.loaded;
+}
+
+void RecordingGL::Reset()
+{
+    bool loaded = s_state.loaded;
+    bool recording = s_state.recording;
+    s_state = RecordingState();
+    s_state.loaded = loaded;
+    s_state.recording = recording;
+}
+
+void RecordingGL::SetRecording(bool recording)
+{
+    s_state.recording = recording;
+}
+
+bool RecordingGL::IsRecording()
+{
+    return s_state.recording;
+}
+
+const std::vector<uint64_t>& RecordingGL::GetCommandBuffer()
+{
+    return s_state.commands;
+}
+
+unsigned int RecordingGL::GetCommandCount()
+{
+    return s_state.commandCount;
+}
+
+void RecordingGL::ClearCommands()
+{
+    s_state.commands.clear();
+    s_state.lastCommand = 0;
+    s_state.commandCount = 0;
+}
+
+const char* RecordingGL::GetEntryPointName(unsigned int entryPoint)
+{
+    return entryPoint < EntryPointCount ? s_entryPointNames[entryPoint] : "unknown";
+}
+
+size_t RecordingGL::ReadCommand(std::span<const uint64_t> commandBuffer, size_t offset, Command& command)
+{
+    assert(offset < commandBuffer.size());
+    uint64_t header = commandBuffer[offset];
+    size_t wordCount = static_cast<size_t>(header >> 32);
+    assert(offset + 1 + wordCount <= commandBuffer.size());
+    command.entryPoint = static_cast<unsigned int>(header & 0xFFFFFFFF);
+    command.words = commandBuffer.subspan(offset + 1, wordCount);
+    return offset + 1 + wordCount;
+}
+
+uint64_t RecordingGL::GetHash(std::span<const uint64_t> commandBuffer)
+{
+    return HashBytes(commandBuffer.data(), commandBuffer.size_bytes());
+}
+
+int RecordingGL::FindFirstDifference(std::span<const uint64_t> commandBuffer, std::span<const uint64_t> otherCommandBuffer)
+{
+    size_t offset = 0;
+    size_t otherOffset = 0;
+    int index = 0;
+    while (offset < commandBuffer.size() && otherOffset < otherCommandBuffer.size())
+    {
+        Command command, otherCommand;
+        offset = ReadCommand(commandBuffer, offset, command);
+        otherOffset = ReadCommand(otherCommandBuffer, otherOffset, otherCommand);
+        if (command.entryPoint != otherCommand.entryPoint || !std::equal(command.words.begin(), command.words.end(), otherCommand.words.begin(), otherCommand.words.end()))
+        {
+            return index;
+        }
+        ++index;
+    }
+    // One of the streams is longer
+    return offset < commandBuffer.size() || otherOffset < otherCommandBuffer.size() ? index : -1;
+}
+
+bool RecordingGL::WriteCommands(std::span<const uint64_t> commandBuffer, const char* path)
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        return false;
+    }
+
+    file << std::hex;
+    for (size_t offset = 0; offset < commandBuffer.size();)
+    {
+        Command command;
+        offset = ReadCommand(commandBuffer, offset, command);
+        file << GetEntryPointName(command.entryPoint);
+        for (uint64_t word : command.words)
+        {
+            file << ' ' << word;
+        }
+        file << '\n';
+    }
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,258 @@
+#include <ituGL/core/RenderState.h>
+
+#include <unordered_map>
+#include <vector>
+#include <functional>
+#include <cassert>
+
+RenderState::Desc::Desc()
+    : depthTestFunction(TestFunction::Less)
+    , depthWrite(true)
+    , stencilTestFunctions{ TestFunction::Never, TestFunction::Never }
+    , stencilRefValues{ 0, 0 }
+    , stencilMasks{ ~0u, ~0u }
+    , stencilFail{ StencilOperation::Keep, StencilOperation::Keep }
+    , stencilDepthFail{ StencilOperation::Keep, StencilOperation::Keep }
+    , stencilDepthPass{ StencilOperation::Keep, StencilOperation::Keep }
+    , blendEquations{ BlendEquation::None, BlendEquation::None }
+    , blendParams{ BlendParam::One, BlendParam::Zero, BlendParam::One, BlendParam::Zero }
+{
+}
+
+bool RenderState::Desc::operator == (const Desc& desc) const
+{
+    return depthTestFunction == desc.depthTestFunction && depthWrite == desc.depthWrite
+        && stencilTestFunctions == desc.stencilTestFunctions && stencilRefValues == desc.stencilRefValues && stencilMasks == desc.stencilMasks
+        && stencilFail == desc.stencilFail && stencilDepthFail == desc.stencilDepthFail && stencilDepthPass == desc.stencilDepthPass
+        && blendEquations == desc.blendEquations && blendParams == desc.blendParams
+        && blendColor.GetRed() == desc.blendColor.GetRed() && blendColor.GetGreen() == desc.blendColor.GetGreen()
+        && blendColor.GetBlue() == desc.blendColor.GetBlue() && blendColor.GetAlpha() == desc.blendColor.GetAlpha();
+}
+
+std::shared_ptr<const RenderState> RenderState::Get(const Desc& desc)
+{
+    // Blocks by hash of the states. Different states with the same hash share the list
+    static std::unordered_map<size_t, std::vector<std::shared_ptr<const RenderState>>> s_renderStates;
+
+    std::vector<std::shared_ptr<const RenderState>>& renderStates = s_renderStates[ComputeHash(desc)];
+    for (const std::shared_ptr<const RenderState>& renderState : renderStates)
+    {
+        if (renderState->m_desc == desc)
+        {
+            return renderState;
+        }
+    }
+    renderStates.push_back(std::shared_ptr<const RenderState>(new RenderState(desc)));
+    return renderStates.back();
+}
+
+RenderState::RenderState(const Desc& desc) : m_desc(desc), m_groups(DepthGroups | StencilGroups | BlendEnable)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        m_blendParams[i] = static_cast<GLenum>(m_desc.blendParams[i]);
+    }
+    for (int i = 0; i < 2; ++i)
+    {
+        m_blendEquations[i] = static_cast<GLenum>(m_desc.blendEquations[i]);
+    }
+
+    // If the blend equation is None for color and alpha, blending is disabled
+    if (m_blendEquations[0] != GL_NONE || m_blendEquations[1] != GL_NONE)
+    {
+        m_groups |= BlendEquations | BlendParams;
+
+        // Because there is no "None" equation, we replace it with (Source * 1 + Dest * 0)
+        if (m_blendEquations[0] == GL_NONE)
+        {
+            m_blendEquations[0] = GL_FUNC_ADD;
+            m_blendParams[0] = GL_ONE;
+            m_blendParams[1] = GL_ZERO;
+        }
+        if (m_blendEquations[1] == GL_NONE)
+        {
+            m_blendEquations[1] = GL_FUNC_ADD;
+            m_blendParams[2] = GL_ONE;
+            m_blendParams[3] = GL_ZERO;
+        }
+
+        // Blend color only if one param is using constant color or constant alpha
+        for (GLenum blendParam : m_blendParams)
+        {
+            if (blendParam == GL_CONSTANT_COLOR || blendParam == GL_ONE_MINUS_CONSTANT_COLOR
+                || blendParam == GL_CONSTANT_ALPHA || blendParam == GL_ONE_MINUS_CONSTANT_ALPHA)
+            {
+                m_groups |= BlendColor;
+            }
+        }
+    }
+}
+
+unsigned int RenderState::GetDifferentGroups(const RenderState& renderState) const
+{
+    const Desc& desc = renderState.m_desc;
+    unsigned int groups = 0;
+    if (m_desc.depthTestFunction != desc.depthTestFunction)
+    {
+        groups |= DepthFunction;
+    }
+    if (m_desc.depthWrite != desc.depthWrite)
+    {
+        groups |= DepthWrite;
+    }
+    if (m_desc.stencilTestFunctions != desc.stencilTestFunctions || m_desc.stencilRefValues != desc.stencilRefValues || m_desc.stencilMasks != desc.stencilMasks)
+    {
+        groups |= StencilFunctions;
+    }
+    if (m_desc.stencilFail != desc.stencilFail || m_desc.stencilDepthFail != desc.stencilDepthFail || m_desc.stencilDepthPass != desc.stencilDepthPass)
+    {
+        groups |= StencilOperations;
+    }
+    if ((m_groups & BlendEquations) != (renderState.m_groups & BlendEquations))
+    {
+        groups |= BlendEnable;
+    }
+    if (m_blendEquations != renderState.m_blendEquations)
+    {
+        groups |= BlendEquations;
+    }
+    if (m_blendParams != renderState.m_blendParams)
+    {
+        groups |= BlendParams;
+    }
+    const Color& blendColor = renderState.m_desc.blendColor;
+    if (m_desc.blendColor.GetRed() != blendColor.GetRed() || m_desc.blendColor.GetGreen() != blendColor.GetGreen()
+        || m_desc.blendColor.GetBlue() != blendColor.GetBlue() || m_desc.blendColor.GetAlpha() != blendColor.GetAlpha())
+    {
+        groups |= BlendColor;
+    }
+    return groups & m_groups;
+}
+
+void RenderState::Apply(unsigned int groupMask) const
+{
+    assert((groupMask & ~m_groups) == 0);
+
+    if (groupMask & DepthFunction)
+    {
+        glDepthFunc(static_cast<GLenum>(m_desc.depthTestFunction));
+    }
+
+    if (groupMask & DepthWrite)
+    {
+        glDepthMask(m_desc.depthWrite ? GL_TRUE : GL_FALSE);
+    }
+
+    if (groupMask & StencilOperations)
+    {
+        const std::array<StencilOperation, 2>& stencilFail = m_desc.stencilFail;
+        const std::array<StencilOperation, 2>& depthFail = m_desc.stencilDepthFail;
+        const std::array<StencilOperation, 2>& depthPass = m_desc.stencilDepthPass;
+        if (stencilFail[0] == stencilFail[1] && depthFail[0] == depthFail[1] && depthPass[0] == depthPass[1])
+        {
+            // Same for front and back
+            glStencilOp(static_cast<GLenum>(stencilFail[0]), static_cast<GLenum>(depthFail[0]), static_cast<GLenum>(depthPass[0]));
+        }
+        else
+        {
+            // Separate functions for front and back
+            glStencilOpSeparate(GL_FRONT, static_cast<GLenum>(stencilFail[0]), static_cast<GLenum>(depthFail[0]), static_cast<GLenum>(depthPass[0]));
+            glStencilOpSeparate(GL_BACK, static_cast<GLenum>(stencilFail[1]), static_cast<GLenum>(depthFail[1]), static_cast<GLenum>(depthPass[1]));
+        }
+    }
+
+    if (groupMask & StencilFunctions)
+    {
+        const std::array<TestFunction, 2>& functions = m_desc.stencilTestFunctions;
+        const std::array<int, 2>& refValues = m_desc.stencilRefValues;
+        const std::array<unsigned int, 2>& masks = m_desc.stencilMasks;
+        if (functions[0] == functions[1] && refValues[0] == refValues[1] && masks[0] == masks[1])
+        {
+            // Same for front and back
+            glStencilFunc(static_cast<GLenum>(functions[0]), refValues[0], masks[0]);
+        }
+        else
+        {
+            // Separate functions for front and back
+            glStencilFuncSeparate(GL_FRONT, static_cast<GLenum>(functions[0]), refValues[0], masks[0]);
+            glStencilFuncSeparate(GL_BACK, static_cast<GLenum>(functions[1]), refValues[1], masks[1]);
+        }
+    }
+
+    if (groupMask & BlendEnable)
+    {
+        if (m_groups & BlendEquations)
+        {
+            glEnable(GL_BLEND);
+        }
+        else
+        {
+            glDisable(GL_BLEND);
+        }
+    }
+
+    if (groupMask & BlendEquations)
+    {
+        if (m_blendEquations[0] == m_blendEquations[1])
+        {
+            // Set the same blend equation for color and alpha
+            glBlendEquation(m_blendEquations[0]);
+        }
+        else
+        {
+            // Set separate blend equation for color and alpha
+            glBlendEquationSeparate(m_blendEquations[0], m_blendEquations[1]);
+        }
+    }
+
+    if (groupMask & BlendParams)
+    {
+        if (m_blendParams[0] == m_blendParams[2] && m_blendParams[1] == m_blendParams[3])
+        {
+            // Set the same blend params for color and alpha
+            glBlendFunc(m_blendParams[0], m_blendParams[1]);
+        }
+        else
+        {
+            // Set separate blend params for color and alpha
+            glBlendFuncSeparate(m_blendParams[0], m_blendParams[1], m_blendParams[2], m_blendParams[3]);
+        }
+    }
+
+    if (groupMask & BlendColor)
+    {
+        const Color& blendColor = m_desc.blendColor;
+        glBlendColor(blendColor.GetRed(), blendColor.GetGreen(), blendColor.GetBlue(), blendColor.GetAlpha());
+    }
+}
+
+size_t RenderState::ComputeHash(const Desc& desc)
+{
+    // Combine the hash of each value, as boost::hash_combine
+    size_t hash = 0;
+    auto combine = [&hash](size_t valueHash) { hash ^= valueHash + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+    std::hash<unsigned int> hashValue;
+    std::hash<float> hashFloat;
+
+    combine(hashValue(static_cast<unsigned int>(desc.depthTestFunction)));
+    combine(hashValue(desc.depthWrite));
+    for (int i = 0; i < 2; ++i)
+    {
+        combine(hashValue(static_cast<unsigned int>(desc.stencilTestFunctions[i])));
+        combine(hashValue(static_cast<unsigned int>(desc.stencilRefValues[i])));
+        combine(hashValue(desc.stencilMasks[i]));
+        combine(hashValue(static_cast<unsigned int>(desc.stencilFail[i])));
+        combine(hashValue(static_cast<unsigned int>(desc.stencilDepthFail[i])));
+        combine(hashValue(static_cast<unsigned int>(desc.stencilDepthPass[i])));
+        combine(hashValue(static_cast<unsigned int>(desc.blendEquations[i])));
+    }
+    for (BlendParam blendParam : desc.blendParams)
+    {
+        combine(hashValue(static_cast<unsigned int>(blendParam)));
+    }
+    combine(hashFloat(desc.blendColor.GetRed()));
+    combine(hashFloat(desc.blendColor.GetGreen()));
+    combine(hashFloat(desc.blendColor.GetBlue()));
+    combine(hashFloat(desc.blendColor.GetAlpha()));
+    return hash;
+}
@@ -5,7 +5,7 @@
 #include <cassert>
 
 Drawcall::Drawcall()
-    : m_primitive(Primitive::Invalid), m_first(0), m_count(0), m_eboType(Data::Type::None)
+    : m_primitive(Primitive::Invalid), m_first(0), m_count(0), m_eboType(Data::Type::None), m_baseVertex(0)
 {
 }
 
@@ -14,12 +14,13 @@ Drawcall::Drawcall(Primitive primitive, GLsizei count, GLint first)
 {
 }
 
-Drawcall::Drawcall(Primitive primitive, GLsizei count, Data::Type eboType, GLint first)
-    : m_primitive(primitive), m_first(first), m_count(count), m_eboType(eboType)
+Drawcall::Drawcall(Primitive primitive, GLsizei count, Data::Type eboType, GLint first, GLint baseVertex)
+    : m_primitive(primitive), m_first(first), m_count(count), m_eboType(eboType), m_baseVertex(baseVertex)
 {
     assert(primitive != Primitive::Invalid);
     assert(first >= 0);
     assert(count > 0);
+    assert(eboType != Data::Type::None || baseVertex == 0);
 }
 
 // Execute the drawcall
@@ -36,9 +37,17 @@ void Drawcall::Draw() const
     }
     else
     {
-        // If there is an EBO, use glDrawElements
+        // If there is an EBO, use glDrawElements, or glDrawElementsBaseVertex if the vertices don't start at 0
         assert(ElementBufferObject::IsSupportedType(m_eboType));
         const char* basePointer = nullptr; // Actual element pointer is in VAO
-        glDrawElements(primitive, m_count, static_cast<GLenum>(m_eboType), basePointer + m_first);
+        const char* elementPointer = basePointer + m_first * Data::GetTypeSize(m_eboType);
+        if (m_baseVertex == 0)
+        {
+            glDrawElements(primitive, m_count, static_cast<GLenum>(m_eboType), elementPointer);
+        }
+        else
+        {
+            glDrawElementsBaseVertex(primitive, m_count, static_cast<GLenum>(m_eboType), elementPointer, m_baseVertex);
+        }
     }
 }
@@ -17,6 +17,7 @@ unsigned int Mesh::AddVertexArray()
 {
     unsigned int vaoIndex = GetVertexArrayCount();
     m_vaos.emplace_back();
+    m_vertexArrayAttributes.emplace_back();
     return vaoIndex;
 }
 
@@ -35,17 +36,126 @@ unsigned int Mesh::AddSubmesh(unsigned int vaoIndex,
     return AddSubmesh(vaoIndex, Drawcall(primitive, count, eboType, first));
 }
 
+// Copy the VAO index, or the shared VAO and its buffers, so both submeshes bind the same state
+unsigned int Mesh::AddSubmeshFrom(unsigned int submeshIndex, const Drawcall& drawcall)
+{
+    Submesh submesh = GetSubmesh(submeshIndex);
+    submesh.drawcall = drawcall;
+
+    unsigned int newSubmeshIndex = GetSubmeshCount();
+    m_submeshes.push_back(std::move(submesh));
+    return newSubmeshIndex;
+}
+
+unsigned int Mesh::AddSubmesh(const Drawcall& drawcall, std::span<const AttributeBinding> attributes, int eboIndex)
+{
+    // Without semantic map, so each attribute keeps the location it is given
+    const SemanticMap noLocations;
+
+    if (VertexArrayObject::IsSharingSupported())
+    {
+        Submesh submesh;
+        submesh.drawcall = drawcall;
+        submesh.eboIndex = eboIndex;
+
+        std::vector<VertexArrayObject::AttributeFormat> formats;
+        for (const AttributeBinding& binding : attributes)
+        {
+            GLuint location = binding.location;
+            AddSharedAttribute(submesh, formats, binding.vboIndex, binding.layout, location, noLocations);
+        }
+        submesh.sharedVao = VertexArrayObject::GetShared(formats);
+
+        unsigned int submeshIndex = GetSubmeshCount();
+        m_submeshes.push_back(std::move(submesh));
+        return submeshIndex;
+    }
+
+    unsigned int vaoIndex = AddVertexArray();
+
+    VertexArrayObject& vao = GetVertexArray(vaoIndex);
+    vao.Bind();
+
+    for (const AttributeBinding& binding : attributes)
+    {
+        GLuint location = binding.location;
+        SetupVertexAttribute(vaoIndex, binding.vboIndex, binding.layout, location, noLocations);
+    }
+    if (eboIndex >= 0)
+    {
+        vao.SetElementBuffer(GetElementBuffer(eboIndex));
+    }
+
+    VertexArrayObject::Unbind();
+    VertexBufferObject::Unbind();
+    ElementBufferObject::Unbind();
+
+    unsigned int submeshIndex = AddSubmesh(vaoIndex, drawcall);
+    GetSubmesh(submeshIndex).eboIndex = eboIndex;
+    return submeshIndex;
+}
+
+const VertexArrayObject& Mesh::GetSubmeshVertexArray(unsigned int submeshIndex) const
+{
+    const Submesh& submesh = GetSubmesh(submeshIndex);
+    return submesh.sharedVao ? *submesh.sharedVao : GetVertexArray(submesh.vaoIndex);
+}
+
+std::span<const Mesh::AttributeBinding> Mesh::GetSubmeshAttributes(unsigned int submeshIndex) const
+{
+    const Submesh& submesh = GetSubmesh(submeshIndex);
+    return submesh.sharedVao ? submesh.attributes : m_vertexArrayAttributes[submesh.vaoIndex];
+}
+
+// Bind the VAO of the submesh. The device skips the VAO and the buffers that are already bound
+void Mesh::BindSubmesh(int submeshIndex) const
+{
+    const Submesh& submesh = GetSubmesh(submeshIndex);
+    if (!submesh.sharedVao)
+    {
+        GetVertexArray(submesh.vaoIndex).Bind();
+        return;
+    }
+
+    VertexArrayObject& vao = *submesh.sharedVao;
+    vao.Bind();
+    for (GLuint bindingIndex = 0; bindingIndex < submesh.vertexBuffers.size(); ++bindingIndex)
+    {
+        const VertexBufferBinding& binding = submesh.vertexBuffers[bindingIndex];
+        vao.SetVertexBuffer(bindingIndex, GetVertexBuffer(binding.vboIndex), binding.offset, binding.stride);
+    }
+    if (submesh.eboIndex >= 0)
+    {
+        vao.SetElementBuffer(GetElementBuffer(submesh.eboIndex));
+    }
+}
+
 // Bind the VAO and render the drawcall of the submesh
 void Mesh::DrawSubmesh(int submeshIndex) const
 {
     const Submesh& submesh = GetSubmesh(submeshIndex);
-    const VertexArrayObject& vao = GetVertexArray(submesh.vaoIndex);
-    vao.Bind();
+    BindSubmesh(submeshIndex);
     submesh.drawcall.Draw();
     //VertexArrayObject::Unbind(); // No need to unbind
 }
 
-void Mesh::SetupVertexAttribute(VertexArrayObject& vao, const VertexAttribute::Layout& attributeLayout, GLuint& location, const SemanticMap& locations)
+void Mesh::SetupVertexAttribute(unsigned int vaoIndex, unsigned int vboIndex, const VertexAttribute::Layout& attributeLayout, GLuint& location, const SemanticMap& locations)
+{
+    const VertexAttribute& attribute = attributeLayout.GetAttribute();
+
+    auto itLocation = locations.find(attribute.GetSemantic());
+    if (itLocation != locations.end())
+    {
+        location = itLocation->second;
+    }
+
+    GetVertexArray(vaoIndex).SetAttribute(location, attribute, GetVertexBuffer(vboIndex), attributeLayout.GetOffset(), attributeLayout.GetStride());
+    m_vertexArrayAttributes[vaoIndex].push_back(AttributeBinding{ vboIndex, attributeLayout, location });
+    location += attribute.GetLocationSize();
+}
+
+void Mesh::AddSharedAttribute(Submesh& submesh, std::vector<VertexArrayObject::AttributeFormat>& formats, unsigned int vboIndex,
+    const VertexAttribute::Layout& attributeLayout, GLuint& location, const SemanticMap& locations)
 {
     const VertexAttribute& attribute = attributeLayout.GetAttribute();
 
@@ -55,6 +165,34 @@ void Mesh::SetupVertexAttribute(VertexArrayObject& vao, const VertexAttribute::L
         location = itLocation->second;
     }
 
-    vao.SetAttribute(location, attribute, attributeLayout.GetOffset(), attributeLayout.GetStride());
+    // Stride must be explicit in the binding, 0 doesn't mean tightly packed
+    GLsizei stride = attributeLayout.GetStride() ? attributeLayout.GetStride() : attribute.GetSize();
+    GLintptr offset = attributeLayout.GetOffset();
+
+    // Look for a binding of the same VBO with a vertex that contains the attribute. Planar attributes get their own binding
+    GLuint bindingIndex = 0;
+    for (; bindingIndex < submesh.vertexBuffers.size(); ++bindingIndex)
+    {
+        const VertexBufferBinding& binding = submesh.vertexBuffers[bindingIndex];
+        if (binding.vboIndex == vboIndex && binding.stride == stride && offset >= binding.offset && offset - binding.offset < stride)
+        {
+            break;
+        }
+    }
+    if (bindingIndex == submesh.vertexBuffers.size())
+    {
+        submesh.vertexBuffers.push_back(VertexBufferBinding{ vboIndex, offset, stride });
+    }
+
+    VertexArrayObject::AttributeFormat format;
+    format.location = location;
+    format.components = attribute.GetComponents();
+    format.type = static_cast<GLenum>(attribute.GetType());
+    format.normalized = attribute.IsNormalized() ? GL_TRUE : GL_FALSE;
+    format.relativeOffset = static_cast<GLuint>(offset - submesh.vertexBuffers[bindingIndex].offset);
+    format.bindingIndex = bindingIndex;
+    formats.push_back(format);
+    submesh.attributes.push_back(AttributeBinding{ vboIndex, attributeLayout, location });
+
     location += attribute.GetLocationSize();
 }
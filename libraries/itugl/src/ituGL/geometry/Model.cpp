@@ -3,7 +3,7 @@
 #include <ituGL/geometry/Mesh.h>
 #include <ituGL/shader/Material.h>
 
-Model::Model(std::shared_ptr<Mesh> mesh) : m_mesh(mesh)
+Model::Model(std::shared_ptr<Mesh> mesh) : m_mesh(mesh), m_bounds(glm::vec3(0.0f), glm::vec3(1.0f))
 {
 }
 
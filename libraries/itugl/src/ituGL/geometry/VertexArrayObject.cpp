@@ -1,25 +1,44 @@
 #include <ituGL/geometry/VertexArrayObject.h>
 
 #include <ituGL/geometry/VertexAttribute.h>
+#include <ituGL/geometry/VertexBufferObject.h>
+#include <ituGL/geometry/ElementBufferObject.h>
+#include <ituGL/core/DeviceGL.h>
+#include <algorithm>
 #include <cassert>
 
-#ifndef NDEBUG
-#include <ituGL/geometry/VertexBufferObject.h>   // To assert that there is a VertexBufferObject bound
+std::vector<VertexArrayObject::SharedEntry> VertexArrayObject::s_sharedEntries;
+
+bool VertexArrayObject::s_sharingEnabled = true;
 
+#ifndef NDEBUG
 VertexArrayObject::Handle VertexArrayObject::s_boundHandle = VertexArrayObject::NullHandle;
 #endif
 
 // Create the object initially null, get object handle and generate 1 vertex array
+// With direct state access it is created already, so it can be edited before binding it
 VertexArrayObject::VertexArrayObject() : Object(NullHandle)
 {
     Handle& handle = GetHandle();
-    glGenVertexArrays(1, &handle);
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glCreateVertexArrays(1, &handle);
+    }
+    else
+    {
+        glGenVertexArrays(1, &handle);
+    }
 }
 
 // Get object handle and delete 1 vertex array
 VertexArrayObject::~VertexArrayObject()
 {
     Handle& handle = GetHandle();
+    DeviceGL* device = DeviceGL::GetInstancePointer();
+    if (device && handle != NullHandle)
+    {
+        device->ForgetVertexArray(handle);
+    }
     glDeleteVertexArrays(1, &handle);
 }
 
@@ -37,7 +56,14 @@ VertexArrayObject& VertexArrayObject::operator = (VertexArrayObject&& vao) noexc
 void VertexArrayObject::Bind() const
 {
     Handle handle = GetHandle();
-    glBindVertexArray(handle);
+    if (DeviceGL* device = DeviceGL::GetInstancePointer())
+    {
+        device->BindVertexArray(handle);
+    }
+    else
+    {
+        glBindVertexArray(handle);
+    }
 #ifndef NDEBUG
     s_boundHandle = handle;
 #endif
@@ -47,7 +73,14 @@ void VertexArrayObject::Bind() const
 void VertexArrayObject::Unbind()
 {
     Handle handle = NullHandle;
-    glBindVertexArray(handle);
+    if (DeviceGL* device = DeviceGL::GetInstancePointer())
+    {
+        device->BindVertexArray(handle);
+    }
+    else
+    {
+        glBindVertexArray(handle);
+    }
 #ifndef NDEBUG
     s_boundHandle = handle;
 #endif
@@ -74,3 +107,116 @@ void VertexArrayObject::SetAttribute(GLuint location, const VertexAttribute& att
     // Finally, we enable the VertexAttribute in this location
     glEnableVertexAttribArray(location);
 }
+
+void VertexArrayObject::SetAttribute(GLuint location, const VertexAttribute& attribute, const VertexBufferObject& vbo, GLint offset, GLsizei stride)
+{
+    if (!DeviceGL::HasDirectStateAccess())
+    {
+        vbo.Bind();
+        SetAttribute(location, attribute, offset, stride);
+        return;
+    }
+
+    // Each attribute reads from its own buffer binding, with the same index as the location
+    // The stride must be explicit in the buffer binding, 0 doesn't mean tightly packed
+    GLuint bindingIndex = location;
+    glVertexArrayVertexBuffer(GetHandle(), bindingIndex, vbo.GetHandle(), offset, stride ? stride : attribute.GetSize());
+
+    GLint components = attribute.GetComponents();
+    GLenum type = static_cast<GLenum>(attribute.GetType());
+    GLboolean normalized = attribute.IsNormalized() ? GL_TRUE : GL_FALSE;
+    glVertexArrayAttribFormat(GetHandle(), location, components, type, normalized, 0);
+    glVertexArrayAttribBinding(GetHandle(), location, bindingIndex);
+    glEnableVertexArrayAttrib(GetHandle(), location);
+}
+
+void VertexArrayObject::SetElementBuffer(const ElementBufferObject& ebo)
+{
+    // The element buffer binding is part of the state of the bound VertexArrayObject
+    assert(DeviceGL::HasDirectStateAccess() || IsBound());
+    if (DeviceGL* device = DeviceGL::GetInstancePointer())
+    {
+        device->BindElementBuffer(GetHandle(), ebo.GetHandle());
+    }
+    else if (DeviceGL::HasDirectStateAccess())
+    {
+        glVertexArrayElementBuffer(GetHandle(), ebo.GetHandle());
+    }
+    else
+    {
+        ebo.Bind();
+    }
+}
+
+void VertexArrayObject::SetAttributeFormat(const AttributeFormat& format)
+{
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glVertexArrayAttribFormat(GetHandle(), format.location, format.components, format.type, format.normalized, format.relativeOffset);
+        glVertexArrayAttribBinding(GetHandle(), format.location, format.bindingIndex);
+        glEnableVertexArrayAttrib(GetHandle(), format.location);
+        return;
+    }
+
+    assert(IsBound());
+    glVertexAttribFormat(format.location, format.components, format.type, format.normalized, format.relativeOffset);
+    glVertexAttribBinding(format.location, format.bindingIndex);
+    glEnableVertexAttribArray(format.location);
+}
+
+void VertexArrayObject::SetVertexBuffer(GLuint bindingIndex, const VertexBufferObject& vbo, GLintptr offset, GLsizei stride)
+{
+    assert(DeviceGL::HasDirectStateAccess() || IsBound());
+    if (DeviceGL* device = DeviceGL::GetInstancePointer())
+    {
+        device->BindVertexBuffer(GetHandle(), bindingIndex, vbo.GetHandle(), offset, stride);
+    }
+    else if (DeviceGL::HasDirectStateAccess())
+    {
+        glVertexArrayVertexBuffer(GetHandle(), bindingIndex, vbo.GetHandle(), offset, stride);
+    }
+    else
+    {
+        glBindVertexBuffer(bindingIndex, vbo.GetHandle(), offset, stride);
+    }
+}
+
+std::shared_ptr<VertexArrayObject> VertexArrayObject::GetShared(std::span<const AttributeFormat> formats)
+{
+    assert(IsSharingSupported());
+
+    // Drop the entries of the VertexArrayObjects already released
+    std::erase_if(s_sharedEntries, [](const SharedEntry& entry) { return entry.vao.expired(); });
+
+    for (const SharedEntry& entry : s_sharedEntries)
+    {
+        if (std::equal(entry.formats.begin(), entry.formats.end(), formats.begin(), formats.end()))
+        {
+            return entry.vao.lock();
+        }
+    }
+
+    // Set the formats once. Meshes using it only attach their buffers
+    std::shared_ptr<VertexArrayObject> vao = std::make_shared<VertexArrayObject>();
+    if (!DeviceGL::HasDirectStateAccess())
+    {
+        vao->Bind();
+    }
+    for (const AttributeFormat& format : formats)
+    {
+        vao->SetAttributeFormat(format);
+    }
+    if (!DeviceGL::HasDirectStateAccess())
+    {
+        Unbind();
+    }
+
+    s_sharedEntries.push_back(SharedEntry{ std::vector<AttributeFormat>(formats.begin(), formats.end()), vao });
+    return vao;
+}
+
+unsigned int VertexArrayObject::GetSharedCount()
+{
+    return static_cast<unsigned int>(std::count_if(s_sharedEntries.begin(), s_sharedEntries.end(),
+        [](const SharedEntry& entry) { return !entry.vao.expired(); }));
+}
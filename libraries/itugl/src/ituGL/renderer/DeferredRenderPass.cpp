@@ -11,6 +11,7 @@
 DeferredRenderPass::DeferredRenderPass(std::shared_ptr<Material> material, std::shared_ptr<const FramebufferObject> framebuffer)
     : RenderPass(framebuffer), m_material(material)
 {
+    SetName("Deferred lighting");
     InitializeMeshes();
 }
 
@@ -25,7 +26,7 @@ void DeferredRenderPass::Render()
 
     assert(m_material);
     m_material->Use();
-    std::shared_ptr<const ShaderProgram> shaderProgram = m_material->GetShaderProgram();
+    std::shared_ptr<const ShaderProgram> shaderProgram = m_material->GetVariant();
 
     // Our fullscreen triangle is directly in clip coordinates.
     // Use the inverse view proj matrix to cancel view projection from the camera
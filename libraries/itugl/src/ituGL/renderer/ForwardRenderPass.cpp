@@ -13,6 +13,7 @@ ForwardRenderPass::ForwardRenderPass()
 ForwardRenderPass::ForwardRenderPass(int drawcallCollectionIndex)
     : m_drawcallCollectionIndex(drawcallCollectionIndex)
 {
+    SetName("Forward");
 }
 
 void ForwardRenderPass::Render()
@@ -29,7 +30,7 @@ void ForwardRenderPass::Render()
         // Prepare drawcall states
         renderer.PrepareDrawcall(drawcallInfo);
 
-        std::shared_ptr<const ShaderProgram> shaderProgram = drawcallInfo.material.GetShaderProgram();
+        std::shared_ptr<const ShaderProgram> shaderProgram = drawcallInfo.material.GetVariant();
 
         //for all lights
         bool first = true;
@@ -0,0 +1,699 @@
+#include <ituGL/renderer/FrameCapture.h>
+
+#include <ituGL/renderer/Renderer.h>
+#include <ituGL/renderer/RenderPass.h>
+#include <ituGL/asset/AssetRegistry.h>
+#include <ituGL/camera/Camera.h>
+#include <ituGL/core/DeviceGL.h>
+#include <ituGL/geometry/Mesh.h>
+#include <ituGL/lighting/PointLight.h>
+#include <ituGL/lighting/SpotLight.h>
+#include <ituGL/shader/Material.h>
+#include <ituGL/shader/ShaderProgram.h>
+#include <fstream>
+#include <type_traits>
+#include <cassert>
+
+static constexpr std::uint32_t s_captureMagic = 0x43465449; // "ITFC"
+static constexpr std::uint32_t s_captureVersion = 1;
+
+// Values of each structure, in the order they are stored. The archive reads, writes or hashes them
+template<typename TArchive> static void Serialize(TArchive& archive, FrameCapture::TextureInfo& info);
+template<typename TArchive> static void Serialize(TArchive& archive, FrameCapture::AttributeInfo& info);
+template<typename TArchive> static void Serialize(TArchive& archive, FrameCapture::SubmeshInfo& info);
+template<typename TArchive> static void Serialize(TArchive& archive, FrameCapture::MeshInfo& info);
+template<typename TArchive> static void Serialize(TArchive& archive, FrameCapture::ProgramInfo& info);
+template<typename TArchive> static void Serialize(TArchive& archive, FrameCapture::VariantInfo& info);
+template<typename TArchive> static void Serialize(TArchive& archive, FrameCapture::PropertyInfo& info);
+template<typename TArchive> static void Serialize(TArchive& archive, FrameCapture::MaterialInfo& info);
+template<typename TArchive> static void Serialize(TArchive& archive, FrameCapture::LightInfo& info);
+template<typename TArchive> static void Serialize(TArchive& archive, FrameCapture::Packet& packet);
+template<typename TArchive> static void Serialize(TArchive& archive, FrameCapture::Frame& frame);
+template<typename TArchive> static void Serialize(TArchive& archive, RenderState::Desc& desc);
+template<typename TArchive> static void Serialize(TArchive& archive, std::string& value);
+template<typename TArchive> static void Serialize(TArchive& archive, std::vector<std::byte>& value);
+template<typename TArchive> static void Serialize(TArchive& archive, glm::mat4& value);
+
+// Writes the values to a stream, or only hashes them if there is no stream
+class FrameCaptureWriter
+{
+public:
+    FrameCaptureWriter(std::ostream* stream) : m_stream(stream), m_hash(AssetRegistry::Hash(nullptr, 0)) {}
+
+    template<typename T>
+    void operator()(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        Write(&value, sizeof(T));
+    }
+
+    // Stored as one byte
+    void operator()(const bool& value)
+    {
+        std::uint8_t byte = value ? 1 : 0;
+        Write(&byte, 1);
+    }
+
+    void operator()(const std::string& value)
+    {
+        (*this)(static_cast<std::uint32_t>(value.size()));
+        Write(value.data(), value.size());
+    }
+
+    void operator()(const std::vector<std::byte>& value)
+    {
+        (*this)(static_cast<std::uint32_t>(value.size()));
+        Write(value.data(), value.size());
+    }
+
+    template<typename T>
+    void operator()(const std::vector<T>& values)
+    {
+        (*this)(static_cast<std::uint32_t>(values.size()));
+        for (const T& value : values)
+        {
+            // Serialize visits the values with non-const references, the writer only reads them
+            Serialize(*this, const_cast<T&>(value));
+        }
+    }
+
+    inline void Fail() {}
+    inline std::uint64_t GetHash() const { return m_hash; }
+
+private:
+    void Write(const void* data, size_t size)
+    {
+        if (m_stream)
+        {
+            m_stream->write(static_cast<const char*>(data), size);
+        }
+        else
+        {
+            m_hash = AssetRegistry::Hash(data, size, m_hash);
+        }
+    }
+
+private:
+    std::ostream* m_stream;
+    std::uint64_t m_hash;
+};
+
+// Reads the values from a stream. Sizes larger than the rest of the file make it invalid, instead of allocating them
+class FrameCaptureReader
+{
+public:
+    FrameCaptureReader(std::istream& stream, size_t size) : m_stream(stream), m_remaining(size), m_valid(true) {}
+
+    template<typename T>
+    void operator()(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        Read(&value, sizeof(T));
+    }
+
+    void operator()(bool& value)
+    {
+        std::uint8_t byte = 0;
+        Read(&byte, 1);
+        value = byte != 0;
+    }
+
+    void operator()(std::string& value)
+    {
+        value.resize(ReadCount());
+        Read(value.data(), value.size());
+    }
+
+    void operator()(std::vector<std::byte>& value)
+    {
+        value.resize(ReadCount());
+        Read(value.data(), value.size());
+    }
+
+    template<typename T>
+    void operator()(std::vector<T>& values)
+    {
+        values.resize(ReadCount());
+        for (T& value : values)
+        {
+            Serialize(*this, value);
+        }
+    }
+
+    inline void Fail() { m_valid = false; }
+    inline bool IsValid() const { return m_valid; }
+
+private:
+    // Every element takes at least one byte
+    std::uint32_t ReadCount()
+    {
+        std::uint32_t count = 0;
+        (*this)(count);
+        if (count > m_remaining)
+        {
+            m_valid = false;
+            count = 0;
+        }
+        return count;
+    }
+
+    void Read(void* data, size_t size)
+    {
+        if (!m_valid || size > m_remaining)
+        {
+            m_valid = false;
+            return;
+        }
+        m_stream.read(static_cast<char*>(data), size);
+        m_remaining -= size;
+        m_valid = static_cast<bool>(m_stream);
+    }
+
+private:
+    std::istream& m_stream;
+    size_t m_remaining;
+    bool m_valid;
+};
+
+template<typename TArchive>
+static void Serialize(TArchive& archive, FrameCapture::TextureInfo& info)
+{
+    archive(info.hash);
+    archive(info.target);
+    archive(info.width);
+    archive(info.height);
+    archive(info.internalFormat);
+    archive(info.levelCount);
+}
+
+template<typename TArchive>
+static void Serialize(TArchive& archive, FrameCapture::AttributeInfo& info)
+{
+    archive(info.vboIndex);
+    archive(info.location);
+    archive(info.type);
+    archive(info.components);
+    archive(info.normalized);
+    archive(info.semantic);
+    archive(info.offset);
+    archive(info.stride);
+}
+
+template<typename TArchive>
+static void Serialize(TArchive& archive, FrameCapture::SubmeshInfo& info)
+{
+    archive(info.primitive);
+    archive(info.first);
+    archive(info.count);
+    archive(info.eboType);
+    archive(info.baseVertex);
+    archive(info.eboIndex);
+    archive(info.attributes);
+}
+
+template<typename TArchive>
+static void Serialize(TArchive& archive, FrameCapture::MeshInfo& info)
+{
+    archive(info.hash);
+    archive(info.vertexBuffers);
+    archive(info.elementBuffers);
+    archive(info.submeshes);
+}
+
+template<typename TArchive>
+static void Serialize(TArchive& archive, FrameCapture::ProgramInfo& info)
+{
+    archive(info.hash);
+    archive(info.binaryFormat);
+    archive(info.binary);
+    archive(info.updateTransforms);
+    archive(info.updateLights);
+}
+
+template<typename TArchive>
+static void Serialize(TArchive& archive, FrameCapture::VariantInfo& info)
+{
+    archive(info.keywordMask);
+    archive(info.programIndex);
+}
+
+template<typename TArchive>
+static void Serialize(TArchive& archive, FrameCapture::PropertyInfo& info)
+{
+    archive(info.name);
+    archive(info.isTexture);
+    archive(info.textureIndex);
+    archive(info.data);
+}
+
+template<typename TArchive>
+static void Serialize(TArchive& archive, FrameCapture::MaterialInfo& info)
+{
+    archive(info.hash);
+    archive(info.programIndex);
+    archive(info.keywords);
+    archive(info.variants);
+    archive(info.keywordMask);
+    Serialize(archive, info.renderState);
+    archive(info.transparent);
+    archive(info.properties);
+}
+
+template<typename TArchive>
+static void Serialize(TArchive& archive, FrameCapture::LightInfo& info)
+{
+    archive(info.type);
+    archive(info.color);
+    archive(info.intensity);
+    archive(info.position);
+    archive(info.direction);
+    archive(info.distanceAttenuation);
+    archive(info.angle);
+    archive(info.angleAttenuation);
+}
+
+template<typename TArchive>
+static void Serialize(TArchive& archive, FrameCapture::Packet& packet)
+{
+    archive(packet.worldMatrixIndex);
+    archive(packet.meshIndex);
+    archive(packet.submeshIndex);
+    archive(packet.materialIndex);
+}
+
+template<typename TArchive>
+static void Serialize(TArchive& archive, FrameCapture::Frame& frame)
+{
+    archive(frame.viewMatrix);
+    archive(frame.projectionMatrix);
+    archive(frame.lights);
+    archive(frame.worldMatrices);
+    archive(frame.packets);
+    archive(frame.passNames);
+}
+
+// Field by field, so the padding is not stored
+template<typename TArchive>
+static void Serialize(TArchive& archive, RenderState::Desc& desc)
+{
+    archive(desc.depthTestFunction);
+    archive(desc.depthWrite);
+    archive(desc.stencilTestFunctions);
+    archive(desc.stencilRefValues);
+    archive(desc.stencilMasks);
+    archive(desc.stencilFail);
+    archive(desc.stencilDepthFail);
+    archive(desc.stencilDepthPass);
+    archive(desc.blendEquations);
+    archive(desc.blendParams);
+    archive(desc.blendColor);
+}
+
+template<typename TArchive>
+static void Serialize(TArchive& archive, std::string& value)
+{
+    archive(value);
+}
+
+template<typename TArchive>
+static void Serialize(TArchive& archive, std::vector<std::byte>& value)
+{
+    archive(value);
+}
+
+template<typename TArchive>
+static void Serialize(TArchive& archive, glm::mat4& value)
+{
+    archive(value);
+}
+
+// Hash of the values of an asset, with its hash field set to 0
+template<typename TInfo>
+static std::uint64_t ComputeHash(TInfo& info, std::uint64_t seed = 0)
+{
+    info.hash = 0;
+    FrameCaptureWriter hasher(nullptr);
+    hasher(seed);
+    Serialize(hasher, info);
+    return hasher.GetHash();
+}
+
+// Check that all the indices point to elements of the tables
+static bool HasValidIndices(const FrameCapture& capture)
+{
+    size_t textureCount = capture.GetTextures().size();
+    size_t programCount = capture.GetPrograms().size();
+    for (const FrameCapture::MeshInfo& mesh : capture.GetMeshes())
+    {
+        for (const FrameCapture::SubmeshInfo& submesh : mesh.submeshes)
+        {
+            if (submesh.eboIndex >= static_cast<int>(mesh.elementBuffers.size()))
+                return false;
+            for (const FrameCapture::AttributeInfo& attribute : submesh.attributes)
+            {
+                if (attribute.vboIndex >= mesh.vertexBuffers.size())
+                    return false;
+            }
+        }
+    }
+    for (const FrameCapture::MaterialInfo& material : capture.GetMaterials())
+    {
+        if (material.programIndex >= programCount)
+            return false;
+        for (const FrameCapture::VariantInfo& variant : material.variants)
+        {
+            if (variant.programIndex >= programCount)
+                return false;
+        }
+        for (const FrameCapture::PropertyInfo& property : material.properties)
+        {
+            if (property.textureIndex >= static_cast<int>(textureCount))
+                return false;
+        }
+    }
+    for (const FrameCapture::Frame& frame : capture.GetFrames())
+    {
+        for (const FrameCapture::Packet& packet : frame.packets)
+        {
+            if (packet.worldMatrixIndex >= frame.worldMatrices.size()
+                || packet.meshIndex >= capture.GetMeshes().size()
+                || packet.submeshIndex >= capture.GetMeshes()[packet.meshIndex].submeshes.size()
+                || packet.materialIndex >= capture.GetMaterials().size())
+                return false;
+        }
+    }
+    return true;
+}
+
+FrameCapture::FrameCapture() : m_remainingFrames(0), m_skippedPacketCount(0)
+{
+}
+
+void FrameCapture::Start(unsigned int frameCount)
+{
+    m_remainingFrames = frameCount;
+    m_assetIndices.clear();
+}
+
+void FrameCapture::Clear()
+{
+    m_remainingFrames = 0;
+    m_skippedPacketCount = 0;
+    m_frames.clear();
+    m_textures.clear();
+    m_meshes.clear();
+    m_programs.clear();
+    m_materials.clear();
+    m_assetIndices.clear();
+}
+
+bool FrameCapture::Save(const char* path) const
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        return false;
+    }
+
+    FrameCaptureWriter writer(&file);
+    // Serialize visits the values with non-const references, the writer only reads them
+    const_cast<FrameCapture*>(this)->Serialize(writer);
+    return static_cast<bool>(file);
+}
+
+bool FrameCapture::Load(const char* path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        return false;
+    }
+    size_t size = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+
+    FrameCapture capture;
+    FrameCaptureReader reader(file, size);
+    capture.Serialize(reader);
+    if (!reader.IsValid() || !HasValidIndices(capture))
+    {
+        return false;
+    }
+
+    *this = std::move(capture);
+    return true;
+}
+
+template<typename TArchive>
+void FrameCapture::Serialize(TArchive& archive)
+{
+    std::uint32_t magic = s_captureMagic;
+    std::uint32_t version = s_captureVersion;
+    archive(magic);
+    archive(version);
+    if (magic != s_captureMagic || version != s_captureVersion)
+    {
+        archive.Fail();
+        return;
+    }
+
+    archive(m_textures);
+    archive(m_meshes);
+    archive(m_programs);
+    archive(m_materials);
+    archive(m_frames);
+    archive(m_skippedPacketCount);
+}
+
+void FrameCapture::AddFrame(const Renderer& renderer)
+{
+    assert(IsCapturing());
+
+    Frame& frame = m_frames.emplace_back();
+
+    const Camera& camera = renderer.GetCurrentCamera();
+    frame.viewMatrix = camera.GetViewMatrix();
+    frame.projectionMatrix = camera.GetProjectionMatrix();
+
+    for (const Light* light : renderer.m_lights)
+    {
+        LightInfo& lightInfo = frame.lights.emplace_back();
+        lightInfo.type = light->GetType();
+        lightInfo.color = light->GetColor();
+        lightInfo.intensity = light->GetIntensity();
+        lightInfo.position = light->GetPosition();
+        lightInfo.direction = light->GetDirection();
+        lightInfo.distanceAttenuation = glm::vec2(0.0f);
+        lightInfo.angle = 0.0f;
+        lightInfo.angleAttenuation = glm::vec2(0.0f);
+        if (lightInfo.type == Light::Type::Point)
+        {
+            lightInfo.distanceAttenuation = static_cast<const PointLight*>(light)->GetDistanceAttenuation();
+        }
+        else if (lightInfo.type == Light::Type::Spot)
+        {
+            const SpotLight* spotLight = static_cast<const SpotLight*>(light);
+            lightInfo.distanceAttenuation = spotLight->GetDistanceAttenuation();
+            lightInfo.angle = spotLight->GetAngle();
+            lightInfo.angleAttenuation = spotLight->GetAngleAttenuation();
+        }
+    }
+
+    frame.worldMatrices = renderer.m_worldMatrices;
+
+    for (const std::unique_ptr<RenderPass>& pass : renderer.m_passes)
+    {
+        frame.passNames.push_back(pass->GetName());
+    }
+
+    // Every collection gets all the drawcalls added, in the same order
+    for (const Renderer::DrawcallInfo& drawcallInfo : renderer.GetDrawcalls(0))
+    {
+        int meshIndex = AddMesh(drawcallInfo.mesh);
+        int materialIndex = AddMaterial(drawcallInfo.material, renderer);
+        if (meshIndex < 0 || materialIndex < 0 || m_meshes[meshIndex].submeshes[drawcallInfo.submeshIndex].attributes.empty())
+        {
+            ++m_skippedPacketCount;
+            continue;
+        }
+        frame.packets.push_back(Packet{ drawcallInfo.worldMatrixIndex, static_cast<unsigned int>(meshIndex), drawcallInfo.submeshIndex, static_cast<unsigned int>(materialIndex) });
+    }
+
+    if (--m_remainingFrames == 0)
+    {
+        m_assetIndices.clear();
+    }
+}
+
+int FrameCapture::AddTexture(const TextureObject& texture)
+{
+    auto itAsset = m_assetIndices.find(&texture);
+    if (itAsset != m_assetIndices.end())
+    {
+        return itAsset->second;
+    }
+
+    if (!DeviceGL::HasDirectStateAccess())
+    {
+        texture.Bind();
+    }
+
+    TextureInfo info;
+    info.target = texture.GetTarget();
+    texture.GetLevelInfo(0, info.width, info.height, info.internalFormat);
+    info.levelCount = 0;
+    for (GLint width = info.width, height = info.height, internalFormat; width > 0; )
+    {
+        ++info.levelCount;
+        texture.GetLevelInfo(info.levelCount, width, height, internalFormat);
+    }
+
+    // The contents are not captured, the handle tells apart textures with the same description
+    info.hash = ComputeHash(info, texture.GetHandle());
+    int index = static_cast<int>(m_textures.size());
+    m_textures.push_back(info);
+
+    m_assetIndices[&texture] = index;
+    return index;
+}
+
+int FrameCapture::AddMesh(const Mesh& mesh)
+{
+    auto itAsset = m_assetIndices.find(&mesh);
+    if (itAsset != m_assetIndices.end())
+    {
+        return itAsset->second;
+    }
+
+    MeshInfo info;
+    bool directStateAccess = DeviceGL::HasDirectStateAccess();
+    for (unsigned int vboIndex = 0; vboIndex < mesh.GetVertexBufferCount(); ++vboIndex)
+    {
+        const VertexBufferObject& vbo = mesh.GetVertexBuffer(vboIndex);
+        std::vector<std::byte>& data = info.vertexBuffers.emplace_back(vbo.GetSize());
+        if (!directStateAccess)
+        {
+            vbo.Bind();
+        }
+        vbo.ReadData(data);
+    }
+    if (!directStateAccess)
+    {
+        // Binding the EBO would attach it to the VAO currently bound
+        VertexArrayObject::Unbind();
+    }
+    for (unsigned int eboIndex = 0; eboIndex < mesh.GetElementBufferCount(); ++eboIndex)
+    {
+        const ElementBufferObject& ebo = mesh.GetElementBuffer(eboIndex);
+        std::vector<std::byte>& data = info.elementBuffers.emplace_back(ebo.GetSize());
+        if (!directStateAccess)
+        {
+            ebo.Bind();
+        }
+        ebo.ReadData(data);
+    }
+
+    for (unsigned int submeshIndex = 0; submeshIndex < mesh.GetSubmeshCount(); ++submeshIndex)
+    {
+        const Drawcall& drawcall = mesh.GetSubmeshDrawcall(submeshIndex);
+        SubmeshInfo& submesh = info.submeshes.emplace_back();
+        submesh.primitive = drawcall.GetPrimitive();
+        submesh.first = drawcall.GetFirst();
+        submesh.count = drawcall.GetCount();
+        submesh.eboType = drawcall.GetEboType();
+        submesh.baseVertex = drawcall.GetBaseVertex();
+        submesh.eboIndex = mesh.GetSubmeshElementBufferIndex(submeshIndex);
+        for (const Mesh::AttributeBinding& binding : mesh.GetSubmeshAttributes(submeshIndex))
+        {
+            const VertexAttribute& attribute = binding.layout.GetAttribute();
+            submesh.attributes.push_back(AttributeInfo{ binding.vboIndex, binding.location,
+                attribute.GetType(), attribute.GetComponents(), attribute.IsNormalized(), attribute.GetSemantic(),
+                binding.layout.GetOffset(), binding.layout.GetStride() });
+        }
+    }
+
+    info.hash = ComputeHash(info);
+    int index = static_cast<int>(m_meshes.size());
+    m_meshes.push_back(std::move(info));
+
+    m_assetIndices[&mesh] = index;
+    return index;
+}
+
+int FrameCapture::AddProgram(const std::shared_ptr<const ShaderProgram>& shaderProgram, const Renderer& renderer)
+{
+    auto itAsset = m_assetIndices.find(shaderProgram.get());
+    if (itAsset != m_assetIndices.end())
+    {
+        return itAsset->second;
+    }
+
+    // Programs without binary can't be replayed, their drawcalls are skipped
+    int index = -1;
+    ProgramInfo info;
+    if (shaderProgram->GetBinary(info.binaryFormat, info.binary))
+    {
+        info.updateTransforms = renderer.m_updateTransformsFunctions.contains(shaderProgram);
+        info.updateLights = renderer.m_updateLightsFunctions.contains(shaderProgram);
+
+        info.hash = ComputeHash(info);
+        index = static_cast<int>(m_programs.size());
+        m_programs.push_back(std::move(info));
+    }
+
+    m_assetIndices[shaderProgram.get()] = index;
+    return index;
+}
+
+int FrameCapture::AddMaterial(const Material& material, const Renderer& renderer)
+{
+    auto itAsset = m_assetIndices.find(&material);
+    if (itAsset != m_assetIndices.end())
+    {
+        return itAsset->second;
+    }
+
+    MaterialInfo info;
+    int programIndex = AddProgram(material.GetShaderProgram(), renderer);
+    info.programIndex = static_cast<unsigned int>(programIndex);
+    info.keywordMask = 0;
+    if (std::shared_ptr<ShaderProgramVariants> shaderVariants = material.GetShaderVariants())
+    {
+        info.keywords = shaderVariants->GetKeywords();
+        for (unsigned int keywordIndex = 0; keywordIndex < info.keywords.size(); ++keywordIndex)
+        {
+            if (material.IsKeywordEnabled(info.keywords[keywordIndex]))
+            {
+                info.keywordMask |= 1u << keywordIndex;
+            }
+        }
+        for (const auto& variant : shaderVariants->GetVariants())
+        {
+            int variantProgramIndex = AddProgram(variant.second, renderer);
+            if (variantProgramIndex >= 0)
+            {
+                info.variants.push_back(VariantInfo{ variant.first, static_cast<unsigned int>(variantProgramIndex) });
+            }
+        }
+    }
+    info.renderState = material.GetRenderState().GetDesc();
+    info.transparent = material.GetTransparency();
+
+    std::vector<ShaderUniformCollection::PropertyValue> values;
+    material.GetPropertyValues(values);
+    for (ShaderUniformCollection::PropertyValue& value : values)
+    {
+        int textureIndex = value.texture ? AddTexture(*value.texture) : -1;
+        info.properties.push_back(PropertyInfo{ std::move(value.name), value.isTexture, textureIndex, std::move(value.data) });
+    }
+
+    int index = -1;
+    if (programIndex >= 0)
+    {
+        info.hash = ComputeHash(info);
+        index = static_cast<int>(m_materials.size());
+        m_materials.push_back(std::move(info));
+    }
+
+    m_assetIndices[&material] = index;
+    return index;
+}
@@ -10,6 +10,11 @@
 GBufferCopyPass::GBufferCopyPass(std::shared_ptr<Material> material, std::shared_ptr<const FramebufferObject> framebuffer)
     : RenderPass(framebuffer), m_material(material)
 {
+    SetName("GBuffer copy");
+
+    RenderState::Desc renderStateDesc;
+    renderStateDesc.depthTestFunction = RenderState::TestFunction::Always;
+    m_renderState = RenderState::Get(renderStateDesc);
 }
 
 void GBufferCopyPass::Render()
@@ -20,11 +25,8 @@ void GBufferCopyPass::Render()
     m_material->Use();
     const Mesh* mesh = &renderer.GetFullscreenMesh();
 
-    // Set to always so we write directly to depth buffer
-    glDepthFunc(GL_ALWAYS);
-    
-    mesh->DrawSubmesh(0);
+    // Set to always so we write directly to depth buffer. The next material sets its own depth function
+    renderer.GetDevice().SetRenderState(*m_renderState, RenderState::DepthFunction);
 
-    // Reset depth function to default
-    glDepthFunc(GL_LESS);
+    mesh->DrawSubmesh(0);
 }
@@ -5,12 +5,14 @@
 #include <ituGL/geometry/VertexArrayObject.h>
 #include <ituGL/renderer/Renderer.h>
 #include <ituGL/texture/Texture2DObject.h>
+#include <ituGL/texture/SamplerObject.h>
 #include <ituGL/texture/FramebufferObject.h>
 
 GBufferRenderPass::GBufferRenderPass(int width, int height, int drawcallCollectionIndex)
     : m_drawcallCollectionIndex(drawcallCollectionIndex)
     , m_transparencyPass(false)
 {
+    SetName("GBuffer");
     InitTextures(width, height);
     InitFramebuffer();
 }
@@ -19,6 +21,7 @@ GBufferRenderPass::GBufferRenderPass(std::shared_ptr<const FramebufferObject> fr
     : m_drawcallCollectionIndex(drawcallCollectionIndex)
     , m_transparencyPass(transparencyPass)
 {
+    SetName(transparencyPass ? "GBuffer transparent" : "GBuffer");
     m_targetFramebuffer = framebuffer;
 }
 
@@ -54,33 +57,29 @@ void GBufferRenderPass::InitFramebuffer()
 
 void GBufferRenderPass::InitTextures(int width, int height)
 {
-    // Depth: Set the min and magfilter as nearest
+    // Depth: Use the nearest sampler
     m_depthTexture = std::make_shared<Texture2DObject>();
     m_depthTexture->Bind();
     m_depthTexture->SetImage(0, width, height, TextureObject::FormatDepth, TextureObject::InternalFormatDepth);
-    m_depthTexture->SetParameter(TextureObject::ParameterEnum::MinFilter, GL_NEAREST);
-    m_depthTexture->SetParameter(TextureObject::ParameterEnum::MagFilter, GL_NEAREST);
+    m_depthTexture->SetSampler(SamplerObject::GetPreset(SamplerObject::Preset::NearestClamp));
 
-    // Albedo: Bind the newly created texture, set the image, and the min and magfilter as nearest
+    // Albedo: Bind the newly created texture, set the image, and use the nearest sampler
     m_albedoTexture = std::make_shared<Texture2DObject>();
     m_albedoTexture->Bind();
     m_albedoTexture->SetImage(0, width, height, TextureObject::FormatRGBA, TextureObject::InternalFormatSRGBA8);
-    m_albedoTexture->SetParameter(TextureObject::ParameterEnum::MinFilter, GL_NEAREST);
-    m_albedoTexture->SetParameter(TextureObject::ParameterEnum::MagFilter, GL_NEAREST);
+    m_albedoTexture->SetSampler(SamplerObject::GetPreset(SamplerObject::Preset::NearestClamp));
 
-    // Normal: Bind the newly created texture, set the image and the min and magfilter as nearest
+    // Normal: Bind the newly created texture, set the image and use the nearest sampler
     m_normalTexture = std::make_shared<Texture2DObject>();
     m_normalTexture->Bind();
     m_normalTexture->SetImage(0, width, height, TextureObject::FormatRG, TextureObject::InternalFormatRG16F);
-    m_normalTexture->SetParameter(TextureObject::ParameterEnum::MinFilter, GL_NEAREST);
-    m_normalTexture->SetParameter(TextureObject::ParameterEnum::MagFilter, GL_NEAREST);
+    m_normalTexture->SetSampler(SamplerObject::GetPreset(SamplerObject::Preset::NearestClamp));
 
-    // Others: Bind the newly created texture, set the image and the min and magfilter as nearest
+    // Others: Bind the newly created texture, set the image and use the nearest sampler
     m_othersTexture = std::make_shared<Texture2DObject>();
     m_othersTexture->Bind();
     m_othersTexture->SetImage(0, width, height, TextureObject::FormatRGBA, TextureObject::InternalFormatSRGBA8);
-    m_othersTexture->SetParameter(TextureObject::ParameterEnum::MinFilter, GL_NEAREST);
-    m_othersTexture->SetParameter(TextureObject::ParameterEnum::MagFilter, GL_NEAREST);
+    m_othersTexture->SetSampler(SamplerObject::GetPreset(SamplerObject::Preset::NearestClamp));
 
     Texture2DObject::Unbind();
 }
@@ -10,6 +10,7 @@
 PostFXRenderPass::PostFXRenderPass(std::shared_ptr<Material> material, std::shared_ptr<const FramebufferObject> framebuffer)
     : RenderPass(framebuffer), m_material(material)
 {
+    SetName("PostFX");
 }
 
 void PostFXRenderPass::Render()
@@ -23,7 +24,7 @@ void PostFXRenderPass::Render()
     //Lets make sure to update the camera projections
     const Camera& camera = renderer.GetCurrentCamera();
     glm::mat4 fullscreenMatrix = glm::inverse(camera.GetViewProjectionMatrix());
-    renderer.UpdateTransforms(m_material->GetShaderProgram(), fullscreenMatrix, true);
+    renderer.UpdateTransforms(m_material->GetVariant(), fullscreenMatrix, true);
 
     mesh->DrawSubmesh(0);
 }
@@ -1,11 +1,13 @@
 #include <ituGL/renderer/RenderPass.h>
 
 #include <ituGL/renderer/Renderer.h>
+#include <ituGL/core/CpuProfiler.h>
 #include <cassert>
 
 RenderPass::RenderPass(std::shared_ptr<const FramebufferObject> targetFramebuffer)
     : m_renderer(nullptr)
     , m_targetFramebuffer(targetFramebuffer)
+    , m_profilerZoneName("RenderPass")
 {
 }
 
@@ -18,6 +20,22 @@ std::shared_ptr<const FramebufferObject> RenderPass::GetTargetFramebuffer() cons
     return m_targetFramebuffer;
 }
 
+const std::string& RenderPass::GetName() const
+{
+    return m_name;
+}
+
+void RenderPass::SetName(const std::string& name)
+{
+    m_name = name;
+    m_profilerZoneName = CpuProfiler::GetInstance().InternName(name);
+}
+
+const char* RenderPass::GetProfilerZoneName() const
+{
+    return m_profilerZoneName;
+}
+
 void RenderPass::SetRenderer(Renderer* renderer)
 {
     m_renderer = renderer;
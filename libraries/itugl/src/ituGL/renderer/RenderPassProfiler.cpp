@@ -0,0 +1,343 @@
+#include <ituGL/renderer/RenderPassProfiler.h>
+
+#include <ituGL/utils/DearImGui.h>
+#include <imgui.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+
+RenderPassProfiler::RenderPassProfiler()
+    : m_enabled(true)
+    , m_frameIndex(0)
+    , m_historySize(DefaultHistorySize)
+    , m_droppedFrames(0)
+{
+}
+
+RenderPassProfiler::~RenderPassProfiler()
+{
+    for (FrameQueries& frame : m_frames)
+    {
+        if (!frame.queries.empty())
+        {
+            glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+        }
+    }
+}
+
+void RenderPassProfiler::BeginFrame()
+{
+    CollectResults();
+
+    // If the GPU is still behind, the results of the oldest frame are lost when its queries are issued again
+    m_frameIndex = (m_frameIndex + 1) % FrameLatency;
+    FrameQueries& frame = m_frames[m_frameIndex];
+    if (frame.pending)
+    {
+        frame.pending = false;
+        ++m_droppedFrames;
+    }
+    frame.passCount = 0;
+}
+
+void RenderPassProfiler::EndFrame()
+{
+    FrameQueries& frame = m_frames[m_frameIndex];
+    frame.pending = frame.passCount > 0;
+}
+
+void RenderPassProfiler::BeginPass(unsigned int passIndex, const std::string& name)
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+
+    while (passIndex >= m_passes.size())
+    {
+        PassTimes& pass = m_passes.emplace_back();
+        pass.gpuTimes.SetCapacity(m_historySize);
+        pass.cpuTimes.SetCapacity(m_historySize);
+    }
+    if (m_passes[passIndex].name != name)
+    {
+        m_passes[passIndex].name = name;
+    }
+
+    // Queries are created the first time a frame measures this many passes
+    FrameQueries& frame = m_frames[m_frameIndex];
+    if (passIndex >= frame.queries.size())
+    {
+        size_t queryCount = frame.queries.size();
+        frame.queries.resize(passIndex + 1);
+        glGenQueries(static_cast<GLsizei>(frame.queries.size() - queryCount), frame.queries.data() + queryCount);
+    }
+
+    // Passes are measured in order, so the results of a frame are available once its last query is
+    assert(passIndex >= frame.passCount);
+    frame.passCount = passIndex + 1;
+
+    glBeginQuery(GL_TIME_ELAPSED, frame.queries[passIndex]);
+    m_passStart = std::chrono::steady_clock::now();
+}
+
+void RenderPassProfiler::EndPass(unsigned int passIndex)
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+
+    std::chrono::duration<float, std::milli> cpuTime = std::chrono::steady_clock::now() - m_passStart;
+    glEndQuery(GL_TIME_ELAPSED);
+
+    assert(passIndex < m_passes.size());
+    m_passes[passIndex].cpuTimes.Add(cpuTime.count());
+}
+
+void RenderPassProfiler::CollectResults(bool wait)
+{
+    // Check the frames from the oldest one
+    for (unsigned int i = 1; i <= FrameLatency; ++i)
+    {
+        FrameQueries& frame = m_frames[(m_frameIndex + i) % FrameLatency];
+        if (!frame.pending)
+        {
+            continue;
+        }
+
+        // Reading the result directly waits for it
+        GLuint available = wait ? GL_TRUE : GL_FALSE;
+        if (!wait)
+        {
+            glGetQueryObjectuiv(frame.queries[frame.passCount - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        }
+        if (!available)
+        {
+            // Newer frames can't be ready either
+            break;
+        }
+
+        for (unsigned int passIndex = 0; passIndex < frame.passCount; ++passIndex)
+        {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(frame.queries[passIndex], GL_QUERY_RESULT, &elapsed);
+            m_passes[passIndex].gpuTimes.Add(static_cast<float>(elapsed) * 1.0e-6f);
+        }
+        frame.pending = false;
+    }
+}
+
+void RenderPassProfiler::SetHistorySize(unsigned int historySize)
+{
+    assert(historySize > 0);
+    m_historySize = historySize;
+    for (PassTimes& pass : m_passes)
+    {
+        pass.gpuTimes.SetCapacity(m_historySize);
+        pass.cpuTimes.SetCapacity(m_historySize);
+    }
+}
+
+void RenderPassProfiler::WaitForResults()
+{
+    CollectResults(true);
+}
+
+void RenderPassProfiler::Clear()
+{
+    for (PassTimes& pass : m_passes)
+    {
+        pass.gpuTimes.Clear();
+        pass.cpuTimes.Clear();
+    }
+    m_droppedFrames = 0;
+}
+
+bool RenderPassProfiler::ExportCsv(const char* path) const
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        return false;
+    }
+
+    // GPU samples arrive some frames later, so a pass can have fewer GPU samples than CPU samples
+    file << "pass,name,sample,gpu_ms,cpu_ms\n";
+    for (unsigned int passIndex = 0; passIndex < m_passes.size(); ++passIndex)
+    {
+        const PassTimes& pass = m_passes[passIndex];
+        unsigned int sampleCount = std::max(pass.gpuTimes.GetCount(), pass.cpuTimes.GetCount());
+        for (unsigned int sample = 0; sample < sampleCount; ++sample)
+        {
+            file << passIndex << ",\"" << pass.name << "\"," << sample << ",";
+            if (sample < pass.gpuTimes.GetCount())
+            {
+                file << pass.gpuTimes.GetSample(sample);
+            }
+            file << ",";
+            if (sample < pass.cpuTimes.GetCount())
+            {
+                file << pass.cpuTimes.GetSample(sample);
+            }
+            file << "\n";
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+void RenderPassProfiler::DrawGUI(DearImGui& imGui)
+{
+    if (auto window = imGui.UseWindow("Render Passes"))
+    {
+        ImGui::Checkbox("Enabled", &m_enabled);
+        ImGui::SameLine();
+        if (ImGui::Button("Clear"))
+        {
+            Clear();
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Export CSV"))
+        {
+            const char* path = "render_passes.csv";
+            m_exportStatus = ExportCsv(path) ? std::string("Saved ") + path : std::string("Could not write ") + path;
+        }
+        if (!m_exportStatus.empty())
+        {
+            ImGui::TextUnformatted(m_exportStatus.c_str());
+        }
+        ImGui::Text("Dropped frames: %u", m_droppedFrames);
+
+        std::vector<Summary> gpuSummaries;
+        std::vector<Summary> cpuSummaries;
+        float gpuTotal = 0.0f;
+        float cpuTotal = 0.0f;
+        for (unsigned int passIndex = 0; passIndex < m_passes.size(); ++passIndex)
+        {
+            gpuSummaries.push_back(GetGpuSummary(passIndex));
+            cpuSummaries.push_back(GetCpuSummary(passIndex));
+            gpuTotal += gpuSummaries.back().avg;
+            cpuTotal += cpuSummaries.back().avg;
+        }
+
+        // Timeline of the frame, with the average GPU time of each pass
+        ImVec2 barPosition = ImGui::GetCursorScreenPos();
+        ImVec2 barSize(std::max(ImGui::GetContentRegionAvail().x, 1.0f), ImGui::GetFrameHeight());
+        ImGui::InvisibleButton("Timeline", barSize);
+        bool barHovered = ImGui::IsItemHovered();
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        drawList->AddRectFilled(barPosition, ImVec2(barPosition.x + barSize.x, barPosition.y + barSize.y), ImGui::GetColorU32(ImGuiCol_FrameBg));
+        float x = barPosition.x;
+        for (unsigned int passIndex = 0; gpuTotal > 0.0f && passIndex < m_passes.size(); ++passIndex)
+        {
+            float width = barSize.x * gpuSummaries[passIndex].avg / gpuTotal;
+            ImVec2 min(x, barPosition.y);
+            ImVec2 max(x + width, barPosition.y + barSize.y);
+            ImColor color = ImColor::HSV(std::fmod(passIndex * 0.13f, 1.0f), 0.6f, 0.8f);
+            drawList->AddRectFilled(min, max, color);
+            if (barHovered && ImGui::IsMouseHoveringRect(min, max))
+            {
+                ImGui::SetTooltip("%s: %.3f ms", m_passes[passIndex].name.c_str(), gpuSummaries[passIndex].avg);
+            }
+            x += width;
+        }
+
+        if (ImGui::BeginTable("Passes", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+        {
+            ImGui::TableSetupColumn("Pass");
+            ImGui::TableSetupColumn("GPU ms");
+            ImGui::TableSetupColumn("GPU min");
+            ImGui::TableSetupColumn("GPU p99");
+            ImGui::TableSetupColumn("CPU ms");
+            ImGui::TableSetupColumn("CPU min");
+            ImGui::TableSetupColumn("CPU p99");
+            ImGui::TableHeadersRow();
+            for (unsigned int passIndex = 0; passIndex < m_passes.size(); ++passIndex)
+            {
+                const Summary& gpu = gpuSummaries[passIndex];
+                const Summary& cpu = cpuSummaries[passIndex];
+                ImGui::TableNextColumn();
+                ImGui::Text("%u %s", passIndex, m_passes[passIndex].name.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", gpu.avg);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", gpu.min);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", gpu.p99);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", cpu.avg);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", cpu.min);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", cpu.p99);
+            }
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted("Total");
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", gpuTotal);
+            ImGui::TableNextColumn();
+            ImGui::TableNextColumn();
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", cpuTotal);
+            ImGui::TableNextColumn();
+            ImGui::TableNextColumn();
+            ImGui::EndTable();
+        }
+    }
+}
+
+void RenderPassProfiler::History::Add(float value)
+{
+    unsigned int capacity = static_cast<unsigned int>(m_values.size());
+    m_values[m_next] = value;
+    m_next = (m_next + 1) % capacity;
+    m_count = std::min(m_count + 1, capacity);
+}
+
+void RenderPassProfiler::History::Clear()
+{
+    m_count = 0;
+    m_next = 0;
+}
+
+void RenderPassProfiler::History::SetCapacity(unsigned int capacity)
+{
+    m_values.assign(capacity, 0.0f);
+    Clear();
+}
+
+float RenderPassProfiler::History::GetSample(unsigned int index) const
+{
+    assert(index < m_count);
+    unsigned int capacity = static_cast<unsigned int>(m_values.size());
+    return m_values[(m_next + capacity - m_count + index) % capacity];
+}
+
+RenderPassProfiler::Summary RenderPassProfiler::History::GetSummary() const
+{
+    Summary summary;
+    if (m_count == 0)
+    {
+        return summary;
+    }
+
+    std::vector<float> sorted(m_count);
+    float sum = 0.0f;
+    for (unsigned int i = 0; i < m_count; ++i)
+    {
+        sorted[i] = GetSample(i);
+        sum += sorted[i];
+    }
+
+    // Nearest rank percentile
+    unsigned int p99Index = static_cast<unsigned int>(std::ceil(0.99f * m_count)) - 1;
+    std::nth_element(sorted.begin(), sorted.begin() + p99Index, sorted.end());
+
+    summary.last = GetSample(m_count - 1);
+    summary.min = *std::min_element(sorted.begin(), sorted.end());
+    summary.avg = sum / m_count;
+    summary.p99 = sorted[p99Index];
+    summary.count = m_count;
+    return summary;
+}
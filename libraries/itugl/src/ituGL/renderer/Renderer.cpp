@@ -9,6 +9,8 @@
 #include <ituGL/lighting/Light.h>
 #include <ituGL/texture/FramebufferObject.h>
 #include <ituGL/renderer/RenderPass.h>
+#include <ituGL/core/CpuProfiler.h>
+#include <ituGL/core/GLInterceptor.h>
 #include <span>
 #include <algorithm>
 #include <cassert>
@@ -22,6 +24,15 @@ Renderer::Renderer(DeviceGL& device)
 {
     InitializeFullscreenMesh();
 
+    // TODO: This should not be hardcoded here
+    RenderState::Desc firstLightDesc;
+    m_firstLightRenderState = RenderState::Get(firstLightDesc);
+    RenderState::Desc additionalLightDesc;
+    additionalLightDesc.depthTestFunction = RenderState::TestFunction::Equal;
+    additionalLightDesc.blendEquations = { RenderState::BlendEquation::Add, RenderState::BlendEquation::Add };
+    additionalLightDesc.blendParams = { RenderState::BlendParam::One, RenderState::BlendParam::One, RenderState::BlendParam::One, RenderState::BlendParam::One };
+    m_additionalLightRenderState = RenderState::Get(additionalLightDesc);
+
     device.EnableFeature(GL_FRAMEBUFFER_SRGB);
     device.EnableFeature(GL_DEPTH_TEST);
     device.EnableFeature(GL_CULL_FACE);
@@ -71,14 +82,34 @@ const Mesh& Renderer::GetFullscreenMesh() const
 
 void Renderer::Render()
 {
+    ITUGL_PROFILE_ZONE("Renderer::Render");
     assert(m_currentCamera);
 
-    for (auto& pass : m_passes)
+    if (m_frameCapture.IsCapturing())
     {
-        SetCurrentFramebuffer(pass->GetTargetFramebuffer());
-        pass->Render();
+        m_frameCapture.AddFrame(*this);
     }
 
+    m_profiler.BeginFrame();
+    for (unsigned int passIndex = 0; passIndex < m_passes.size(); ++passIndex)
+    {
+        RenderPass& pass = *m_passes[passIndex];
+        ITUGL_PROFILE_ZONE(pass.GetProfilerZoneName());
+        m_profiler.BeginPass(passIndex, pass.GetName());
+        if (GLInterceptor::IsEnabled())
+        {
+            GLInterceptor::GetInstance().BeginPass(pass.GetName());
+        }
+        SetCurrentFramebuffer(pass.GetTargetFramebuffer());
+        pass.Render();
+        if (GLInterceptor::IsEnabled())
+        {
+            GLInterceptor::GetInstance().EndPass();
+        }
+        m_profiler.EndPass(passIndex);
+    }
+    m_profiler.EndFrame();
+
     Reset();
 }
 
@@ -86,6 +117,9 @@ void Renderer::Reset()
 {
     m_lights.clear();
 
+    // The drawcalls of the next frame index the world matrices from the start again
+    m_worldMatrices.clear();
+
     for (auto& collection : m_drawcallCollections)
     {
         collection.clear();
@@ -198,46 +232,55 @@ std::span<const Renderer::DrawcallInfo> Renderer::GetDrawcalls(unsigned int coll
 
 void Renderer::AddModel(const Model& model, const glm::mat4& worldMatrix)
 {
-    unsigned int worldMatrixIndex = static_cast<unsigned int>(m_worldMatrices.size());
-    m_worldMatrices.push_back(worldMatrix);
+    unsigned int worldMatrixIndex = AddWorldMatrix(worldMatrix);
 
     const Mesh& mesh = model.GetMesh();
     for (unsigned int submeshIndex = 0; submeshIndex < mesh.GetSubmeshCount(); ++submeshIndex)
     {
-        DrawcallInfo drawcallInfo(model.GetMaterial(submeshIndex), worldMatrixIndex,
-            mesh.GetSubmeshVertexArray(submeshIndex), mesh.GetSubmeshDrawcall(submeshIndex));
+        AddDrawcall(model.GetMaterial(submeshIndex), worldMatrixIndex, mesh, submeshIndex);
+    }
+}
 
-        for (DrawcallCollection& collection : m_drawcallCollections)
-        {
-            collection.push_back(drawcallInfo);
-        }
+unsigned int Renderer::AddWorldMatrix(const glm::mat4& worldMatrix)
+{
+    unsigned int worldMatrixIndex = static_cast<unsigned int>(m_worldMatrices.size());
+    m_worldMatrices.push_back(worldMatrix);
+    return worldMatrixIndex;
+}
+
+void Renderer::AddDrawcall(const Material& material, unsigned int worldMatrixIndex, const Mesh& mesh, unsigned int submeshIndex)
+{
+    assert(worldMatrixIndex < m_worldMatrices.size());
+    DrawcallInfo drawcallInfo(material, worldMatrixIndex, mesh, submeshIndex);
+
+    for (DrawcallCollection& collection : m_drawcallCollections)
+    {
+        collection.push_back(drawcallInfo);
     }
 }
 
-void Renderer::PrepareDrawcall(const DrawcallInfo& drawcallInfo)
+void Renderer::PrepareDrawcall(const DrawcallInfo& drawcallInfo, std::span<const std::string> passKeywords)
 {
-    std::shared_ptr<const ShaderProgram> shaderProgram = drawcallInfo.material.GetShaderProgram();
+    std::shared_ptr<const ShaderProgram> shaderProgram = drawcallInfo.material.GetVariant(passKeywords);
 
     // TODO: Room for optimization here, caching current material, current worldMatrixIndex and current VAO
 
     // Setup material
-    drawcallInfo.material.Use();
+    drawcallInfo.material.Use(passKeywords);
 
     // Setup world matrix
     // Setup camera
     UpdateTransforms(shaderProgram, drawcallInfo.worldMatrixIndex);
 
     // Setup VAO
-    drawcallInfo.vao.Bind();
+    drawcallInfo.mesh.BindSubmesh(drawcallInfo.submeshIndex);
 }
 
 void Renderer::SetLightingRenderStates(bool firstPass)
 {
     // Set the render states for the first and additional lights
-    m_device.SetFeatureEnabled(GL_BLEND, !firstPass);
-    // TODO: This should not be hardcoded here
-    glDepthFunc(firstPass ? GL_LESS : GL_EQUAL);
-    glBlendFunc(GL_ONE, GL_ONE);
+    const RenderState& renderState = firstPass ? *m_firstLightRenderState : *m_additionalLightRenderState;
+    m_device.SetRenderState(renderState, RenderState::DepthFunction | RenderState::BlendGroups);
 }
 
 void Renderer::InitializeFullscreenMesh()
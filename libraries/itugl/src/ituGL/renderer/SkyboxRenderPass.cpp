@@ -3,7 +3,7 @@
 #include <ituGL/renderer/Renderer.h>
 #include <ituGL/geometry/Mesh.h>
 #include <ituGL/camera/Camera.h>
-#include <ituGL/asset/ShaderLoader.h>
+#include <ituGL/asset/ShaderProgramCache.h>
 #include <ituGL/texture/TextureCubemapObject.h>
 
 SkyboxRenderPass::SkyboxRenderPass(std::shared_ptr<TextureCubemapObject> texture, std::shared_ptr<const FramebufferObject> targetFramebuffer)
@@ -13,15 +13,21 @@ SkyboxRenderPass::SkyboxRenderPass(std::shared_ptr<TextureCubemapObject> texture
     , m_invViewProjMatrixLocation(-1)
     , m_skyboxTextureLocation(-1)
 {
+    SetName("Skybox");
+
     // Load shaders and build shader program
-    Shader vertexShader = ShaderLoader(Shader::VertexShader).Load("shaders/renderer/skybox.vert");
-    Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load("shaders/renderer/skybox.frag");
-    m_shaderProgram.Build(vertexShader, fragmentShader);
+    const char* vertexShaderPath = "shaders/renderer/skybox.vert";
+    const char* fragmentShaderPath = "shaders/renderer/skybox.frag";
+    ShaderProgramCache::GetInstance().Build(m_shaderProgram, std::span(&vertexShaderPath, 1), std::span(&fragmentShaderPath, 1));
 
     // Get uniform locations
     m_cameraPositionLocation = m_shaderProgram.GetUniformLocation("CameraPosition");
     m_invViewProjMatrixLocation = m_shaderProgram.GetUniformLocation("InvViewProjMatrix");
     m_skyboxTextureLocation = m_shaderProgram.GetUniformLocation("SkyboxTexture");
+
+    RenderState::Desc renderStateDesc;
+    renderStateDesc.depthTestFunction = RenderState::TestFunction::Equal;
+    m_renderState = RenderState::Get(renderStateDesc);
 }
 
 std::shared_ptr<TextureCubemapObject> SkyboxRenderPass::GetTexture() const
@@ -43,15 +49,12 @@ void SkyboxRenderPass::Render()
     const Camera& camera = renderer.GetCurrentCamera();
     m_shaderProgram.SetUniform(m_cameraPositionLocation, camera.ExtractTranslation());
     m_shaderProgram.SetUniform(m_invViewProjMatrixLocation, glm::inverse(camera.GetViewProjectionMatrix()));
-    m_shaderProgram.SetTexture(m_skyboxTextureLocation, 0, *m_texture);
+    m_shaderProgram.SetTexture(m_skyboxTextureLocation, *m_texture);
 
-    // Only write to depth == 1
-    glDepthFunc(GL_EQUAL);
+    // Only write to depth == 1. Materials set their own depth function, so it is not restored
+    renderer.GetDevice().SetRenderState(*m_renderState, RenderState::DepthFunction);
 
     const Mesh& fullscreenMesh = renderer.GetFullscreenMesh();
 
     fullscreenMesh.DrawSubmesh(0);
-    
-    // Restore default value
-    glDepthFunc(GL_LESS);
 }
@@ -12,8 +12,22 @@ TransparencyPass::TransparencyPass(std::shared_ptr<const FramebufferObject> fram
 
 TransparencyPass::TransparencyPass(std::shared_ptr<const FramebufferObject> framebuffer, int drawcallCollectionIndex)
     : m_drawcallCollectionIndex(drawcallCollectionIndex)
+    , m_passKeywords{ "FORWARD_PASS" }
 {
+    SetName("Transparency");
     m_targetFramebuffer = framebuffer;
+
+    RenderState::Desc firstLightDesc;
+    firstLightDesc.blendEquations = { RenderState::BlendEquation::Add, RenderState::BlendEquation::Add };
+    firstLightDesc.blendParams = { RenderState::BlendParam::SourceAlpha, RenderState::BlendParam::OneMinusSourceAlpha,
+        RenderState::BlendParam::SourceAlpha, RenderState::BlendParam::OneMinusSourceAlpha };
+    m_firstLightRenderState = RenderState::Get(firstLightDesc);
+
+    RenderState::Desc additionalLightDesc = firstLightDesc;
+    additionalLightDesc.depthTestFunction = RenderState::TestFunction::Equal;
+    additionalLightDesc.blendParams = { RenderState::BlendParam::SourceAlpha, RenderState::BlendParam::One,
+        RenderState::BlendParam::SourceAlpha, RenderState::BlendParam::One };
+    m_additionalLightRenderState = RenderState::Get(additionalLightDesc);
 }
 
 void TransparencyPass::Render()
@@ -23,7 +37,7 @@ void TransparencyPass::Render()
     const Camera& camera = renderer.GetCurrentCamera();
     const auto& lights = renderer.GetLights();
     const auto& drawcallCollection = renderer.GetDrawcalls(m_drawcallCollectionIndex);
-    const bool blendEnabled = renderer.GetDevice().IsFeatureEnabled(GL_BLEND);
+    DeviceGL& device = renderer.GetDevice();
 
     // for all drawcalls
     for (const Renderer::DrawcallInfo& drawcallInfo : drawcallCollection)
@@ -31,14 +45,10 @@ void TransparencyPass::Render()
         if (!drawcallInfo.material.GetTransparency())
             continue;
 
-        // Prepare drawcall states
-        renderer.PrepareDrawcall(drawcallInfo);
-
-        std::shared_ptr<const ShaderProgram> shaderProgram = drawcallInfo.material.GetShaderProgram();
-
+        // Prepare drawcall states, with the forward variant of the shader
+        renderer.PrepareDrawcall(drawcallInfo, m_passKeywords);
 
-        auto forwardPass = shaderProgram->GetUniformLocation("ForwardPass");
-        shaderProgram->SetUniform(forwardPass, 1);
+        std::shared_ptr<const ShaderProgram> shaderProgram = drawcallInfo.material.GetVariant(m_passKeywords);
 
         //for all lights
         bool first = true;
@@ -46,9 +56,8 @@ void TransparencyPass::Render()
  
         // Hacky way to ensure that we have blend enabled
         // but can allow that since all objects getting rendered this pass is transparent
-        renderer.GetDevice().EnableFeature(GL_BLEND);
-        glBlendEquation(GL_FUNC_ADD);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        // The material of the next drawcall sets its own depth function and blending, so they are not restored
+        device.SetRenderState(*m_firstLightRenderState, RenderState::BlendGroups);
         while (renderer.UpdateLights(shaderProgram, lights, lightIndex))
         {
 
@@ -58,12 +67,8 @@ void TransparencyPass::Render()
             if (first)
             {
                 first = false;
-                glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-                glDepthFunc(GL_EQUAL);
+                device.SetRenderState(*m_additionalLightRenderState, RenderState::DepthFunction | RenderState::BlendGroups);
             }
         }
-        shaderProgram->SetUniform(forwardPass, 0);
-        glDepthFunc(GL_LESS);
     }
-    renderer.GetDevice().SetFeatureEnabled(GL_BLEND, blendEnabled);
 }
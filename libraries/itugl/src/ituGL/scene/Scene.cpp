@@ -2,6 +2,7 @@
 
 #include <ituGL/scene/SceneNode.h>
 #include <ituGL/scene/SceneVisitor.h>
+#include <ituGL/core/CpuProfiler.h>
 #include <cassert>
 
 Scene::Scene()
@@ -56,6 +57,7 @@ bool Scene::RemoveSceneNode(const std::string& name)
 
 void Scene::AcceptVisitor(SceneVisitor& visitor)
 {
+    ITUGL_PROFILE_ZONE("Scene::AcceptVisitor");
     for (auto& pair : m_nodes)
     {
         pair.second->AcceptVisitor(visitor);
@@ -64,6 +66,7 @@ void Scene::AcceptVisitor(SceneVisitor& visitor)
 
 void Scene::AcceptVisitor(SceneVisitor& visitor) const
 {
+    ITUGL_PROFILE_ZONE("Scene::AcceptVisitor");
     for (auto& pair : m_nodes)
     {
         pair.second->AcceptVisitor(visitor);
@@ -57,7 +57,12 @@ BoxBounds SceneModel::GetBoxBounds() const
 {
     assert(m_transform);
     assert(m_model);
-    return BoxBounds(m_transform->GetTranslation(), m_transform->GetRotationMatrix(), m_transform->GetScale() /* * m_model->GetSize()*/);
+    // Transform the model bounds to world space
+    const AabbBounds& modelBounds = m_model->GetBounds();
+    glm::mat3 rotationMatrix(m_transform->GetRotationMatrix());
+    glm::vec3 scale = m_transform->GetScale();
+    glm::vec3 center = m_transform->GetTranslation() + rotationMatrix * (scale * modelBounds.GetCenter());
+    return BoxBounds(center, rotationMatrix, scale * modelBounds.GetSize());
 }
 
 void SceneModel::AcceptVisitor(SceneVisitor& visitor)
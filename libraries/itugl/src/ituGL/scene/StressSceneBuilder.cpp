@@ -0,0 +1,190 @@
+#include <ituGL/scene/StressSceneBuilder.h>
+
+#include <ituGL/geometry/Model.h>
+#include <ituGL/lighting/DirectionalLight.h>
+#include <ituGL/lighting/PointLight.h>
+#include <ituGL/lighting/SpotLight.h>
+#include <ituGL/scene/Scene.h>
+#include <ituGL/scene/SceneLight.h>
+#include <ituGL/scene/SceneModel.h>
+#include <ituGL/scene/Transform.h>
+#include <ituGL/shader/Material.h>
+#include <algorithm>
+#include <cassert>
+
+StressSceneBuilder::Random::Random(unsigned int seed) : m_engine(seed)
+{
+}
+
+// 24 bits of the output, so every value is exact in a float
+float StressSceneBuilder::Random::GetFloat()
+{
+    return static_cast<float>(m_engine() >> 8) * (1.0f / 16777216.0f);
+}
+
+float StressSceneBuilder::Random::GetFloat(float min, float max)
+{
+    return min + (max - min) * GetFloat();
+}
+
+unsigned int StressSceneBuilder::Random::GetIndex(unsigned int count)
+{
+    assert(count > 0);
+    return static_cast<unsigned int>(m_engine() % count);
+}
+
+StressSceneBuilder::StressSceneBuilder(const Settings& settings) : m_settings(settings)
+{
+}
+
+void StressSceneBuilder::Build(Scene& scene, std::span<const std::shared_ptr<Model>> models)
+{
+    assert(!models.empty() || m_settings.modelCount == 0);
+    m_stats = Stats();
+
+    // Models and lights use separate generators, so changing the light count keeps the same models
+    Random modelRandom(m_settings.seed);
+    Random lightRandom(m_settings.seed ^ 0x9e3779b9u);
+
+    if (m_settings.modelVariantCount > 0)
+    {
+        std::vector<std::shared_ptr<Model>> variants = CreateModelVariants(models);
+        AddModels(scene, variants, modelRandom);
+    }
+    else
+    {
+        m_stats.modelCount = static_cast<unsigned int>(models.size());
+        AddModels(scene, models, modelRandom);
+    }
+    AddLights(scene, lightRandom);
+}
+
+std::vector<std::shared_ptr<Model>> StressSceneBuilder::CreateModelVariants(std::span<const std::shared_ptr<Model>> models)
+{
+    std::vector<std::shared_ptr<Model>> variants;
+    for (unsigned int variantIndex = 0; variantIndex < m_settings.modelVariantCount; ++variantIndex)
+    {
+        // The mesh is shared, the materials are copied
+        std::shared_ptr<Model> variant = std::make_shared<Model>(*models[variantIndex % models.size()]);
+        unsigned int materialCount = variant->GetMaterialCount();
+        for (unsigned int materialIndex = 0; materialIndex < materialCount; ++materialIndex)
+        {
+            std::shared_ptr<Material> material = std::make_shared<Material>(variant->GetMaterial(materialIndex));
+            if (m_settings.materialVariantFunction)
+            {
+                m_settings.materialVariantFunction(*material, variantIndex);
+            }
+            variant->SetMaterial(materialIndex, material);
+        }
+        m_stats.materialCount += materialCount;
+        variants.push_back(variant);
+    }
+    m_stats.modelCount = static_cast<unsigned int>(variants.size());
+    return variants;
+}
+
+std::vector<std::shared_ptr<Transform>> StressSceneBuilder::CreateHierarchy(Random& random)
+{
+    std::vector<std::shared_ptr<Transform>> level;
+    if (m_settings.hierarchyDepth == 0)
+    {
+        return level;
+    }
+
+    // One root, and each level has up to hierarchyBranching children for each transform of the level above
+    // Levels never have more transforms than models, so deep hierarchies don't grow exponentially
+    level.push_back(std::make_shared<Transform>());
+    m_stats.hierarchyTransformCount = 1;
+
+    unsigned int branching = std::max(m_settings.hierarchyBranching, 1u);
+    float offset = 0.05f * m_settings.extent;
+    for (unsigned int depth = 1; depth < m_settings.hierarchyDepth; ++depth)
+    {
+        size_t levelSize = std::min(level.size() * branching, static_cast<size_t>(std::max(m_settings.modelCount, 1u)));
+        std::vector<std::shared_ptr<Transform>> nextLevel;
+        nextLevel.reserve(levelSize);
+        for (size_t index = 0; index < levelSize; ++index)
+        {
+            std::shared_ptr<Transform> transform = std::make_shared<Transform>();
+            transform->SetTranslation(glm::vec3(random.GetFloat(-offset, offset), 0.0f, random.GetFloat(-offset, offset)));
+            transform->SetRotation(glm::vec3(0.0f, random.GetFloat(-0.1f, 0.1f), 0.0f));
+            transform->SetParent(level[index / branching]);
+            nextLevel.push_back(transform);
+        }
+        m_stats.hierarchyTransformCount += static_cast<unsigned int>(levelSize);
+        level.swap(nextLevel);
+    }
+    return level;
+}
+
+void StressSceneBuilder::AddModels(Scene& scene, std::span<const std::shared_ptr<Model>> models, Random& random)
+{
+    std::vector<std::shared_ptr<Transform>> parents = CreateHierarchy(random);
+
+    const float extent = m_settings.extent;
+    for (unsigned int index = 0; index < m_settings.modelCount; ++index)
+    {
+        std::shared_ptr<Transform> transform = std::make_shared<Transform>();
+        transform->SetTranslation(glm::vec3(random.GetFloat(-extent, extent), random.GetFloat(0.0f, 0.25f * extent), random.GetFloat(-extent, extent)));
+        transform->SetRotation(glm::vec3(0.0f, random.GetFloat(0.0f, 6.2831853f), 0.0f));
+        transform->SetScale(glm::vec3(random.GetFloat(0.5f, 1.5f)));
+        if (!parents.empty())
+        {
+            transform->SetParent(parents[index % parents.size()]);
+        }
+
+        std::shared_ptr<Model> model = models[random.GetIndex(static_cast<unsigned int>(models.size()))];
+        bool added = scene.AddSceneNode(std::make_shared<SceneModel>(m_settings.namePrefix + " model " + std::to_string(index), model, transform));
+        assert(added);
+        m_stats.modelNodeCount += added ? 1 : 0;
+    }
+}
+
+void StressSceneBuilder::AddLights(Scene& scene, Random& random)
+{
+    float totalWeight = m_settings.pointLightWeight + m_settings.spotLightWeight + m_settings.directionalLightWeight;
+    assert(totalWeight > 0.0f || m_settings.lightCount == 0);
+
+    // Lights reach a few models around them
+    const float extent = m_settings.extent;
+    glm::vec2 distanceAttenuation(0.02f * extent, 0.08f * extent);
+    for (unsigned int index = 0; index < m_settings.lightCount; ++index)
+    {
+        glm::vec3 position(random.GetFloat(-extent, extent), random.GetFloat(0.05f * extent, 0.3f * extent), random.GetFloat(-extent, extent));
+        glm::vec3 direction(random.GetFloat(-0.5f, 0.5f), -1.0f, random.GetFloat(-0.5f, 0.5f));
+
+        std::shared_ptr<Light> light;
+        float type = random.GetFloat(0.0f, totalWeight);
+        if (type < m_settings.pointLightWeight)
+        {
+            std::shared_ptr<PointLight> pointLight = std::make_shared<PointLight>();
+            pointLight->SetPosition(position);
+            pointLight->SetDistanceAttenuation(distanceAttenuation);
+            light = pointLight;
+            ++m_stats.pointLightCount;
+        }
+        else if (type < m_settings.pointLightWeight + m_settings.spotLightWeight)
+        {
+            std::shared_ptr<SpotLight> spotLight = std::make_shared<SpotLight>();
+            spotLight->SetPosition(position);
+            spotLight->SetDirection(direction);
+            spotLight->SetDistanceAttenuation(distanceAttenuation);
+            spotLight->SetAngleAttenuation(glm::vec2(0.4f, 0.6f));
+            light = spotLight;
+            ++m_stats.spotLightCount;
+        }
+        else
+        {
+            std::shared_ptr<DirectionalLight> directionalLight = std::make_shared<DirectionalLight>();
+            directionalLight->SetDirection(direction);
+            light = directionalLight;
+            ++m_stats.directionalLightCount;
+        }
+        light->SetColor(glm::vec3(random.GetFloat(0.5f, 1.0f), random.GetFloat(0.5f, 1.0f), random.GetFloat(0.5f, 1.0f)));
+        light->SetIntensity(random.GetFloat(0.5f, 2.0f));
+
+        bool added = scene.AddSceneNode(std::make_shared<SceneLight>(m_settings.namePrefix + " light " + std::to_string(index), light));
+        assert(added);
+        m_stats.lightNodeCount += added ? 1 : 0;
+    }
+}
@@ -0,0 +1,33 @@
+#include <ituGL/scene/TextureStreamingSceneVisitor.h>
+
+#include <ituGL/texture/TextureStreamingManager.h>
+#include <ituGL/camera/Camera.h>
+#include <ituGL/scene/SceneModel.h>
+#include <glm/geometric.hpp>
+#include <limits>
+
+TextureStreamingSceneVisitor::TextureStreamingSceneVisitor(TextureStreamingManager& streamingManager, const Camera& camera, int viewportHeight)
+    : m_streamingManager(streamingManager), m_camera(camera), m_viewportHeight(viewportHeight)
+{
+}
+
+void TextureStreamingSceneVisitor::VisitModel(SceneModel& sceneModel)
+{
+    if (!sceneModel.GetModel())
+    {
+        return;
+    }
+
+    SphereBounds bounds = sceneModel.GetSphereBounds();
+    float distance = glm::distance(bounds.GetCenter(), m_camera.ExtractTranslation());
+
+    // Projected diameter of the bounding sphere, in pixels. If the camera is inside, it covers the whole screen or more
+    float screenSize = std::numeric_limits<float>::max();
+    if (distance > bounds.GetRadius())
+    {
+        const glm::mat4& projMatrix = m_camera.GetProjectionMatrix();
+        screenSize = bounds.GetRadius() * projMatrix[1][1] * m_viewportHeight / distance;
+    }
+
+    m_streamingManager.RequestModel(*sceneModel.GetModel(), screenSize);
+}
@@ -2,26 +2,61 @@
 #include <ituGL/core/DeviceGL.h>
 #include <cassert>
 
-Material::Material() : Material(nullptr)
+Material::Material() : Material(std::shared_ptr<ShaderProgram>())
 {
 }
 
 Material::Material(std::shared_ptr<ShaderProgram> shaderProgram, const NameSet& filteredUniforms)
     : ShaderUniformCollection(shaderProgram, filteredUniforms)
-    , m_depthTestFunction(TestFunction::Less)
-    , m_depthWrite(true)
-    , m_stencilTestFunctions{ TestFunction::Never, TestFunction::Never }
-    , m_stencilRefValues{ 0, 0 }
-    , m_stencilMasks{ ~0u, ~0u }
-    , m_stencilFail{ StencilOperation::Keep, StencilOperation::Keep }
-    , m_stencilDepthFail{ StencilOperation::Keep, StencilOperation::Keep }
-    , m_stencilDepthPass{ StencilOperation::Keep, StencilOperation::Keep }
-    , m_blendEquations{ BlendEquation::None }
-    , m_blendParams{ BlendParam::One, BlendParam::Zero, BlendParam::One, BlendParam::Zero }
+    , m_keywordMask(0)
     , m_isTransparent(false)
 {
 }
 
+Material::Material(std::shared_ptr<ShaderProgramVariants> shaderVariants, const NameSet& filteredUniforms)
+    : Material(shaderVariants->GetVariant(0), filteredUniforms)
+{
+    m_shaderVariants = shaderVariants;
+}
+
+bool Material::IsKeywordEnabled(const std::string& keyword) const
+{
+    int keywordIndex = m_shaderVariants ? m_shaderVariants->GetKeywordIndex(keyword) : -1;
+    return keywordIndex >= 0 && (m_keywordMask & (1u << keywordIndex)) != 0;
+}
+
+void Material::SetKeyword(const std::string& keyword, bool enabled)
+{
+    assert(m_shaderVariants);
+    int keywordIndex = m_shaderVariants->GetKeywordIndex(keyword);
+    assert(keywordIndex >= 0);
+    if (enabled)
+    {
+        m_keywordMask |= 1u << keywordIndex;
+    }
+    else
+    {
+        m_keywordMask &= ~(1u << keywordIndex);
+    }
+}
+
+std::shared_ptr<const ShaderProgram> Material::GetVariant(std::span<const std::string> passKeywords) const
+{
+    ShaderProgramVariants::KeywordMask keywordMask;
+    return GetVariant(passKeywords, keywordMask);
+}
+
+std::shared_ptr<ShaderProgram> Material::GetVariant(std::span<const std::string> passKeywords, ShaderProgramVariants::KeywordMask& keywordMask) const
+{
+    if (!m_shaderVariants)
+    {
+        keywordMask = 0;
+        return m_shaderProgram;
+    }
+    keywordMask = m_keywordMask | m_shaderVariants->GetKeywordMask(passKeywords);
+    return keywordMask ? m_shaderVariants->GetVariant(keywordMask) : m_shaderProgram;
+}
+
 void Material::SetShaderSetupFunction(ShaderSetupFunction shaderSetupFunction)
 {
     m_shaderSetupFunction = shaderSetupFunction;
@@ -29,22 +64,22 @@ void Material::SetShaderSetupFunction(ShaderSetupFunction shaderSetupFunction)
 
 Material::TestFunction Material::GetDepthTestFunction() const
 {
-    return m_depthTestFunction;
+    return m_renderStateDesc.depthTestFunction;
 }
 
 void Material::SetDepthTestFunction(TestFunction function)
 {
-    m_depthTestFunction = function;
+    GetRenderStateDesc().depthTestFunction = function;
 }
 
 bool Material::GetDepthWrite() const
 {
-    return m_depthWrite;
+    return m_renderStateDesc.depthWrite;
 }
 
 void Material::SetDepthWrite(bool depthWrite)
 {
-    m_depthWrite = depthWrite;
+    GetRenderStateDesc().depthWrite = depthWrite;
 }
 
 void Material::SetStencilTestFunction(TestFunction function, int refValue, unsigned int mask)
@@ -55,30 +90,32 @@ void Material::SetStencilTestFunction(TestFunction function, int refValue, unsig
 
 Material::TestFunction Material::GetStencilFrontTestFunction(int &refValue, unsigned int &mask) const
 {
-    refValue = m_stencilRefValues[0];
-    mask = m_stencilMasks[0];
-    return m_stencilTestFunctions[0];
+    refValue = m_renderStateDesc.stencilRefValues[0];
+    mask = m_renderStateDesc.stencilMasks[0];
+    return m_renderStateDesc.stencilTestFunctions[0];
 }
 
 void Material::SetStencilFrontTestFunction(TestFunction function, int refValue, unsigned int mask)
 {
-    m_stencilTestFunctions[0] = function;
-    m_stencilRefValues[0] = refValue;
-    m_stencilMasks[0] = mask;
+    RenderState::Desc& desc = GetRenderStateDesc();
+    desc.stencilTestFunctions[0] = function;
+    desc.stencilRefValues[0] = refValue;
+    desc.stencilMasks[0] = mask;
 }
 
 Material::TestFunction Material::GetStencilBackTestFunction(int& refValue, unsigned int& mask) const
 {
-    refValue = m_stencilRefValues[1];
-    mask = m_stencilMasks[1];
-    return m_stencilTestFunctions[1];
+    refValue = m_renderStateDesc.stencilRefValues[1];
+    mask = m_renderStateDesc.stencilMasks[1];
+    return m_renderStateDesc.stencilTestFunctions[1];
 }
 
 void Material::SetStencilBackTestFunction(TestFunction function, int refValue, unsigned int mask)
 {
-    m_stencilTestFunctions[1] = function;
-    m_stencilRefValues[1] = refValue;
-    m_stencilMasks[1] = mask;
+    RenderState::Desc& desc = GetRenderStateDesc();
+    desc.stencilTestFunctions[1] = function;
+    desc.stencilRefValues[1] = refValue;
+    desc.stencilMasks[1] = mask;
 }
 
 void Material::SetStencilOperations(StencilOperation stencilFail, StencilOperation depthFail, StencilOperation depthPass)
@@ -89,40 +126,42 @@ void Material::SetStencilOperations(StencilOperation stencilFail, StencilOperati
 
 void Material::GetStencilFrontOperations(StencilOperation& stencilFail, StencilOperation& depthFail, StencilOperation& depthPass) const
 {
-    stencilFail = m_stencilFail[0];
-    depthFail = m_stencilDepthFail[0];
-    depthPass = m_stencilDepthPass[0];
+    stencilFail = m_renderStateDesc.stencilFail[0];
+    depthFail = m_renderStateDesc.stencilDepthFail[0];
+    depthPass = m_renderStateDesc.stencilDepthPass[0];
 }
 
 void Material::SetStencilFrontOperations(StencilOperation stencilFail, StencilOperation depthFail, StencilOperation depthPass)
 {
-    m_stencilFail[0] = stencilFail;
-    m_stencilDepthFail[0] = depthFail;
-    m_stencilDepthPass[0] = depthPass;
+    RenderState::Desc& desc = GetRenderStateDesc();
+    desc.stencilFail[0] = stencilFail;
+    desc.stencilDepthFail[0] = depthFail;
+    desc.stencilDepthPass[0] = depthPass;
 }
 
 void Material::GetStencilBackOperations(StencilOperation& stencilFail, StencilOperation& depthFail, StencilOperation& depthPass) const
 {
-    stencilFail = m_stencilFail[1];
-    depthFail = m_stencilDepthFail[1];
-    depthPass = m_stencilDepthPass[1];
+    stencilFail = m_renderStateDesc.stencilFail[1];
+    depthFail = m_renderStateDesc.stencilDepthFail[1];
+    depthPass = m_renderStateDesc.stencilDepthPass[1];
 }
 
 void Material::SetStencilBackOperations(StencilOperation stencilFail, StencilOperation depthFail, StencilOperation depthPass)
 {
-    m_stencilFail[1] = stencilFail;
-    m_stencilDepthFail[1] = depthFail;
-    m_stencilDepthPass[1] = depthPass;
+    RenderState::Desc& desc = GetRenderStateDesc();
+    desc.stencilFail[1] = stencilFail;
+    desc.stencilDepthFail[1] = depthFail;
+    desc.stencilDepthPass[1] = depthPass;
 }
 
 Material::BlendEquation Material::GetBlendEquationColor() const
 {
-    return m_blendEquations[0];
+    return m_renderStateDesc.blendEquations[0];
 }
 
 Material::BlendEquation Material::GetBlendEquationAlpha() const
 {
-    return m_blendEquations[1];
+    return m_renderStateDesc.blendEquations[1];
 }
 
 void Material::SetBlendEquation(BlendEquation blendEquation)
@@ -132,8 +171,9 @@ void Material::SetBlendEquation(BlendEquation blendEquation)
 
 void Material::SetBlendEquation(BlendEquation blendEquationColor, BlendEquation blendEquationAlpha)
 {
-    m_blendEquations[0] = blendEquationColor;
-    m_blendEquations[1] = blendEquationAlpha;
+    RenderState::Desc& desc = GetRenderStateDesc();
+    desc.blendEquations[0] = blendEquationColor;
+    desc.blendEquations[1] = blendEquationAlpha;
 }
 
 void Material::SetBlendParams(BlendParam source, BlendParam dest)
@@ -148,10 +188,11 @@ void Material::SetBlendParams(BlendParam source, BlendParam dest, Color blendCol
 
 void Material::SetBlendParams(BlendParam sourceColor, BlendParam destColor, BlendParam sourceAlpha, BlendParam destAlpha)
 {
-    m_blendParams[0] = sourceColor;
-    m_blendParams[1] = destColor;
-    m_blendParams[2] = sourceAlpha;
-    m_blendParams[3] = destAlpha;
+    RenderState::Desc& desc = GetRenderStateDesc();
+    desc.blendParams[0] = sourceColor;
+    desc.blendParams[1] = destColor;
+    desc.blendParams[2] = sourceAlpha;
+    desc.blendParams[3] = destAlpha;
 }
 
 void Material::SetBlendParams(BlendParam sourceColor, BlendParam destColor, BlendParam sourceAlpha, BlendParam destAlpha, Color blendColor)
@@ -162,157 +203,98 @@ void Material::SetBlendParams(BlendParam sourceColor, BlendParam destColor, Blen
 
 void Material::SetBlendColor(Color blendColor)
 {
+    RenderState::Desc& desc = GetRenderStateDesc();
+
     // Check that at least one of the parameters is ConstantColor or ConstantAlpha
-    assert(m_blendParams[0] == BlendParam::ConstantColor || m_blendParams[0] == BlendParam::ConstantAlpha
-        || m_blendParams[1] == BlendParam::ConstantColor || m_blendParams[1] == BlendParam::ConstantAlpha
-        || m_blendParams[2] == BlendParam::ConstantColor || m_blendParams[2] == BlendParam::ConstantAlpha
-        || m_blendParams[3] == BlendParam::ConstantColor || m_blendParams[3] == BlendParam::ConstantAlpha);
+    assert(desc.blendParams[0] == BlendParam::ConstantColor || desc.blendParams[0] == BlendParam::ConstantAlpha
+        || desc.blendParams[1] == BlendParam::ConstantColor || desc.blendParams[1] == BlendParam::ConstantAlpha
+        || desc.blendParams[2] == BlendParam::ConstantColor || desc.blendParams[2] == BlendParam::ConstantAlpha
+        || desc.blendParams[3] == BlendParam::ConstantColor || desc.blendParams[3] == BlendParam::ConstantAlpha);
 
-    m_blendColor = blendColor;
+    desc.blendColor = blendColor;
 }
 
-void Material::Use(OverrideFlags overrideFlags) const
+const RenderState& Material::GetRenderState() const
 {
-    assert(m_shaderProgram);
-
-    // Set the shader program as the one currently in use
-    m_shaderProgram->Use();
-
-    // Set the value of all the uniforms stored as properties
-    SetUniforms();
-
-    if (m_shaderSetupFunction)
+    if (!m_renderState)
     {
-        // if needed, do extra set up for the shader
-        m_shaderSetupFunction(*m_shaderProgram);
-    }
-
-    // If not skipped, set the depth settings
-    if ((overrideFlags & OverrideFlags::OverrideDepthTest) == 0)
-    {
-        UseDepthTest();
-    }
-
-    // If not skipped, set the stencil settings
-    if ((overrideFlags & OverrideFlags::OverrideStencilTest) == 0)
-    {
-        UseStencilTest();
-    }
-
-    // If not skipped, set the blend settings
-    if ((overrideFlags & OverrideFlags::OverrideBlend) == 0)
-    {
-        UseBlend();
+        m_renderState = RenderState::Get(m_renderStateDesc);
     }
+    return *m_renderState;
 }
 
-void Material::SetTransparency(bool isTransparent)
+void Material::SetRenderState(const RenderState::Desc& desc)
 {
-    m_isTransparent = isTransparent;
+    GetRenderStateDesc() = desc;
 }
 
-const bool Material::GetTransparency() const
+RenderState::Desc& Material::GetRenderStateDesc()
 {
-    return m_isTransparent;
+    m_renderState = nullptr;
+    return m_renderStateDesc;
 }
 
-void Material::UseDepthTest() const
+void Material::Use(OverrideFlags overrideFlags) const
 {
-    // Depth function
-    glDepthFunc(static_cast<GLenum>(m_depthTestFunction));
-
-    // Depth write
-    glDepthMask(m_depthWrite ? GL_TRUE : GL_FALSE);
+    Use({}, overrideFlags);
 }
 
-void Material::UseStencilTest() const
+void Material::Use(std::span<const std::string> passKeywords, OverrideFlags overrideFlags) const
 {
-    // Stencil operations
-    if (m_stencilFail[0] == m_stencilFail[1] && m_stencilDepthFail[0] == m_stencilDepthFail[1] && m_stencilDepthPass[0] == m_stencilDepthPass[1])
+    assert(m_shaderProgram);
+
+    ShaderProgramVariants::KeywordMask keywordMask;
+    std::shared_ptr<ShaderProgram> shaderProgram = GetVariant(passKeywords, keywordMask);
+
+    // Set the shader program as the one currently in use
+    shaderProgram->Use();
+
+    // Set the value of all the uniforms stored as properties
+    if (shaderProgram == m_shaderProgram)
     {
-        // Same for front and back
-        glStencilOp(static_cast<GLenum>(m_stencilFail[0]), static_cast<GLenum>(m_stencilDepthFail[0]), static_cast<GLenum>(m_stencilDepthPass[0]));
+        SetUniforms();
     }
     else
     {
-        // Separate functions for front and back
-        glStencilOpSeparate(GL_FRONT, static_cast<GLenum>(m_stencilFail[0]), static_cast<GLenum>(m_stencilDepthFail[0]), static_cast<GLenum>(m_stencilDepthPass[0]));
-        glStencilOpSeparate(GL_BACK, static_cast<GLenum>(m_stencilFail[1]), static_cast<GLenum>(m_stencilDepthFail[1]), static_cast<GLenum>(m_stencilDepthPass[1]));
+        // Other variants can have different locations, they are matched by name the first time they are used
+        auto itLocations = m_variantLocations.find(keywordMask);
+        if (itLocations == m_variantLocations.end())
+        {
+            itLocations = m_variantLocations.emplace(keywordMask, std::vector<ShaderProgram::Location>()).first;
+            GetUniformLocations(*shaderProgram, itLocations->second);
+        }
+        SetUniforms(*shaderProgram, itLocations->second);
     }
 
-    // Stencil functions
-    if (m_stencilTestFunctions[0] == m_stencilTestFunctions[1] && m_stencilRefValues[0] == m_stencilRefValues[1] && m_stencilMasks[0] == m_stencilMasks[1])
+    if (m_shaderSetupFunction)
     {
-        // Same for front and back
-        glStencilFunc(static_cast<GLenum>(m_stencilTestFunctions[0]), m_stencilRefValues[0], m_stencilMasks[0]);
+        // if needed, do extra set up for the shader
+        m_shaderSetupFunction(*shaderProgram);
     }
-    else
+
+    // Set the depth, stencil and blend settings that are not skipped. The device only sets the ones that changed
+    unsigned int groupMask = RenderState::AllGroups;
+    if (overrideFlags & OverrideFlags::OverrideDepthTest)
+    {
+        groupMask &= ~RenderState::DepthGroups;
+    }
+    if (overrideFlags & OverrideFlags::OverrideStencilTest)
+    {
+        groupMask &= ~RenderState::StencilGroups;
+    }
+    if (overrideFlags & OverrideFlags::OverrideBlend)
     {
-        // Separate functions for front and back
-        glStencilFuncSeparate(GL_FRONT, static_cast<GLenum>(m_stencilTestFunctions[0]), m_stencilRefValues[0], m_stencilMasks[0]);
-        glStencilFuncSeparate(GL_BACK, static_cast<GLenum>(m_stencilTestFunctions[1]), m_stencilRefValues[1], m_stencilMasks[1]);
+        groupMask &= ~RenderState::BlendGroups;
     }
+    DeviceGL::GetInstance().SetRenderState(GetRenderState(), groupMask);
 }
 
-void Material::UseBlend() const
+void Material::SetTransparency(bool isTransparent)
 {
-    // If the blend equation is None for color and alpha, do nothing
-    bool blending = m_blendEquations[0] != BlendEquation::None || m_blendEquations[1] != BlendEquation::None;
-    DeviceGL::GetInstance().SetFeatureEnabled(GL_BLEND, blending);
-    if (blending)
-    {
-        std::array<BlendParam, 4> blendParams = m_blendParams;
-
-        // Set blend equation
-        if (m_blendEquations[0] == m_blendEquations[1])
-        {
-            // Set the same blend equation for color and alpha
-            glBlendEquation(static_cast<GLenum>(m_blendEquations[0]));
-        }
-        else
-        {
-            GLenum blendEquationColor = static_cast<GLenum>(m_blendEquations[0]);
-            GLenum blendEquationAlpha = static_cast<GLenum>(m_blendEquations[1]);
-
-            // Because there is no "None" equation, we replace it with (Source * 1 + Dest * 0)
-            if (m_blendEquations[0] == BlendEquation::None)
-            {
-                blendEquationColor = GL_FUNC_ADD;
-                blendParams[0] = BlendParam::One;
-                blendParams[1] = BlendParam::Zero;
-            }
-            if (m_blendEquations[1] == BlendEquation::None)
-            {
-                blendEquationAlpha = GL_FUNC_ADD;
-                blendParams[2] = BlendParam::One;
-                blendParams[3] = BlendParam::Zero;
-            }
-
-            // Set separate blend equation for color and alpha
-            glBlendEquationSeparate(blendEquationColor, blendEquationAlpha);
-        }
-
-        // Set blend params
-        if (blendParams[0] == blendParams[2] && blendParams[1] == blendParams[3])
-        {
-            // Set the same blend params for color and alpha
-            glBlendFunc(static_cast<GLenum>(blendParams[0]), static_cast<GLenum>(blendParams[1]));
-        }
-        else
-        {
-            // Set separate blend params for color and alpha
-            glBlendFuncSeparate(
-                static_cast<GLenum>(blendParams[0]), static_cast<GLenum>(blendParams[1]),
-                static_cast<GLenum>(blendParams[2]), static_cast<GLenum>(blendParams[3]));
-        }
+    m_isTransparent = isTransparent;
+}
 
-        // Set blend color only if one param is using constant color or constant alpha
-        if (blendParams[0] == BlendParam::ConstantColor || blendParams[0] == BlendParam::ConstantAlpha ||
-            blendParams[1] == BlendParam::ConstantColor || blendParams[1] == BlendParam::ConstantAlpha ||
-            blendParams[2] == BlendParam::ConstantColor || blendParams[2] == BlendParam::ConstantAlpha ||
-            blendParams[3] == BlendParam::ConstantColor || blendParams[3] == BlendParam::ConstantAlpha)
-        {
-            glBlendColor(m_blendColor.GetRed(), m_blendColor.GetGreen(), m_blendColor.GetBlue(), m_blendColor.GetAlpha());
-        }
-    }
+const bool Material::GetTransparency() const
+{
+    return m_isTransparent;
 }
@@ -55,11 +55,17 @@ void Shader::SetSource(std::span<const char*> source)
 
 // Compile the shader source code
 bool Shader::Compile()
+{
+    SubmitCompile();
+    return IsCompiled();
+}
+
+// Start compiling the shader source code, the status is not queried
+void Shader::SubmitCompile()
 {
     assert(IsValid());
 
     glCompileShader(GetHandle());
-    return IsCompiled();
 }
 
 // Check if the shader has been successfully compiled
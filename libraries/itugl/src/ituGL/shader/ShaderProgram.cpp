@@ -2,16 +2,34 @@
 
 #include <ituGL/shader/Shader.h>
 #include <ituGL/texture/TextureObject.h>
+#include <ituGL/core/DeviceGL.h>
 #include <cassert>
+#include <cstring>
+#include <iostream>
+
+ShaderProgram::UniformStats ShaderProgram::s_uniformStats;
+
+bool ShaderProgram::s_driverQueried = false;
+bool ShaderProgram::s_explicitUniformLocations = false;
+GLint ShaderProgram::s_maxTextureUnits = 0;
+
+bool ShaderProgram::s_sharedTextureUnits = false;
+std::vector<GLint> ShaderProgram::s_textureUnits;
+GLint ShaderProgram::s_textureUnitCount = 0;
 
 #ifndef NDEBUG
 ShaderProgram::Handle ShaderProgram::s_usedHandle = ShaderProgram::NullHandle;
 #endif
 
-ShaderProgram::ShaderProgram() : Object(NullHandle)
+ShaderProgram::ShaderProgram() : Object(NullHandle), m_uniformSourceVersion(0), m_textureUnitCount(0)
 {
     Handle& handle = GetHandle();
     handle = glCreateProgram();
+
+    if (!s_driverQueried)
+    {
+        QueryDriverSupport();
+    }
 }
 
 ShaderProgram::~ShaderProgram()
@@ -25,12 +43,24 @@ ShaderProgram::~ShaderProgram()
 }
 
 ShaderProgram::ShaderProgram(ShaderProgram&& shaderProgram) noexcept : Object(std::move(shaderProgram))
+    , m_resolvedUniformLocations(std::move(shaderProgram.m_resolvedUniformLocations))
+    , m_uniformShadows(std::move(shaderProgram.m_uniformShadows))
+    , m_uniformShadowValues(std::move(shaderProgram.m_uniformShadowValues))
+    , m_uniformSourceVersion(shaderProgram.m_uniformSourceVersion)
+    , m_textureUnits(std::move(shaderProgram.m_textureUnits))
+    , m_textureUnitCount(shaderProgram.m_textureUnitCount)
 {
 }
 
 ShaderProgram& ShaderProgram::operator = (ShaderProgram&& shaderProgram) noexcept
 {
     Object::operator=(std::move(shaderProgram));
+    m_resolvedUniformLocations = std::move(shaderProgram.m_resolvedUniformLocations);
+    m_uniformShadows = std::move(shaderProgram.m_uniformShadows);
+    m_uniformShadowValues = std::move(shaderProgram.m_uniformShadowValues);
+    m_uniformSourceVersion = shaderProgram.m_uniformSourceVersion;
+    m_textureUnits = std::move(shaderProgram.m_textureUnits);
+    m_textureUnitCount = shaderProgram.m_textureUnitCount;
     return *this;
 }
 
@@ -44,15 +74,31 @@ void ShaderProgram::Bind() const
 // Build (Attach and link) a shader program with a compute shader
 bool ShaderProgram::Build(const Shader& computeShader)
 {
-    assert(computeShader.IsType(Shader::ComputeShader));
-    AttachShader(computeShader);
-    return Link();
+    SubmitBuild(computeShader);
+    return IsLinked();
 }
 
 // Build (Attach and link) all shaders provided for the rasterization pipeline
 bool ShaderProgram::Build(const Shader& vertexShader, const Shader& fragmentShader,
     const Shader* tesselationControlShader, const Shader* tesselationEvaluationShader,
     const Shader* geometryShader)
+{
+    SubmitBuild(vertexShader, fragmentShader, tesselationControlShader, tesselationEvaluationShader, geometryShader);
+    return IsLinked();
+}
+
+// Attach the compute shader and start linking
+void ShaderProgram::SubmitBuild(const Shader& computeShader)
+{
+    assert(computeShader.IsType(Shader::ComputeShader));
+    AttachShader(computeShader);
+    SubmitLink();
+}
+
+// Attach all shaders provided for the rasterization pipeline and start linking
+void ShaderProgram::SubmitBuild(const Shader& vertexShader, const Shader& fragmentShader,
+    const Shader* tesselationControlShader, const Shader* tesselationEvaluationShader,
+    const Shader* geometryShader)
 {
     assert(vertexShader.IsType(Shader::VertexShader));
     AttachShader(vertexShader);
@@ -79,7 +125,7 @@ bool ShaderProgram::Build(const Shader& vertexShader, const Shader& fragmentShad
         AttachShader(*geometryShader);
     }
 
-    return Link();
+    SubmitLink();
 }
 
 // Attach a shader to be linked
@@ -94,10 +140,19 @@ void ShaderProgram::AttachShader(const Shader& shader)
 
 // Link currently attached shaders
 bool ShaderProgram::Link()
+{
+    SubmitLink();
+    return IsLinked();
+}
+
+// Start linking the attached shaders
+void ShaderProgram::SubmitLink()
 {
     assert(IsValid());
     glLinkProgram(GetHandle());
-    return IsLinked();
+    m_resolvedUniformLocations.clear();
+    ResetUniformShadow();
+    ResetTextureUnits();
 }
 
 // Check if shaders have been linked to create a valid program
@@ -110,6 +165,39 @@ bool ShaderProgram::IsLinked() const
     return success;
 }
 
+void ShaderProgram::SetBinaryRetrievable(bool retrievable)
+{
+    assert(IsValid());
+    glProgramParameteri(GetHandle(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, retrievable ? GL_TRUE : GL_FALSE);
+}
+
+bool ShaderProgram::GetBinary(GLenum& format, std::vector<std::byte>& binary) const
+{
+    assert(IsValid());
+    assert(IsLinked());
+
+    GLint binaryLength = 0;
+    glGetProgramiv(GetHandle(), GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+    binary.resize(binaryLength);
+    if (binaryLength > 0)
+    {
+        GLsizei length = 0;
+        glGetProgramBinary(GetHandle(), binaryLength, &length, &format, binary.data());
+        binary.resize(length);
+    }
+    return !binary.empty();
+}
+
+bool ShaderProgram::SetBinary(GLenum format, std::span<const std::byte> binary)
+{
+    assert(IsValid());
+    glProgramBinary(GetHandle(), format, binary.data(), static_cast<GLsizei>(binary.size()));
+    m_resolvedUniformLocations.clear();
+    ResetUniformShadow();
+    ResetTextureUnits();
+    return IsLinked();
+}
+
 // Get a string with linking error messages
 // The max length of the string returned is determined by the capacity of the span
 void ShaderProgram::GetLinkingErrors(std::span<char> errors) const
@@ -130,6 +218,75 @@ void ShaderProgram::Use() const
 #endif
 }
 
+bool ShaderProgram::CheckUniformSource(unsigned int version, unsigned int uniformCount) const
+{
+    bool current = version != 0 && version == m_uniformSourceVersion;
+    if (current)
+    {
+        s_uniformStats.skipped += uniformCount;
+    }
+    return current;
+}
+
+void ShaderProgram::SetUniformSource(unsigned int version, std::span<const Location> locations) const
+{
+    for (Location location : locations)
+    {
+        if (location >= 0 && location < static_cast<Location>(m_uniformShadows.size()))
+        {
+            m_uniformShadows[location].fromSource = true;
+        }
+    }
+    m_uniformSourceVersion = version;
+}
+
+bool ShaderProgram::UpdateUniformShadow(Location location, const void* values, size_t size) const
+{
+    // GL ignores the locations of uniforms that the program doesn't use
+    if (location < 0)
+    {
+        return false;
+    }
+
+    if (location >= static_cast<Location>(m_uniformShadows.size()))
+    {
+        m_uniformShadows.resize(location + 1);
+    }
+
+    UniformShadow& shadow = m_uniformShadows[location];
+    if (shadow.size == size && std::memcmp(&m_uniformShadowValues[shadow.offset], values, size) == 0)
+    {
+        ++s_uniformStats.skipped;
+        return false;
+    }
+
+    // The first upload allocates the space, the next ones have the same size
+    if (shadow.size < size)
+    {
+        shadow.offset = static_cast<unsigned int>(m_uniformShadowValues.size());
+        m_uniformShadowValues.resize(m_uniformShadowValues.size() + size);
+    }
+    shadow.size = static_cast<unsigned int>(size);
+    std::memcpy(&m_uniformShadowValues[shadow.offset], values, size);
+
+    // Something changed a value of the collection, it will have to check all its values again
+    if (shadow.fromSource)
+    {
+        shadow.fromSource = false;
+        m_uniformSourceVersion = 0;
+    }
+
+    ++s_uniformStats.uploads;
+    return true;
+}
+
+void ShaderProgram::ResetUniformShadow()
+{
+    m_uniformShadows.clear();
+    m_uniformShadowValues.clear();
+    m_uniformSourceVersion = 0;
+}
+
 // Find an attribute location by name
 ShaderProgram::Location ShaderProgram::GetAttributeLocation(const char* name) const
 {
@@ -146,6 +303,44 @@ ShaderProgram::Location ShaderProgram::GetUniformLocation(const char* name) cons
     return glGetUniformLocation(GetHandle(), name);
 }
 
+// Find the uniform by name only the first time, the next times the stored location is used
+ShaderProgram::Location ShaderProgram::ResolveUniformLocation(Location fixedLocation, const char* name) const
+{
+    if (fixedLocation < 0)
+    {
+        return -1;
+    }
+    if (fixedLocation >= static_cast<Location>(m_resolvedUniformLocations.size()))
+    {
+        // -2 marks the locations not resolved yet, -1 is a uniform that the program doesn't use
+        m_resolvedUniformLocations.resize(fixedLocation + 1, -2);
+    }
+
+    Location& location = m_resolvedUniformLocations[fixedLocation];
+    if (location == -2)
+    {
+        location = GetUniformLocation(name);
+        assert(!s_explicitUniformLocations || location == -1 || location == fixedLocation);
+    }
+    return location;
+}
+
+void ShaderProgram::QueryDriverSupport()
+{
+    // The shaders check the same extension to fix the locations
+    GLint extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    for (GLint i = 0; i < extensionCount && !s_explicitUniformLocations; ++i)
+    {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        s_explicitUniformLocations = std::strcmp(extension, "GL_ARB_explicit_uniform_location") == 0;
+    }
+    s_sharedTextureUnits = s_explicitUniformLocations;
+
+    glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &s_maxTextureUnits);
+    s_driverQueried = true;
+}
+
 // Get how many uniforms exist in this shader program
 unsigned int ShaderProgram::GetUniformCount() const
 {
@@ -160,6 +355,34 @@ void ShaderProgram::GetUniformInfo(unsigned int index, int& size, GLenum& glType
     glGetActiveUniform(GetHandle(), index, uniformName.size(), nullptr, &size, &glType, uniformName.data());
 }
 
+void ShaderProgram::GetUniformBlockLayout(unsigned int index, int& blockIndex, int& offset, int& arrayStride, int& matrixStride) const
+{
+    GLuint glIndex = index;
+    glGetActiveUniformsiv(GetHandle(), 1, &glIndex, GL_UNIFORM_BLOCK_INDEX, &blockIndex);
+    glGetActiveUniformsiv(GetHandle(), 1, &glIndex, GL_UNIFORM_OFFSET, &offset);
+    glGetActiveUniformsiv(GetHandle(), 1, &glIndex, GL_UNIFORM_ARRAY_STRIDE, &arrayStride);
+    glGetActiveUniformsiv(GetHandle(), 1, &glIndex, GL_UNIFORM_MATRIX_STRIDE, &matrixStride);
+}
+
+int ShaderProgram::GetUniformBlockIndex(const char* name) const
+{
+    GLuint blockIndex = glGetUniformBlockIndex(GetHandle(), name);
+    return blockIndex != GL_INVALID_INDEX ? static_cast<int>(blockIndex) : -1;
+}
+
+void ShaderProgram::GetUniformBlockInfo(int blockIndex, int& dataSize, std::span<char> blockName) const
+{
+    assert(blockIndex >= 0);
+    glGetActiveUniformBlockiv(GetHandle(), blockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &dataSize);
+    glGetActiveUniformBlockName(GetHandle(), blockIndex, static_cast<GLsizei>(blockName.size()), nullptr, blockName.data());
+}
+
+void ShaderProgram::SetUniformBlockBinding(int blockIndex, GLuint binding) const
+{
+    assert(blockIndex >= 0);
+    glUniformBlockBinding(GetHandle(), blockIndex, binding);
+}
+
 // All the different combinations of Get/SetUniform
 template<>
 void ShaderProgram::GetUniform<GLint>(Location location, std::span<GLint> value) const
@@ -197,207 +420,506 @@ template<>
 void ShaderProgram::SetUniforms<GLint, 1>(Location location, const GLint* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform1iv(location, count, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 1 * sizeof(GLint)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniform1iv(GetHandle(), location, count, values);
+        }
+        else
+        {
+            glUniform1iv(location, count, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLint, 2>(Location location, const GLint* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform2iv(location, count, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 2 * sizeof(GLint)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniform2iv(GetHandle(), location, count, values);
+        }
+        else
+        {
+            glUniform2iv(location, count, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLint, 3>(Location location, const GLint* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform3iv(location, count, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 3 * sizeof(GLint)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniform3iv(GetHandle(), location, count, values);
+        }
+        else
+        {
+            glUniform3iv(location, count, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLint, 4>(Location location, const GLint* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform4iv(location, count, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 4 * sizeof(GLint)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniform4iv(GetHandle(), location, count, values);
+        }
+        else
+        {
+            glUniform4iv(location, count, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLuint, 1>(Location location, const GLuint* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform1uiv(location, count, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 1 * sizeof(GLuint)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniform1uiv(GetHandle(), location, count, values);
+        }
+        else
+        {
+            glUniform1uiv(location, count, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLuint, 2>(Location location, const GLuint* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform2uiv(location, count, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 2 * sizeof(GLuint)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniform2uiv(GetHandle(), location, count, values);
+        }
+        else
+        {
+            glUniform2uiv(location, count, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLuint, 3>(Location location, const GLuint* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform3uiv(location, count, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 3 * sizeof(GLuint)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniform3uiv(GetHandle(), location, count, values);
+        }
+        else
+        {
+            glUniform3uiv(location, count, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLuint, 4>(Location location, const GLuint* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform4uiv(location, count, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 4 * sizeof(GLuint)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniform4uiv(GetHandle(), location, count, values);
+        }
+        else
+        {
+            glUniform4uiv(location, count, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 1>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform1fv(location, count, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 1 * sizeof(GLfloat)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniform1fv(GetHandle(), location, count, values);
+        }
+        else
+        {
+            glUniform1fv(location, count, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 2>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform2fv(location, count, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 2 * sizeof(GLfloat)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniform2fv(GetHandle(), location, count, values);
+        }
+        else
+        {
+            glUniform2fv(location, count, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 3>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform3fv(location, count, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 3 * sizeof(GLfloat)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniform3fv(GetHandle(), location, count, values);
+        }
+        else
+        {
+            glUniform3fv(location, count, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 4>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform4fv(location, count, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 4 * sizeof(GLfloat)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniform4fv(GetHandle(), location, count, values);
+        }
+        else
+        {
+            glUniform4fv(location, count, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLdouble, 1>(Location location, const GLdouble* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform1dv(location, count, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 1 * sizeof(GLdouble)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniform1dv(GetHandle(), location, count, values);
+        }
+        else
+        {
+            glUniform1dv(location, count, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLdouble, 2>(Location location, const GLdouble* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform2dv(location, count, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 2 * sizeof(GLdouble)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniform2dv(GetHandle(), location, count, values);
+        }
+        else
+        {
+            glUniform2dv(location, count, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLdouble, 3>(Location location, const GLdouble* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform3dv(location, count, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 3 * sizeof(GLdouble)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniform3dv(GetHandle(), location, count, values);
+        }
+        else
+        {
+            glUniform3dv(location, count, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLdouble, 4>(Location location, const GLdouble* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniform4dv(location, count, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 4 * sizeof(GLdouble)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniform4dv(GetHandle(), location, count, values);
+        }
+        else
+        {
+            glUniform4dv(location, count, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 2, 2>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniformMatrix2fv(location, count, false, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 4 * sizeof(GLfloat)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniformMatrix2fv(GetHandle(), location, count, false, values);
+        }
+        else
+        {
+            glUniformMatrix2fv(location, count, false, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 2, 3>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniformMatrix2x3fv(location, count, false, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 6 * sizeof(GLfloat)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniformMatrix2x3fv(GetHandle(), location, count, false, values);
+        }
+        else
+        {
+            glUniformMatrix2x3fv(location, count, false, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 2, 4>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniformMatrix2x4fv(location, count, false, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 8 * sizeof(GLfloat)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniformMatrix2x4fv(GetHandle(), location, count, false, values);
+        }
+        else
+        {
+            glUniformMatrix2x4fv(location, count, false, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 3, 2>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniformMatrix3x2fv(location, count, false, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 6 * sizeof(GLfloat)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniformMatrix3x2fv(GetHandle(), location, count, false, values);
+        }
+        else
+        {
+            glUniformMatrix3x2fv(location, count, false, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 3, 3>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniformMatrix3fv(location, count, false, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 9 * sizeof(GLfloat)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniformMatrix3fv(GetHandle(), location, count, false, values);
+        }
+        else
+        {
+            glUniformMatrix3fv(location, count, false, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 3, 4>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniformMatrix3x4fv(location, count, false, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 12 * sizeof(GLfloat)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniformMatrix3x4fv(GetHandle(), location, count, false, values);
+        }
+        else
+        {
+            glUniformMatrix3x4fv(location, count, false, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 4, 2>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniformMatrix4x2fv(location, count, false, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 8 * sizeof(GLfloat)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniformMatrix4x2fv(GetHandle(), location, count, false, values);
+        }
+        else
+        {
+            glUniformMatrix4x2fv(location, count, false, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 4, 3>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniformMatrix4x3fv(location, count, false, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 12 * sizeof(GLfloat)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniformMatrix4x3fv(GetHandle(), location, count, false, values);
+        }
+        else
+        {
+            glUniformMatrix4x3fv(location, count, false, values);
+        }
+    }
 }
 
 template<>
 void ShaderProgram::SetUniforms<GLfloat, 4, 4>(Location location, const GLfloat* values, GLsizei count) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    glUniformMatrix4fv(location, count, false, values);
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    if (UpdateUniformShadow(location, values, count * 16 * sizeof(GLfloat)))
+    {
+        if (DeviceGL::HasDirectStateAccess())
+        {
+            glProgramUniformMatrix4fv(GetHandle(), location, count, false, values);
+        }
+        else
+        {
+            glUniformMatrix4fv(location, count, false, values);
+        }
+    }
 }
 
 void ShaderProgram::SetTexture(Location location, GLint textureUnit, const TextureObject& texture) const
 {
     assert(IsValid());
-    assert(IsUsed());
-    TextureObject::SetActiveTexture(textureUnit);
-    texture.Bind();
+    assert(IsUsed() || DeviceGL::HasDirectStateAccess());
+    texture.BindTextureUnit(textureUnit);
     SetUniform(location, textureUnit);
 }
+
+GLint ShaderProgram::GetTextureUnit(Location location) const
+{
+    assert(location >= 0);
+
+    // Fixed locations are the same in all the programs, so the units are shared too
+    // If the sampler locations of all the programs need more units than the driver has, each program assigns its own
+    // The units are set again with the textures, so the programs that used the shared ones switch on their next draw
+    if (s_sharedTextureUnits)
+    {
+        GLint textureUnit = location < static_cast<Location>(s_textureUnits.size()) ? s_textureUnits[location] : -1;
+        if (textureUnit >= 0)
+        {
+            return textureUnit;
+        }
+        if (s_textureUnitCount < s_maxTextureUnits)
+        {
+            if (location >= static_cast<Location>(s_textureUnits.size()))
+            {
+                s_textureUnits.resize(location + 1, -1);
+            }
+            s_textureUnits[location] = s_textureUnitCount++;
+            return s_textureUnits[location];
+        }
+
+        std::cout << "WARNING::SHADER::TEXTURE_UNITS_EXCEEDED\n" << "More than " << s_maxTextureUnits
+            << " sampler locations, texture units are assigned per program" << std::endl;
+        s_sharedTextureUnits = false;
+    }
+
+    if (location >= static_cast<Location>(m_textureUnits.size()))
+    {
+        m_textureUnits.resize(location + 1, -1);
+    }
+
+    GLint& textureUnit = m_textureUnits[location];
+    if (textureUnit < 0)
+    {
+        // The program itself uses more samplers than the driver supports
+        assert(m_textureUnitCount < s_maxTextureUnits);
+        textureUnit = m_textureUnitCount++;
+    }
+    return textureUnit;
+}
+
+void ShaderProgram::ResetTextureUnits()
+{
+    m_textureUnits.clear();
+    m_textureUnitCount = 0;
+}
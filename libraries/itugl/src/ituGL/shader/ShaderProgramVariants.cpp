@@ -0,0 +1,129 @@
+#include <ituGL/shader/ShaderProgramVariants.h>
+
+#include <ituGL/shader/ShaderProgram.h>
+#include <ituGL/asset/ShaderProgramCache.h>
+#include <algorithm>
+#include <cassert>
+
+ShaderProgramVariants::ShaderProgramVariants(std::span<const char*> vertexShaderPaths, std::span<const char*> fragmentShaderPaths,
+    std::span<const char* const> keywords)
+    : m_vertexShaderPaths(vertexShaderPaths.begin(), vertexShaderPaths.end())
+    , m_fragmentShaderPaths(fragmentShaderPaths.begin(), fragmentShaderPaths.end())
+    , m_keywords(keywords.begin(), keywords.end())
+{
+    assert(m_keywords.size() <= sizeof(KeywordMask) * 8);
+}
+
+int ShaderProgramVariants::GetKeywordIndex(const std::string& keyword) const
+{
+    for (size_t i = 0; i < m_keywords.size(); ++i)
+    {
+        if (m_keywords[i] == keyword)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+ShaderProgramVariants::KeywordMask ShaderProgramVariants::GetKeywordMask(std::span<const std::string> keywords) const
+{
+    KeywordMask keywordMask = 0;
+    for (const std::string& keyword : keywords)
+    {
+        int keywordIndex = GetKeywordIndex(keyword);
+        if (keywordIndex >= 0)
+        {
+            keywordMask |= 1u << keywordIndex;
+        }
+    }
+    return keywordMask;
+}
+
+std::shared_ptr<ShaderProgram> ShaderProgramVariants::GetVariant(KeywordMask keywordMask)
+{
+    auto itVariant = m_variants.find(keywordMask);
+    if (itVariant == m_variants.end())
+    {
+        Prewarm(std::span(&keywordMask, 1));
+        itVariant = m_variants.find(keywordMask);
+    }
+    return itVariant->second;
+}
+
+void ShaderProgramVariants::Prewarm(std::span<const KeywordMask> keywordMasks)
+{
+    std::vector<const char*> vertexShaderPaths;
+    for (const std::string& path : m_vertexShaderPaths)
+    {
+        vertexShaderPaths.push_back(path.c_str());
+    }
+    std::vector<const char*> fragmentShaderPaths;
+    for (const std::string& path : m_fragmentShaderPaths)
+    {
+        fragmentShaderPaths.push_back(path.c_str());
+    }
+    ShaderProgramCache::Stage stages[] = { { Shader::VertexShader, vertexShaderPaths }, { Shader::FragmentShader, fragmentShaderPaths } };
+
+    // The requests point to the defines, so they are all created before building
+    std::vector<KeywordMask> newMasks;
+    for (KeywordMask keywordMask : keywordMasks)
+    {
+        if (!m_variants.contains(keywordMask) && std::find(newMasks.begin(), newMasks.end(), keywordMask) == newMasks.end())
+        {
+            newMasks.push_back(keywordMask);
+        }
+    }
+    std::vector<std::vector<std::string>> defines(newMasks.size());
+    std::vector<std::shared_ptr<ShaderProgram>> shaderPrograms;
+    std::vector<ShaderProgramCache::Request> requests;
+    for (size_t i = 0; i < newMasks.size(); ++i)
+    {
+        GetDefines(newMasks[i], defines[i]);
+        shaderPrograms.push_back(std::make_shared<ShaderProgram>());
+        requests.push_back(ShaderProgramCache::Request{ shaderPrograms[i].get(), stages, defines[i] });
+    }
+    ShaderProgramCache::GetInstance().Build(requests);
+
+    for (size_t i = 0; i < newMasks.size(); ++i)
+    {
+        m_variants[newMasks[i]] = shaderPrograms[i];
+        if (m_variantCreatedFunction)
+        {
+            m_variantCreatedFunction(shaderPrograms[i]);
+        }
+    }
+}
+
+void ShaderProgramVariants::AddVariant(KeywordMask keywordMask, std::shared_ptr<ShaderProgram> shaderProgram)
+{
+    assert(shaderProgram);
+    m_variants[keywordMask] = shaderProgram;
+    if (m_variantCreatedFunction)
+    {
+        m_variantCreatedFunction(shaderProgram);
+    }
+}
+
+void ShaderProgramVariants::SetVariantCreatedFunction(VariantCreatedFunction variantCreatedFunction)
+{
+    m_variantCreatedFunction = variantCreatedFunction;
+    if (m_variantCreatedFunction)
+    {
+        for (auto& variant : m_variants)
+        {
+            m_variantCreatedFunction(variant.second);
+        }
+    }
+}
+
+void ShaderProgramVariants::GetDefines(KeywordMask keywordMask, std::vector<std::string>& defines) const
+{
+    for (size_t i = 0; i < m_keywords.size(); ++i)
+    {
+        if (keywordMask & (1u << i))
+        {
+            defines.push_back(m_keywords[i]);
+        }
+    }
+}
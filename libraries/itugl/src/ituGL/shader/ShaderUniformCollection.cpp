@@ -1,14 +1,21 @@
 #include <ituGL/shader/ShaderUniformCollection.h>
 #include <cassert>
 #include <array>
+#include <algorithm>
+
+unsigned int ShaderUniformCollection::s_lastVersion = 0;
 
 ShaderUniformCollection::ShaderUniformCollection() : m_shaderProgram(nullptr)
+    , m_blockUniformCount(0), m_blockDirtyBegin(0), m_blockDirtyEnd(0), m_version(0)
 {
+    UpdateVersion();
 }
 
 ShaderUniformCollection::ShaderUniformCollection(std::shared_ptr<ShaderProgram> shaderProgram, const NameSet& filteredUniforms) : m_shaderProgram(shaderProgram)
+    , m_blockUniformCount(0), m_blockDirtyBegin(0), m_blockDirtyEnd(0), m_version(0)
 {
     ExtractUniforms(filteredUniforms);
+    UpdateVersion();
 }
 
 std::shared_ptr<ShaderProgram> ShaderUniformCollection::GetShaderProgram()
@@ -26,6 +33,7 @@ void ShaderUniformCollection::ChangeShader(std::shared_ptr<ShaderProgram> shader
     Reset();
     m_shaderProgram = shaderProgram;
     ExtractUniforms(filteredUniforms);
+    UpdateVersion();
 }
 
 ShaderProgram::Location ShaderUniformCollection::GetAttributeLocation(const char* name) const
@@ -35,6 +43,14 @@ ShaderProgram::Location ShaderUniformCollection::GetAttributeLocation(const char
 
 ShaderProgram::Location ShaderUniformCollection::GetUniformLocation(const char* name) const
 {
+    if (!m_blockLocations.empty())
+    {
+        auto itBlock = m_blockLocations.find(name);
+        if (itBlock != m_blockLocations.end())
+        {
+            return itBlock->second;
+        }
+    }
     return m_shaderProgram->GetUniformLocation(name);
 }
 
@@ -45,7 +61,9 @@ ShaderUniformCollection::DataUniform& ShaderUniformCollection::GetDataUniform(Sh
 
 const ShaderUniformCollection::DataUniform& ShaderUniformCollection::GetDataUniform(ShaderProgram::Location location) const
 {
-    int uniformIndex = m_locationDataIndex.at(location);
+    assert(location >= 0 && location < static_cast<ShaderProgram::Location>(m_locationDataIndex.size()));
+    int uniformIndex = m_locationDataIndex[location];
+    assert(uniformIndex >= 0);
     const DataUniform& uniform = m_dataUniforms[uniformIndex];
     assert(uniform.location == location);
     return uniform;
@@ -58,7 +76,9 @@ ShaderUniformCollection::TextureUniform& ShaderUniformCollection::GetTextureUnif
 
 const ShaderUniformCollection::TextureUniform& ShaderUniformCollection::GetTextureUniform(ShaderProgram::Location location) const
 {
-    int uniformIndex = m_locationTextureIndex.at(location);
+    assert(location >= 0 && location < static_cast<ShaderProgram::Location>(m_locationTextureIndex.size()));
+    int uniformIndex = m_locationTextureIndex[location];
+    assert(uniformIndex >= 0);
     const TextureUniform& uniform = m_textureUniforms[uniformIndex];
     assert(uniform.location == location);
     return uniform;
@@ -72,6 +92,11 @@ void ShaderUniformCollection::ExtractUniforms(const NameSet& filteredUniforms)
 
     unsigned int uniformCount = shaderProgram.GetUniformCount();
 
+    // Properties in the uniform block are added at the end, with locations after the last one of the program
+    std::vector<std::pair<std::string, DataUniform>> blockUniforms;
+    ShaderProgram::Location maxLocation = -1;
+    int blockIndex = -1;
+
     // Loop over all the uniforms
     for (unsigned int i = 0; i < uniformCount; ++i)
     {
@@ -85,13 +110,38 @@ void ShaderUniformCollection::ExtractUniforms(const NameSet& filteredUniforms)
         if (filteredUniforms.contains(uniformName))
             continue;
 
-        // Get the uniform location
-        ShaderProgram::Location location = GetUniformLocation(uniformName);
-        assert(location >= 0);
+        int uniformBlockIndex, blockOffset, arrayStride, matrixStride;
+        shaderProgram.GetUniformBlockLayout(i, uniformBlockIndex, blockOffset, arrayStride, matrixStride);
 
         Data::Type type;
         UniformDimension dimension;
         TextureObject::Target target;
+        if (uniformBlockIndex >= 0)
+        {
+            // Only one block of properties is supported, with data properties
+            bool isData = IsDataUniform(glType, type, dimension);
+            assert(isData && (blockIndex < 0 || blockIndex == uniformBlockIndex));
+            if (!isData || (blockIndex >= 0 && blockIndex != uniformBlockIndex))
+                continue;
+
+            blockIndex = uniformBlockIndex;
+            DataUniform uniform;
+            uniform.location = -1;
+            uniform.type = type;
+            uniform.dimension = dimension;
+            uniform.count = size;
+            uniform.blockOffset = blockOffset;
+            uniform.arrayStride = arrayStride;
+            uniform.matrixStride = matrixStride;
+            blockUniforms.emplace_back(uniformName, uniform);
+            continue;
+        }
+
+        // Get the uniform location
+        ShaderProgram::Location location = GetUniformLocation(uniformName);
+        assert(location >= 0);
+        maxLocation = std::max(maxLocation, location);
+
         if (IsDataUniform(glType, type, dimension))
         {
             // If it is a data property, store as data
@@ -100,6 +150,9 @@ void ShaderUniformCollection::ExtractUniforms(const NameSet& filteredUniforms)
             uniform.type = type;
             uniform.dimension = dimension;
             uniform.count = size;
+            uniform.blockOffset = -1;
+            uniform.arrayStride = 0;
+            uniform.matrixStride = 0;
             AddUniform(uniform);
         }
         else if (IsTextureUniform(glType, target))
@@ -116,6 +169,40 @@ void ShaderUniformCollection::ExtractUniforms(const NameSet& filteredUniforms)
             assert(false);
         }
     }
+
+    if (blockIndex >= 0)
+    {
+        int dataSize;
+        char blockName[256];
+        shaderProgram.GetUniformBlockInfo(blockIndex, dataSize, std::span(blockName, sizeof(blockName)));
+        m_blockName = blockName;
+
+        for (auto& blockUniform : blockUniforms)
+        {
+            blockUniform.second.location = ++maxLocation;
+            m_blockLocations[blockUniform.first] = blockUniform.second.location;
+            AddUniform(blockUniform.second);
+        }
+        m_blockUniformCount = static_cast<unsigned int>(blockUniforms.size());
+
+        // All the values are uploaded on the first use
+        m_blockData.assign(dataSize, std::byte(0));
+        m_blockDirtyBegin = 0;
+        m_blockDirtyEnd = m_blockData.size();
+        m_blockStorage.Allocate(m_blockData.size());
+
+        SetupUniformBlock(shaderProgram);
+    }
+
+    // Same order as GetUniformLocations. The properties in the block are not set as uniforms
+    for (const DataUniform& uniform : m_dataUniforms)
+    {
+        m_uniformLocations.push_back(uniform.blockOffset < 0 ? uniform.location : -1);
+    }
+    for (const TextureUniform& uniform : m_textureUniforms)
+    {
+        m_uniformLocations.push_back(uniform.location);
+    }
 }
 
 bool ShaderUniformCollection::IsDataUniform(GLenum glType, Data::Type& type, UniformDimension& dimension)
@@ -282,97 +369,314 @@ void ShaderUniformCollection::AddUniform(const DataUniform& uniform)
 
 void ShaderUniformCollection::AddUniform(const TextureUniform& uniform)
 {
-    m_locationTextureIndex.insert(std::make_pair(uniform.location, static_cast<int>(m_textureUniforms.size())));
+    if (uniform.location >= static_cast<ShaderProgram::Location>(m_locationTextureIndex.size()))
+    {
+        m_locationTextureIndex.resize(uniform.location + 1, -1);
+    }
+    m_locationTextureIndex[uniform.location] = static_cast<int>(m_textureUniforms.size());
     m_textureUniforms.push_back(uniform);
 }
 
 void ShaderUniformCollection::SetUniforms() const
 {
-    for (const DataUniform& uniform : m_dataUniforms)
+    SetUniforms(*m_shaderProgram, m_uniformLocations);
+}
+
+void ShaderUniformCollection::GetUniformLocations(const ShaderProgram& shaderProgram, std::vector<ShaderProgram::Location>& locations) const
+{
+    assert(m_shaderProgram);
+
+    SetupUniformBlock(shaderProgram);
+
+    // Data properties first, then texture properties, in the same order they are stored
+    locations.assign(m_dataUniforms.size() + m_textureUniforms.size(), -1);
+
+    // The names are not stored, so they are taken from the uniforms of our own program
+    unsigned int uniformCount = m_shaderProgram->GetUniformCount();
+    for (unsigned int i = 0; i < uniformCount; ++i)
     {
-        UseUniform(uniform);
+        int size;
+        GLenum glType;
+        char uniformName[256];
+        m_shaderProgram->GetUniformInfo(i, size, glType, std::span(uniformName, sizeof(uniformName)));
+
+        ShaderProgram::Location location = GetUniformLocation(uniformName);
+        if (location < 0)
+        {
+            continue;
+        }
+        if (location < static_cast<ShaderProgram::Location>(m_locationDataIndex.size()) && m_locationDataIndex[location] >= 0)
+        {
+            locations[m_locationDataIndex[location]] = shaderProgram.GetUniformLocation(uniformName);
+            continue;
+        }
+        if (location < static_cast<ShaderProgram::Location>(m_locationTextureIndex.size()) && m_locationTextureIndex[location] >= 0)
+        {
+            locations[m_dataUniforms.size() + m_locationTextureIndex[location]] = shaderProgram.GetUniformLocation(uniformName);
+        }
     }
+}
+
+void ShaderUniformCollection::SetUniforms(const ShaderProgram& shaderProgram, std::span<const ShaderProgram::Location> locations) const
+{
+    assert(locations.size() == m_dataUniforms.size() + m_textureUniforms.size());
+
+    size_t locationIndex = 0;
+
+    // If the program still has the values of this version, the data uniforms are skipped
+    // Each upload still compares the value with the last one in the program, in case another collection set it
+    if (!shaderProgram.CheckUniformSource(m_version, static_cast<unsigned int>(m_dataUniforms.size()) - m_blockUniformCount))
+    {
+        for (const DataUniform& uniform : m_dataUniforms)
+        {
+            ShaderProgram::Location location = locations[locationIndex++];
+            if (location >= 0)
+            {
+                UseUniform(uniform, shaderProgram, location);
+            }
+        }
+        shaderProgram.SetUniformSource(m_version, locations.first(m_dataUniforms.size()));
+    }
+    locationIndex = m_dataUniforms.size();
+
+    // Texture units are global, so the textures are always bound, unless the device has them bound already
+    // The sampler uniforms are skipped if unchanged
+    for (const TextureUniform& uniform : m_textureUniforms)
+    {
+        ShaderProgram::Location location = locations[locationIndex++];
+        if (location >= 0)
+        {
+            UseUniform(uniform, shaderProgram, location);
+        }
+    }
+
+    if (!m_blockName.empty())
+    {
+        UseUniformBlock();
+    }
+}
+
+void ShaderUniformCollection::GetTextures(std::vector<const TextureObject*>& textures) const
+{
     for (const TextureUniform& uniform : m_textureUniforms)
     {
-        UseUniform(uniform);
+        if (uniform.texture)
+        {
+            textures.push_back(uniform.texture.get());
+        }
+    }
+}
+
+void ShaderUniformCollection::GetPropertyValues(std::vector<PropertyValue>& values) const
+{
+    assert(m_shaderProgram);
+
+    // The names are not stored, so they are taken from the uniforms of our own program, like in GetUniformLocations
+    unsigned int uniformCount = m_shaderProgram->GetUniformCount();
+    for (unsigned int i = 0; i < uniformCount; ++i)
+    {
+        int size;
+        GLenum glType;
+        char uniformName[256];
+        m_shaderProgram->GetUniformInfo(i, size, glType, std::span(uniformName, sizeof(uniformName)));
+
+        ShaderProgram::Location location = GetUniformLocation(uniformName);
+        if (location < 0)
+        {
+            continue;
+        }
+        if (location < static_cast<ShaderProgram::Location>(m_locationDataIndex.size()) && m_locationDataIndex[location] >= 0)
+        {
+            const DataUniform& uniform = m_dataUniforms[m_locationDataIndex[location]];
+            const std::byte* bytes = GetDataBytes(uniform);
+            PropertyValue& value = values.emplace_back();
+            value.name = uniformName;
+            value.data.assign(bytes, bytes + GetDataUniformSize(uniform) * Data::GetTypeSize(uniform.type));
+        }
+        else if (location < static_cast<ShaderProgram::Location>(m_locationTextureIndex.size()) && m_locationTextureIndex[location] >= 0)
+        {
+            PropertyValue& value = values.emplace_back();
+            value.name = uniformName;
+            value.isTexture = true;
+            value.texture = m_textureUniforms[m_locationTextureIndex[location]].texture;
+        }
+    }
+}
+
+unsigned int ShaderUniformCollection::SetPropertyValues(std::span<const PropertyValue> values)
+{
+    unsigned int setCount = 0;
+    for (const PropertyValue& value : values)
+    {
+        ShaderProgram::Location location = GetUniformLocation(value.name.c_str());
+        if (location < 0)
+        {
+            continue;
+        }
+        if (value.isTexture)
+        {
+            if (location < static_cast<ShaderProgram::Location>(m_locationTextureIndex.size()) && m_locationTextureIndex[location] >= 0)
+            {
+                TextureUniform& uniform = m_textureUniforms[m_locationTextureIndex[location]];
+                if (!value.texture || uniform.target == value.texture->GetTarget())
+                {
+                    uniform.texture = value.texture;
+                    setCount++;
+                }
+            }
+        }
+        else if (location < static_cast<ShaderProgram::Location>(m_locationDataIndex.size()) && m_locationDataIndex[location] >= 0)
+        {
+            const DataUniform& uniform = m_dataUniforms[m_locationDataIndex[location]];
+            if (value.data.size() == static_cast<size_t>(GetDataUniformSize(uniform) * Data::GetTypeSize(uniform.type)))
+            {
+                std::memcpy(const_cast<std::byte*>(GetDataBytes(uniform)), value.data.data(), value.data.size());
+                if (!m_blockName.empty())
+                {
+                    WriteBlockValues(uniform);
+                }
+                setCount++;
+            }
+        }
+    }
+
+    if (setCount > 0)
+    {
+        UpdateVersion();
     }
+    return setCount;
 }
 
-void ShaderUniformCollection::UseUniform(const DataUniform& uniform) const
+void ShaderUniformCollection::WriteBlockValues(const DataUniform& uniform)
+{
+    if (uniform.blockOffset < 0)
+    {
+        return;
+    }
+
+    // Matrices are stored by columns, and each column and array element can have padding after it
+    int columns, rows;
+    GetDimensionSize(uniform.dimension, columns, rows);
+    size_t columnSize = rows * Data::GetTypeSize(uniform.type);
+    const std::byte* values = GetDataBytes(uniform);
+    size_t end = uniform.blockOffset;
+    for (unsigned int element = 0; element < uniform.count; ++element)
+    {
+        size_t elementOffset = uniform.blockOffset + element * uniform.arrayStride;
+        for (int column = 0; column < columns; ++column)
+        {
+            size_t columnOffset = elementOffset + column * uniform.matrixStride;
+            assert(columnOffset + columnSize <= m_blockData.size());
+            std::memcpy(&m_blockData[columnOffset], values, columnSize);
+            values += columnSize;
+            end = std::max(end, columnOffset + columnSize);
+        }
+    }
+
+    m_blockDirtyBegin = std::min(m_blockDirtyBegin, static_cast<size_t>(uniform.blockOffset));
+    m_blockDirtyEnd = std::max(m_blockDirtyEnd, end);
+}
+
+void ShaderUniformCollection::UseUniformBlock() const
+{
+    UniformBufferArena& arena = *m_blockStorage.arena;
+    if (m_blockDirtyBegin < m_blockDirtyEnd)
+    {
+        std::span<const std::byte> blockData(m_blockData);
+        arena.Update(m_blockStorage.slice, m_blockDirtyBegin, blockData.subspan(m_blockDirtyBegin, m_blockDirtyEnd - m_blockDirtyBegin));
+        m_blockDirtyBegin = m_blockData.size();
+        m_blockDirtyEnd = 0;
+    }
+    arena.Bind(BlockBinding, m_blockStorage.slice);
+}
+
+void ShaderUniformCollection::SetupUniformBlock(const ShaderProgram& shaderProgram) const
+{
+    if (!m_blockName.empty())
+    {
+        int blockIndex = shaderProgram.GetUniformBlockIndex(m_blockName.c_str());
+        if (blockIndex >= 0)
+        {
+            shaderProgram.SetUniformBlockBinding(blockIndex, BlockBinding);
+        }
+    }
+}
+
+void ShaderUniformCollection::UseUniform(const DataUniform& uniform, const ShaderProgram& targetProgram, ShaderProgram::Location targetLocation) const
 {
     switch (uniform.type)
     {
     case Data::Type::Int:
-        UseUniform<int>(uniform);
+        UseUniform<int>(uniform, targetProgram, targetLocation);
         break;
     case Data::Type::UInt:
-        UseUniform<unsigned int>(uniform);
+        UseUniform<unsigned int>(uniform, targetProgram, targetLocation);
         break;
     case Data::Type::Float:
-        UseUniform<float>(uniform);
+        UseUniform<float>(uniform, targetProgram, targetLocation);
         break;
     case Data::Type::Double:
-        UseUniform<double>(uniform);
+        UseUniform<double>(uniform, targetProgram, targetLocation);
         break;
     default:
         assert(false);
     }
 }
 
-void ShaderUniformCollection::UseUniform(const TextureUniform& uniform) const
+void ShaderUniformCollection::UseUniform(const TextureUniform& uniform, const ShaderProgram& targetProgram, ShaderProgram::Location targetLocation) const
 {
     //TODO: default texture
     if (uniform.texture)
     {
-        size_t textureIndex = &uniform - m_textureUniforms.data();
-        m_shaderProgram->SetTexture(uniform.location, static_cast<int>(textureIndex), *uniform.texture);
+        // Each location keeps its texture unit, so materials sharing textures don't bind them again
+        targetProgram.SetTexture(targetLocation, *uniform.texture);
     }
 }
 
 template<>
-void ShaderUniformCollection::UseUniform<float>(const DataUniform& uniform) const
+void ShaderUniformCollection::UseUniform<float>(const DataUniform& uniform, const ShaderProgram& targetProgram, ShaderProgram::Location targetLocation) const
 {
     ShaderProgram::Location location = uniform.location;
     switch (uniform.dimension)
     {
     case UniformDimension::Scalar:
-        m_shaderProgram->SetUniforms<float>(location, GetDataValues<float>(location));
+        targetProgram.SetUniforms<float>(targetLocation, GetDataValues<float>(location));
         break;
     case UniformDimension::Vector2:
-        m_shaderProgram->SetUniforms<float, 2>(location, GetDataValues<glm::vec<2,float>>(location));
+        targetProgram.SetUniforms<float, 2>(targetLocation, GetDataValues<glm::vec<2,float>>(location));
         break;
     case UniformDimension::Vector3:
-        m_shaderProgram->SetUniforms<float, 3>(location, GetDataValues<glm::vec<3, float>>(location));
+        targetProgram.SetUniforms<float, 3>(targetLocation, GetDataValues<glm::vec<3, float>>(location));
         break;
     case UniformDimension::Vector4:
-        m_shaderProgram->SetUniforms<float, 4>(location, GetDataValues<glm::vec<4, float>>(location));
+        targetProgram.SetUniforms<float, 4>(targetLocation, GetDataValues<glm::vec<4, float>>(location));
         break;
     case UniformDimension::Matrix2x2:
-        m_shaderProgram->SetUniforms<float, 2, 2>(location, GetDataValues<glm::mat<2, 2, float>>(location));
+        targetProgram.SetUniforms<float, 2, 2>(targetLocation, GetDataValues<glm::mat<2, 2, float>>(location));
         break;
     case UniformDimension::Matrix2x3:
-        m_shaderProgram->SetUniforms<float, 2, 3>(location, GetDataValues<glm::mat<2, 3, float>>(location));
+        targetProgram.SetUniforms<float, 2, 3>(targetLocation, GetDataValues<glm::mat<2, 3, float>>(location));
         break;
     case UniformDimension::Matrix2x4:
-        m_shaderProgram->SetUniforms<float, 2, 4>(location, GetDataValues<glm::mat<2, 4, float>>(location));
+        targetProgram.SetUniforms<float, 2, 4>(targetLocation, GetDataValues<glm::mat<2, 4, float>>(location));
         break;
     case UniformDimension::Matrix3x2:
-        m_shaderProgram->SetUniforms<float, 3, 2>(location, GetDataValues<glm::mat<3, 2, float>>(location));
+        targetProgram.SetUniforms<float, 3, 2>(targetLocation, GetDataValues<glm::mat<3, 2, float>>(location));
         break;
     case UniformDimension::Matrix3x3:
-        m_shaderProgram->SetUniforms<float, 3, 3>(location, GetDataValues<glm::mat<3, 3, float>>(location));
+        targetProgram.SetUniforms<float, 3, 3>(targetLocation, GetDataValues<glm::mat<3, 3, float>>(location));
         break;
     case UniformDimension::Matrix3x4:
-        m_shaderProgram->SetUniforms<float, 3, 4>(location, GetDataValues<glm::mat<3, 4, float>>(location));
+        targetProgram.SetUniforms<float, 3, 4>(targetLocation, GetDataValues<glm::mat<3, 4, float>>(location));
         break;
     case UniformDimension::Matrix4x2:
-        m_shaderProgram->SetUniforms<float, 4, 2>(location, GetDataValues<glm::mat<4, 2, float>>(location));
+        targetProgram.SetUniforms<float, 4, 2>(targetLocation, GetDataValues<glm::mat<4, 2, float>>(location));
         break;
     case UniformDimension::Matrix4x3:
-        m_shaderProgram->SetUniforms<float, 4, 3>(location, GetDataValues<glm::mat<4, 3, float>>(location));
+        targetProgram.SetUniforms<float, 4, 3>(targetLocation, GetDataValues<glm::mat<4, 3, float>>(location));
         break;
     case UniformDimension::Matrix4x4:
-        m_shaderProgram->SetUniforms<float, 4, 4>(location, GetDataValues<glm::mat<4, 4, float>>(location));
+        targetProgram.SetUniforms<float, 4, 4>(targetLocation, GetDataValues<glm::mat<4, 4, float>>(location));
         break;
     default:
         assert(false);
@@ -392,6 +696,25 @@ void ShaderUniformCollection::SetUniformValue(ShaderProgram::Location location,
     TextureUniform& uniform = GetTextureUniform(location);
     assert(!value || uniform.target == value->GetTarget());
     uniform.texture = value;
+    UpdateVersion();
+}
+
+const std::byte* ShaderUniformCollection::GetDataBytes(const DataUniform& uniform) const
+{
+    switch (uniform.type)
+    {
+    case Data::Type::Int:
+        return reinterpret_cast<const std::byte*>(&m_intDataValues[uniform.index]);
+    case Data::Type::UInt:
+        return reinterpret_cast<const std::byte*>(&m_uintDataValues[uniform.index]);
+    case Data::Type::Float:
+        return reinterpret_cast<const std::byte*>(&m_floatDataValues[uniform.index]);
+    case Data::Type::Double:
+        return reinterpret_cast<const std::byte*>(&m_doubleDataValues[uniform.index]);
+    default:
+        assert(false);
+        return nullptr;
+    }
 }
 
 int ShaderUniformCollection::GetDataUniformSize(const DataUniform& uniform) const
@@ -436,6 +759,21 @@ int ShaderUniformCollection::GetDataUniformSize(const DataUniform& uniform) cons
     return size * uniform.count;
 }
 
+void ShaderUniformCollection::GetDimensionSize(UniformDimension dimension, int& columns, int& rows)
+{
+    if (dimension >= UniformDimension::MatrixFirst && dimension <= UniformDimension::MatrixLast)
+    {
+        int offset = static_cast<int>(dimension) - static_cast<int>(UniformDimension::MatrixFirst);
+        columns = 2 + offset / 3;
+        rows = 2 + offset % 3;
+    }
+    else
+    {
+        columns = 1;
+        rows = 1 + static_cast<int>(dimension) - static_cast<int>(UniformDimension::Scalar);
+    }
+}
+
 void ShaderUniformCollection::Reset()
 {
     m_shaderProgram = nullptr;
@@ -443,10 +781,60 @@ void ShaderUniformCollection::Reset()
     m_textureUniforms.clear();
     m_locationDataIndex.clear();
     m_locationTextureIndex.clear();
+    m_uniformLocations.clear();
     m_intDataValues.clear();
     m_uintDataValues.clear();
     m_floatDataValues.clear();
     m_doubleDataValues.clear();
+    m_blockName.clear();
+    m_blockLocations.clear();
+    m_blockUniformCount = 0;
+    m_blockData.clear();
+    m_blockDirtyBegin = 0;
+    m_blockDirtyEnd = 0;
+    m_blockStorage.Free();
+}
+
+ShaderUniformCollection::BlockStorage::BlockStorage(const BlockStorage& blockStorage)
+{
+    *this = blockStorage;
+}
+
+ShaderUniformCollection::BlockStorage& ShaderUniformCollection::BlockStorage::operator = (const BlockStorage& blockStorage)
+{
+    if (this != &blockStorage)
+    {
+        Free();
+        if (blockStorage.arena)
+        {
+            // Start with the contents uploaded for the other one, the values not uploaded yet are still marked as changed
+            Allocate(blockStorage.slice.size);
+            arena->Update(slice, 0, arena->GetData(blockStorage.slice));
+        }
+    }
+    return *this;
+}
+
+ShaderUniformCollection::BlockStorage::~BlockStorage()
+{
+    Free();
+}
+
+void ShaderUniformCollection::BlockStorage::Allocate(size_t size)
+{
+    Free();
+    arena = UniformBufferArena::GetInstance();
+    slice = arena->Allocate(size);
+}
+
+void ShaderUniformCollection::BlockStorage::Free()
+{
+    if (arena)
+    {
+        arena->Free(slice);
+        arena = nullptr;
+        slice = UniformBufferArena::Slice();
+    }
 }
 
 #ifndef NDEBUG
@@ -0,0 +1,140 @@
+#include <ituGL/shader/UniformBufferArena.h>
+
+#include <ituGL/core/DeviceGL.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+// Size of the buffer when it is created
+static const size_t s_initialCapacity = 16 * 1024;
+
+std::shared_ptr<UniformBufferArena> UniformBufferArena::GetInstance()
+{
+    static std::shared_ptr<UniformBufferArena> instance = std::make_shared<UniformBufferArena>();
+    return instance;
+}
+
+UniformBufferArena::UniformBufferArena()
+{
+}
+
+UniformBufferArena::Slice UniformBufferArena::Allocate(size_t size)
+{
+    // Slices start at aligned offsets, so each one can be bound on its own
+    size_t alignment = UniformBufferObject::GetOffsetAlignment();
+    size = (std::max<size_t>(size, 1) + alignment - 1) / alignment * alignment;
+
+    Slice slice;
+    if (!TakeFreeRange(size, slice))
+    {
+        Grow(m_data.size() + size);
+        bool found = TakeFreeRange(size, slice);
+        assert(found);
+    }
+    return slice;
+}
+
+void UniformBufferArena::Free(const Slice& slice)
+{
+    if (slice.size == 0)
+    {
+        return;
+    }
+
+    auto itNext = std::lower_bound(m_freeSlices.begin(), m_freeSlices.end(), slice.offset,
+        [](const Slice& freeSlice, size_t offset) { return freeSlice.offset < offset; });
+    auto itSlice = m_freeSlices.insert(itNext, slice);
+
+    // Merge with the next and the previous free ranges
+    auto itAfter = itSlice + 1;
+    if (itAfter != m_freeSlices.end() && itSlice->offset + itSlice->size == itAfter->offset)
+    {
+        itSlice->size += itAfter->size;
+        m_freeSlices.erase(itAfter);
+    }
+    if (itSlice != m_freeSlices.begin())
+    {
+        auto itBefore = itSlice - 1;
+        if (itBefore->offset + itBefore->size == itSlice->offset)
+        {
+            itBefore->size += itSlice->size;
+            m_freeSlices.erase(itSlice);
+        }
+    }
+}
+
+void UniformBufferArena::Update(const Slice& slice, size_t offset, std::span<const std::byte> data)
+{
+    assert(offset + data.size() <= slice.size);
+    std::memcpy(m_data.data() + slice.offset + offset, data.data(), data.size());
+
+    // With direct state access, the update doesn't change the generic binding
+    if (!DeviceGL::HasDirectStateAccess())
+    {
+        m_buffer->Bind();
+    }
+    m_buffer->UpdateData(data, slice.offset + offset);
+    ++m_stats.updates;
+    m_stats.updatedBytes += data.size();
+}
+
+void UniformBufferArena::Bind(GLuint binding, const Slice& slice)
+{
+    if (binding >= m_boundSlices.size())
+    {
+        m_boundSlices.resize(binding + 1);
+    }
+
+    Slice& boundSlice = m_boundSlices[binding];
+    if (boundSlice.offset == slice.offset && boundSlice.size == slice.size)
+    {
+        ++m_stats.skippedBinds;
+        return;
+    }
+
+    m_buffer->BindRange(binding, slice.offset, slice.size);
+    boundSlice = slice;
+    ++m_stats.binds;
+}
+
+bool UniformBufferArena::TakeFreeRange(size_t size, Slice& slice)
+{
+    for (auto itFree = m_freeSlices.begin(); itFree != m_freeSlices.end(); ++itFree)
+    {
+        if (itFree->size >= size)
+        {
+            slice.offset = itFree->offset;
+            slice.size = size;
+            itFree->offset += size;
+            itFree->size -= size;
+            if (itFree->size == 0)
+            {
+                m_freeSlices.erase(itFree);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void UniformBufferArena::Grow(size_t minCapacity)
+{
+    size_t oldCapacity = m_data.size();
+    size_t capacity = std::max(oldCapacity * 2, s_initialCapacity);
+    while (capacity < minCapacity)
+    {
+        capacity *= 2;
+    }
+    m_data.resize(capacity);
+
+    // Deleting the old buffer unbinds it, so nothing is bound anymore
+    m_buffer = std::make_unique<UniformBufferObject>();
+    if (!DeviceGL::HasDirectStateAccess())
+    {
+        m_buffer->Bind();
+    }
+    m_buffer->AllocateData(m_data, BufferObject::DynamicDraw);
+    m_boundSlices.clear();
+
+    Free(Slice{ oldCapacity, capacity - oldCapacity });
+}
@@ -0,0 +1,28 @@
+#include <ituGL/shader/UniformBufferObject.h>
+
+#include <cassert>
+
+UniformBufferObject::UniformBufferObject()
+{
+    // Nothing to do here, it is done by the base class
+}
+
+void UniformBufferObject::BindRange(GLuint binding, size_t offset, size_t size) const
+{
+    assert(offset % GetOffsetAlignment() == 0);
+    // It also binds the buffer to the generic target
+    glBindBufferRange(GL_UNIFORM_BUFFER, binding, GetHandle(), offset, size);
+#ifndef NDEBUG
+    s_boundHandle = GetHandle();
+#endif
+}
+
+size_t UniformBufferObject::GetOffsetAlignment()
+{
+    static GLint alignment = 0;
+    if (alignment == 0)
+    {
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    }
+    return static_cast<size_t>(alignment);
+}
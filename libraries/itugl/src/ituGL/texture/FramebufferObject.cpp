@@ -1,6 +1,8 @@
 #include <ituGL/texture/FramebufferObject.h>
 
 #include <ituGL/texture/Texture2DObject.h>
+#include <ituGL/core/DeviceGL.h>
+#include <ituGL/core/MemoryTracker.h>
 #include <cassert>
 
 std::shared_ptr<const FramebufferObject> FramebufferObject::s_defaultFramebuffer(std::make_shared<FramebufferObject>(FramebufferObject(Object::NullHandle)));
@@ -8,7 +10,14 @@ std::shared_ptr<const FramebufferObject> FramebufferObject::s_defaultFramebuffer
 FramebufferObject::FramebufferObject() : Object(NullHandle)
 {
     Handle& handle = GetHandle();
-    glGenFramebuffers(1, &handle);
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glCreateFramebuffers(1, &handle);
+    }
+    else
+    {
+        glGenFramebuffers(1, &handle);
+    }
 }
 
 FramebufferObject::FramebufferObject(Handle handle) : Object(handle)
@@ -55,10 +64,21 @@ std::shared_ptr<const FramebufferObject> FramebufferObject::GetDefault()
 
 void FramebufferObject::SetTexture(Target target, Attachment attachment, const Texture2DObject& texture, int level)
 {
+    MemoryTracker::GetInstance().SetCategory(MemoryTracker::ObjectType::Texture, texture.GetHandle(), MemoryTracker::Category::RenderTarget);
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glNamedFramebufferTexture(GetHandle(), static_cast<GLenum>(attachment), texture.GetHandle(), level);
+        return;
+    }
     glFramebufferTexture2D(static_cast<GLenum>(target), static_cast<GLenum>(attachment), texture.GetTarget(), texture.GetHandle(), level);
 }
 
 void FramebufferObject::SetDrawBuffers(std::span<const Attachment> attachments)
 {
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glNamedFramebufferDrawBuffers(GetHandle(), static_cast<GLint>(attachments.size()), reinterpret_cast<const GLenum*>(attachments.data()));
+        return;
+    }
     glDrawBuffers(static_cast<GLint>(attachments.size()), reinterpret_cast<const GLenum*>(attachments.data()));
 }
@@ -0,0 +1,92 @@
+#include <ituGL/texture/SamplerObject.h>
+
+#include <ituGL/core/DeviceGL.h>
+#include <array>
+#include <cassert>
+
+SamplerObject::SamplerObject() : Object(NullHandle)
+{
+    Handle& handle = GetHandle();
+    glGenSamplers(1, &handle);
+}
+
+SamplerObject::~SamplerObject()
+{
+    Handle& handle = GetHandle();
+    DeviceGL* device = DeviceGL::GetInstancePointer();
+    if (device && handle != NullHandle)
+    {
+        device->ForgetSampler(handle);
+    }
+    glDeleteSamplers(1, &handle);
+}
+
+void SamplerObject::Bind() const
+{
+    DeviceGL& device = DeviceGL::GetInstance();
+    assert(device.GetActiveTextureUnit() >= 0);
+    device.BindSampler(device.GetActiveTextureUnit(), GetHandle());
+}
+
+void SamplerObject::Bind(GLint textureUnit) const
+{
+    DeviceGL::GetInstance().BindSampler(textureUnit, GetHandle());
+}
+
+void SamplerObject::Unbind(GLint textureUnit)
+{
+    DeviceGL::GetInstance().BindSampler(textureUnit, NullHandle);
+}
+
+std::shared_ptr<const SamplerObject> SamplerObject::GetPreset(Preset preset)
+{
+    static std::array<std::shared_ptr<const SamplerObject>, static_cast<size_t>(Preset::Count)> presets;
+
+    std::shared_ptr<const SamplerObject>& presetSampler = presets[static_cast<size_t>(preset)];
+    if (!presetSampler)
+    {
+        bool mipmap = preset == Preset::LinearMipmapRepeat || preset == Preset::LinearMipmapClamp;
+        bool nearest = preset == Preset::NearestRepeat || preset == Preset::NearestClamp;
+        bool clamp = preset == Preset::LinearMipmapClamp || preset == Preset::LinearClamp || preset == Preset::NearestClamp;
+
+        std::shared_ptr<SamplerObject> sampler = std::make_shared<SamplerObject>();
+        sampler->SetParameter(TextureObject::ParameterEnum::MinFilter, nearest ? GL_NEAREST : (mipmap ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
+        sampler->SetParameter(TextureObject::ParameterEnum::MagFilter, nearest ? GL_NEAREST : GL_LINEAR);
+        GLenum wrap = clamp ? GL_CLAMP_TO_EDGE : GL_REPEAT;
+        sampler->SetParameter(TextureObject::ParameterEnum::WrapS, wrap);
+        sampler->SetParameter(TextureObject::ParameterEnum::WrapT, wrap);
+        sampler->SetParameter(TextureObject::ParameterEnum::WrapR, wrap);
+        presetSampler = sampler;
+    }
+    return presetSampler;
+}
+
+void SamplerObject::GetParameter(TextureObject::ParameterFloat pname, GLfloat& param) const
+{
+    glGetSamplerParameterfv(GetHandle(), static_cast<GLenum>(pname), &param);
+}
+
+void SamplerObject::SetParameter(TextureObject::ParameterFloat pname, GLfloat param)
+{
+    glSamplerParameterf(GetHandle(), static_cast<GLenum>(pname), param);
+}
+
+void SamplerObject::GetParameter(TextureObject::ParameterEnum pname, GLenum& param) const
+{
+    glGetSamplerParameterIuiv(GetHandle(), static_cast<GLenum>(pname), &param);
+}
+
+void SamplerObject::SetParameter(TextureObject::ParameterEnum pname, GLenum param)
+{
+    glSamplerParameteri(GetHandle(), static_cast<GLenum>(pname), param);
+}
+
+void SamplerObject::GetParameter(TextureObject::ParameterColor pname, std::span<GLfloat, 4> params) const
+{
+    glGetSamplerParameterfv(GetHandle(), static_cast<GLenum>(pname), params.data());
+}
+
+void SamplerObject::SetParameter(TextureObject::ParameterColor pname, std::span<const GLfloat, 4> params)
+{
+    glSamplerParameterfv(GetHandle(), static_cast<GLenum>(pname), params.data());
+}
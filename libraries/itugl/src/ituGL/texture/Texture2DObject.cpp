@@ -1,5 +1,8 @@
 #include <ituGL/texture/Texture2DObject.h>
 
+#include <ituGL/texture/PixelBufferObject.h>
+#include <ituGL/core/DeviceGL.h>
+
 #include <cassert>
 
 Texture2DObject::Texture2DObject()
@@ -14,9 +17,23 @@ void Texture2DObject::SetImage<std::byte>(GLint level, GLsizei width, GLsizei he
     assert(IsValidFormat(format, internalFormat));
     assert(data.empty() || data.size_bytes() == width * height * GetDataComponentCount(internalFormat) * Data::GetTypeSize(type));
     glTexImage2D(GetTarget(), level, internalFormat, width, height, 0, format, static_cast<GLenum>(type), data.data());
+    TrackImageMemory(level, width, height, internalFormat);
 }
 
 void Texture2DObject::SetImage(GLint level, GLsizei width, GLsizei height, Format format, InternalFormat internalFormat)
 {
     SetImage<float>(level, width, height, format, internalFormat, std::span<float>());
 }
+
+void Texture2DObject::SetSubImage(GLint level, GLint x, GLint y, GLsizei width, GLsizei height, Format format, Data::Type type, size_t bufferOffset)
+{
+    assert(PixelBufferObject::IsAnyBound());
+    assert(type != Data::Type::None);
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glTextureSubImage2D(GetHandle(), level, x, y, width, height, format, static_cast<GLenum>(type), reinterpret_cast<const void*>(bufferOffset));
+        return;
+    }
+    assert(IsBound());
+    glTexSubImage2D(GetTarget(), level, x, y, width, height, format, static_cast<GLenum>(type), reinterpret_cast<const void*>(bufferOffset));
+}
@@ -1,5 +1,8 @@
 #include <ituGL/texture/TextureCubemapObject.h>
 
+#include <ituGL/texture/PixelBufferObject.h>
+#include <ituGL/core/DeviceGL.h>
+
 #include <cassert>
 
 TextureCubemapObject::TextureCubemapObject()
@@ -14,6 +17,7 @@ void TextureCubemapObject::SetImage<std::byte>(GLint level, Face face, GLsizei s
     assert(IsValidFormat(format, internalFormat));
     assert(data.empty() || data.size_bytes() == side * side * GetDataComponentCount(internalFormat) * Data::GetTypeSize(type));
     glTexImage2D(static_cast<GLenum>(face), level, internalFormat, side, side, 0, format, static_cast<GLenum>(type), data.data());
+    TrackImageMemory(level * 6 + (static_cast<GLenum>(face) - GL_TEXTURE_CUBE_MAP_POSITIVE_X), side, side, internalFormat);
 }
 
 void TextureCubemapObject::SetImage(GLint level, GLsizei side, Format format, InternalFormat internalFormat)
@@ -26,3 +30,18 @@ void TextureCubemapObject::SetImage(GLint level, GLsizei side, Format format, In
     SetImage<std::byte>(level, Face::Front, side, format, internalFormat, empty, Data::Type::None);
     SetImage<std::byte>(level, Face::Back, side, format, internalFormat, empty, Data::Type::None);
 }
+
+void TextureCubemapObject::SetSubImage(GLint level, Face face, GLint x, GLint y, GLsizei width, GLsizei height, Format format, Data::Type type, size_t bufferOffset)
+{
+    assert(PixelBufferObject::IsAnyBound());
+    assert(type != Data::Type::None);
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        // The faces are the layers of the cubemap, in the order of their targets
+        GLint layer = static_cast<GLint>(static_cast<GLenum>(face) - GL_TEXTURE_CUBE_MAP_POSITIVE_X);
+        glTextureSubImage3D(GetHandle(), level, x, y, layer, width, height, 1, format, static_cast<GLenum>(type), reinterpret_cast<const void*>(bufferOffset));
+        return;
+    }
+    assert(IsBound());
+    glTexSubImage2D(static_cast<GLenum>(face), level, x, y, width, height, format, static_cast<GLenum>(type), reinterpret_cast<const void*>(bufferOffset));
+}
@@ -1,16 +1,36 @@
 #include <ituGL/texture/TextureObject.h>
 
+#include <ituGL/texture/SamplerObject.h>
+#include <ituGL/core/DeviceGL.h>
+#include <ituGL/core/MemoryTracker.h>
 #include <cassert>
 
-TextureObject::TextureObject() : Object(NullHandle)
+// With direct state access the texture is created already with its target, so it can be edited before binding it
+TextureObject::TextureObject(Target target) : Object(NullHandle)
 {
     Handle& handle = GetHandle();
-    glGenTextures(1, &handle);
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glCreateTextures(target, 1, &handle);
+    }
+    else
+    {
+        glGenTextures(1, &handle);
+    }
 }
 
 TextureObject::~TextureObject()
 {
     Handle& handle = GetHandle();
+    DeviceGL* device = DeviceGL::GetInstancePointer();
+    if (device && handle != NullHandle)
+    {
+        device->ForgetTexture(handle);
+    }
+    if (handle != NullHandle)
+    {
+        MemoryTracker::GetInstance().RemoveObject(MemoryTracker::ObjectType::Texture, handle);
+    }
     glDeleteTextures(1, &handle);
 }
 
@@ -23,85 +43,261 @@ GLint TextureObject::GetActiveTexture()
 }
 #endif
 
+// Binds go through the device when there is one, so it can skip the redundant ones
+
 void TextureObject::SetActiveTexture(GLint textureUnit)
 {
+    if (DeviceGL* device = DeviceGL::GetInstancePointer())
+    {
+        device->SetActiveTextureUnit(textureUnit);
+        return;
+    }
     glActiveTexture(GL_TEXTURE0 + textureUnit);
 }
 
 void TextureObject::Bind(Target target) const
 {
     Handle handle = GetHandle();
+    if (DeviceGL* device = DeviceGL::GetInstancePointer())
+    {
+        device->BindTexture(target, handle);
+        return;
+    }
     glBindTexture(target, handle);
 }
 
 void TextureObject::Unbind(Target target)
 {
     Handle handle = NullHandle;
+    if (DeviceGL* device = DeviceGL::GetInstancePointer())
+    {
+        device->BindTexture(target, handle);
+        return;
+    }
     glBindTexture(target, handle);
 }
 
+Object::Handle TextureObject::BindTextureUnit(Target target, GLint textureUnit) const
+{
+    Handle handle = GetHandle();
+    Handle sampler = m_sampler ? m_sampler->GetHandle() : NullHandle;
+    if (DeviceGL* device = DeviceGL::GetInstancePointer())
+    {
+        device->BindTexture(textureUnit, target, handle, sampler);
+        return device->GetBoundTexture(target);
+    }
+    glActiveTexture(GL_TEXTURE0 + textureUnit);
+    glBindTexture(target, handle);
+    glBindSampler(textureUnit, sampler);
+    return handle;
+}
+
 void TextureObject::GenerateMipmap()
 {
+    MemoryTracker::GetInstance().SetTextureMipmaps(GetHandle(), GetTarget() == TextureCubemap ? 6 : 1);
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glGenerateTextureMipmap(GetHandle());
+        return;
+    }
     assert(IsBound());
     glGenerateMipmap(GetTarget());
 }
 
+void TextureObject::TrackImageMemory(unsigned int image, GLsizei width, GLsizei height, InternalFormat internalFormat) const
+{
+    size_t bytes = static_cast<size_t>(width) * height * GetPixelBits(internalFormat) / 8;
+    MemoryTracker::GetInstance().SetTextureImage(GetHandle(), image, bytes, width, height);
+}
+
+size_t TextureObject::GetMemorySize() const
+{
+    bool directStateAccess = DeviceGL::HasDirectStateAccess();
+    assert(directStateAccess || IsBound());
+
+    // Cubemap levels are queried on one face, all faces have the same size
+    Target target = GetTarget();
+    GLenum levelTarget = target == TextureCubemap ? GL_TEXTURE_CUBE_MAP_POSITIVE_X : target;
+    size_t faceCount = target == TextureCubemap ? 6 : 1;
+
+    // Query a level parameter, with the texture or with the bound target
+    Handle handle = GetHandle();
+    auto getLevelParameter = [=](GLint level, GLenum pname, GLint* param)
+        {
+            if (directStateAccess)
+            {
+                glGetTextureLevelParameteriv(handle, level, pname, param);
+            }
+            else
+            {
+                glGetTexLevelParameteriv(levelTarget, level, pname, param);
+            }
+        };
+
+    // Levels can be missing, like when streaming mips, so all possible levels are checked
+    GLint maxTextureSize;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+
+    size_t size = 0;
+    for (GLint level = 0; (1 << level) <= maxTextureSize; ++level)
+    {
+        GLint width = 0, height = 0, depth = 0;
+        getLevelParameter(level, GL_TEXTURE_WIDTH, &width);
+        getLevelParameter(level, GL_TEXTURE_HEIGHT, &height);
+        getLevelParameter(level, GL_TEXTURE_DEPTH, &depth);
+        if (width == 0 || height == 0 || depth == 0)
+        {
+            continue;
+        }
+
+        GLint compressed = GL_FALSE;
+        getLevelParameter(level, GL_TEXTURE_COMPRESSED, &compressed);
+        if (compressed)
+        {
+            GLint imageSize = 0;
+            getLevelParameter(level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &imageSize);
+            size += faceCount * imageSize;
+        }
+        else
+        {
+            GLint bits = 0;
+            for (GLenum pname : { GL_TEXTURE_RED_SIZE, GL_TEXTURE_GREEN_SIZE, GL_TEXTURE_BLUE_SIZE, GL_TEXTURE_ALPHA_SIZE, GL_TEXTURE_DEPTH_SIZE, GL_TEXTURE_STENCIL_SIZE })
+            {
+                GLint componentBits = 0;
+                getLevelParameter(level, pname, &componentBits);
+                bits += componentBits;
+            }
+            size += faceCount * width * height * depth * ((bits + 7) / 8);
+        }
+    }
+    return size;
+}
+
+void TextureObject::GetLevelInfo(GLint level, GLint& width, GLint& height, GLint& internalFormat) const
+{
+    width = height = internalFormat = 0;
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        Handle handle = GetHandle();
+        glGetTextureLevelParameteriv(handle, level, GL_TEXTURE_WIDTH, &width);
+        glGetTextureLevelParameteriv(handle, level, GL_TEXTURE_HEIGHT, &height);
+        glGetTextureLevelParameteriv(handle, level, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+        return;
+    }
+    assert(IsBound());
+    Target target = GetTarget();
+    GLenum levelTarget = target == TextureCubemap ? GL_TEXTURE_CUBE_MAP_POSITIVE_X : target;
+    glGetTexLevelParameteriv(levelTarget, level, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(levelTarget, level, GL_TEXTURE_HEIGHT, &height);
+    glGetTexLevelParameteriv(levelTarget, level, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+}
+
 void TextureObject::GetParameter(ParameterFloat pname, GLfloat& param) const
 {
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glGetTextureParameterfv(GetHandle(), static_cast<GLenum>(pname), &param);
+        return;
+    }
     assert(IsBound());
     glGetTexParameterfv(GetTarget(), static_cast<GLenum>(pname), &param);
 }
 
 void TextureObject::SetParameter(ParameterFloat pname, GLfloat param)
 {
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glTextureParameterf(GetHandle(), static_cast<GLenum>(pname), param);
+        return;
+    }
     assert(IsBound());
     glTexParameterf(GetTarget(), static_cast<GLenum>(pname), param);
 }
 
 void TextureObject::GetParameter(ParameterInt pname, GLint& param) const
 {
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glGetTextureParameteriv(GetHandle(), static_cast<GLenum>(pname), &param);
+        return;
+    }
     assert(IsBound());
     glGetTexParameteriv(GetTarget(), static_cast<GLenum>(pname), &param);
 }
 
 void TextureObject::SetParameter(ParameterInt pname, GLint param)
 {
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glTextureParameteri(GetHandle(), static_cast<GLenum>(pname), param);
+        return;
+    }
     assert(IsBound());
     glTexParameteri(GetTarget(), static_cast<GLenum>(pname), param);
 }
 
 void TextureObject::GetParameter(ParameterEnum pname, GLenum& param) const
 {
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glGetTextureParameterIuiv(GetHandle(), static_cast<GLenum>(pname), &param);
+        return;
+    }
     assert(IsBound());
     glGetTexParameterIuiv(GetTarget(), static_cast<GLenum>(pname), &param);
 }
 
 void TextureObject::SetParameter(ParameterEnum pname, GLenum param)
 {
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glTextureParameteri(GetHandle(), static_cast<GLenum>(pname), param);
+        return;
+    }
     assert(IsBound());
     glTexParameteri(GetTarget(), static_cast<GLenum>(pname), param);
 }
 
 void TextureObject::GetParameter(ParameterEnumVector pname, std::span<GLenum> params) const
 {
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glGetTextureParameterIuiv(GetHandle(), static_cast<GLenum>(pname), params.data());
+        return;
+    }
     assert(IsBound());
     glGetTexParameterIuiv(GetTarget(), static_cast<GLenum>(pname), params.data());
 }
 
 void TextureObject::SetParameter(ParameterEnumVector pname, std::span<const GLenum> params)
 {
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glTextureParameterIuiv(GetHandle(), static_cast<GLenum>(pname), params.data());
+        return;
+    }
     assert(IsBound());
     glTexParameterIuiv(GetTarget(), static_cast<GLenum>(pname), params.data());
 }
 
 void TextureObject::GetParameter(ParameterColor pname, std::span<GLfloat, 4> params) const
 {
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glGetTextureParameterfv(GetHandle(), static_cast<GLenum>(pname), params.data());
+        return;
+    }
     assert(IsBound());
     glGetTexParameterfv(GetTarget(), static_cast<GLenum>(pname), params.data());
 }
 
 void TextureObject::SetParameter(ParameterColor pname, std::span<const GLfloat, 4> params)
 {
+    if (DeviceGL::HasDirectStateAccess())
+    {
+        glTextureParameterfv(GetHandle(), static_cast<GLenum>(pname), params.data());
+        return;
+    }
     assert(IsBound());
     glTexParameterfv(GetTarget(), static_cast<GLenum>(pname), params.data());
 }
@@ -250,3 +446,67 @@ int TextureObject::GetDataComponentCount(InternalFormat internalFormat)
         return 0;
     }
 }
+
+int TextureObject::GetPixelBits(InternalFormat internalFormat)
+{
+    switch (internalFormat)
+    {
+    // Block compressed, assuming RGTC and S3TC
+    case InternalFormatRCompressed:
+    case InternalFormatRGBCompressed:
+    case InternalFormatSRGBCompressed:
+        return 4;
+    case InternalFormatRGCompressed:
+    case InternalFormatRGBACompressed:
+    case InternalFormatSRGBACompressed:
+        return 8;
+    case InternalFormatR:
+    case InternalFormatR8:
+    case InternalFormatR8SNorm:
+        return 8;
+    case InternalFormatRG:
+    case InternalFormatRG8:
+    case InternalFormatRG8SNorm:
+    case InternalFormatR16:
+    case InternalFormatR16SNorm:
+    case InternalFormatR16F:
+    case InternalFormatDepth16:
+        return 16;
+    case InternalFormatRGB:
+    case InternalFormatRGBA:
+    case InternalFormatRGB8:
+    case InternalFormatRGBA8:
+    case InternalFormatRGB8SNorm:
+    case InternalFormatRGBA8SNorm:
+    case InternalFormatSRGB8:
+    case InternalFormatSRGBA8:
+    case InternalFormatRG16:
+    case InternalFormatRG16SNorm:
+    case InternalFormatRG16F:
+    case InternalFormatR32F:
+    case InternalFormatR11G11B10:
+    case InternalFormatRGB10A2:
+    case InternalFormatDepth:
+    case InternalFormatDepth24:
+    case InternalFormatDepth32:
+    case InternalFormatDepth32F:
+    case InternalFormatDepthStencil:
+    case InternalFormatDepth24Stencil8:
+        return 32;
+    case InternalFormatRGB16:
+    case InternalFormatRGBA16:
+    case InternalFormatRGB16SNorm:
+    case InternalFormatRGBA16SNorm:
+    case InternalFormatRGB16F:
+    case InternalFormatRGBA16F:
+    case InternalFormatRG32F:
+    case InternalFormatDepth32FStencil8:
+        return 64;
+    case InternalFormatRGB32F:
+    case InternalFormatRGBA32F:
+        return 128;
+    default:
+        //Unknown format
+        return 0;
+    }
+}
@@ -0,0 +1,325 @@
+#include <ituGL/texture/TextureStreamingManager.h>
+
+#include <ituGL/texture/TextureUploadRing.h>
+#include <ituGL/geometry/Model.h>
+#include <ituGL/shader/Material.h>
+#include <ituGL/core/DeviceGL.h>
+#include <ituGL/utils/DearImGui.h>
+#include <imgui.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+TextureStreamingManager::TextureStreamingManager(TextureUploadRing& uploadRing, size_t memoryBudget)
+    : m_uploadRing(uploadRing)
+    , m_memoryBudget(memoryBudget)
+    , m_residentSize(64)
+    , m_lodBias(0.0f)
+    , m_fadeTime(0.25f)
+    , m_residentBytes(0)
+{
+}
+
+std::shared_ptr<Texture2DObject> TextureStreamingManager::AddTexture(const std::string& name, std::shared_ptr<const TextureLoaderUtils::TextureData> textureData)
+{
+    assert(!textureData->data.empty());
+    assert(textureData->GetLevelCount() > 1 || std::max(textureData->width, textureData->height) == 1);
+
+    Entry entry;
+    entry.name = name;
+    entry.texture = std::make_shared<Texture2DObject>();
+    entry.textureData = textureData;
+    entry.uploadLevel = -1;
+    entry.minLod = 0.0f;
+    entry.residentBytes = 0;
+
+    // Find the first level that is always resident
+    int levelCount = textureData->GetLevelCount();
+    entry.residentLevel = levelCount - 1;
+    for (int level = 0; level < levelCount; ++level)
+    {
+        int width, height;
+        textureData->GetLevel(level, width, height);
+        if (std::max(width, height) <= m_residentSize)
+        {
+            entry.residentLevel = level;
+            break;
+        }
+    }
+    entry.firstLevel = entry.residentLevel;
+    entry.baseLevel = entry.residentLevel;
+    entry.requestedLevel = entry.residentLevel;
+    entry.neededLevel = entry.residentLevel;
+
+    // The coarse levels are small, upload them right away. Small levels are not 4-byte aligned
+    GLint unpackAlignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    Texture2DObject& texture = *entry.texture;
+    texture.Bind();
+    for (int level = entry.residentLevel; level < levelCount; ++level)
+    {
+        int width, height;
+        std::span<const std::byte> data = textureData->GetLevel(level, width, height);
+        texture.SetImage<std::byte>(level, width, height, textureData->format, textureData->internalFormat, data, textureData->dataType);
+        entry.residentBytes += GetLevelBytes(*textureData, level);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+
+    texture.SetParameter(TextureObject::ParameterEnum::MinFilter, GL_LINEAR_MIPMAP_LINEAR);
+    texture.SetParameter(TextureObject::ParameterEnum::MagFilter, GL_LINEAR);
+    texture.SetParameter(TextureObject::ParameterInt::MaxLevel, levelCount - 1);
+    UpdateLodRange(entry);
+    Texture2DObject::Unbind();
+
+    m_residentBytes += entry.residentBytes;
+    m_entryIndices[entry.texture.get()] = m_entries.size();
+    m_entries.push_back(entry);
+
+    return entry.texture;
+}
+
+void TextureStreamingManager::RequestModel(Model& model, float screenSize)
+{
+    std::vector<const TextureObject*> textures;
+    for (unsigned int materialIndex = 0; materialIndex < model.GetMaterialCount(); ++materialIndex)
+    {
+        model.GetMaterial(materialIndex).GetTextures(textures);
+    }
+
+    for (const TextureObject* texture : textures)
+    {
+        auto itEntry = m_entryIndices.find(texture);
+        if (itEntry == m_entryIndices.end())
+        {
+            continue;
+        }
+
+        // Assume the texture covers the model once: one texel per pixel at the requested level
+        Entry& entry = m_entries[itEntry->second];
+        int size = std::max(entry.textureData->width, entry.textureData->height);
+        float lod = std::log2(size / std::max(screenSize, 1.0f)) + m_lodBias;
+        int level = std::clamp(static_cast<int>(std::floor(lod)), 0, entry.residentLevel);
+        entry.requestedLevel = std::min(entry.requestedLevel, level);
+    }
+}
+
+void TextureStreamingManager::Update(float deltaTime)
+{
+    // Forget the textures that are not used anymore
+    for (size_t i = 0; i < m_entries.size();)
+    {
+        if (m_entries[i].texture.use_count() == 1)
+        {
+            m_residentBytes -= m_entries[i].residentBytes;
+            m_entryIndices.erase(m_entries[i].texture.get());
+            if (i != m_entries.size() - 1)
+            {
+                m_entries[i] = std::move(m_entries.back());
+                m_entryIndices[m_entries[i].texture.get()] = i;
+            }
+            m_entries.pop_back();
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    for (Entry& entry : m_entries)
+    {
+        // Take the requests of this frame, and start collecting the next ones
+        entry.neededLevel = entry.requestedLevel;
+        entry.requestedLevel = entry.residentLevel;
+
+        // Fade in the last uploaded level
+        if (entry.minLod > 0.0f)
+        {
+            entry.minLod = std::max(entry.minLod - deltaTime / m_fadeTime, 0.0f);
+            if (DeviceGL::HasDirectStateAccess())
+            {
+                entry.texture->SetParameter(TextureObject::ParameterFloat::MinLod, entry.minLod);
+            }
+            else
+            {
+                entry.texture->Bind();
+                entry.texture->SetParameter(TextureObject::ParameterFloat::MinLod, entry.minLod);
+                Texture2DObject::Unbind();
+            }
+        }
+
+        // Evict the levels that are not needed anymore
+        // One extra level is kept, so small camera movements don't stream the same level again and again
+        while (entry.uploadLevel < 0 && entry.firstLevel < entry.residentLevel && entry.firstLevel < entry.neededLevel - 1)
+        {
+            EvictLevel(entry);
+        }
+    }
+
+    // If over budget, evict the finest levels first, they free the most memory
+    while (m_residentBytes > m_memoryBudget)
+    {
+        Entry* evictEntry = nullptr;
+        size_t evictBytes = 0;
+        for (Entry& entry : m_entries)
+        {
+            if (entry.uploadLevel < 0 && entry.firstLevel < entry.residentLevel)
+            {
+                size_t levelBytes = GetLevelBytes(*entry.textureData, entry.firstLevel);
+                if (levelBytes > evictBytes)
+                {
+                    evictEntry = &entry;
+                    evictBytes = levelBytes;
+                }
+            }
+        }
+
+        if (!evictEntry)
+        {
+            break;
+        }
+        EvictLevel(*evictEntry);
+    }
+
+    // Stream the next level of the textures that need it, the ones missing more levels first
+    std::vector<Entry*> streamEntries;
+    for (Entry& entry : m_entries)
+    {
+        if (entry.uploadLevel < 0 && entry.firstLevel > entry.neededLevel)
+        {
+            streamEntries.push_back(&entry);
+        }
+    }
+    std::sort(streamEntries.begin(), streamEntries.end(), [](const Entry* a, const Entry* b)
+        {
+            return a->firstLevel - a->neededLevel > b->firstLevel - b->neededLevel;
+        });
+    for (Entry* entry : streamEntries)
+    {
+        if (m_residentBytes + GetLevelBytes(*entry->textureData, entry->firstLevel - 1) <= m_memoryBudget)
+        {
+            StreamLevel(*entry);
+        }
+    }
+}
+
+void TextureStreamingManager::DrawGUI(DearImGui& imGui)
+{
+    if (auto window = imGui.UseWindow("Mip Streaming"))
+    {
+        int memoryBudgetMB = static_cast<int>(m_memoryBudget >> 20);
+        if (ImGui::DragInt("Memory budget (MB)", &memoryBudgetMB, 1, 1, 4096))
+        {
+            m_memoryBudget = static_cast<size_t>(memoryBudgetMB) << 20;
+        }
+        ImGui::DragFloat("LOD bias", &m_lodBias, 0.1f, -4.0f, 4.0f);
+        ImGui::Text("Resident: %.2f / %.2f MB", m_residentBytes / (1024.0f * 1024.0f), m_memoryBudget / (1024.0f * 1024.0f));
+
+        if (ImGui::BeginTable("Textures", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+        {
+            ImGui::TableSetupColumn("Texture");
+            ImGui::TableSetupColumn("Resident size");
+            ImGui::TableSetupColumn("Needed size");
+            ImGui::TableSetupColumn("Resident KB");
+            ImGui::TableHeadersRow();
+            for (const Entry& entry : m_entries)
+            {
+                int width, height;
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(entry.name.c_str());
+                ImGui::TableNextColumn();
+                entry.textureData->GetLevel(entry.baseLevel, width, height);
+                ImGui::Text(entry.uploadLevel >= 0 ? "%dx%d (streaming)" : "%dx%d", width, height);
+                ImGui::TableNextColumn();
+                entry.textureData->GetLevel(entry.neededLevel, width, height);
+                ImGui::Text("%dx%d", width, height);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", entry.residentBytes / 1024.0f);
+            }
+            ImGui::EndTable();
+        }
+    }
+}
+
+size_t TextureStreamingManager::GetLevelBytes(const TextureLoaderUtils::TextureData& textureData, int level)
+{
+    // Estimated with the size of the decoded data, the driver may pad or convert it
+    int width, height;
+    return textureData.GetLevel(level, width, height).size_bytes();
+}
+
+void TextureStreamingManager::StreamLevel(Entry& entry)
+{
+    assert(entry.uploadLevel < 0 && entry.firstLevel > 0);
+
+    const TextureLoaderUtils::TextureData& textureData = *entry.textureData;
+    int level = entry.firstLevel - 1;
+    int width, height;
+    std::span<const std::byte> data = textureData.GetLevel(level, width, height);
+
+    // Allocate the level now. It is not sampled until BaseLevel includes it
+    entry.texture->Bind();
+    entry.texture->SetImage<std::byte>(level, width, height, textureData.format, textureData.internalFormat, std::span<const std::byte>(), textureData.dataType);
+    Texture2DObject::Unbind();
+
+    entry.firstLevel = level;
+    entry.uploadLevel = level;
+    size_t levelBytes = GetLevelBytes(textureData, level);
+    entry.residentBytes += levelBytes;
+    m_residentBytes += levelBytes;
+
+    const Texture2DObject* texture = entry.texture.get();
+    m_uploadRing.QueueUpload(entry.texture, level, width, height, textureData.format, textureData.dataType, data, entry.textureData,
+        [this, texture, level]() { OnLevelUploaded(texture, level); });
+}
+
+void TextureStreamingManager::EvictLevel(Entry& entry)
+{
+    assert(entry.uploadLevel < 0 && entry.firstLevel < entry.residentLevel);
+
+    int level = entry.firstLevel;
+    entry.firstLevel = level + 1;
+    entry.baseLevel = level + 1;
+    entry.minLod = 0.0f;
+
+    // Stop sampling the level before releasing its storage, so the texture stays complete
+    entry.texture->Bind();
+    UpdateLodRange(entry);
+    entry.texture->SetImage<std::byte>(level, 0, 0, entry.textureData->format, entry.textureData->internalFormat, std::span<const std::byte>(), entry.textureData->dataType);
+    Texture2DObject::Unbind();
+
+    size_t levelBytes = GetLevelBytes(*entry.textureData, level);
+    entry.residentBytes -= levelBytes;
+    m_residentBytes -= levelBytes;
+}
+
+void TextureStreamingManager::OnLevelUploaded(const Texture2DObject* texture, int level)
+{
+    auto itEntry = m_entryIndices.find(texture);
+    if (itEntry == m_entryIndices.end())
+    {
+        return;
+    }
+
+    Entry& entry = m_entries[itEntry->second];
+    assert(entry.uploadLevel == level);
+    entry.uploadLevel = -1;
+    entry.baseLevel = level;
+
+    // Keep sampling the previous level, and fade to the new one in the next updates
+    entry.minLod = 1.0f;
+
+    entry.texture->Bind();
+    UpdateLodRange(entry);
+    Texture2DObject::Unbind();
+}
+
+void TextureStreamingManager::UpdateLodRange(Entry& entry)
+{
+    // LOD is relative to the base level
+    int levelCount = entry.textureData->GetLevelCount();
+    entry.texture->SetParameter(TextureObject::ParameterInt::BaseLevel, entry.baseLevel);
+    entry.texture->SetParameter(TextureObject::ParameterFloat::MinLod, entry.minLod);
+    entry.texture->SetParameter(TextureObject::ParameterFloat::MaxLod, static_cast<float>(levelCount - 1 - entry.baseLevel));
+}
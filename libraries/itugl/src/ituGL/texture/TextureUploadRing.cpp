@@ -0,0 +1,260 @@
+#include <ituGL/texture/TextureUploadRing.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+TextureUploadRing::TextureUploadRing(size_t ringSize, size_t frameBudget)
+    : m_mappedData(nullptr)
+    , m_ringSize(ringSize)
+    , m_frameBudget(frameBudget)
+    , m_head(0)
+    , m_streamedLastFrame(false)
+{
+    m_buffer.Bind();
+    if (GLAD_GL_VERSION_4_4)
+    {
+        // Map once, and keep the mapping while the GPU reads from the buffer
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        m_buffer.AllocateStorage(m_ringSize, flags);
+        m_mappedData = m_buffer.MapData(0, m_ringSize, flags).data();
+    }
+    else
+    {
+        m_buffer.AllocateData(m_ringSize, BufferObject::StreamDraw);
+    }
+    PixelBufferObject::Unbind();
+}
+
+TextureUploadRing::~TextureUploadRing()
+{
+    for (Segment& segment : m_segments)
+    {
+        glDeleteSync(segment.fence);
+    }
+
+    if (m_mappedData)
+    {
+        m_buffer.Bind();
+        m_buffer.UnmapData();
+        PixelBufferObject::Unbind();
+    }
+}
+
+size_t TextureUploadRing::GetPendingBytes() const
+{
+    size_t pendingBytes = 0;
+    for (const Upload& upload : m_uploads)
+    {
+        pendingBytes += (upload.rowCount - upload.nextRow) * upload.rowSize;
+    }
+    return pendingBytes;
+}
+
+void TextureUploadRing::QueueUpload(std::shared_ptr<Texture2DObject> texture, GLint level, GLsizei width, GLsizei height,
+    TextureObject::Format format, Data::Type dataType, std::span<const std::byte> data,
+    std::shared_ptr<const void> dataOwner, CompletionFunction completion)
+{
+    size_t rowSize = width * TextureObject::GetComponentCount(format) * Data::GetTypeSize(dataType);
+    assert(data.size_bytes() == rowSize * height);
+
+    Upload& upload = m_uploads.emplace_back();
+    upload.setRows = [=](GLint firstRow, GLsizei rowCount, size_t bufferOffset)
+        {
+            texture->Bind();
+            texture->SetSubImage(level, 0, firstRow, width, rowCount, format, dataType, bufferOffset);
+        };
+    upload.data = data.data();
+    upload.rowSize = rowSize;
+    upload.dataStride = rowSize;
+    upload.rowCount = height;
+    upload.nextRow = 0;
+    upload.dataOwner = dataOwner;
+    upload.completion = completion;
+}
+
+void TextureUploadRing::QueueUpload(std::shared_ptr<TextureCubemapObject> texture, TextureCubemapObject::Face face, GLint level, GLsizei side,
+    TextureObject::Format format, Data::Type dataType, std::span<const std::byte> data, size_t dataStride,
+    std::shared_ptr<const void> dataOwner, CompletionFunction completion)
+{
+    size_t rowSize = side * TextureObject::GetComponentCount(format) * Data::GetTypeSize(dataType);
+    assert(dataStride >= rowSize);
+    assert(data.size_bytes() >= dataStride * (side - 1) + rowSize);
+
+    Upload& upload = m_uploads.emplace_back();
+    upload.setRows = [=](GLint firstRow, GLsizei rowCount, size_t bufferOffset)
+        {
+            texture->Bind();
+            texture->SetSubImage(level, face, 0, firstRow, side, rowCount, format, dataType, bufferOffset);
+        };
+    upload.data = data.data();
+    upload.rowSize = rowSize;
+    upload.dataStride = dataStride;
+    upload.rowCount = side;
+    upload.nextRow = 0;
+    upload.dataOwner = dataOwner;
+    upload.completion = completion;
+}
+
+void TextureUploadRing::Update()
+{
+    std::chrono::steady_clock::time_point updateTime = std::chrono::steady_clock::now();
+
+    // Frame time is measured between consecutive updates, only while streaming
+    if (m_streamedLastFrame)
+    {
+        std::chrono::duration<float> frameTime = updateTime - m_lastUpdateTime;
+        m_stats.streamingTime += frameTime.count();
+        m_stats.worstFrameTime = std::max(m_stats.worstFrameTime, frameTime.count());
+    }
+    m_lastUpdateTime = updateTime;
+
+    RetireSegments();
+
+    m_streamedLastFrame = !m_uploads.empty();
+    if (m_uploads.empty())
+    {
+        return;
+    }
+
+    // Rows are copied tightly packed to the ring
+    GLint unpackAlignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    m_buffer.Bind();
+
+    size_t frameBytes = 0;
+    while (!m_uploads.empty() && frameBytes < m_frameBudget)
+    {
+        Upload& upload = m_uploads.front();
+
+        // Fit the rows in the remaining budget and in the ring, but always upload at least one row
+        size_t maxRowsInBudget = std::max<size_t>((m_frameBudget - frameBytes) / upload.rowSize, 1);
+        size_t maxRowsInRing = m_ringSize / upload.rowSize;
+        assert(maxRowsInRing > 0);
+        GLsizei rowCount = static_cast<GLsizei>(std::min({ maxRowsInBudget, maxRowsInRing, static_cast<size_t>(upload.rowCount - upload.nextRow) }));
+
+        if (!UploadRows(upload, rowCount))
+        {
+            // The GPU is still reading all the ring, wait for the next frame
+            ++m_stats.ringFullFrames;
+            break;
+        }
+        frameBytes += rowCount * upload.rowSize;
+
+        if (upload.nextRow == upload.rowCount)
+        {
+            if (upload.completion)
+            {
+                upload.completion();
+            }
+            ++m_stats.completedUploads;
+            m_uploads.pop_front();
+        }
+    }
+
+    // Unbind the pixel buffer, or following texture uploads would read from it
+    PixelBufferObject::Unbind();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment);
+
+    m_stats.uploadedBytes += frameBytes;
+
+    std::chrono::duration<float> updateDuration = std::chrono::steady_clock::now() - updateTime;
+    m_stats.worstUpdateTime = std::max(m_stats.worstUpdateTime, updateDuration.count());
+}
+
+bool TextureUploadRing::UploadRows(Upload& upload, GLsizei rowCount)
+{
+    size_t size = rowCount * upload.rowSize;
+    size_t offset;
+    if (!Allocate(size, offset))
+    {
+        return false;
+    }
+
+    // The fences guarantee that the GPU is not reading this range anymore
+    std::byte* destination = m_mappedData ? m_mappedData + offset
+        : m_buffer.MapData(offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT).data();
+    assert(destination);
+
+    const std::byte* source = upload.data + upload.nextRow * upload.dataStride;
+    if (upload.dataStride == upload.rowSize)
+    {
+        std::memcpy(destination, source, size);
+    }
+    else
+    {
+        for (GLsizei row = 0; row < rowCount; ++row)
+        {
+            std::memcpy(destination + row * upload.rowSize, source + row * upload.dataStride, upload.rowSize);
+        }
+    }
+
+    if (!m_mappedData)
+    {
+        m_buffer.UnmapData();
+    }
+
+    upload.setRows(upload.nextRow, rowCount, offset);
+    upload.nextRow += rowCount;
+
+    m_segments.push_back(Segment{ offset, offset + size, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) });
+    return true;
+}
+
+bool TextureUploadRing::Allocate(size_t size, size_t& offset)
+{
+    if (m_segments.empty())
+    {
+        m_head = 0;
+    }
+
+    // Head never reaches the tail, so head == tail always means that the ring is empty
+    size_t tail = m_segments.empty() ? 0 : m_segments.front().begin;
+    if (m_segments.empty() || m_head >= tail)
+    {
+        // Free space is at the end of the ring, and at the beginning until the tail
+        if (m_head + size <= m_ringSize)
+        {
+            offset = m_head;
+        }
+        else if (size < tail)
+        {
+            offset = 0;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    else
+    {
+        // Free space is between the head and the tail
+        if (m_head + size < tail)
+        {
+            offset = m_head;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    m_head = offset + size;
+    return true;
+}
+
+void TextureUploadRing::RetireSegments()
+{
+    while (!m_segments.empty())
+    {
+        Segment& segment = m_segments.front();
+        GLenum result = glClientWaitSync(segment.fence, 0, 0);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+        {
+            break;
+        }
+        glDeleteSync(segment.fence);
+        m_segments.pop_front();
+    }
+}
@@ -5,7 +5,7 @@
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 
-DearImGui::DearImGui()
+DearImGui::DearImGui() : m_headlessWindow(nullptr)
 {
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
@@ -22,20 +22,42 @@ DearImGui::~DearImGui()
 void DearImGui::Initialize(::Window& window)
 {
     // Setup Platform/Renderer bindings
-    ImGui_ImplGlfw_InitForOpenGL(window.GetInternalWindow(), true);
+    if (window.IsHeadless())
+    {
+        m_headlessWindow = &window;
+    }
+    else
+    {
+        ImGui_ImplGlfw_InitForOpenGL(window.GetInternalWindow(), true);
+    }
     ImGui_ImplOpenGL3_Init("#version 410 core");
 }
 
 void DearImGui::Cleanup()
 {
     ImGui_ImplOpenGL3_Shutdown();
-    ImGui_ImplGlfw_Shutdown();
+    if (!m_headlessWindow)
+    {
+        ImGui_ImplGlfw_Shutdown();
+    }
 }
 
 void DearImGui::BeginFrame()
 {
     ImGui_ImplOpenGL3_NewFrame();
-    ImGui_ImplGlfw_NewFrame();
+    if (m_headlessWindow)
+    {
+        // No input, and a fixed frame time
+        int width, height;
+        m_headlessWindow->GetDimensions(width, height);
+        ImGuiIO& io = ImGui::GetIO();
+        io.DisplaySize = ImVec2(static_cast<float>(width), static_cast<float>(height));
+        io.DeltaTime = 1.0f / 60.0f;
+    }
+    else
+    {
+        ImGui_ImplGlfw_NewFrame();
+    }
     ImGui::NewFrame();
 }
 
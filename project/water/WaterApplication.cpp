@@ -1,8 +1,12 @@
 #include "WaterApplication.h"
+#include "ShaderInterface.h"
 
 #include <ituGL/asset/TextureCubemapLoader.h>
+#include <ituGL/asset/ShaderProgramCache.h>
 #include <ituGL/asset/ShaderLoader.h>
 #include <ituGL/asset/ModelLoader.h>
+#include <ituGL/asset/AssetLoadQueue.h>
+#include <ituGL/asset/AssetRegistry.h>
 
 #include <ituGL/camera/Camera.h>
 #include <ituGL/scene/SceneCamera.h>
@@ -12,9 +16,15 @@
 #include <ituGL/lighting/SpotLight.h>
 #include <ituGL/scene/SceneLight.h>
 
+#include <ituGL/texture/SamplerObject.h>
 #include <ituGL/shader/ShaderUniformCollection.h>
 #include <ituGL/shader/Material.h>
+#include <ituGL/shader/ShaderProgramVariants.h>
 #include <ituGL/geometry/Model.h>
+#include <ituGL/geometry/VertexArrayObject.h>
+#include <ituGL/core/CpuProfiler.h>
+#include <ituGL/core/GLInterceptor.h>
+#include <ituGL/core/MemoryTracker.h>
 #include <ituGL/scene/SceneModel.h>
 #include <ituGL/scene/Transform.h>
 
@@ -25,15 +35,26 @@
 #include <ituGL/renderer/PostFXRenderPass.h>
 #include <ituGL/renderer/TransparencyPass.h>
 #include <ituGL/scene/RendererSceneVisitor.h>
+#include <ituGL/scene/TextureStreamingSceneVisitor.h>
 
 #include <ituGL/scene/ImGuiSceneVisitor.h>
 #include <imgui.h>
+#include <chrono>
+#include <iostream>
 
 const float _MaxPlaytime = 60;
 
+// Keywords of the deferred shader for the debug views. ShowType 0 is the lit scene, without keywords
+const char* _ShowTypeKeywords[] = { "SHOW_ALBEDO", "SHOW_POSITION", "SHOW_DEPTH", "SHOW_NORMAL", "SHOW_GBUFFER_NORMAL" };
+
+// Decode the assets on worker threads. Set to false to compare the startup time with synchronous loading
+const bool _AsyncAssetLoading = true;
+
 WaterApplication::WaterApplication()
     : Application(1024, 1024, "Water Scene")
     , m_renderer(GetDevice())
+    , m_textureStreaming(false)
+    , m_textureStreamingManager(m_textureUploadRing)
     , m_mainSceneFramebuffer(std::make_shared<FramebufferObject>())
     , m_reflectionBuffer(std::make_shared<FramebufferObject>())
     , m_fullSceneFramebuffer(std::make_shared<FramebufferObject>())
@@ -55,9 +76,11 @@ void WaterApplication::Initialize()
 {
     Application::Initialize();
 
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
     // Initialize DearImGUI
     m_imGui.Initialize(GetMainWindow());
-    m_waterManager = std::make_shared<WaterManager>(m_renderer, m_timeElapsed);
+    m_waterManager = std::make_shared<WaterManager>(m_renderer, m_timeElapsed, _AsyncAssetLoading, &m_textureUploadRing);
 
     InitializeCamera();
     InitializeLights();
@@ -65,12 +88,45 @@ void WaterApplication::Initialize()
     InitializeModels();
     InitializeRenderer();
 
+    std::chrono::duration<float, std::milli> initializeTime = std::chrono::steady_clock::now() - startTime;
+    std::cout << "Initialization took " << initializeTime.count() << " ms ("
+        << (_AsyncAssetLoading ? "asynchronous" : "synchronous") << " asset loading)" << std::endl;
+
+    // Cold runs compile every program, warm runs load them from the binary cache
+    const ShaderProgramCache::Stats& shaderStats = ShaderProgramCache::GetInstance().GetStats();
+    std::cout << "Shader setup took " << shaderStats.setupTime * 1000.0f << " ms (" << shaderStats.hits << " programs from cache, "
+        << shaderStats.misses << " compiled, " << shaderStats.rejected << " rejected)" << std::endl;
+    ShaderLoader::Stats compileStats = ShaderLoader::GetStats();
+    std::cout << "Shader stages: " << compileStats.compileCount << " compiled in " << compileStats.compileTime * 1000.0f << " ms, "
+        << compileStats.sharedCount << " shared" << std::endl;
+
+    AssetRegistry& registry = AssetRegistry::GetInstance();
+    AssetRegistry::Stats registryStats = registry.GetStats();
+    std::cout << "Asset registry: " << registryStats.hits << " hits, " << registryStats.misses << " misses (" << registryStats.GetHitRate() * 100.0f << "% hit rate), "
+        << registry.GetAssetCount() << " assets, " << registry.GetRetainedBytes() / (1024.0f * 1024.0f) << " MB retained" << std::endl;
 }
 
 void WaterApplication::Update()
 {
     Application::Update();
 
+    // Request the mip levels needed from the camera. The manager queues them in the upload ring
+    int width, height;
+    GetMainWindow().GetDimensions(width, height);
+    TextureStreamingSceneVisitor textureStreamingVisitor(m_textureStreamingManager, *m_cameraController.GetCamera()->GetCamera(), height);
+    m_scene.AcceptVisitor(textureStreamingVisitor);
+    m_textureStreamingManager.Update(GetDeltaTime());
+
+    // Stream the pending texture data, within the frame budget
+    m_textureUploadRing.Update();
+    if (m_textureStreaming && !m_textureUploadRing.IsStreaming())
+    {
+        const TextureUploadRing::Stats& stats = m_textureUploadRing.GetStats();
+        std::cout << "Texture streaming finished: " << stats.uploadedBytes / (1024.0f * 1024.0f) << " MB in " << stats.streamingTime * 1000.0f << " ms, "
+            << stats.GetThroughput() / (1024.0f * 1024.0f) << " MB/s, worst frame " << stats.worstFrameTime * 1000.0f << " ms" << std::endl;
+    }
+    m_textureStreaming = m_textureUploadRing.IsStreaming();
+
     // Update camera controller
     m_cameraController.Update(GetMainWindow(), GetDeltaTime());
 
@@ -105,6 +161,19 @@ void WaterApplication::Render()
     // Render the scene
     m_renderer.Render();
 
+    // Keep the counters of this frame to show them
+    m_uniformStats = ShaderProgram::GetUniformStats();
+    ShaderProgram::ResetUniformStats();
+    std::shared_ptr<UniformBufferArena> uniformBufferArena = UniformBufferArena::GetInstance();
+    m_uniformBufferStats = uniformBufferArena->GetStats();
+    uniformBufferArena->ResetStats();
+    m_renderStateStats = GetDevice().GetRenderStateStats();
+    GetDevice().ResetRenderStateStats();
+    m_textureBindStats = GetDevice().GetTextureBindStats();
+    GetDevice().ResetTextureBindStats();
+    m_vertexBindStats = GetDevice().GetVertexBindStats();
+    GetDevice().ResetVertexBindStats();
+
     // Render the debug user interface
     RenderGUI();
 }
@@ -165,40 +234,34 @@ void WaterApplication::InitializeMaterials()
         std::vector<const char*> vertexShaderPaths;
         vertexShaderPaths.push_back("shaders/version330.glsl");
         vertexShaderPaths.push_back("shaders/default.vert");
-        Shader vertexShader = ShaderLoader(Shader::VertexShader).Load(vertexShaderPaths);
 
         std::vector<const char*> fragmentShaderPaths;
         fragmentShaderPaths.push_back("shaders/version330.glsl");
         fragmentShaderPaths.push_back("shaders/utils.glsl");
         fragmentShaderPaths.push_back("shaders/default.frag");
-        Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load(fragmentShaderPaths);
 
         std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
-        shaderProgramPtr->Build(vertexShader, fragmentShader);
-
-        // Get transform related uniform locations
-        ShaderProgram::Location worldViewMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldViewMatrix");
-        ShaderProgram::Location worldViewProjMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldViewProjMatrix");
+        ShaderProgramCache::GetInstance().Build(*shaderProgramPtr, vertexShaderPaths, fragmentShaderPaths);
 
         // Register shader with renderer
         m_renderer.RegisterShaderProgram(shaderProgramPtr,
-            [=](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
+            [](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
             {
-                shaderProgram.SetUniform(worldViewMatrixLocation, camera.GetViewMatrix() * worldMatrix);
-                shaderProgram.SetUniform(worldViewProjMatrixLocation, camera.GetViewProjectionMatrix() * worldMatrix);
+                shaderProgram.SetUniform(ShaderUniforms::WorldViewMatrix, camera.GetViewMatrix() * worldMatrix);
+                shaderProgram.SetUniform(ShaderUniforms::WorldViewProjMatrix, camera.GetViewProjectionMatrix() * worldMatrix);
             },
             nullptr
         );
 
         // Filter out uniforms that are not material properties
         ShaderUniformCollection::NameSet filteredUniforms;
-        filteredUniforms.insert("WorldViewMatrix");
-        filteredUniforms.insert("WorldViewProjMatrix");
+        filteredUniforms.insert(ShaderUniforms::WorldViewMatrix.name);
+        filteredUniforms.insert(ShaderUniforms::WorldViewProjMatrix.name);
 
         // Create material
         m_defaultMaterial = std::make_shared<Material>(shaderProgramPtr, filteredUniforms);
-        m_defaultMaterial->SetUniformValue("Color", glm::vec3(1.0f));
-        m_defaultMaterial->SetUniformValue("HaveTextures", glm::vec3(0));
+        m_defaultMaterial->SetUniformValue(ShaderUniforms::Color, glm::vec3(1.0f));
+        m_defaultMaterial->SetUniformValue(ShaderUniforms::HaveTextures, glm::vec3(0));
     }
 
     // Deferred material
@@ -206,65 +269,54 @@ void WaterApplication::InitializeMaterials()
         std::vector<const char*> vertexShaderPaths;
         vertexShaderPaths.push_back("shaders/version330.glsl");
         vertexShaderPaths.push_back("shaders/renderer/deferred.vert");
-        Shader vertexShader = ShaderLoader(Shader::VertexShader).Load(vertexShaderPaths);
 
         std::vector<const char*> fragmentShaderPaths;
         fragmentShaderPaths.push_back("shaders/version330.glsl");
-        fragmentShaderPaths.push_back("shaders/utils.glsl");
-        fragmentShaderPaths.push_back("shaders/lambert-ggx.glsl");
+        // Includes lambert-ggx.glsl and utils.glsl
         fragmentShaderPaths.push_back("shaders/lighting.glsl");
         fragmentShaderPaths.push_back("shaders/renderer/deferred.frag");
-        Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load(fragmentShaderPaths);
 
-        std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
-        shaderProgramPtr->Build(vertexShader, fragmentShader);
+        // Each debug view is a variant, built the first time it is shown
+        std::shared_ptr<ShaderProgramVariants> shaderVariants = std::make_shared<ShaderProgramVariants>(vertexShaderPaths, fragmentShaderPaths, _ShowTypeKeywords);
 
         // Filter out uniforms that are not material properties
         ShaderUniformCollection::NameSet filteredUniforms;
-        filteredUniforms.insert("InvViewMatrix");
-        filteredUniforms.insert("InvProjMatrix");
-        filteredUniforms.insert("WorldViewProjMatrix");
-        filteredUniforms.insert("LightIndirect");
-        filteredUniforms.insert("LightColor");
-        filteredUniforms.insert("LightPosition");
-        filteredUniforms.insert("LightDirection"); 
-        filteredUniforms.insert("LightAttenuation");
-
-        // Get transform related uniform locations
-        ShaderProgram::Location invViewMatrixLocation = shaderProgramPtr->GetUniformLocation("InvViewMatrix");
-        ShaderProgram::Location invProjMatrixLocation = shaderProgramPtr->GetUniformLocation("InvProjMatrix");
-        ShaderProgram::Location worldViewProjMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldViewProjMatrix");
-
-        // Register shader with renderer
-        m_renderer.RegisterShaderProgram(shaderProgramPtr,
-            [=](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
+        filteredUniforms.insert(ShaderUniforms::InvViewMatrix.name);
+        filteredUniforms.insert(ShaderUniforms::InvProjMatrix.name);
+        filteredUniforms.insert(ShaderUniforms::WorldViewProjMatrix.name);
+        filteredUniforms.insert(ShaderUniforms::LightIndirect.name);
+        filteredUniforms.insert(ShaderUniforms::LightColor.name);
+        filteredUniforms.insert(ShaderUniforms::LightPosition.name);
+        filteredUniforms.insert(ShaderUniforms::LightDirection.name); 
+        filteredUniforms.insert(ShaderUniforms::LightAttenuation.name);
+
+        // Register each variant with renderer
+        shaderVariants->SetVariantCreatedFunction([this](std::shared_ptr<ShaderProgram> shaderProgramPtr)
             {
-                if (cameraChanged)
-                {
-                    shaderProgram.SetUniform(invViewMatrixLocation, glm::inverse(camera.GetViewMatrix()));
-                    shaderProgram.SetUniform(invProjMatrixLocation, glm::inverse(camera.GetProjectionMatrix()));
-                }
-                shaderProgram.SetUniform(worldViewProjMatrixLocation, camera.GetViewProjectionMatrix() * worldMatrix);
-            },
-            m_renderer.GetDefaultUpdateLightsFunction(*shaderProgramPtr)
-        );
+                m_renderer.RegisterShaderProgram(shaderProgramPtr,
+                    GetFullscreenTransformFunction(),
+                    m_renderer.GetDefaultUpdateLightsFunction(*shaderProgramPtr)
+                );
+            });
 
         // Create material
-        m_deferredMaterial = std::make_shared<Material>(shaderProgramPtr, filteredUniforms);
+        m_deferredMaterial = std::make_shared<Material>(shaderVariants, filteredUniforms);
     }
 }
 
 void WaterApplication::InitializeModels()
 {
-    m_skyboxTexture = TextureCubemapLoader::LoadTextureShared("models/skybox/puresky.hdr", TextureObject::FormatRGB, TextureObject::InternalFormatRGB16F);
-
-    m_skyboxTexture->Bind();
-    m_skyboxTexture->GetParameter(TextureObject::ParameterFloat::MaxLod, m_maxLod);
-    TextureCubemapObject::Unbind();
-
-    // Set the environment texture on the deferred material
-    m_deferredMaterial->SetUniformValue("EnvironmentTexture", m_skyboxTexture);
-    m_deferredMaterial->SetUniformValue("EnvironmentMaxLod", m_maxLod);
+    AssetLoadQueue& loadQueue = AssetLoadQueue::GetInstance();
+
+    // Start decoding the skybox while the models are set up
+    TextureCubemapLoader skyboxLoader(TextureObject::FormatRGB, TextureObject::InternalFormatRGB16F);
+    skyboxLoader.SetGenerateMipmap(true);
+    skyboxLoader.SetUploadRing(&m_textureUploadRing);
+    TextureCubemapLoader::SharedFuture skyboxFuture;
+    if (_AsyncAssetLoading)
+    {
+        skyboxFuture = skyboxLoader.LoadSharedAsync("models/skybox/puresky.hdr");
+    }
 
     // Configure loader
     ModelLoader loader(m_defaultMaterial);
@@ -272,9 +324,15 @@ void WaterApplication::InitializeModels()
     // Create a new material copy for each submaterial
     loader.SetCreateMaterials(true);
 
+    // Pack the submeshes in a few buffers, so drawing them doesn't switch buffers
+    loader.SetPackGeometry(true);
+
     // Flip vertically textures loaded by the model loader
     loader.GetTexture2DLoader().SetFlipVertical(true);
 
+    // Start with the coarse mip levels only, and stream the rest when the camera gets closer
+    loader.GetTexture2DLoader().SetStreamingManager(&m_textureStreamingManager);
+
     // Link vertex properties to attributes
     loader.SetMaterialAttribute(VertexAttribute::Semantic::Position, "VertexPosition");
     loader.SetMaterialAttribute(VertexAttribute::Semantic::Normal, "VertexNormal");
@@ -289,12 +347,40 @@ void WaterApplication::InitializeModels()
     loader.SetMaterialProperty(ModelLoader::MaterialProperty::SpecularTexture, "SpecularTexture");
 
     // Load models
-    std::shared_ptr<Model> lightHouse = loader.LoadShared("models/Lighthouse/LighthouseScaled.obj");
+    std::shared_ptr<Model> lightHouse;
+    std::shared_ptr<Model> underwaterModel;
+    if (_AsyncAssetLoading)
+    {
+        // Both models are imported in parallel, while the skybox is still decoding
+        ModelLoader::SharedFuture lightHouseFuture = loader.LoadSharedAsync("models/Lighthouse/LightHouseScaled.obj");
+        ModelLoader::SharedFuture underwaterFuture = loader.LoadSharedAsync("models/UnderwaterScene/underwater.obj");
+
+        loadQueue.Wait(skyboxFuture);
+        loadQueue.Wait(lightHouseFuture);
+        loadQueue.Wait(underwaterFuture);
+
+        m_skyboxTexture = skyboxFuture.get();
+        lightHouse = lightHouseFuture.get();
+        underwaterModel = underwaterFuture.get();
+    }
+    else
+    {
+        m_skyboxTexture = skyboxLoader.LoadShared("models/skybox/puresky.hdr");
+        lightHouse = loader.LoadShared("models/Lighthouse/LightHouseScaled.obj");
+        underwaterModel = loader.LoadShared("models/UnderwaterScene/underwater.obj");
+    }
+
+    m_skyboxTexture->Bind();
+    m_skyboxTexture->GetParameter(TextureObject::ParameterFloat::MaxLod, m_maxLod);
+    TextureCubemapObject::Unbind();
+
+    // Set the environment texture on the deferred material
+    m_deferredMaterial->SetUniformValue(ShaderUniforms::EnvironmentTexture, m_skyboxTexture);
+    m_deferredMaterial->SetUniformValue(ShaderUniforms::EnvironmentMaxLod, m_maxLod);
+
     auto lightHouseSceneModel = std::make_shared<SceneModel>("LightHouse", lightHouse);
     lightHouseSceneModel->GetTransform()->SetTranslation(glm::vec3(0.0, -0.5, 0.0));
 
-    std::shared_ptr<Model> underwaterModel = loader.LoadShared("models/UnderwaterScene/underwater.obj");
-
     m_scene.AddSceneNode(lightHouseSceneModel);
     m_scene.AddSceneNode(std::make_shared<SceneModel>("Under Water", underwaterModel));
 
@@ -313,8 +399,7 @@ void WaterApplication::InitializeFramebuffers()
     m_sceneTexture = std::make_shared<Texture2DObject>();
     m_sceneTexture->Bind();
     m_sceneTexture->SetImage(0, width, height, TextureObject::FormatRGBA, TextureObject::InternalFormat::InternalFormatSRGBA8);
-    m_sceneTexture->SetParameter(TextureObject::ParameterEnum::MinFilter, GL_LINEAR);
-    m_sceneTexture->SetParameter(TextureObject::ParameterEnum::MagFilter, GL_LINEAR);
+    m_sceneTexture->SetSampler(SamplerObject::GetPreset(SamplerObject::Preset::LinearRepeat));
 
     // Scene framebuffer
     m_mainSceneFramebuffer->Bind();
@@ -325,8 +410,7 @@ void WaterApplication::InitializeFramebuffers()
     m_reflectiveColorTexture = std::make_shared<Texture2DObject>();
     m_reflectiveColorTexture->Bind();
     m_reflectiveColorTexture->SetImage(0, width, height, TextureObject::FormatRGBA, TextureObject::InternalFormat::InternalFormatSRGBA8);
-    m_reflectiveColorTexture->SetParameter(TextureObject::ParameterEnum::MinFilter, GL_LINEAR);
-    m_reflectiveColorTexture->SetParameter(TextureObject::ParameterEnum::MagFilter, GL_LINEAR);
+    m_reflectiveColorTexture->SetSampler(SamplerObject::GetPreset(SamplerObject::Preset::LinearRepeat));
 
     m_reflectionBuffer->Bind();
     m_reflectionBuffer->SetTexture(FramebufferObject::Target::Draw, FramebufferObject::Attachment::Color0, *m_reflectiveColorTexture);
@@ -337,10 +421,7 @@ void WaterApplication::InitializeFramebuffers()
         m_tempTextures[i] = std::make_shared<Texture2DObject>();
         m_tempTextures[i]->Bind();
         m_tempTextures[i]->SetImage(0, width, height, TextureObject::FormatRGBA, TextureObject::InternalFormat::InternalFormatSRGBA8);
-        m_tempTextures[i]->SetParameter(TextureObject::ParameterEnum::WrapS, GL_CLAMP_TO_EDGE);
-        m_tempTextures[i]->SetParameter(TextureObject::ParameterEnum::WrapT, GL_CLAMP_TO_EDGE);
-        m_tempTextures[i]->SetParameter(TextureObject::ParameterEnum::MinFilter, GL_LINEAR);
-        m_tempTextures[i]->SetParameter(TextureObject::ParameterEnum::MagFilter, GL_LINEAR);
+        m_tempTextures[i]->SetSampler(SamplerObject::GetPreset(SamplerObject::Preset::LinearClamp));
 
         m_tempFramebuffers[i] = std::make_shared<FramebufferObject>();
         m_tempFramebuffers[i]->Bind();
@@ -348,33 +429,29 @@ void WaterApplication::InitializeFramebuffers()
         m_tempFramebuffers[i]->SetDrawBuffers(std::array<FramebufferObject::Attachment, 1>({ FramebufferObject::Attachment::Color0 }));
     }
 
-    // Depth: Set the min and magfilter as nearest
+    // Depth: Use the nearest sampler
     m_fullSceneTextures[0] = std::make_shared<Texture2DObject>();
     m_fullSceneTextures[0]->Bind();
     m_fullSceneTextures[0]->SetImage(0, width, height, TextureObject::FormatDepth, TextureObject::InternalFormatDepth);
-    m_fullSceneTextures[0]->SetParameter(TextureObject::ParameterEnum::MinFilter, GL_NEAREST);
-    m_fullSceneTextures[0]->SetParameter(TextureObject::ParameterEnum::MagFilter, GL_NEAREST);
+    m_fullSceneTextures[0]->SetSampler(SamplerObject::GetPreset(SamplerObject::Preset::NearestClamp));
 
-    // Albedo: Bind the newly created texture, set the image, and the min and magfilter as nearest
+    // Albedo: Bind the newly created texture, set the image, and use the nearest sampler
     m_fullSceneTextures[1] = std::make_shared<Texture2DObject>();
     m_fullSceneTextures[1]->Bind();
     m_fullSceneTextures[1]->SetImage(0, width, height, TextureObject::FormatRGBA, TextureObject::InternalFormatSRGBA8);
-    m_fullSceneTextures[1]->SetParameter(TextureObject::ParameterEnum::MinFilter, GL_NEAREST);
-    m_fullSceneTextures[1]->SetParameter(TextureObject::ParameterEnum::MagFilter, GL_NEAREST);
+    m_fullSceneTextures[1]->SetSampler(SamplerObject::GetPreset(SamplerObject::Preset::NearestClamp));
 
-    // Normal: Bind the newly created texture, set the image and the min and magfilter as nearest
+    // Normal: Bind the newly created texture, set the image and use the nearest sampler
     m_fullSceneTextures[2] = std::make_shared<Texture2DObject>();
     m_fullSceneTextures[2]->Bind();
     m_fullSceneTextures[2]->SetImage(0, width, height, TextureObject::FormatRG, TextureObject::InternalFormatRG16F);
-    m_fullSceneTextures[2]->SetParameter(TextureObject::ParameterEnum::MinFilter, GL_NEAREST);
-    m_fullSceneTextures[2]->SetParameter(TextureObject::ParameterEnum::MagFilter, GL_NEAREST);
+    m_fullSceneTextures[2]->SetSampler(SamplerObject::GetPreset(SamplerObject::Preset::NearestClamp));
 
-    // Others: Bind the newly created texture, set the image and the min and magfilter as nearest
+    // Others: Bind the newly created texture, set the image and use the nearest sampler
     m_fullSceneTextures[3] = std::make_shared<Texture2DObject>();
     m_fullSceneTextures[3]->Bind();
     m_fullSceneTextures[3]->SetImage(0, width, height, TextureObject::FormatRGBA, TextureObject::InternalFormatSRGBA8);
-    m_fullSceneTextures[3]->SetParameter(TextureObject::ParameterEnum::MinFilter, GL_NEAREST);
-    m_fullSceneTextures[3]->SetParameter(TextureObject::ParameterEnum::MagFilter, GL_NEAREST);
+    m_fullSceneTextures[3]->SetSampler(SamplerObject::GetPreset(SamplerObject::Preset::NearestClamp));
 
     m_fullSceneFramebuffer->Bind();
     m_fullSceneFramebuffer->SetTexture(FramebufferObject::Target::Draw, FramebufferObject::Attachment::Depth, *m_fullSceneTextures[0]);
@@ -405,11 +482,14 @@ void WaterApplication::InitializeRenderer()
         std::unique_ptr<GBufferRenderPass> gbufferRenderPass(std::make_unique<GBufferRenderPass>(width, height));
 
         // Set the g-buffer textures as properties of the deferred material
-        m_deferredMaterial->SetUniformValue("DepthTexture", gbufferRenderPass->GetDepthTexture());
-        m_deferredMaterial->SetUniformValue("AlbedoTexture", gbufferRenderPass->GetAlbedoTexture());
-        m_deferredMaterial->SetUniformValue("NormalTexture", gbufferRenderPass->GetNormalTexture());
-        m_deferredMaterial->SetUniformValue("OthersTexture", gbufferRenderPass->GetOthersTexture());
-        m_deferredMaterial->SetUniformValue("ShowType", m_showType);
+        m_deferredMaterial->SetUniformValue(ShaderUniforms::DepthTexture, gbufferRenderPass->GetDepthTexture());
+        m_deferredMaterial->SetUniformValue(ShaderUniforms::AlbedoTexture, gbufferRenderPass->GetAlbedoTexture());
+        m_deferredMaterial->SetUniformValue(ShaderUniforms::NormalTexture, gbufferRenderPass->GetNormalTexture());
+        m_deferredMaterial->SetUniformValue(ShaderUniforms::OthersTexture, gbufferRenderPass->GetOthersTexture());
+        if (m_showType > 0)
+        {
+            m_deferredMaterial->SetKeyword(_ShowTypeKeywords[m_showType - 1], true);
+        }
     
         // Save some gbuffer textures for later
         m_depthTexture = gbufferRenderPass->GetDepthTexture();
@@ -433,10 +513,10 @@ void WaterApplication::InitializeRenderer()
     // and then the full scene g-buffer for the rest of the passes going forward
     {
         // Copy the opaque gbuffer textures into our fullscene framebruffer
-        std::shared_ptr<Material> copyGbuffer = CreatePostFXMaterial("shaders/postfx/copyGBuffer.frag", m_sceneTexture);
-        copyGbuffer->SetUniformValue("DepthTexture", m_depthTexture);
-        copyGbuffer->SetUniformValue("NormalTexture", m_normalTexture);
-        copyGbuffer->SetUniformValue("OtherTexture", m_otherTexture);
+        std::shared_ptr<Material> copyGbuffer = CreatePostFXMaterial("shaders/postfx/copyGbuffer.frag", m_sceneTexture);
+        copyGbuffer->SetUniformValue(ShaderUniforms::DepthTexture, m_depthTexture);
+        copyGbuffer->SetUniformValue(ShaderUniforms::NormalTexture, m_normalTexture);
+        copyGbuffer->SetUniformValue(ShaderUniforms::OtherTexture, m_otherTexture);
         m_renderer.AddRenderPass(std::make_unique<GBufferCopyPass>(copyGbuffer, m_fullSceneFramebuffer));
 
         // Update the fullscene g-buffer with the transparent data
@@ -445,41 +525,49 @@ void WaterApplication::InitializeRenderer()
         // Run the forward rendering pass on the opaque data only
         m_renderer.AddRenderPass(std::make_unique<TransparencyPass>(m_mainSceneFramebuffer));
     }
+    // Post process passes, named to tell them apart in the profiler
+    auto addPostFXPass = [&](std::shared_ptr<Material> material, std::shared_ptr<const FramebufferObject> framebuffer, const std::string& name)
+        {
+            std::unique_ptr<PostFXRenderPass> postFXRenderPass(std::make_unique<PostFXRenderPass>(material, framebuffer));
+            postFXRenderPass->SetName(name);
+            m_renderer.AddRenderPass(std::move(postFXRenderPass));
+        };
+
     // SSR pass
     {
         // Get the reflection texture
         m_ssrMaterial = CreateSSRMaterial(m_sceneTexture, m_fullSceneTextures[0], m_fullSceneTextures[2], m_fullSceneTextures[3]);
-        m_renderer.AddRenderPass(std::make_unique<PostFXRenderPass>(m_ssrMaterial, m_reflectionBuffer));
+        addPostFXPass(m_ssrMaterial, m_reflectionBuffer, "SSR");
 
         // Copy the reflections into temp buffers for blurring
         std::shared_ptr<Material> copyMaterial = CreatePostFXMaterial("shaders/postfx/copy.frag", m_reflectiveColorTexture);
-        m_renderer.AddRenderPass(std::make_unique<PostFXRenderPass>(copyMaterial, m_tempFramebuffers[0]));
+        addPostFXPass(copyMaterial, m_tempFramebuffers[0], "Reflection copy");
 
         // Blur the copied reflection texture
         std::shared_ptr<Material> blurHorizontalMaterial = CreatePostFXMaterial("shaders/postfx/blur.frag", m_tempTextures[0]);
         std::shared_ptr<Material> blurVerticalMaterial = CreatePostFXMaterial("shaders/postfx/blur.frag", m_tempTextures[1]);
 
-        blurHorizontalMaterial->SetUniformValue("Scale", glm::vec2(3.0f / width, 0.0f));
-        blurVerticalMaterial->SetUniformValue("Scale", glm::vec2(0.0f, 3.0f / height));
+        blurHorizontalMaterial->SetUniformValue(ShaderUniforms::Scale, glm::vec2(3.0f / width, 0.0f));
+        blurVerticalMaterial->SetUniformValue(ShaderUniforms::Scale, glm::vec2(0.0f, 3.0f / height));
 
         for (int i = 0; i < m_blurIterations; ++i)
         {
-            m_renderer.AddRenderPass(std::make_unique<PostFXRenderPass>(blurHorizontalMaterial, m_tempFramebuffers[1]));
-            m_renderer.AddRenderPass(std::make_unique<PostFXRenderPass>(blurVerticalMaterial, m_tempFramebuffers[0]));
+            addPostFXPass(blurHorizontalMaterial, m_tempFramebuffers[1], "Blur horizontal " + std::to_string(i));
+            addPostFXPass(blurVerticalMaterial, m_tempFramebuffers[0], "Blur vertical " + std::to_string(i));
         }
     }
 
     // Final composite pass
     std::shared_ptr<Material> composeMaterial = CreateCompositeMaterial(m_sceneTexture);
-    composeMaterial->SetUniformValue("ReflectiveTexture", m_reflectiveColorTexture);
-    composeMaterial->SetUniformValue("BlurReflectiveTexture", m_tempTextures[0]);
-    composeMaterial->SetUniformValue("SpecularTexture", m_fullSceneTextures[3]);
-    composeMaterial->SetUniformValue("EnvironmentTexture", m_skyboxTexture);
-    composeMaterial->SetUniformValue("DepthTexture", m_fullSceneTextures[0]);
-    composeMaterial->SetUniformValue("NormalTexture", m_fullSceneTextures[2]);
-    composeMaterial->SetUniformValue("EnvironmentMaxLod", m_maxLod);
-
-    m_renderer.AddRenderPass(std::make_unique<PostFXRenderPass>(composeMaterial, m_renderer.GetDefaultFramebuffer()));
+    composeMaterial->SetUniformValue(ShaderUniforms::ReflectiveTexture, m_reflectiveColorTexture);
+    composeMaterial->SetUniformValue(ShaderUniforms::BlurReflectiveTexture, m_tempTextures[0]);
+    composeMaterial->SetUniformValue(ShaderUniforms::SpecularTexture, m_fullSceneTextures[3]);
+    composeMaterial->SetUniformValue(ShaderUniforms::EnvironmentTexture, m_skyboxTexture);
+    composeMaterial->SetUniformValue(ShaderUniforms::DepthTexture, m_fullSceneTextures[0]);
+    composeMaterial->SetUniformValue(ShaderUniforms::NormalTexture, m_fullSceneTextures[2]);
+    composeMaterial->SetUniformValue(ShaderUniforms::EnvironmentMaxLod, m_maxLod);
+
+    addPostFXPass(composeMaterial, m_renderer.GetDefaultFramebuffer(), "Composite");
 }
 
 // Material for Screen-Space Reflections
@@ -488,139 +576,123 @@ std::shared_ptr<Material> WaterApplication::CreateSSRMaterial(std::shared_ptr<Te
     std::vector<const char*> vertexShaderPaths;
     vertexShaderPaths.push_back("shaders/version330.glsl");
     vertexShaderPaths.push_back("shaders/renderer/fullscreen.vert");
-    Shader vertexShader = ShaderLoader(Shader::VertexShader).Load(vertexShaderPaths);
 
     std::vector<const char*> fragmentShaderPaths;
     fragmentShaderPaths.push_back("shaders/version330.glsl");
     fragmentShaderPaths.push_back("shaders/utils.glsl");
     fragmentShaderPaths.push_back("shaders/ssr.frag");
-    Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load(fragmentShaderPaths);
 
-    std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
-    shaderProgramPtr->Build(vertexShader, fragmentShader);
-
-    // Get transform related uniform locations
-    ShaderProgram::Location projMatrixLocation = shaderProgramPtr->GetUniformLocation("ProjectionMatrix");
-    ShaderProgram::Location invProjMatrixLocation = shaderProgramPtr->GetUniformLocation("InvProjMatrix");
-    ShaderProgram::Location zNearLocation = shaderProgramPtr->GetUniformLocation("ZNear");
-    ShaderProgram::Location zFarLocation = shaderProgramPtr->GetUniformLocation("ZFar");
+    // Disabling SSR switches to a variant that skips the ray march
+    const char* keywords[] = { "SSR_DISABLED" };
+    std::shared_ptr<ShaderProgramVariants> shaderVariants = std::make_shared<ShaderProgramVariants>(vertexShaderPaths, fragmentShaderPaths, keywords);
 
-    // Register shader with renderer
-    m_renderer.RegisterShaderProgram(shaderProgramPtr,
-        [=](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
+    shaderVariants->SetVariantCreatedFunction([this](std::shared_ptr<ShaderProgram> shaderProgramPtr)
         {
-            shaderProgram.SetUniform(projMatrixLocation, camera.GetProjectionMatrix());
-            shaderProgram.SetUniform(invProjMatrixLocation, glm::inverse(camera.GetProjectionMatrix()));
-            shaderProgram.SetUniform(zNearLocation, camera.getNear());
-            shaderProgram.SetUniform(zFarLocation, camera.getFar());
-        },
-        nullptr
-    );
+            // Register shader with renderer
+            m_renderer.RegisterShaderProgram(shaderProgramPtr,
+                [](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
+                {
+                    shaderProgram.SetUniform(ShaderUniforms::ProjectionMatrix, camera.GetProjectionMatrix());
+                    shaderProgram.SetUniform(ShaderUniforms::InvProjMatrix, glm::inverse(camera.GetProjectionMatrix()));
+                    shaderProgram.SetUniform(ShaderUniforms::ZNear, camera.getNear());
+                    shaderProgram.SetUniform(ShaderUniforms::ZFar, camera.getFar());
+                },
+                nullptr
+            );
+        });
 
     ShaderUniformCollection::NameSet filteredUniforms;
-    filteredUniforms.insert("InvProjMatrix");
-    filteredUniforms.insert("InvViewMatrix");
-    filteredUniforms.insert("ProjectionMatrix");
-    filteredUniforms.insert("ZNear");
-    filteredUniforms.insert("ZFar");
+    filteredUniforms.insert(ShaderUniforms::InvProjMatrix.name);
+    filteredUniforms.insert(ShaderUniforms::InvViewMatrix.name);
+    filteredUniforms.insert(ShaderUniforms::ProjectionMatrix.name);
+    filteredUniforms.insert(ShaderUniforms::ZNear.name);
+    filteredUniforms.insert(ShaderUniforms::ZFar.name);
 
     // Create material
-    std::shared_ptr<Material> material = std::make_shared<Material>(shaderProgramPtr, filteredUniforms);
-    material->SetUniformValue("SourceTexture", sourceTexture);
-    material->SetUniformValue("DepthTexture", depthTexture);
-    material->SetUniformValue("NormalTexture", normalTexture);
-    material->SetUniformValue("SpecularTexture", otherTexture);
-
-    material->SetUniformValue("MaxDistance", m_maxDistance);
-    material->SetUniformValue("Resolution", m_resolution);
-    material->SetUniformValue("Steps", m_steps);
-    material->SetUniformValue("Thickness", m_thickness);
-    material->SetUniformValue("Enabled", 1);
+    std::shared_ptr<Material> material = std::make_shared<Material>(shaderVariants, filteredUniforms);
+    material->SetUniformValue(ShaderUniforms::SourceTexture, sourceTexture);
+    material->SetUniformValue(ShaderUniforms::DepthTexture, depthTexture);
+    material->SetUniformValue(ShaderUniforms::NormalTexture, normalTexture);
+    material->SetUniformValue(ShaderUniforms::SpecularTexture, otherTexture);
+
+    material->SetUniformValue(ShaderUniforms::MaxDistance, m_maxDistance);
+    material->SetUniformValue(ShaderUniforms::Resolution, m_resolution);
+    material->SetUniformValue(ShaderUniforms::Steps, m_steps);
+    material->SetUniformValue(ShaderUniforms::Thickness, m_thickness);
+    material->SetKeyword("SSR_DISABLED", !m_ssrEnabled);
     return material;
 }
 
 // Material to combine and blend indirect lighting into the scene
 std::shared_ptr<Material> WaterApplication::CreateCompositeMaterial(std::shared_ptr<Texture2DObject> sourceTexture)
 {
-    // We could keep this vertex shader and reuse it, but it looks simpler this way
+    // The fullscreen vertex shader is compiled once, and shared by all the post-processing programs
     std::vector<const char*> vertexShaderPaths;
     vertexShaderPaths.push_back("shaders/version330.glsl");
     vertexShaderPaths.push_back("shaders/renderer/fullscreen.vert");
-    Shader vertexShader = ShaderLoader(Shader::VertexShader).Load(vertexShaderPaths);
 
     std::vector<const char*> fragmentShaderPaths;
     fragmentShaderPaths.push_back("shaders/version330.glsl");
-    fragmentShaderPaths.push_back("shaders/utils.glsl");
-    fragmentShaderPaths.push_back("shaders/lambert-ggx.glsl");
+    // Includes lambert-ggx.glsl and utils.glsl
     fragmentShaderPaths.push_back("shaders/lighting.glsl");
     fragmentShaderPaths.push_back("shaders/postfx/compose.frag");
-    Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load(fragmentShaderPaths);
 
     std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
-    shaderProgramPtr->Build(vertexShader, fragmentShader);
+    ShaderProgramCache::GetInstance().Build(*shaderProgramPtr, vertexShaderPaths, fragmentShaderPaths);
 
-    ShaderProgram::Location invProjMatrixLocation = shaderProgramPtr->GetUniformLocation("InvProjMatrix");
-    ShaderProgram::Location invViewMatrixLocation = shaderProgramPtr->GetUniformLocation("InvViewMatrix");
     m_renderer.RegisterShaderProgram(shaderProgramPtr,
-        [=](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
+        [](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
         {
-            shaderProgram.SetUniform(invProjMatrixLocation, glm::inverse(camera.GetProjectionMatrix()));
-            shaderProgram.SetUniform(invViewMatrixLocation, glm::inverse(camera.GetViewMatrix()));
+            shaderProgram.SetUniform(ShaderUniforms::InvProjMatrix, glm::inverse(camera.GetProjectionMatrix()));
+            shaderProgram.SetUniform(ShaderUniforms::InvViewMatrix, glm::inverse(camera.GetViewMatrix()));
         },
         nullptr
     );
 
     ShaderUniformCollection::NameSet filteredUniforms;
-    filteredUniforms.insert("InvProjMatrix");
-    filteredUniforms.insert("InvViewMatrix");
+    filteredUniforms.insert(ShaderUniforms::InvProjMatrix.name);
+    filteredUniforms.insert(ShaderUniforms::InvViewMatrix.name);
 
     // Create material
     std::shared_ptr<Material> material = std::make_shared<Material>(shaderProgramPtr, filteredUniforms);
-    material->SetUniformValue("SourceTexture", sourceTexture);
+    material->SetUniformValue(ShaderUniforms::SourceTexture, sourceTexture);
 
     return material;
 }
 
 std::shared_ptr<Material> WaterApplication::CreatePostFXMaterial(const char* fragmentShaderPath, std::shared_ptr<Texture2DObject> sourceTexture)
 {
-    // We could keep this vertex shader and reuse it, but it looks simpler this way
+    // The fullscreen vertex shader is compiled once, and shared by all the post-processing programs
     std::vector<const char*> vertexShaderPaths;
     vertexShaderPaths.push_back("shaders/version330.glsl");
     vertexShaderPaths.push_back("shaders/renderer/fullscreen.vert");
-    Shader vertexShader = ShaderLoader(Shader::VertexShader).Load(vertexShaderPaths);
 
     std::vector<const char*> fragmentShaderPaths;
     fragmentShaderPaths.push_back("shaders/version330.glsl");
     fragmentShaderPaths.push_back("shaders/utils.glsl");
     fragmentShaderPaths.push_back(fragmentShaderPath);
-    Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load(fragmentShaderPaths);
 
     std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
-    shaderProgramPtr->Build(vertexShader, fragmentShader);
+    ShaderProgramCache::GetInstance().Build(*shaderProgramPtr, vertexShaderPaths, fragmentShaderPaths);
 
     // Create material
     std::shared_ptr<Material> material = std::make_shared<Material>(shaderProgramPtr);
-    material->SetUniformValue("SourceTexture", sourceTexture);
+    material->SetUniformValue(ShaderUniforms::SourceTexture, sourceTexture);
     
     return material;
 }
 
-Renderer::UpdateTransformsFunction WaterApplication::GetFullscreenTransformFunction(std::shared_ptr<ShaderProgram> shaderProgramPtr) const
+Renderer::UpdateTransformsFunction WaterApplication::GetFullscreenTransformFunction() const
 {
-    // Get transform related uniform locations
-    ShaderProgram::Location invViewMatrixLocation = shaderProgramPtr->GetUniformLocation("InvViewMatrix");
-    ShaderProgram::Location invProjMatrixLocation = shaderProgramPtr->GetUniformLocation("InvProjMatrix");
-    ShaderProgram::Location worldViewProjMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldViewProjMatrix");
-
     // Return transform function
-    return [=](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
+    return [](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
         {
             if (cameraChanged)
             {
-                shaderProgram.SetUniform(invViewMatrixLocation, glm::inverse(camera.GetViewMatrix()));
-                shaderProgram.SetUniform(invProjMatrixLocation, glm::inverse(camera.GetProjectionMatrix()));
+                shaderProgram.SetUniform(ShaderUniforms::InvViewMatrix, glm::inverse(camera.GetViewMatrix()));
+                shaderProgram.SetUniform(ShaderUniforms::InvProjMatrix, glm::inverse(camera.GetProjectionMatrix()));
             }
-            shaderProgram.SetUniform(worldViewProjMatrixLocation, camera.GetViewProjectionMatrix() * worldMatrix);
+            shaderProgram.SetUniform(ShaderUniforms::WorldViewProjMatrix, camera.GetViewProjectionMatrix() * worldMatrix);
         };
 }
 
@@ -635,6 +707,18 @@ void WaterApplication::RenderGUI()
     // Draw GUI for camera controller
     m_cameraController.DrawGUI(m_imGui);
 
+    // Draw GUI for the streamed mip levels
+    m_textureStreamingManager.DrawGUI(m_imGui);
+
+    // Draw GUI for the GPU and CPU times of the render passes
+    m_renderer.GetProfiler().DrawGUI(m_imGui);
+
+    // Draw GUI for the GL calls per pass, and the redundant ones
+    GLInterceptor::GetInstance().DrawGUI(m_imGui);
+
+    // Draw GUI for the estimated memory of the GL objects and of the asset data
+    MemoryTracker::GetInstance().DrawGUI(m_imGui);
+
     if (auto window = m_imGui.UseWindow("Water"))
     {
         ImGui::Checkbox("Play", &m_play);
@@ -643,28 +727,34 @@ void WaterApplication::RenderGUI()
 
         m_waterManager->RenderGUI(m_imGui);
 
+        RenderStreamingGUI();
+
+        RenderStatsGUI();
+
+        RenderTraceGUI();
+
         if (ImGui::CollapsingHeader("SSR Settings"))
         {
             ImGui::Indent();
             if (ImGui::Checkbox("Enabled", &m_ssrEnabled))
             {
-                m_ssrMaterial->SetUniformValue("Enabled", m_ssrEnabled > 0 ? 1 : 0);
+                m_ssrMaterial->SetKeyword("SSR_DISABLED", !m_ssrEnabled);
             }
             if (ImGui::DragFloat("Max distance", &m_maxDistance, 1.0f, 0.0f, 100))
             {
-                m_ssrMaterial->SetUniformValue("MaxDistance", m_maxDistance);
+                m_ssrMaterial->SetUniformValue(ShaderUniforms::MaxDistance, m_maxDistance);
             }
             if (ImGui::DragFloat("Resolution", &m_resolution, 0.1f, 0.0f, 1.0f))
             {
-                m_ssrMaterial->SetUniformValue("Resolution", m_resolution);
+                m_ssrMaterial->SetUniformValue(ShaderUniforms::Resolution, m_resolution);
             }
             if (ImGui::DragInt("Steps", &m_steps, 1, 0, 100))
             {
-                m_ssrMaterial->SetUniformValue("Steps", m_steps);
+                m_ssrMaterial->SetUniformValue(ShaderUniforms::Steps, m_steps);
             }
             if (ImGui::DragFloat("Thickness", &m_thickness, 0.05f, 0.0f, 10.0))
             {
-                m_ssrMaterial->SetUniformValue("Thickness", m_thickness);
+                m_ssrMaterial->SetUniformValue(ShaderUniforms::Thickness, m_thickness);
             }
             ImGui::Unindent();
         }
@@ -672,3 +762,73 @@ void WaterApplication::RenderGUI()
 
     m_imGui.EndFrame();
 }
+
+void WaterApplication::RenderStreamingGUI()
+{
+    if (ImGui::CollapsingHeader("Texture Streaming"))
+    {
+        ImGui::Indent();
+        const TextureUploadRing::Stats& stats = m_textureUploadRing.GetStats();
+
+        int frameBudgetKB = static_cast<int>(m_textureUploadRing.GetFrameBudget() / 1024);
+        if (ImGui::DragInt("Frame budget (KB)", &frameBudgetKB, 64, 64, static_cast<int>(m_textureUploadRing.GetRingSize() / 1024)))
+        {
+            m_textureUploadRing.SetFrameBudget(static_cast<size_t>(frameBudgetKB) * 1024);
+        }
+        ImGui::Text("Persistent mapping: %s", m_textureUploadRing.IsPersistentlyMapped() ? "yes" : "no");
+        ImGui::Text("Pending: %.2f MB", m_textureUploadRing.GetPendingBytes() / (1024.0f * 1024.0f));
+        ImGui::Text("Uploaded: %.2f MB in %u images", stats.uploadedBytes / (1024.0f * 1024.0f), stats.completedUploads);
+        ImGui::Text("Throughput: %.2f MB/s", stats.GetThroughput() / (1024.0f * 1024.0f));
+        ImGui::Text("Worst frame while streaming: %.2f ms", stats.worstFrameTime * 1000.0f);
+        ImGui::Text("Worst upload update: %.2f ms", stats.worstUpdateTime * 1000.0f);
+        ImGui::Text("Frames with full ring: %u", stats.ringFullFrames);
+        ImGui::Unindent();
+    }
+}
+
+void WaterApplication::RenderStatsGUI()
+{
+    if (ImGui::CollapsingHeader("Render Stats"))
+    {
+        ImGui::Indent();
+        ImGui::Text("Uniform uploads: %u", m_uniformStats.uploads);
+        ImGui::Text("Uniform uploads skipped: %u", m_uniformStats.skipped);
+        ImGui::Text("Material block updates: %u (%zu bytes)", m_uniformBufferStats.updates, m_uniformBufferStats.updatedBytes);
+        ImGui::Text("Material block binds: %u, skipped: %u", m_uniformBufferStats.binds, m_uniformBufferStats.skippedBinds);
+        ImGui::Text("Render state changes: %u (%u groups)", m_renderStateStats.changes, m_renderStateStats.groupsSet);
+        ImGui::Text("Render state changes skipped: %u", m_renderStateStats.skipped);
+        ImGui::Text("Texture binds: %u (%u avoided)", m_textureBindStats.binds, m_textureBindStats.skipped);
+        ImGui::Text("Sampler binds: %u (%u avoided)", m_textureBindStats.samplerBinds, m_textureBindStats.samplersSkipped);
+        ImGui::Text("Texture unit changes: %u", m_textureBindStats.unitChanges);
+        ImGui::Text("Vertex array binds: %u (%u avoided)", m_vertexBindStats.vertexArrayBinds, m_vertexBindStats.vertexArraysSkipped);
+        ImGui::Text("Vertex buffer attachments: %u (%u avoided)", m_vertexBindStats.bufferBinds, m_vertexBindStats.buffersSkipped);
+        ImGui::Text("Shared vertex arrays: %u", VertexArrayObject::GetSharedCount());
+        ImGui::Unindent();
+    }
+}
+
+void WaterApplication::RenderTraceGUI()
+{
+    if (ImGui::CollapsingHeader("CPU Trace"))
+    {
+        ImGui::Indent();
+        CpuProfiler& profiler = CpuProfiler::GetInstance();
+        bool enabled = CpuProfiler::GetEnabled();
+        if (ImGui::Checkbox("Record zones", &enabled))
+        {
+            profiler.SetEnabled(enabled);
+        }
+        ImGui::Text("Zones: %u", profiler.GetZoneCount());
+        if (ImGui::Button("Clear"))
+        {
+            profiler.Clear();
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Export trace"))
+        {
+            // Open it in Perfetto or chrome://tracing
+            profiler.ExportChromeTrace("cpu_trace.json");
+        }
+        ImGui::Unindent();
+    }
+}
@@ -4,10 +4,13 @@
 
 #include <ituGL/scene/Scene.h>
 #include <ituGL/texture/FramebufferObject.h>
+#include <ituGL/texture/TextureUploadRing.h>
+#include <ituGL/texture/TextureStreamingManager.h>
 #include <ituGL/renderer/Renderer.h>
 #include <ituGL/camera/CameraController.h>
 #include <ituGL/utils/DearImGui.h>
 #include <ituGL/scene/SceneLight.h>
+#include <ituGL/shader/UniformBufferArena.h>
 #include "WaterManager.h"
 
 class Texture2DObject;
@@ -25,6 +28,11 @@ protected:
     void Render() override;
     void Cleanup() override;
 
+    // Used by the benchmark harness to drive the scene
+    CameraController& GetCameraController() { return m_cameraController; }
+    Renderer& GetRenderer() { return m_renderer; }
+    void SetPlaying(bool play) { m_play = play; }
+
 private:
     void InitializeCamera();
     void InitializeLights();
@@ -37,9 +45,12 @@ private:
     std::shared_ptr<Material> CreateSSRMaterial(std::shared_ptr<Texture2DObject> sourceTexture, std::shared_ptr<Texture2DObject> depthTexture, std::shared_ptr<Texture2DObject> normalTexture, std::shared_ptr<Texture2DObject> otherTexture);
     std::shared_ptr<Material> CreateCompositeMaterial(std::shared_ptr<Texture2DObject> sourceTexture);
 
-    Renderer::UpdateTransformsFunction GetFullscreenTransformFunction(std::shared_ptr<ShaderProgram> shaderProgramPtr) const;
+    Renderer::UpdateTransformsFunction GetFullscreenTransformFunction() const;
 
     void RenderGUI();
+    void RenderStreamingGUI();
+    void RenderStatsGUI();
+    void RenderTraceGUI();
 
 private:
     // Helper object for debug GUI
@@ -53,6 +64,13 @@ private:
 
     // Renderer
     Renderer m_renderer;
+
+    // Ring used to stream the large textures after loading
+    TextureUploadRing m_textureUploadRing;
+    bool m_textureStreaming;
+
+    // Streams the mip levels of the model textures, depending on their distance to the camera
+    TextureStreamingManager m_textureStreamingManager;
     
     // Light
     std::shared_ptr<SceneLight> m_spotLight;
@@ -77,6 +95,17 @@ private:
     std::array<std::shared_ptr<FramebufferObject>, 2> m_tempFramebuffers;
     std::array<std::shared_ptr<Texture2DObject>, 2> m_tempTextures;
 
+    // Uniform uploads in the last frame
+    ShaderProgram::UniformStats m_uniformStats;
+    // Material uniform block updates and binds in the last frame
+    UniformBufferArena::Stats m_uniformBufferStats;
+    // Depth, stencil and blend state changes in the last frame
+    DeviceGL::RenderStateStats m_renderStateStats;
+    // Texture and sampler binds in the last frame
+    DeviceGL::TextureBindStats m_textureBindStats;
+    // Vertex array binds and buffer attachments in the last frame
+    DeviceGL::VertexBindStats m_vertexBindStats;
+
     // Skybox texture
     std::shared_ptr<TextureCubemapObject> m_skyboxTexture;
     float m_maxLod;
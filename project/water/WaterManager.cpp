@@ -1,11 +1,13 @@
 #include "WaterManager.h"
+#include "ShaderInterface.h"
 #include <imgui.h>
 #include <ituGL/geometry/Mesh.h>
-#include <ituGL/asset/ShaderLoader.h>
+#include <ituGL/shader/ShaderProgramVariants.h>
 #include <ituGL/asset/Texture2DLoader.h>
 #include <ituGL/asset/ModelLoader.h>
+#include <ituGL/asset/AssetLoadQueue.h>
 
-WaterManager::WaterManager(Renderer& renderer, float& time)
+WaterManager::WaterManager(Renderer& renderer, float& time, bool asyncLoading, TextureUploadRing* uploadRing)
     : m_colour(0.31, 0.515, 0.663)
     , m_jump(0.24f, 0.208f)
     , m_tiling(3)
@@ -19,7 +21,7 @@ WaterManager::WaterManager(Renderer& renderer, float& time)
     , m_metalness(0.0)
     , m_alpha(0.2)
 {
-    InitializeWaterMaterial(renderer, time);
+    InitializeWaterMaterial(renderer, time, asyncLoading, uploadRing);
     LoadModel();
 }
 
@@ -29,40 +31,40 @@ void WaterManager::RenderGUI(DearImGui& imgui)
     {
         ImGui::Indent();
         if (ImGui::ColorEdit3("Colour", &m_colour[0]))
-            m_waterMaterial->SetUniformValue("Color", m_colour);
+            m_waterMaterial->SetUniformValue(ShaderUniforms::Color, m_colour);
 
         if (ImGui::SliderFloat("Alpha", &m_alpha, 0.0, 1.0))
-            m_waterMaterial->SetUniformValue("Alpha", m_alpha);
+            m_waterMaterial->SetUniformValue(ShaderUniforms::Alpha, m_alpha);
 
         if (ImGui::DragFloat2("Jump", &m_jump[0], 0.01f, -0.25f, 0.25f))
-            m_waterMaterial->SetUniformValue("Jump", m_jump);
+            m_waterMaterial->SetUniformValue(ShaderUniforms::Jump, m_jump);
 
         if (ImGui::DragInt("Tiling", &m_tiling, 1, 1, 100))
-            m_waterMaterial->SetUniformValue("Tiling", m_tiling);
+            m_waterMaterial->SetUniformValue(ShaderUniforms::Tiling, m_tiling);
 
         if (ImGui::DragFloat("Speed", &m_speed, 0.05f, 0.0f, 100.f))
-            m_waterMaterial->SetUniformValue("Speed", m_speed);
+            m_waterMaterial->SetUniformValue(ShaderUniforms::Speed, m_speed);
 
         if (ImGui::DragFloat("Flow Strength", &m_flowStrength, 0.05f, 0.0f, 1.f))
-            m_waterMaterial->SetUniformValue("FlowStrength", m_flowStrength);
+            m_waterMaterial->SetUniformValue(ShaderUniforms::FlowStrength, m_flowStrength);
 
         if (ImGui::DragFloat("Flow Offset", &m_flowOffset, 0.05f, -1.0f, 1.f))
-            m_waterMaterial->SetUniformValue("FlowOffset", m_flowOffset);
+            m_waterMaterial->SetUniformValue(ShaderUniforms::FlowOffset, m_flowOffset);
 
         if (ImGui::DragFloat("Height Scale (Base)", &m_heightScale, 0.05f, 0.0f, 10.f))
-            m_waterMaterial->SetUniformValue("HeightScale", m_heightScale);
+            m_waterMaterial->SetUniformValue(ShaderUniforms::HeightScale, m_heightScale);
 
         if (ImGui::DragFloat("Height Scale (Modulated)", &m_heightScaleModulated, 0.5f, 0.0f, 100.f))
-            m_waterMaterial->SetUniformValue("HeightScaleModulated", m_heightScaleModulated);
+            m_waterMaterial->SetUniformValue(ShaderUniforms::HeightScaleModulated, m_heightScaleModulated);
 
         if (ImGui::CollapsingHeader("Visual Properties"))
         {
             if (ImGui::DragFloat("Ambient Occlusion", &m_ambientOcclusion, 0.05, 0.0, 1.0))
-                m_waterMaterial->SetUniformValue("AmbientOcclusion", m_ambientOcclusion);
+                m_waterMaterial->SetUniformValue(ShaderUniforms::AmbientOcclusion, m_ambientOcclusion);
             if (ImGui::DragFloat("Roughness", &m_roughness, 0.05, 0.0, 1.0))
-                m_waterMaterial->SetUniformValue("Roughness", m_roughness);
+                m_waterMaterial->SetUniformValue(ShaderUniforms::Roughness, m_roughness);
             if (ImGui::DragFloat("Metalness", &m_metalness, 0.05, 0.0, 1.0))
-                m_waterMaterial->SetUniformValue("Metalness", m_metalness);
+                m_waterMaterial->SetUniformValue(ShaderUniforms::Metalness, m_metalness);
         }
 
         ImGui::Unindent();
@@ -73,77 +75,109 @@ WaterManager::~WaterManager()
 {
 }
 
-void WaterManager::InitializeWaterMaterial(Renderer& renderer, float& time)
+void WaterManager::InitializeWaterMaterial(Renderer& renderer, float& time, bool asyncLoading, TextureUploadRing* uploadRing)
 {
+    // Start decoding the textures, so it happens while the shaders compile
+    Texture2DLoader textureLoader;
+    textureLoader.SetGenerateMipmap(true);
+    Texture2DLoader::SharedFuture albedoMapFuture, flowMapFuture, normalMapFuture;
+    if (asyncLoading)
+    {
+        textureLoader.SetFormat(TextureObject::FormatRGB);
+        textureLoader.SetInternalFormat(TextureObject::InternalFormatRGB16F);
+        albedoMapFuture = textureLoader.LoadSharedAsync("models/water/water.png");
+
+        // The flow map is big, stream it over several frames instead of uploading it at once
+        textureLoader.SetFormat(TextureObject::FormatRGBA);
+        textureLoader.SetInternalFormat(TextureObject::InternalFormatRGBA32F);
+        textureLoader.SetUploadRing(uploadRing);
+        flowMapFuture = textureLoader.LoadSharedAsync("models/water/flow-speed-noise.png");
+        textureLoader.SetUploadRing(nullptr);
+
+        textureLoader.SetFormat(TextureObject::FormatRGB);
+        textureLoader.SetInternalFormat(TextureObject::InternalFormatRGB8SNorm);
+        normalMapFuture = textureLoader.LoadSharedAsync("models/water/water-normal.png");
+    }
+
     // Load and build shader
     std::vector<const char*> vertexShaderPaths;
     vertexShaderPaths.push_back("shaders/version330.glsl");
     vertexShaderPaths.push_back("shaders/default.vert");
-    Shader vertexShader = ShaderLoader(Shader::VertexShader).Load(vertexShaderPaths);
 
     std::vector<const char*> fragmentShaderPaths;
     fragmentShaderPaths.push_back("shaders/version330.glsl");
-    fragmentShaderPaths.push_back("shaders/utils.glsl");
-    fragmentShaderPaths.push_back("shaders/lambert-ggx.glsl");
+    // Includes lambert-ggx.glsl and utils.glsl
     fragmentShaderPaths.push_back("shaders/lighting.glsl");
     fragmentShaderPaths.push_back("shaders/water.frag");
-    Shader fragmentShader = ShaderLoader(Shader::FragmentShader).Load(fragmentShaderPaths);
-
-    std::shared_ptr<ShaderProgram> shaderProgramPtr = std::make_shared<ShaderProgram>();
-    shaderProgramPtr->Build(vertexShader, fragmentShader);
 
-    // Get transform related uniform locations
-    ShaderProgram::Location worldViewMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldViewMatrix");
-    ShaderProgram::Location worldViewProjMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldViewProjMatrix");
-    ShaderProgram::Location worldMatrixLocation = shaderProgramPtr->GetUniformLocation("WorldMatrix");
-    ShaderProgram::Location invViewMatrixLocation = shaderProgramPtr->GetUniformLocation("InvViewMatrix");
-    ShaderProgram::Location timeLocation = shaderProgramPtr->GetUniformLocation("ElapsedTime");
+    // The transparency pass renders the water with the FORWARD_PASS variant
+    const char* keywords[] = { "FORWARD_PASS" };
+    std::shared_ptr<ShaderProgramVariants> shaderVariants = std::make_shared<ShaderProgramVariants>(vertexShaderPaths, fragmentShaderPaths, keywords);
 
-    // Register shader with renderer
-    renderer.RegisterShaderProgram(shaderProgramPtr,
-        [=, &time](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
+    // Register each variant with the renderer
+    shaderVariants->SetVariantCreatedFunction([&renderer, &time](std::shared_ptr<ShaderProgram> shaderProgramPtr)
         {
-            shaderProgram.SetUniform(worldViewMatrixLocation, camera.GetViewMatrix() * worldMatrix);
-            shaderProgram.SetUniform(worldViewProjMatrixLocation, camera.GetViewProjectionMatrix() * worldMatrix);
-            shaderProgram.SetUniform(worldMatrixLocation, worldMatrix);
-            shaderProgram.SetUniform(invViewMatrixLocation, glm::inverse(camera.GetViewMatrix()));
-            shaderProgram.SetUniform(timeLocation, time);
-        },
-        renderer.GetDefaultUpdateLightsFunction(*shaderProgramPtr)
-    );
+            // Register shader with renderer
+            renderer.RegisterShaderProgram(shaderProgramPtr,
+                [&time](const ShaderProgram& shaderProgram, const glm::mat4& worldMatrix, const Camera& camera, bool cameraChanged)
+                {
+                    shaderProgram.SetUniform(ShaderUniforms::WorldViewMatrix, camera.GetViewMatrix() * worldMatrix);
+                    shaderProgram.SetUniform(ShaderUniforms::WorldViewProjMatrix, camera.GetViewProjectionMatrix() * worldMatrix);
+                    shaderProgram.SetUniform(ShaderUniforms::WorldMatrix, worldMatrix);
+                    shaderProgram.SetUniform(ShaderUniforms::InvViewMatrix, glm::inverse(camera.GetViewMatrix()));
+                    shaderProgram.SetUniform(ShaderUniforms::ElapsedTime, time);
+                },
+                renderer.GetDefaultUpdateLightsFunction(*shaderProgramPtr)
+            );
+        });
+
+    // Build both variants now, in one batch, instead of on the first frame
+    ShaderProgramVariants::KeywordMask keywordMasks[] = { 0, 1u << shaderVariants->GetKeywordIndex("FORWARD_PASS") };
+    shaderVariants->Prewarm(keywordMasks);
 
     // Filter out uniforms that are not material properties
     ShaderUniformCollection::NameSet filteredUniforms;
-    filteredUniforms.insert("WorldViewMatrix");
-    filteredUniforms.insert("WorldViewProjMatrix");
-    filteredUniforms.insert("WorldMatrix");
-    filteredUniforms.insert("InvViewMatrix");
-    filteredUniforms.insert("ElapsedTime");
-
-    Texture2DLoader textureLoader;
-    textureLoader.SetGenerateMipmap(true);
-    std::shared_ptr<Texture2DObject> albedoMap = textureLoader.LoadTextureShared("models/water/water.png", TextureObject::FormatRGB, TextureObject::InternalFormat::InternalFormatRGB16F);
-    std::shared_ptr<Texture2DObject> flowMap = textureLoader.LoadTextureShared("models/water/flow-speed-noise.png", TextureObject::FormatRGBA, TextureObject::InternalFormatRGBA32F);
-    std::shared_ptr<Texture2DObject> normalMap = textureLoader.LoadTextureShared("models/water/water-normal.png", TextureObject::FormatRGB, TextureObject::InternalFormatRGB8SNorm);
+    filteredUniforms.insert(ShaderUniforms::WorldViewMatrix.name);
+    filteredUniforms.insert(ShaderUniforms::WorldViewProjMatrix.name);
+    filteredUniforms.insert(ShaderUniforms::WorldMatrix.name);
+    filteredUniforms.insert(ShaderUniforms::InvViewMatrix.name);
+    filteredUniforms.insert(ShaderUniforms::ElapsedTime.name);
+
+    std::shared_ptr<Texture2DObject> albedoMap, flowMap, normalMap;
+    if (asyncLoading)
+    {
+        AssetLoadQueue& loadQueue = AssetLoadQueue::GetInstance();
+        loadQueue.Wait(albedoMapFuture);
+        loadQueue.Wait(flowMapFuture);
+        loadQueue.Wait(normalMapFuture);
+        albedoMap = albedoMapFuture.get();
+        flowMap = flowMapFuture.get();
+        normalMap = normalMapFuture.get();
+    }
+    else
+    {
+        albedoMap = textureLoader.LoadTextureShared("models/water/water.png", TextureObject::FormatRGB, TextureObject::InternalFormat::InternalFormatRGB16F);
+        flowMap = textureLoader.LoadTextureShared("models/water/flow-speed-noise.png", TextureObject::FormatRGBA, TextureObject::InternalFormatRGBA32F);
+        normalMap = textureLoader.LoadTextureShared("models/water/water-normal.png", TextureObject::FormatRGB, TextureObject::InternalFormatRGB8SNorm);
+    }
 
     // Create material
-    std::shared_ptr waterMaterial = std::make_shared<Material>(shaderProgramPtr, filteredUniforms);
-    waterMaterial->SetUniformValue("Color", m_colour);
-    waterMaterial->SetUniformValue("ColorTexture", albedoMap);
-    waterMaterial->SetUniformValue("NormalTexture", normalMap);
-    waterMaterial->SetUniformValue("FlowTexture", flowMap);
-    waterMaterial->SetUniformValue("Jump", m_jump);
-    waterMaterial->SetUniformValue("Tiling", m_tiling);
-    waterMaterial->SetUniformValue("Speed", m_speed);
-    waterMaterial->SetUniformValue("FlowStrength", m_flowStrength);
-    waterMaterial->SetUniformValue("FlowOffset", m_flowOffset);
-    waterMaterial->SetUniformValue("HeightScale", m_heightScale);
-    waterMaterial->SetUniformValue("HeightScaleModulated", m_heightScaleModulated);
-    waterMaterial->SetUniformValue("AmbientOcclusion", m_ambientOcclusion);
-    waterMaterial->SetUniformValue("Roughness", m_roughness);
-    waterMaterial->SetUniformValue("Metalness", m_metalness);
-    waterMaterial->SetUniformValue("Alpha", m_alpha);
-    waterMaterial->SetUniformValue("ForwardPass", 0);
+    std::shared_ptr waterMaterial = std::make_shared<Material>(shaderVariants, filteredUniforms);
+    waterMaterial->SetUniformValue(ShaderUniforms::Color, m_colour);
+    waterMaterial->SetUniformValue(ShaderUniforms::ColorTexture, albedoMap);
+    waterMaterial->SetUniformValue(ShaderUniforms::NormalTexture, normalMap);
+    waterMaterial->SetUniformValue(ShaderUniforms::FlowTexture, flowMap);
+    waterMaterial->SetUniformValue(ShaderUniforms::Jump, m_jump);
+    waterMaterial->SetUniformValue(ShaderUniforms::Tiling, m_tiling);
+    waterMaterial->SetUniformValue(ShaderUniforms::Speed, m_speed);
+    waterMaterial->SetUniformValue(ShaderUniforms::FlowStrength, m_flowStrength);
+    waterMaterial->SetUniformValue(ShaderUniforms::FlowOffset, m_flowOffset);
+    waterMaterial->SetUniformValue(ShaderUniforms::HeightScale, m_heightScale);
+    waterMaterial->SetUniformValue(ShaderUniforms::HeightScaleModulated, m_heightScaleModulated);
+    waterMaterial->SetUniformValue(ShaderUniforms::AmbientOcclusion, m_ambientOcclusion);
+    waterMaterial->SetUniformValue(ShaderUniforms::Roughness, m_roughness);
+    waterMaterial->SetUniformValue(ShaderUniforms::Metalness, m_metalness);
+    waterMaterial->SetUniformValue(ShaderUniforms::Alpha, m_alpha);
     waterMaterial->SetTransparency(true);
     m_waterMaterial = waterMaterial;
 }
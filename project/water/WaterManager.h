@@ -6,18 +6,19 @@
 #include <ituGL/renderer/Renderer.h>
 #include <ituGL/geometry/Model.h>
 
+class TextureUploadRing;
 
 class WaterManager
 {
 public:
-	WaterManager(Renderer& renderer, float& time);
+	WaterManager(Renderer& renderer, float& time, bool asyncLoading = false, TextureUploadRing* uploadRing = nullptr);
 	~WaterManager();
 
 	void RenderGUI(DearImGui& imgui);
 	const std::shared_ptr<Model> GetWaterPlane();
 
 private:
-	void InitializeWaterMaterial(Renderer& renderer, float& time);
+	void InitializeWaterMaterial(Renderer& renderer, float& time, bool asyncLoading, TextureUploadRing* uploadRing);
 	void LoadModel();
 
 	std::shared_ptr<Material> m_waterMaterial;
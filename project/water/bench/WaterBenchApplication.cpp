@@ -0,0 +1,274 @@
+#include "WaterBenchApplication.h"
+
+#include <ituGL/camera/Camera.h>
+#include <ituGL/scene/SceneCamera.h>
+#include <ituGL/core/GLInterceptor.h>
+#include <ituGL/core/MemoryTracker.h>
+#include <glm/common.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+// Camera keys, in simulated seconds. The path goes around the lighthouse and back to the start
+struct CameraKey
+{
+    float time;
+    glm::vec3 position;
+    glm::vec3 target;
+};
+
+static const CameraKey s_cameraPath[] = {
+    { 0.0f, glm::vec3(-18.0f, 9.0f, -2.0f), glm::vec3(0.0f, 2.0f, 0.0f) },
+    { 4.0f, glm::vec3(-6.0f, 4.0f, -14.0f), glm::vec3(0.0f, 2.0f, 0.0f) },
+    { 8.0f, glm::vec3(10.0f, 3.0f, -10.0f), glm::vec3(0.0f, 1.0f, 0.0f) },
+    { 12.0f, glm::vec3(14.0f, 6.0f, 8.0f), glm::vec3(0.0f, 2.0f, 0.0f) },
+    { 16.0f, glm::vec3(-18.0f, 9.0f, -2.0f), glm::vec3(0.0f, 2.0f, 0.0f) },
+};
+
+WaterBenchApplication::WaterBenchApplication(const Settings& settings)
+    : m_settings(settings)
+    , m_frameIndex(0)
+{
+    SetFixedTimeStep(m_settings.timeStep);
+    m_settings.captureFrames = std::min(m_settings.captureFrames, m_settings.measuredFrames);
+}
+
+void WaterBenchApplication::Initialize()
+{
+    WaterApplication::Initialize();
+
+    // The renderer enables vsync, the frames must not wait for the display
+    GetDevice().SetVSyncEnabled(false);
+
+    // Animate the water and the lights with the simulated time
+    SetPlaying(true);
+
+    m_frameTimes.reserve(m_settings.measuredFrames);
+
+    if (!m_settings.glCallsPath.empty())
+    {
+        GLInterceptor::GetInstance().SetEnabled(true);
+    }
+}
+
+void WaterBenchApplication::Update()
+{
+    RenderPassProfiler& profiler = GetRenderer().GetProfiler();
+    if (m_frameIndex == m_settings.warmupFrames)
+    {
+        // Keep every measured frame, and drop the results of the warm-up frames still in flight
+        profiler.WaitForResults();
+        profiler.SetHistorySize(std::max(m_settings.measuredFrames, 1u));
+        profiler.Clear();
+        GLInterceptor::GetInstance().Clear();
+
+        if (!m_settings.capturePath.empty())
+        {
+            GetRenderer().GetFrameCapture().Start(m_settings.captureFrames);
+        }
+    }
+
+    // Frame time from the start of the previous frame, measured after the profiler stall above
+    std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+    if (m_frameIndex > m_settings.warmupFrames && m_frameTimes.size() < m_settings.measuredFrames)
+    {
+        std::chrono::duration<float, std::milli> frameTime = frameStart - m_frameStart;
+        m_frameTimes.push_back(frameTime.count());
+    }
+    m_frameStart = frameStart;
+
+    // The measured frames are done, this one is only rendered before closing
+    if (m_frameIndex == m_settings.warmupFrames + m_settings.measuredFrames)
+    {
+        profiler.WaitForResults();
+        WriteReport();
+        if (!m_settings.glCallsPath.empty() && !GLInterceptor::GetInstance().ExportJson(m_settings.glCallsPath.c_str()))
+        {
+            std::cerr << "Could not write " << m_settings.glCallsPath << std::endl;
+        }
+
+        // Saved after the measured frames, so writing the file is not part of any frame time
+        // The capture is complete, it never has more frames than the measured ones
+        if (!m_settings.capturePath.empty())
+        {
+            const FrameCapture& frameCapture = GetRenderer().GetFrameCapture();
+            if (frameCapture.Save(m_settings.capturePath.c_str()))
+            {
+                std::cout << "Capture of " << frameCapture.GetFrames().size() << " frames written to " << m_settings.capturePath << std::endl;
+            }
+            else
+            {
+                std::cerr << "Could not write " << m_settings.capturePath << std::endl;
+            }
+        }
+        Close();
+    }
+    ++m_frameIndex;
+
+    UpdateCamera(GetCurrentTime());
+
+    WaterApplication::Update();
+}
+
+void WaterBenchApplication::UpdateCamera(float time)
+{
+    std::shared_ptr<SceneCamera> sceneCamera = GetCameraController().GetCamera();
+    if (!sceneCamera || !sceneCamera->GetCamera())
+    {
+        return;
+    }
+
+    const unsigned int keyCount = sizeof(s_cameraPath) / sizeof(CameraKey);
+    float pathTime = std::fmod(time, s_cameraPath[keyCount - 1].time);
+    unsigned int key = 0;
+    while (key + 2 < keyCount && s_cameraPath[key + 1].time <= pathTime)
+    {
+        ++key;
+    }
+    const CameraKey& from = s_cameraPath[key];
+    const CameraKey& to = s_cameraPath[key + 1];
+    float t = (pathTime - from.time) / (to.time - from.time);
+
+    sceneCamera->GetCamera()->SetViewMatrix(glm::mix(from.position, to.position, t), glm::mix(from.target, to.target, t), glm::vec3(0.0f, 1.0f, 0.0f));
+    sceneCamera->MatchTransformToCamera();
+}
+
+// Nearest rank percentile of sorted values
+static float GetPercentile(const std::vector<float>& sortedValues, float percentile)
+{
+    size_t rank = static_cast<size_t>(std::ceil(percentile * 0.01f * sortedValues.size()));
+    return sortedValues[std::max(rank, static_cast<size_t>(1)) - 1];
+}
+
+static void WriteSummary(std::ostream& stream, const RenderPassProfiler::Summary& summary)
+{
+    stream << "{ \"avg\": " << summary.avg << ", \"min\": " << summary.min << ", \"p99\": " << summary.p99 << ", \"samples\": " << summary.count << " }";
+}
+
+static void WriteString(std::ostream& stream, const char* string)
+{
+    stream << '"';
+    for (const char* c = string; c && *c; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            stream << '\\';
+        }
+        stream << *c;
+    }
+    stream << '"';
+}
+
+static void WriteMemoryTotals(std::ostream& stream, const MemoryTracker::Totals& totals)
+{
+    stream << "{ \"bytes\": " << totals.bytes << ", \"peakBytes\": " << totals.peakBytes << ", \"objects\": " << totals.objectCount << " }";
+}
+
+void WaterBenchApplication::WriteReport()
+{
+    std::ofstream file(m_settings.outputPath);
+    if (!file)
+    {
+        std::cout << "Could not write the benchmark report to " << m_settings.outputPath << std::endl;
+        return;
+    }
+
+    int width, height;
+    GetMainWindow().GetDimensions(width, height);
+
+    file << "{\n";
+    file << "  \"renderer\": ";
+    WriteString(file, reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    file << ",\n  \"glVersion\": ";
+    WriteString(file, reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+    file << ",\n  \"headless\": " << (GetMainWindow().IsHeadless() ? "true" : "false");
+    file << ",\n  \"width\": " << width << ",\n  \"height\": " << height;
+    file << ",\n  \"warmupFrames\": " << m_settings.warmupFrames << ",\n  \"measuredFrames\": " << m_frameTimes.size();
+    file << ",\n  \"timeStep\": " << m_settings.timeStep;
+
+    // Frame times, in milliseconds
+    std::vector<float> sortedFrameTimes(m_frameTimes);
+    std::sort(sortedFrameTimes.begin(), sortedFrameTimes.end());
+    if (!sortedFrameTimes.empty())
+    {
+        float sum = 0.0f;
+        for (float frameTime : sortedFrameTimes)
+        {
+            sum += frameTime;
+        }
+        file << ",\n  \"frameTimeMs\": { \"avg\": " << sum / sortedFrameTimes.size()
+            << ", \"min\": " << sortedFrameTimes.front()
+            << ", \"p50\": " << GetPercentile(sortedFrameTimes, 50.0f)
+            << ", \"p90\": " << GetPercentile(sortedFrameTimes, 90.0f)
+            << ", \"p95\": " << GetPercentile(sortedFrameTimes, 95.0f)
+            << ", \"p99\": " << GetPercentile(sortedFrameTimes, 99.0f)
+            << ", \"max\": " << sortedFrameTimes.back() << " }";
+    }
+
+    // Times of each render pass, in milliseconds
+    const RenderPassProfiler& profiler = GetRenderer().GetProfiler();
+    file << ",\n  \"droppedProfilerFrames\": " << profiler.GetDroppedFrames();
+    file << ",\n  \"passes\": [";
+    float gpuTotal = 0.0f;
+    float cpuTotal = 0.0f;
+    for (unsigned int passIndex = 0; passIndex < profiler.GetPassCount(); ++passIndex)
+    {
+        RenderPassProfiler::Summary gpuSummary = profiler.GetGpuSummary(passIndex);
+        RenderPassProfiler::Summary cpuSummary = profiler.GetCpuSummary(passIndex);
+        gpuTotal += gpuSummary.avg;
+        cpuTotal += cpuSummary.avg;
+
+        file << (passIndex ? "," : "") << "\n    { \"name\": ";
+        WriteString(file, profiler.GetPassName(passIndex).c_str());
+        file << ", \"gpuMs\": ";
+        WriteSummary(file, gpuSummary);
+        file << ", \"cpuMs\": ";
+        WriteSummary(file, cpuSummary);
+        file << " }";
+    }
+    file << "\n  ],\n  \"passTotalMs\": { \"gpu\": " << gpuTotal << ", \"cpu\": " << cpuTotal << " }";
+
+    // Estimated memory, at the end of the run and at the peak
+    const MemoryTracker& memoryTracker = MemoryTracker::GetInstance();
+    file << ",\n  \"memory\": {\n    \"gpu\": ";
+    WriteMemoryTotals(file, memoryTracker.GetGpuTotals());
+    file << ",\n    \"cpu\": ";
+    WriteMemoryTotals(file, memoryTracker.GetCpuTotals());
+    file << ",\n    \"categories\": {";
+    for (unsigned int category = 0; category < static_cast<unsigned int>(MemoryTracker::Category::Count); ++category)
+    {
+        file << (category ? "," : "") << "\n      ";
+        WriteString(file, MemoryTracker::GetCategoryName(static_cast<MemoryTracker::Category>(category)));
+        file << ": ";
+        WriteMemoryTotals(file, memoryTracker.GetTotals(static_cast<MemoryTracker::Category>(category)));
+    }
+    file << "\n    },\n    \"objects\": [";
+    std::vector<MemoryTracker::ObjectInfo> objects = memoryTracker.GetObjects();
+    for (unsigned int objectIndex = 0; objectIndex < objects.size(); ++objectIndex)
+    {
+        const MemoryTracker::ObjectInfo& object = objects[objectIndex];
+        file << (objectIndex ? "," : "") << "\n      { \"type\": ";
+        WriteString(file, MemoryTracker::GetObjectTypeName(object.type));
+        if (object.type != MemoryTracker::ObjectType::Cpu)
+        {
+            file << ", \"handle\": " << object.id;
+        }
+        file << ", \"category\": ";
+        WriteString(file, MemoryTracker::GetCategoryName(object.category));
+        file << ", \"bytes\": " << object.bytes;
+        if (object.width > 0)
+        {
+            file << ", \"width\": " << object.width << ", \"height\": " << object.height;
+        }
+        if (!object.name.empty())
+        {
+            file << ", \"name\": ";
+            WriteString(file, object.name.c_str());
+        }
+        file << " }";
+    }
+    file << "\n    ]\n  }\n}\n";
+
+    std::cout << "Benchmark report written to " << m_settings.outputPath << std::endl;
+}
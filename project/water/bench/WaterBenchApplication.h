@@ -0,0 +1,50 @@
+#pragma once
+
+#include "WaterApplication.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Runs the water scene for a fixed number of frames, with a scripted camera and a fixed time step,
+// and writes the frame times and the times of each render pass as JSON
+class WaterBenchApplication : public WaterApplication
+{
+public:
+    struct Settings
+    {
+        // Frames rendered before measuring, to let the streaming and the caches settle
+        unsigned int warmupFrames = 60;
+        unsigned int measuredFrames = 300;
+        // Simulated seconds per frame
+        float timeStep = 1.0f / 60.0f;
+        std::string outputPath = "water_bench.json";
+        // If set, the GL calls of the measured frames are counted and written here as JSON
+        std::string glCallsPath;
+        // If set, the first measured frames are captured and written here, to replay them with itugl_replay
+        // Capturing reads back the buffers and programs the first time they are used, so those frames are slower
+        std::string capturePath;
+        unsigned int captureFrames = 1;
+    };
+
+    WaterBenchApplication(const Settings& settings);
+
+protected:
+    void Initialize() override;
+    void Update() override;
+
+private:
+    // Move the camera along the path, looping
+    void UpdateCamera(float time);
+
+    void WriteReport();
+
+private:
+    Settings m_settings;
+
+    unsigned int m_frameIndex;
+    std::chrono::steady_clock::time_point m_frameStart;
+
+    // Wall time of each measured frame, in milliseconds
+    std::vector<float> m_frameTimes;
+};
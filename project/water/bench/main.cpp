@@ -0,0 +1,59 @@
+#include "WaterBenchApplication.h"
+
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+// Usage: water_bench [--warmup N] [--frames M] [--size WIDTHxHEIGHT] [--timestep SECONDS] [--output PATH] [--gl-calls PATH]
+//        [--capture PATH] [--capture-frames N] [--windowed]
+// Runs headless unless --windowed is set. Run it from the water folder, so the assets are found
+int main(int argc, char** argv)
+{
+    WaterBenchApplication::Settings settings;
+    Application::HeadlessSettings headlessSettings;
+    headlessSettings.enabled = true;
+    for (int i = 1; i < argc; ++i)
+    {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--warmup") == 0 && hasValue)
+        {
+            settings.warmupFrames = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--frames") == 0 && hasValue)
+        {
+            settings.measuredFrames = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--size") == 0 && hasValue)
+        {
+            std::sscanf(argv[++i], "%dx%d", &headlessSettings.width, &headlessSettings.height);
+        }
+        else if (std::strcmp(argv[i], "--timestep") == 0 && hasValue)
+        {
+            settings.timeStep = std::strtof(argv[++i], nullptr);
+        }
+        else if (std::strcmp(argv[i], "--output") == 0 && hasValue)
+        {
+            settings.outputPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--gl-calls") == 0 && hasValue)
+        {
+            settings.glCallsPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--capture") == 0 && hasValue)
+        {
+            settings.capturePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--capture-frames") == 0 && hasValue)
+        {
+            settings.captureFrames = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--windowed") == 0)
+        {
+            headlessSettings.enabled = false;
+        }
+    }
+    Application::SetHeadlessSettings(headlessSettings);
+
+    WaterBenchApplication benchApplication(settings);
+    return benchApplication.Run();
+}
@@ -1,7 +1,31 @@
 #include "WaterApplication.h"
 
-int main()
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+// Usage: water [--headless] [--frames N] [--size WIDTHxHEIGHT]
+// Headless runs render offscreen, without a display, and stop after N frames if set
+int main(int argc, char** argv)
 {
+    Application::HeadlessSettings headlessSettings;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--headless") == 0)
+        {
+            headlessSettings.enabled = true;
+        }
+        else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            headlessSettings.frameCount = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+        {
+            std::sscanf(argv[++i], "%dx%d", &headlessSettings.width, &headlessSettings.height);
+        }
+    }
+    Application::SetHeadlessSettings(headlessSettings);
+
     WaterApplication sceneViewerApplication;
     return sceneViewerApplication.Run();
 }
@@ -10,11 +10,11 @@ out vec2 FragNormal;
 out vec4 FragOthers;
 
 //Uniforms
-uniform vec3 Color;
-uniform vec3 HaveTextures;
-uniform sampler2D ColorTexture;
-uniform sampler2D NormalTexture;
-uniform sampler2D SpecularTexture;
+LOCATION(32) uniform vec3 Color;
+LOCATION(33) uniform vec3 HaveTextures;
+LOCATION(64) uniform sampler2D ColorTexture;
+LOCATION(65) uniform sampler2D NormalTexture;
+LOCATION(72) uniform sampler2D SpecularTexture;
 
 vec4 defaultSpecular = vec4(0.0, 0.5, 0.0, 0);
 
@@ -13,8 +13,8 @@ out vec2 TexCoord;
 out vec3 ViewPosition;
 
 //Uniforms
-uniform mat4 WorldViewMatrix;
-uniform mat4 WorldViewProjMatrix;
+LOCATION(1) uniform mat4 WorldViewMatrix;
+LOCATION(2) uniform mat4 WorldViewProjMatrix;
 
 void main()
 {
@@ -1,6 +1,7 @@
+#include "utils.glsl"
 
-uniform samplerCube EnvironmentTexture;
-uniform float EnvironmentMaxLod;
+LOCATION(75) uniform samplerCube EnvironmentTexture;
+LOCATION(45) uniform float EnvironmentMaxLod;
 
 struct SurfaceData
 {
@@ -1,9 +1,10 @@
+#include "lambert-ggx.glsl"
 
-uniform bool LightIndirect;
-uniform vec3 LightColor;
-uniform vec3 LightPosition;
-uniform vec3 LightDirection;
-uniform vec4 LightAttenuation;
+LOCATION(16) uniform bool LightIndirect;
+LOCATION(17) uniform vec3 LightColor;
+LOCATION(18) uniform vec3 LightPosition;
+LOCATION(19) uniform vec3 LightDirection;
+LOCATION(20) uniform vec4 LightAttenuation;
 
 float ComputeDistanceAttenuation(vec3 position)
 {
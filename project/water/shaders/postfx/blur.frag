@@ -5,8 +5,8 @@ in vec2 TexCoord;
 out vec4 FragColor;
 
 //Uniforms
-uniform sampler2D SourceTexture;
-uniform vec2 Scale; // Scale to adjust to the resolution, and to select direction
+LOCATION(67) uniform sampler2D SourceTexture;
+LOCATION(50) uniform vec2 Scale; // Scale to adjust to the resolution, and to select direction
 
 // Offset (in pixels) where to sample the neighbors. We sample between texels to take advantage of the linear filtering
 const float offsets[3] = float[](0.0, 1.3846153846f, 3.2307692308f);
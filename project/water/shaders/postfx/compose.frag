@@ -5,15 +5,15 @@ in vec2 TexCoord;
 out vec4 FragColor;
 
 //Uniforms
-uniform sampler2D DepthTexture;
-uniform sampler2D SourceTexture;
-uniform sampler2D NormalTexture;
-uniform sampler2D ReflectiveTexture;
-uniform sampler2D BlurReflectiveTexture;
-uniform sampler2D SpecularTexture;
+LOCATION(68) uniform sampler2D DepthTexture;
+LOCATION(67) uniform sampler2D SourceTexture;
+LOCATION(65) uniform sampler2D NormalTexture;
+LOCATION(73) uniform sampler2D ReflectiveTexture;
+LOCATION(74) uniform sampler2D BlurReflectiveTexture;
+LOCATION(72) uniform sampler2D SpecularTexture;
 
-uniform mat4 InvViewMatrix;
-uniform mat4 InvProjMatrix;
+LOCATION(5) uniform mat4 InvViewMatrix;
+LOCATION(4) uniform mat4 InvProjMatrix;
 
 // Computes the color for our ssr reflection
 vec3 ComputeSSRIndirectLighting(SurfaceData data, vec3 viewDir, vec4 reflectiveColor, float ssrVisibility)
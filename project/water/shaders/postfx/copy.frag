@@ -5,7 +5,7 @@ in vec2 TexCoord;
 out vec4 FragColor;
 
 //Uniforms
-uniform sampler2D SourceTexture;
+LOCATION(67) uniform sampler2D SourceTexture;
 
 void main()
 {
@@ -7,10 +7,10 @@ out vec2 FragNormal;
 out vec4 FragOthers;
 
 //Uniforms
-uniform sampler2D SourceTexture;
-uniform sampler2D DepthTexture;
-uniform sampler2D NormalTexture;
-uniform sampler2D OtherTexture;
+LOCATION(67) uniform sampler2D SourceTexture;
+LOCATION(68) uniform sampler2D DepthTexture;
+LOCATION(65) uniform sampler2D NormalTexture;
+LOCATION(71) uniform sampler2D OtherTexture;
 
 void main()
 {
@@ -5,13 +5,12 @@ in vec2 TexCoord;
 out vec4 FragColor;
 
 //Uniforms
-uniform sampler2D DepthTexture;
-uniform sampler2D AlbedoTexture;
-uniform sampler2D NormalTexture;
-uniform sampler2D OthersTexture;
-uniform mat4 InvViewMatrix;
-uniform mat4 InvProjMatrix;
-uniform int ShowType;
+LOCATION(68) uniform sampler2D DepthTexture;
+LOCATION(69) uniform sampler2D AlbedoTexture;
+LOCATION(65) uniform sampler2D NormalTexture;
+LOCATION(70) uniform sampler2D OthersTexture;
+LOCATION(5) uniform mat4 InvViewMatrix;
+LOCATION(4) uniform mat4 InvProjMatrix;
 
 void main()
 {
@@ -41,17 +40,18 @@ void main()
 		// No indirect ligthning since we are going to use SSR/Environment map blending later
 		vec3 lighting = ComputeLighting(position, data, viewDir, false);
 
-		// Different options for some debug visuals
-		if(ShowType == 0)
-			FragColor = vec4(lighting, 1.0f);
-		else if (ShowType == 1)
-			FragColor = vec4(albedo, 1.0f);
-		else if (ShowType == 2)
-			FragColor = vec4(position, 1.0f);
-		else if (ShowType == 3)
-			FragColor = vec4(texture(DepthTexture, TexCoord).r, 1, 1, 1.0f);
-		else if (ShowType == 4)
-			FragColor = vec4(normalize(normal), 1.0f);
-		else if (ShowType == 5)
-			FragColor = vec4(GetImplicitNormal(texture(NormalTexture, TexCoord).xy), 1.0f);
+		// Different options for some debug visuals, each one in its own variant
+#if defined(SHOW_ALBEDO)
+		FragColor = vec4(albedo, 1.0f);
+#elif defined(SHOW_POSITION)
+		FragColor = vec4(position, 1.0f);
+#elif defined(SHOW_DEPTH)
+		FragColor = vec4(texture(DepthTexture, TexCoord).r, 1, 1, 1.0f);
+#elif defined(SHOW_NORMAL)
+		FragColor = vec4(normalize(normal), 1.0f);
+#elif defined(SHOW_GBUFFER_NORMAL)
+		FragColor = vec4(GetImplicitNormal(texture(NormalTexture, TexCoord).xy), 1.0f);
+#else
+		FragColor = vec4(lighting, 1.0f);
+#endif
 }
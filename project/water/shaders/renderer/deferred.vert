@@ -5,7 +5,7 @@ layout (location = 0) in vec3 VertexPosition;
 out vec2 TexCoord;
 
 //Uniforms
-uniform mat4 WorldViewProjMatrix;
+LOCATION(2) uniform mat4 WorldViewProjMatrix;
 
 void main()
 {
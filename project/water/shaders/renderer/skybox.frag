@@ -1,4 +1,4 @@
-#version 330 core
+#include "../version330.glsl"
 
 //Inputs
 in vec3 ViewDir;
@@ -7,7 +7,7 @@ in vec3 ViewDir;
 out vec4 FragColor;
 
 //Uniforms
-uniform samplerCube SkyboxTexture;
+LOCATION(76) uniform samplerCube SkyboxTexture;
 
 void main()
 {
@@ -1,4 +1,4 @@
-#version 330 core
+#include "../version330.glsl"
 
 //Inputs
 layout (location = 0) in vec3 VertexPosition;
@@ -7,8 +7,8 @@ layout (location = 0) in vec3 VertexPosition;
 out vec3 ViewDir;
 
 //Uniforms
-uniform vec3 CameraPosition;
-uniform mat4 InvViewProjMatrix;
+LOCATION(7) uniform vec3 CameraPosition;
+LOCATION(6) uniform mat4 InvViewProjMatrix;
 
 void main()
 {
@@ -5,24 +5,28 @@ in vec2 TexCoord;
 out vec4 FragColor;
 
 //Uniforms
-uniform sampler2D DepthTexture;
-uniform sampler2D SourceTexture;
-uniform sampler2D NormalTexture;
-uniform sampler2D SpecularTexture;
-uniform mat4 ProjectionMatrix;
-uniform mat4 InvProjMatrix;
-uniform int Enabled;
-uniform float ZNear;
-uniform float ZFar;
+LOCATION(68) uniform sampler2D DepthTexture;
+LOCATION(67) uniform sampler2D SourceTexture;
+LOCATION(65) uniform sampler2D NormalTexture;
+LOCATION(72) uniform sampler2D SpecularTexture;
+LOCATION(3) uniform mat4 ProjectionMatrix;
+LOCATION(4) uniform mat4 InvProjMatrix;
+LOCATION(8) uniform float ZNear;
+LOCATION(9) uniform float ZFar;
 
 //SSR Properties
-uniform float MaxDistance;
-uniform float Resolution;
-uniform int Steps;
-uniform float Thickness;
+LOCATION(46) uniform float MaxDistance;
+LOCATION(47) uniform float Resolution;
+LOCATION(48) uniform int Steps;
+LOCATION(49) uniform float Thickness;
 
 void main()
 {
+#ifdef SSR_DISABLED
+	FragColor = vec4(0, 0, 0, 0);
+	return;
+#endif
+
 	float steps = Steps;
 	vec2 texSize = textureSize(DepthTexture, 0).xy;
 	vec4 uv = vec4(0);
@@ -37,7 +41,7 @@ void main()
 	vec4 endView = vec4(positionFrom + (reflection * MaxDistance), 1);
 
 	// Early exit 
-	if (texture(DepthTexture, TexCoord).r == 1 || reflection.z > 0 || Enabled == 0)
+	if (texture(DepthTexture, TexCoord).r == 1 || reflection.z > 0)
 	{
 		FragColor = vec4(0, 0, 0, 0);
 		return;
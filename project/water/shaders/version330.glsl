@@ -1 +1,11 @@
 #version 330 core
+
+// Uniforms are declared with LOCATION(N), with the location of each name fixed in all the shaders
+// The application sets them with the constants generated from the shaders, without looking them up by name
+// Without GL_ARB_explicit_uniform_location, the driver assigns the locations and the application finds them once per program
+#extension GL_ARB_explicit_uniform_location : enable
+#ifdef GL_ARB_explicit_uniform_location
+#define LOCATION(N) layout(location = N)
+#else
+#define LOCATION(N)
+#endif
@@ -11,28 +11,32 @@ out vec2 FragNormal;
 out vec4 FragOthers;
 
 //Uniforms
-uniform vec3 Color;
-uniform sampler2D ColorTexture;
-uniform sampler2D NormalTexture;
-uniform sampler2D FlowTexture;
-uniform mat4 InvViewMatrix;
-uniform float ElapsedTime;
-uniform int ForwardPass;
-
-//Water properties
-uniform vec2 Jump;
-uniform int Tiling;
-uniform float Speed; 
-uniform float FlowStrength;
-uniform float FlowOffset;
-uniform float HeightScale;
-uniform float HeightScaleModulated;
-
-//Visual Properties
-uniform float AmbientOcclusion;
-uniform float Roughness;
-uniform float Metalness;
-uniform float Alpha;
+LOCATION(64) uniform sampler2D ColorTexture;
+LOCATION(65) uniform sampler2D NormalTexture;
+LOCATION(66) uniform sampler2D FlowTexture;
+LOCATION(5) uniform mat4 InvViewMatrix;
+LOCATION(10) uniform float ElapsedTime;
+
+//Material properties, read from the slice of the material in a shared uniform buffer
+layout(std140) uniform WaterMaterial
+{
+	vec3 Color;
+	float Alpha;
+
+	//Water properties
+	vec2 Jump;
+	int Tiling;
+	float Speed;
+	float FlowStrength;
+	float FlowOffset;
+	float HeightScale;
+	float HeightScaleModulated;
+
+	//Visual Properties
+	float AmbientOcclusion;
+	float Roughness;
+	float Metalness;
+};
 
 //Calculate the offset uv coordinates based on certain flow variables and time
 vec3 FlowUVW(vec2 uv, vec2 flowVector, vec2 jump, float flowOffset, float tiling, float time, bool flowB)
@@ -78,35 +82,32 @@ void main()
 
 	vec3 combinedViewSpaceNormal = normalize(normalA + normalB);
 
-	// Hacky way to differentiate DeferredPass and ForwardPass
-	if(ForwardPass == 0)
-	{
-		FragAlbedo = vec4(Color * (texA + texB), Alpha);
-		FragNormal = normalize(combinedViewSpaceNormal).xy;
-		FragOthers = waterSpecular;
-	}
-	else
-	{
-		// Compute view vector in view space
-		vec3 viewDir = GetDirection(ViewPosition, vec3(0));
-
-		// Convert position, normal and view vector to world space
-		vec3 worldNormal = (InvViewMatrix * vec4(normalize(combinedViewSpaceNormal), 0)).xyz;
-		vec3 worldPosition = (InvViewMatrix * vec4(ViewPosition, 1)).xyz;
-		viewDir = (InvViewMatrix * vec4(viewDir, 0)).xyz;
-
-		// Set surface material data
-		SurfaceData data;
-		data.normal = worldNormal;
-		data.albedo = Color * (texA + texB);
-		data.ambientOcclusion = waterSpecular.x;
-		data.roughness = waterSpecular.y;
-		data.metalness = waterSpecular.z;
-
-		// Compute lighting
-		// No indirect ligthning since we are going to use SSR/Environment map blending later
-		vec3 lighting = ComputeLighting(worldPosition, data, viewDir, false);
-
-		FragAlbedo = vec4(lighting, Alpha);
-	}
+	// The forward variant is used by the transparency pass, the default one writes the g-buffer
+#ifndef FORWARD_PASS
+	FragAlbedo = vec4(Color * (texA + texB), Alpha);
+	FragNormal = normalize(combinedViewSpaceNormal).xy;
+	FragOthers = waterSpecular;
+#else
+	// Compute view vector in view space
+	vec3 viewDir = GetDirection(ViewPosition, vec3(0));
+
+	// Convert position, normal and view vector to world space
+	vec3 worldNormal = (InvViewMatrix * vec4(normalize(combinedViewSpaceNormal), 0)).xyz;
+	vec3 worldPosition = (InvViewMatrix * vec4(ViewPosition, 1)).xyz;
+	viewDir = (InvViewMatrix * vec4(viewDir, 0)).xyz;
+
+	// Set surface material data
+	SurfaceData data;
+	data.normal = worldNormal;
+	data.albedo = Color * (texA + texB);
+	data.ambientOcclusion = waterSpecular.x;
+	data.roughness = waterSpecular.y;
+	data.metalness = waterSpecular.z;
+
+	// Compute lighting
+	// No indirect ligthning since we are going to use SSR/Environment map blending later
+	vec3 lighting = ComputeLighting(worldPosition, data, viewDir, false);
+
+	FragAlbedo = vec4(lighting, Alpha);
+#endif
 }
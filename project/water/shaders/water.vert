@@ -13,9 +13,9 @@ out vec3 ViewPosition;
 out vec2 TexCoord;
 
 //Uniforms
-uniform mat4 WorldViewMatrix;
-uniform mat4 WorldViewProjMatrix;
-uniform mat4 WorldMatrix;
+LOCATION(1) uniform mat4 WorldViewMatrix;
+LOCATION(2) uniform mat4 WorldViewProjMatrix;
+LOCATION(0) uniform mat4 WorldMatrix;
 
 void main()
 {